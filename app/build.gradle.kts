@@ -1,3 +1,6 @@
+import javax.inject.Inject
+import org.gradle.process.ExecOperations
+
 plugins {
     alias(libs.plugins.android.application)
     alias(libs.plugins.kotlin.android)
@@ -86,6 +89,77 @@ android {
     ndkVersion = "29.0.14206865"
 }
 
+/**
+ * 用NDK自带的glslc把vulkan/shaders下的GLSL源码编译为SPIR-V，输出作为生成的assets打包
+ * 仓库中不提交着色器二进制，.comp源码是唯一来源
+ */
+abstract class CompileShadersTask : DefaultTask() {
+    @get:InputDirectory
+    @get:PathSensitive(PathSensitivity.RELATIVE)
+    abstract val shaderDir: DirectoryProperty
+
+    // 输出文件名（不含扩展名） -> [源文件名, glslc额外参数...]
+    @get:Input
+    abstract val variants: MapProperty<String, List<String>>
+
+    @get:Internal
+    abstract val ndkDirectory: DirectoryProperty
+
+    @get:OutputDirectory
+    abstract val outputDir: DirectoryProperty
+
+    @get:Inject
+    abstract val execOperations: ExecOperations
+
+    @TaskAction
+    fun compile() {
+        val osName = System.getProperty("os.name").lowercase()
+        val host = when {
+            osName.contains("windows") -> "windows-x86_64"
+            osName.contains("mac") -> "darwin-x86_64"
+            else -> "linux-x86_64"
+        }
+        val executable = if (host.startsWith("windows")) "glslc.exe" else "glslc"
+        val glslc = ndkDirectory.get().dir("shader-tools/$host").file(executable).asFile
+        if (!glslc.canExecute()) {
+            throw GradleException("找不到glslc: $glslc，请通过SDK Manager安装NDK $host 工具")
+        }
+
+        // 资源路径与运行时加载路径一致：shaders/<name>.spv
+        val shaderOutput = outputDir.get().dir("shaders").asFile
+        shaderOutput.deleteRecursively()
+        shaderOutput.mkdirs()
+
+        variants.get().forEach { (name, arguments) ->
+            val source = shaderDir.get().file(arguments.first()).asFile
+            execOperations.exec {
+                commandLine(
+                    listOf(glslc.absolutePath, "--target-env=vulkan1.0", "-O") +
+                            arguments.drop(1) +
+                            listOf(source.absolutePath, "-o", File(shaderOutput, "$name.spv").absolutePath)
+                )
+            }
+        }
+    }
+}
+
+val compileShaders = tasks.register<CompileShadersTask>("compileShaders") {
+    shaderDir.set(layout.projectDirectory.dir("src/main/cpp/vulkan/shaders"))
+    variants.put("lut_processor", listOf("lut_processor.comp"))
+    // 存储缓冲区变体：同一源文件定义STORAGE_BUFFER
+    variants.put("lut_processor_buffer", listOf("lut_processor.comp", "-DSTORAGE_BUFFER"))
+    ndkDirectory.set(androidComponents.sdkComponents.ndkDirectory)
+}
+
+androidComponents {
+    onVariants { variant ->
+        variant.sources.assets?.addGeneratedSourceDirectory(
+            compileShaders,
+            CompileShadersTask::outputDir
+        )
+    }
+}
+
 dependencies {
     implementation(libs.androidx.core.ktx)
     implementation(libs.androidx.appcompat)
@@ -1,9 +1,22 @@
 #include "image_processor.h"
 #include "lut_processor.h"
+#include "lut_baker.h"
+#include "tile_autotuner.h"
 #include "../utils/simd_utils.h"
 #include <algorithm>
 #include <random>
 #include <cmath>
+#include <memory>
+
+namespace {
+    // SplitMix64终结函数，把相邻的种子打散为互不相关的64位值
+    inline uint64_t mixSeed(uint64_t value) {
+        value += 0x9E3779B97F4A7C15ULL;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+        return value ^ (value >> 31);
+    }
+}
 
 ImageProcessor::ImageProcessor() {
     LOGD("ImageProcessor构造函数");
@@ -30,23 +43,21 @@ ProcessResult ImageProcessor::processSingleThreaded(
     uint8_t *outputPixels = static_cast<uint8_t *>(output.pixels);
 
     const int totalPixels = input.width * input.height;
-    const int bytesPerPixel = 4; // ARGB_8888
 
-    LOGD("开始单线程处理，总像素数: %d", totalPixels);
+    const bool useBakedLut = params.bakedLut != nullptr && params.bakedLut->isBaked;
+
+    LOGD("开始单线程处理，总像素数: %d, 使用烘焙LUT: %d, SIMD: %s", totalPixels, useBakedLut,
+         SIMDUtils::getSimdLevelName(SIMDUtils::getSimdLevel()));
 
-    // 逐像素处理
+    // 逐行处理
     for (int y = 0; y < input.height; ++y) {
-        for (int x = 0; x < input.width; ++x) {
-            const int pixelIndex = y * input.stride + x * bytesPerPixel;
-
-            processPixel(
-                    &inputPixels[pixelIndex],
-                    &outputPixels[pixelIndex],
-                    primaryLut,
-                    secondaryLut,
-                    params
-            );
-        }
+        // 整行交给批处理：烘焙LUT优先，否则按运行时SIMD级别分派
+        // 输入输出可以是跨度不同的视图（如流式处理的分块）
+        processPixelsBatch(&inputPixels[static_cast<size_t>(y) * input.stride],
+                           &outputPixels[static_cast<size_t>(y) * output.stride], input.width,
+                           primaryLut, secondaryLut, params,
+                           OrderedDitherRow(params.ditherType, params.ditherOriginX,
+                                            params.ditherOriginY + y));
 
         // 更新进度
         if (callback && y % 100 == 0) {
@@ -74,92 +85,85 @@ ProcessResult ImageProcessor::processMultiThreaded(
         const LutData &primaryLut,
         const LutData &secondaryLut,
         const ProcessingParams &params,
-        NativeProgressCallback callback
+        NativeProgressCallback callback,
+        JobArena *arena
 ) {
     if (!input.pixels || !output.pixels) {
         LOGE("输入或输出像素数据为空");
         return ProcessResult::ERROR_INVALID_BITMAP;
     }
 
-    const int threadCount = calculateOptimalThreadCount(input.width, input.height);
-    const int rowsPerThread = input.height / threadCount;
+    ThreadPool &pool = ThreadPool::getInstance();
 
-    LOGD("开始多线程处理，线程数: %d, 每线程行数: %d", threadCount, rowsPerThread);
+    // Floyd-Steinberg抖动与LUT逐行融合，按波前并行扩散误差
+    if (params.ditherType == 1) {
+        processWavefrontFloydSteinberg(input, output, primaryLut, secondaryLut, params, callback,
+                                       arena);
+        LOGD("多线程处理完成（波前抖动）");
+        return ProcessResult::SUCCESS;
+    }
+
+    const ThreadPool::SchedulingMode mode = selectSchedulingMode(params);
+    const int parallelism = pool.getWorkerCount() + 1;
+
+    // 工作窃取模式：行带数量至少为并行度的数倍，较快的大核处理完自己的行带后会窃取其余行带，
+    // 调优后行带按缓存大小进一步缩小；自适应模式：grain作为最小分块，各线程按实测吞吐量动态领取行数
+    int grain = MIN_BAND_ROWS;
+    if (mode == ThreadPool::SchedulingMode::WORK_STEALING) {
+        grain = std::max(MIN_BAND_ROWS, input.height / (parallelism * BANDS_PER_THREAD));
+        const TileTuning tuning = TileAutotuner::getInstance().getTuning();
+        if (tuning.tuned) {
+            grain = std::clamp(TileAutotuner::bandRows(tuning.bandBytes, input.width),
+                               MIN_BAND_ROWS, grain);
+        }
+    }
 
-    std::vector<std::thread> workers;
-    std::vector<std::atomic<float>> threadProgress(threadCount);
+    LOGD("开始多线程处理，并行度: %d, 调度模式: %s, 分块行数: %d", parallelism,
+         mode == ThreadPool::SchedulingMode::ADAPTIVE ? "自适应" : "工作窃取", grain);
 
     const uint8_t *inputPixels = static_cast<const uint8_t *>(input.pixels);
     uint8_t *outputPixels = static_cast<uint8_t *>(output.pixels);
 
-    // 启动工作线程
-    for (int i = 0; i < threadCount; ++i) {
-        const int startRow = i * rowsPerThread;
-        const int endRow = (i == threadCount - 1) ? input.height : (i + 1) * rowsPerThread;
-
-        threadProgress[i] = 0.0f;
-
-        workers.emplace_back(
-                workerFunction,
-                inputPixels,
-                outputPixels,
-                startRow,
-                endRow,
-                input.width,
-                input.stride,
-                std::cref(primaryLut),
-                std::cref(secondaryLut),
-                std::cref(params),
-                std::ref(threadProgress[i])
-        );
-    }
-
-    // 监控进度
+    // 进度由分块完成事件驱动，回调始终在调用线程上执行
+    ThreadPool::ProgressCallback progressCallback = nullptr;
     if (callback) {
-        while (true) {
-            float totalProgress = 0.0f;
-            bool allCompleted = true;
-
-            for (int i = 0; i < threadCount; ++i) {
-                float progress = threadProgress[i].load();
-                totalProgress += progress;
-                if (progress < 1.0f) {
-                    allCompleted = false;
-                }
-            }
-
-            callback(totalProgress / threadCount);
-
-            if (allCompleted) {
-                break;
-            }
-
-            std::this_thread::sleep_for(std::chrono::milliseconds(50));
-        }
-    }
-
-    // 等待所有线程完成
-    for (auto &worker: workers) {
-        if (worker.joinable()) {
-            worker.join();
-        }
+        progressCallback = [callback](int completed, int total) {
+            callback(static_cast<float>(completed) / total);
+        };
     }
 
-    // 应用抖动处理
-    if (params.ditherType > 0) {
-        applyDithering(outputPixels, output.width, output.height, output.stride, params);
-    }
+    // 随机抖动在各行带内完成，不再对整图做第二遍；整个任务只取一次种子
+    const uint64_t ditherSeed = params.ditherType == 2 ? newDitherSeed() : 0;
+    pool.run(mode, 0, input.height, grain, [&](int startRow, int endRow) {
+        processBand(inputPixels, outputPixels, startRow, endRow, input.width, input.stride,
+                    output.stride, primaryLut, secondaryLut, params, ditherSeed);
+    }, progressCallback);
 
     LOGD("多线程处理完成");
     return ProcessResult::SUCCESS;
 }
 
+ThreadPool::SchedulingMode ImageProcessor::selectSchedulingMode(const ProcessingParams &params) {
+    switch (params.schedulerMode) {
+        case 1:
+            return ThreadPool::SchedulingMode::WORK_STEALING;
+        case 2:
+            return ThreadPool::SchedulingMode::ADAPTIVE;
+        default:
+            // 大小核混合时固定大小的行带在小核上耗时更长，改为按实测吞吐量分配
+            return CpuTopology::getSystemTopology().isHeterogeneous()
+                   ? ThreadPool::SchedulingMode::ADAPTIVE
+                   : ThreadPool::SchedulingMode::WORK_STEALING;
+    }
+}
+
 void ImageProcessor::processPixel(
         const uint8_t *inputPixel,
         uint8_t *outputPixel,
         const LutData &primaryLut,
         const LutData &secondaryLut,
-        const ProcessingParams &params
+        const ProcessingParams &params,
+        float quantizeOffset
 ) {
     // ARGB_8888格式：A=3, R=2, G=1, B=0
     const uint8_t alpha = inputPixel[3];
@@ -172,37 +176,49 @@ void ImageProcessor::processPixel(
     float g = green / 255.0f;
     float b = blue / 255.0f;
 
-    // 应用主LUT
     float lutR, lutG, lutB;
-    LutProcessor::applyLut(r, g, b, lutR, lutG, lutB, primaryLut);
+    applyLutChain(r, g, b, lutR, lutG, lutB, primaryLut, secondaryLut, params);
+
+    // 限制范围并转换回8位
+    lutR = std::clamp(lutR, 0.0f, 1.0f);
+    lutG = std::clamp(lutG, 0.0f, 1.0f);
+    lutB = std::clamp(lutB, 0.0f, 1.0f);
+
+    outputPixel[3] = alpha; // 保持Alpha通道
+    outputPixel[2] = static_cast<uint8_t>(lutR * 255.0f + quantizeOffset);
+    outputPixel[1] = static_cast<uint8_t>(lutG * 255.0f + quantizeOffset);
+    outputPixel[0] = static_cast<uint8_t>(lutB * 255.0f + quantizeOffset);
+}
+
+void ImageProcessor::applyLutChain(
+        float r, float g, float b,
+        float &outR, float &outG, float &outB,
+        const LutData &primaryLut,
+        const LutData &secondaryLut,
+        const ProcessingParams &params
+) {
+    // 应用主LUT
+    LutProcessor::applyLut(r, g, b, outR, outG, outB, primaryLut,
+                           params.interpolationMode);
 
     // 应用第二LUT（如果存在）
     if (secondaryLut.isLoaded && params.lut2Strength > 0.0f) {
         float lut2R, lut2G, lut2B;
-        LutProcessor::applyLut(lutR, lutG, lutB, lut2R, lut2G, lut2B, secondaryLut);
+        LutProcessor::applyLut(outR, outG, outB, lut2R, lut2G, lut2B, secondaryLut,
+                               params.interpolationMode);
 
         // 混合两个LUT的结果
-        lutR = lutR * (1.0f - params.lut2Strength) + lut2R * params.lut2Strength;
-        lutG = lutG * (1.0f - params.lut2Strength) + lut2G * params.lut2Strength;
-        lutB = lutB * (1.0f - params.lut2Strength) + lut2B * params.lut2Strength;
+        outR = outR * (1.0f - params.lut2Strength) + lut2R * params.lut2Strength;
+        outG = outG * (1.0f - params.lut2Strength) + lut2G * params.lut2Strength;
+        outB = outB * (1.0f - params.lut2Strength) + lut2B * params.lut2Strength;
     }
 
     // 应用强度混合
     if (params.strength < 1.0f) {
-        lutR = r * (1.0f - params.strength) + lutR * params.strength;
-        lutG = g * (1.0f - params.strength) + lutG * params.strength;
-        lutB = b * (1.0f - params.strength) + lutB * params.strength;
+        outR = r * (1.0f - params.strength) + outR * params.strength;
+        outG = g * (1.0f - params.strength) + outG * params.strength;
+        outB = b * (1.0f - params.strength) + outB * params.strength;
     }
-
-    // 限制范围并转换回8位
-    lutR = std::clamp(lutR, 0.0f, 1.0f);
-    lutG = std::clamp(lutG, 0.0f, 1.0f);
-    lutB = std::clamp(lutB, 0.0f, 1.0f);
-
-    outputPixel[3] = alpha; // 保持Alpha通道
-    outputPixel[2] = static_cast<uint8_t>(lutR * 255.0f + 0.5f);
-    outputPixel[1] = static_cast<uint8_t>(lutG * 255.0f + 0.5f);
-    outputPixel[0] = static_cast<uint8_t>(lutB * 255.0f + 0.5f);
 }
 
 void ImageProcessor::processPixelsBatch(
@@ -211,31 +227,18 @@ void ImageProcessor::processPixelsBatch(
         int pixelCount,
         const LutData &primaryLut,
         const LutData &secondaryLut,
-        const ProcessingParams &params
+        const ProcessingParams &params,
+        const OrderedDitherRow &dither
 ) {
-#ifdef USE_NEON_SIMD
-    // 使用NEON SIMD优化
-    if (SIMDUtils::isNeonAvailable()) {
-        SIMDUtils::processPixelsNeon(
-                inputPixels, outputPixels, pixelCount,
-                primaryLut, secondaryLut, params
-        );
+    // 调用方提供了烘焙数据时走整数查表路径（NativeLutProcessor只在标量回退时烘焙）
+    if (params.bakedLut != nullptr && params.bakedLut->isBaked) {
+        LutBaker::processPixels(inputPixels, outputPixels, pixelCount, *params.bakedLut, dither);
         return;
     }
-#endif
 
-    // 回退到标准处理
-    const int bytesPerPixel = 4;
-    for (int i = 0; i < pixelCount; ++i) {
-        const int offset = i * bytesPerPixel;
-        processPixel(
-                &inputPixels[offset],
-                &outputPixels[offset],
-                primaryLut,
-                secondaryLut,
-                params
-        );
-    }
+    // 按运行时SIMD级别分派（NEON/AVX2/SSE4.1，无可用指令集时为标量实现）
+    SIMDUtils::processPixels(inputPixels, outputPixels, pixelCount,
+                             primaryLut, secondaryLut, params, dither);
 }
 
 void ImageProcessor::applyDithering(
@@ -250,45 +253,54 @@ void ImageProcessor::applyDithering(
             applyFloydSteinbergDithering(pixels, width, height, stride);
             break;
         case 2: // Random
-            applyRandomDithering(pixels, width, height, stride);
+            applyRandomDithering(pixels, width, height, stride, newDitherSeed(), 0);
             break;
         default:
-            // 无抖动
+            // 无抖动；Bayer/蓝噪声有序抖动已在量化时完成
             break;
     }
 }
 
-void ImageProcessor::workerFunction(
+void ImageProcessor::processBand(
         const uint8_t *inputPixels,
         uint8_t *outputPixels,
         int startRow,
         int endRow,
         int width,
-        int stride,
+        int inputStride,
+        int outputStride,
         const LutData &primaryLut,
         const LutData &secondaryLut,
         const ProcessingParams &params,
-        std::atomic<float> &progress
+        uint64_t ditherSeed
 ) {
-    const int bytesPerPixel = 4;
-    const int totalRows = endRow - startRow;
+    processRows(inputPixels, outputPixels, startRow, endRow, width, inputStride, outputStride,
+                primaryLut, secondaryLut, params);
+    if (params.ditherType == 2) {
+        applyRandomDithering(outputPixels + static_cast<size_t>(startRow) * outputStride, width,
+                             endRow - startRow, outputStride, ditherSeed, startRow);
+    }
+}
 
+void ImageProcessor::processRows(
+        const uint8_t *inputPixels,
+        uint8_t *outputPixels,
+        int startRow,
+        int endRow,
+        int width,
+        int inputStride,
+        int outputStride,
+        const LutData &primaryLut,
+        const LutData &secondaryLut,
+        const ProcessingParams &params
+) {
     for (int y = startRow; y < endRow; ++y) {
-        for (int x = 0; x < width; ++x) {
-            const int pixelIndex = y * stride + x * bytesPerPixel;
-
-            processPixel(
-                    &inputPixels[pixelIndex],
-                    &outputPixels[pixelIndex],
-                    primaryLut,
-                    secondaryLut,
-                    params
-            );
-        }
-
-        // 更新进度
-        float currentProgress = static_cast<float>(y - startRow + 1) / totalRows;
-        progress.store(currentProgress);
+        // 整行交给批处理：烘焙LUT优先，否则按运行时SIMD级别分派，有序抖动在量化时完成
+        processPixelsBatch(&inputPixels[static_cast<size_t>(y) * inputStride],
+                           &outputPixels[static_cast<size_t>(y) * outputStride], width,
+                           primaryLut, secondaryLut, params,
+                           OrderedDitherRow(params.ditherType, params.ditherOriginX,
+                                            params.ditherOriginY + y));
     }
 }
 
@@ -297,64 +309,179 @@ void ImageProcessor::applyFloydSteinbergDithering(
         int width,
         int height,
         int stride
+) {
+    for (int y = 0; y < height - 1; ++y) {
+        ditherFloydSteinbergSpan(pixels, y, 1, width - 1, width, height, stride);
+    }
+}
+
+void ImageProcessor::ditherFloydSteinbergSpan(
+        uint8_t *pixels,
+        int y,
+        int xBegin,
+        int xEnd,
+        int width,
+        int height,
+        int stride
 ) {
     const int bytesPerPixel = 4;
 
-    for (int y = 0; y < height - 1; ++y) {
-        for (int x = 1; x < width - 1; ++x) {
-            const int currentIndex = y * stride + x * bytesPerPixel;
+    for (int x = xBegin; x < xEnd; ++x) {
+        const int currentIndex = y * stride + x * bytesPerPixel;
 
-            for (int channel = 0; channel < 3; ++channel) { // 跳过Alpha通道
-                const int oldPixel = pixels[currentIndex + channel];
-                const int newPixel = (oldPixel > 127) ? 255 : 0;
-                const int error = oldPixel - newPixel;
+        for (int channel = 0; channel < 3; ++channel) { // 跳过Alpha通道
+            const int oldPixel = pixels[currentIndex + channel];
+            const int newPixel = (oldPixel > 127) ? 255 : 0;
+            const int error = oldPixel - newPixel;
 
-                pixels[currentIndex + channel] = newPixel;
+            pixels[currentIndex + channel] = newPixel;
 
-                // 分布误差
-                if (x + 1 < width) {
-                    const int rightIndex = currentIndex + bytesPerPixel + channel;
-                    pixels[rightIndex] = std::clamp(
-                            pixels[rightIndex] + error * 7 / 16, 0, 255
+            // 分布误差
+            if (x + 1 < width) {
+                const int rightIndex = currentIndex + bytesPerPixel + channel;
+                pixels[rightIndex] = std::clamp(
+                        pixels[rightIndex] + error * 7 / 16, 0, 255
+                );
+            }
+
+            if (y + 1 < height) {
+                if (x > 0) {
+                    const int bottomLeftIndex =
+                            (y + 1) * stride + (x - 1) * bytesPerPixel + channel;
+                    pixels[bottomLeftIndex] = std::clamp(
+                            pixels[bottomLeftIndex] + error * 3 / 16, 0, 255
                     );
                 }
 
-                if (y + 1 < height) {
-                    if (x > 0) {
-                        const int bottomLeftIndex =
-                                (y + 1) * stride + (x - 1) * bytesPerPixel + channel;
-                        pixels[bottomLeftIndex] = std::clamp(
-                                pixels[bottomLeftIndex] + error * 3 / 16, 0, 255
-                        );
-                    }
+                const int bottomIndex = (y + 1) * stride + x * bytesPerPixel + channel;
+                pixels[bottomIndex] = std::clamp(
+                        pixels[bottomIndex] + error * 5 / 16, 0, 255
+                );
 
-                    const int bottomIndex = (y + 1) * stride + x * bytesPerPixel + channel;
-                    pixels[bottomIndex] = std::clamp(
-                            pixels[bottomIndex] + error * 5 / 16, 0, 255
+                if (x + 1 < width) {
+                    const int bottomRightIndex =
+                            (y + 1) * stride + (x + 1) * bytesPerPixel + channel;
+                    pixels[bottomRightIndex] = std::clamp(
+                            pixels[bottomRightIndex] + error * 1 / 16, 0, 255
                     );
+                }
+            }
+        }
+    }
+}
+
+void ImageProcessor::processWavefrontFloydSteinberg(
+        const ImageInfo &input,
+        ImageInfo &output,
+        const LutData &primaryLut,
+        const LutData &secondaryLut,
+        const ProcessingParams &params,
+        NativeProgressCallback callback,
+        JobArena *arena
+) {
+    const int width = input.width;
+    const int height = input.height;
+    if (height <= 0) {
+        return;
+    }
+
+    const uint8_t *inputPixels = static_cast<const uint8_t *>(input.pixels);
+    uint8_t *outputPixels = static_cast<uint8_t *>(output.pixels);
+
+    // 行y的像素(y, x)要等上一行处理完x+2列后才能处理：串行顺序中最后一次写入(y, x+1)的
+    // 是(y-1, x+2)的左下误差，满足该条件即可保证每个字节的累加与截断顺序和串行版本完全一致。
+    // rowProgress[y]表示行y已完成抖动的前缀列数（整行完成后为width）
+    // 进度表随任务内存一起释放；没有任务内存或切分失败时使用堆内存
+    std::unique_ptr<std::atomic<int>[]> ownedProgress;
+    std::atomic<int> *rowProgress =
+            arena ? arena->allocateArray<std::atomic<int>>(height) : nullptr;
+    if (!rowProgress) {
+        ownedProgress.reset(new std::atomic<int>[height]);
+        rowProgress = ownedProgress.get();
+    }
+    for (int y = 0; y < height; ++y) {
+        new(&rowProgress[y]) std::atomic<int>(0);
+    }
 
-                    if (x + 1 < width) {
-                        const int bottomRightIndex =
-                                (y + 1) * stride + (x + 1) * bytesPerPixel + channel;
-                        pixels[bottomRightIndex] = std::clamp(
-                                pixels[bottomRightIndex] + error * 1 / 16, 0, 255
-                        );
+    // 领取行y的线程先完成行y+1的LUT映射再抖动行y，因为行y的误差会写入行y+1；
+    // 行y本身的LUT由领取行y-1的线程在其抖动开始前完成，rowProgress的release/acquire保证可见性。
+    // 行按递增顺序领取且只依赖更小的行，因此不会死锁
+    const int claimCount = height > 1 ? height - 1 : 1;
+    std::atomic<int> nextRow{0};
+    std::atomic<int> completedRows{0};
+    const std::thread::id callerThread = std::this_thread::get_id();
+    int reportedRows = 0; // 只在调用线程上读写
+
+    auto runner = [&](int, int) {
+        while (true) {
+            const int y = nextRow.fetch_add(1);
+            if (y >= claimCount) {
+                break;
+            }
+
+            if (y == 0) {
+                processRows(inputPixels, outputPixels, 0, 1, width, input.stride,
+                            output.stride, primaryLut, secondaryLut, params);
+            }
+            if (y + 1 < height) {
+                processRows(inputPixels, outputPixels, y + 1, y + 2, width, input.stride,
+                            output.stride, primaryLut, secondaryLut, params);
+            }
+
+            if (y < height - 1) {
+                int available = y == 0 ? width : 0;
+                for (int x = 1; x < width - 1; x += WAVEFRONT_SPAN_COLUMNS) {
+                    const int spanEnd = std::min(x + WAVEFRONT_SPAN_COLUMNS, width - 1);
+                    const int required = std::min(spanEnd + 2, width);
+                    while (available < required) {
+                        available = rowProgress[y - 1].load(std::memory_order_acquire);
+                        if (available < required) {
+                            std::this_thread::yield();
+                        }
                     }
+
+                    ditherFloydSteinbergSpan(outputPixels, y, x, spanEnd, width, height,
+                                             output.stride);
+                    rowProgress[y].store(spanEnd, std::memory_order_release);
                 }
             }
+            rowProgress[y].store(width, std::memory_order_release);
+
+            const int completed = completedRows.fetch_add(1) + 1;
+            if (callback && std::this_thread::get_id() == callerThread &&
+                completed - reportedRows >= 64) {
+                reportedRows = completed;
+                callback(static_cast<float>(completed) / claimCount);
+            }
         }
+    };
+
+    // 每个参与线程运行一个领取循环
+    ThreadPool &pool = ThreadPool::getInstance();
+    const int participants = pool.getWorkerCount() + 1;
+    pool.parallelFor(0, participants, 1, runner);
+
+    if (callback) {
+        callback(1.0f);
     }
 }
 
+uint64_t ImageProcessor::newDitherSeed() {
+    std::random_device rd;
+    return (static_cast<uint64_t>(rd()) << 32) ^ rd();
+}
+
 void ImageProcessor::applyRandomDithering(
         uint8_t *pixels,
         int width,
         int height,
-        int stride
+        int stride,
+        uint64_t seed,
+        int firstRow
 ) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<float> dis(-0.5f, 0.5f);
+    // 每个行带由任务种子与起始行派生独立的SplitMix64序列，不再逐行带创建random_device与mt19937，
+    // 同一任务内结果也与行带由哪个线程处理无关
+    uint64_t state = mixSeed(seed ^ mixSeed(static_cast<uint64_t>(firstRow)));
 
     const int bytesPerPixel = 4;
 
@@ -362,29 +489,15 @@ void ImageProcessor::applyRandomDithering(
         for (int x = 0; x < width; ++x) {
             const int pixelIndex = y * stride + x * bytesPerPixel;
 
+            // 一次取64位，三个通道各用16位，噪声范围与原先的(-0.5, 0.5) * 32一致
+            const uint64_t bits = mixSeed(state);
+            state += 0x9E3779B97F4A7C15ULL;
             for (int channel = 0; channel < 3; ++channel) { // 跳过Alpha通道
-                float noise = dis(gen) * 32.0f; // 调整噪声强度
+                const float noise = static_cast<float>((bits >> (16 * channel)) & 0xFFFF) *
+                                    (32.0f / 65536.0f) - 16.0f;
                 int newValue = static_cast<int>(pixels[pixelIndex + channel] + noise);
                 pixels[pixelIndex + channel] = std::clamp(newValue, 0, 255);
             }
         }
     }
 }
-
-int ImageProcessor::calculateOptimalThreadCount(int imageWidth, int imageHeight) {
-    const int totalPixels = imageWidth * imageHeight;
-    const int coreCount = std::thread::hardware_concurrency();
-
-    // 根据图片大小和CPU核心数计算最优线程数
-    int optimalThreads;
-
-    if (totalPixels < 1000000) { // 小于100万像素
-        optimalThreads = std::min(2, coreCount);
-    } else if (totalPixels < 4000000) { // 小于400万像素
-        optimalThreads = std::min(4, coreCount);
-    } else { // 大图片
-        optimalThreads = std::min(8, coreCount);
-    }
-
-    return std::max(1, optimalThreads);
-}
\ No newline at end of file
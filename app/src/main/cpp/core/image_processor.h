@@ -2,6 +2,9 @@
 #define IMAGE_PROCESSOR_H
 
 #include "../include/native_lut_processor.h"
+#include "../utils/thread_pool.h"
+#include "../utils/dither_matrix.h"
+#include "../utils/job_arena.h"
 #include <thread>
 #include <vector>
 #include <functional>
@@ -31,6 +34,7 @@ public:
 
     /**
      * 多线程处理图片
+     * @param arena 本次任务的内存，非空时临时缓冲区从中分配，为空时使用堆内存
      */
     static ProcessResult processMultiThreaded(
             const ImageInfo &input,
@@ -38,22 +42,37 @@ public:
             const LutData &primaryLut,
             const LutData &secondaryLut,
             const ProcessingParams &params,
-            NativeProgressCallback callback = nullptr
+            NativeProgressCallback callback = nullptr,
+            JobArena *arena = nullptr
     );
 
     /**
      * 处理单个像素
+     * @param quantizeOffset 量化偏移（value * 255 + offset 后截断），有序抖动时为该像素的阈值
      */
     static void processPixel(
             const uint8_t *inputPixel,
             uint8_t *outputPixel,
             const LutData &primaryLut,
             const LutData &secondaryLut,
+            const ProcessingParams &params,
+            float quantizeOffset = 0.5f
+    );
+
+    /**
+     * 对归一化RGB值依次应用主LUT、第二LUT和强度混合（未限制范围）
+     */
+    static void applyLutChain(
+            float r, float g, float b,
+            float &outR, float &outG, float &outB,
+            const LutData &primaryLut,
+            const LutData &secondaryLut,
             const ProcessingParams &params
     );
 
     /**
      * 批量处理像素（SIMD优化）
+     * @param dither 这些像素所在行的有序抖动阈值（不抖动时为空）
      */
     static void processPixelsBatch(
             const uint8_t *inputPixels,
@@ -61,7 +80,8 @@ public:
             int pixelCount,
             const LutData &primaryLut,
             const LutData &secondaryLut,
-            const ProcessingParams &params
+            const ProcessingParams &params,
+            const OrderedDitherRow &dither = OrderedDitherRow()
     );
 
     /**
@@ -75,30 +95,50 @@ public:
             const ProcessingParams &params
     );
 
+    /**
+     * 处理一个行带：LUT查表后立即对同一行带做随机抖动，
+     * 行带工作集在缓存内时第二遍不必再从内存读取
+     * @param ditherSeed 随机抖动的任务种子，各行带按起始行派生各自的随机序列
+     */
+    static void processBand(
+            const uint8_t *inputPixels,
+            uint8_t *outputPixels,
+            int startRow,
+            int endRow,
+            int width,
+            int inputStride,
+            int outputStride,
+            const LutData &primaryLut,
+            const LutData &secondaryLut,
+            const ProcessingParams &params,
+            uint64_t ditherSeed = 0
+    );
+
+    /**
+     * 为一次处理任务生成随机抖动种子（每个任务只访问一次random_device）
+     */
+    static uint64_t newDitherSeed();
+
 private:
     /**
-     * 工作线程结构
+     * 根据参数与CPU拓扑选择多线程调度模式
      */
-    struct WorkerThread {
-        std::thread thread;
-        std::atomic<bool> isRunning{false};
-        std::atomic<float> progress{0.0f};
-    };
+    static ThreadPool::SchedulingMode selectSchedulingMode(const ProcessingParams &params);
 
     /**
-     * 线程工作函数
+     * 处理一段连续的行（线程池中的一个行带）
      */
-    static void workerFunction(
+    static void processRows(
             const uint8_t *inputPixels,
             uint8_t *outputPixels,
             int startRow,
             int endRow,
             int width,
-            int stride,
+            int inputStride,
+            int outputStride,
             const LutData &primaryLut,
             const LutData &secondaryLut,
-            const ProcessingParams &params,
-            std::atomic<float> &progress
+            const ProcessingParams &params
     );
 
     /**
@@ -112,19 +152,53 @@ private:
     );
 
     /**
-     * 随机抖动
+     * 对第y行的[xBegin, xEnd)列做Floyd-Steinberg误差扩散，串行与波前版本共用
      */
-    static void applyRandomDithering(
+    static void ditherFloydSteinbergSpan(
             uint8_t *pixels,
+            int y,
+            int xBegin,
+            int xEnd,
             int width,
             int height,
             int stride
     );
 
     /**
-     * 计算最优线程数
+     * 融合LUT与Floyd-Steinberg抖动的波前并行处理
+     * 各线程按行领取：映射下一行后紧接着扩散本行误差，行y只需落后行y-1若干列即可开始，
+     * 输出与先整体映射再串行抖动的结果逐字节一致
      */
-    static int calculateOptimalThreadCount(int imageWidth, int imageHeight);
+    static void processWavefrontFloydSteinberg(
+            const ImageInfo &input,
+            ImageInfo &output,
+            const LutData &primaryLut,
+            const LutData &secondaryLut,
+            const ProcessingParams &params,
+            NativeProgressCallback callback,
+            JobArena *arena
+    );
+
+    /**
+     * 随机抖动
+     * @param seed 任务种子
+     * @param firstRow pixels首行在整图中的行号，用于派生该行带的随机序列
+     */
+    static void applyRandomDithering(
+            uint8_t *pixels,
+            int width,
+            int height,
+            int stride,
+            uint64_t seed,
+            int firstRow
+    );
+
+    // 每个并行线程平均分到的行带数量，用于工作窃取时的负载均衡
+    static constexpr int BANDS_PER_THREAD = 4;
+    // 行带的最小行数，避免行带过小时调度开销超过处理开销
+    static constexpr int MIN_BAND_ROWS = 8;
+    // 波前抖动每发布一次行进度所处理的列数
+    static constexpr int WAVEFRONT_SPAN_COLUMNS = 64;
 };
 
 #endif // IMAGE_PROCESSOR_H
\ No newline at end of file
@@ -0,0 +1,272 @@
+#include "lut_baker.h"
+#include "image_processor.h"
+#include "lut_processor.h"
+#include "../utils/simd_utils.h"
+#include <algorithm>
+#include <cmath>
+
+bool LutBaker::bake(
+        const LutData &primaryLut,
+        const LutData &secondaryLut,
+        const ProcessingParams &params,
+        BakedLutData &bakedLut,
+        int gridSize
+) {
+    if (!LutProcessor::isValidLutData(primaryLut)) {
+        LOGE("烘焙失败：主LUT未加载");
+        bakedLut.clear();
+        return false;
+    }
+
+    const int size = gridSize > 1 ? std::min(gridSize, MAX_GRID_SIZE)
+                                  : selectGridSize(primaryLut, secondaryLut, params);
+    const int totalEntries = size * size * size;
+
+    try {
+        bakedLut.data.resize(totalEntries * 3);
+    } catch (const std::exception &e) {
+        LOGE("烘焙LUT内存分配失败: %s", e.what());
+        bakedLut.clear();
+        return false;
+    }
+
+    // 在网格节点上求值完整的处理链，结果限制到[0,1]后存为定点值（1.0 = 255*256）
+    const float maxIndex = static_cast<float>(size - 1);
+    const float fixedScale = 255.0f * 256.0f;
+    for (int r = 0; r < size; ++r) {
+        for (int g = 0; g < size; ++g) {
+            for (int b = 0; b < size; ++b) {
+                float outR, outG, outB;
+                ImageProcessor::applyLutChain(
+                        r / maxIndex, g / maxIndex, b / maxIndex,
+                        outR, outG, outB,
+                        primaryLut, secondaryLut, params
+                );
+
+                const int index = (r * size * size + g * size + b) * 3;
+                bakedLut.data[index + 0] = static_cast<uint16_t>(
+                        std::clamp(outR, 0.0f, 1.0f) * fixedScale + 0.5f);
+                bakedLut.data[index + 1] = static_cast<uint16_t>(
+                        std::clamp(outG, 0.0f, 1.0f) * fixedScale + 0.5f);
+                bakedLut.data[index + 2] = static_cast<uint16_t>(
+                        std::clamp(outB, 0.0f, 1.0f) * fixedScale + 0.5f);
+            }
+        }
+    }
+
+    // 8位输入值 -> 网格基准索引与8位小数部分
+    for (int v = 0; v < 256; ++v) {
+        const int position = (v * (size - 1) * 256 + 127) / 255;
+        const int base = std::min(position >> 8, size - 2);
+        bakedLut.offsetR[v] = static_cast<uint32_t>(base * size * size * 3);
+        bakedLut.offsetG[v] = static_cast<uint32_t>(base * size * 3);
+        bakedLut.offsetB[v] = static_cast<uint32_t>(base * 3);
+        bakedLut.fraction[v] = static_cast<uint16_t>(position - base * 256);
+    }
+
+    bakedLut.size = size;
+    bakedLut.strength = params.strength;
+    bakedLut.lut2Strength = params.lut2Strength;
+    bakedLut.interpolationMode = params.interpolationMode;
+    bakedLut.hasSecondaryLut = secondaryLut.isLoaded;
+    bakedLut.isBaked = true;
+
+    LOGD("LUT烘焙完成，网格尺寸: %d, 强度: %.2f/%.2f", size, params.strength,
+         params.lut2Strength);
+    return true;
+}
+
+bool LutBaker::isBakeCurrent(
+        const BakedLutData &bakedLut,
+        const LutData &secondaryLut,
+        const ProcessingParams &params
+) {
+    return bakedLut.isBaked &&
+           bakedLut.strength == params.strength &&
+           bakedLut.lut2Strength == params.lut2Strength &&
+           bakedLut.interpolationMode == params.interpolationMode &&
+           bakedLut.hasSecondaryLut == secondaryLut.isLoaded;
+}
+
+bool LutBaker::isPreferred() {
+    return SIMDUtils::getSimdLevel() == SimdLevel::SCALAR;
+}
+
+void LutBaker::processPixels(
+        const uint8_t *inputPixels,
+        uint8_t *outputPixels,
+        int pixelCount,
+        const BakedLutData &bakedLut,
+        const OrderedDitherRow &dither
+) {
+    // 插值方式在批次外选定，逐像素循环内没有分支
+    if (bakedLut.interpolationMode == 1) {
+        processPixelsWith<processPixelTetrahedral>(inputPixels, outputPixels, pixelCount,
+                                                   bakedLut, dither);
+    } else {
+        processPixelsWith<processPixelTrilinear>(inputPixels, outputPixels, pixelCount,
+                                                 bakedLut, dither);
+    }
+}
+
+template<LutBaker::PixelKernel kernel>
+void LutBaker::processPixelsWith(
+        const uint8_t *inputPixels,
+        uint8_t *outputPixels,
+        int pixelCount,
+        const BakedLutData &bakedLut,
+        const OrderedDitherRow &dither
+) {
+    const int bytesPerPixel = 4;
+    if (!dither.enabled()) {
+        for (int i = 0; i < pixelCount; ++i) {
+            const int offset = i * bytesPerPixel;
+            kernel(&inputPixels[offset], &outputPixels[offset], bakedLut, 32768);
+        }
+        return;
+    }
+
+    for (int i = 0; i < pixelCount; ++i) {
+        const int offset = i * bytesPerPixel;
+        const uint32_t rounding = (static_cast<uint32_t>(*dither.at(i)) << 8) + 128;
+        kernel(&inputPixels[offset], &outputPixels[offset], bakedLut, rounding);
+    }
+}
+
+void LutBaker::processPixel(
+        const uint8_t *inputPixel,
+        uint8_t *outputPixel,
+        const BakedLutData &bakedLut,
+        uint32_t rounding
+) {
+    if (bakedLut.interpolationMode == 1) {
+        processPixelTetrahedral(inputPixel, outputPixel, bakedLut, rounding);
+    } else {
+        processPixelTrilinear(inputPixel, outputPixel, bakedLut, rounding);
+    }
+}
+
+void LutBaker::processPixelTetrahedral(
+        const uint8_t *inputPixel,
+        uint8_t *outputPixel,
+        const BakedLutData &bakedLut,
+        uint32_t rounding
+) {
+    // ARGB_8888格式：A=3, R=2, G=1, B=0
+    const uint8_t red = inputPixel[2];
+    const uint8_t green = inputPixel[1];
+    const uint8_t blue = inputPixel[0];
+
+    const uint32_t fr = bakedLut.fraction[red];
+    const uint32_t fg = bakedLut.fraction[green];
+    const uint32_t fb = bakedLut.fraction[blue];
+
+    // 各轴在网格数组中的步长（索引 = r*size*size + g*size + b，每项3个分量）
+    const uint32_t strideR = static_cast<uint32_t>(bakedLut.size * bakedLut.size * 3);
+    const uint32_t strideG = static_cast<uint32_t>(bakedLut.size * 3);
+    const uint32_t strideB = 3;
+
+    // 按小数部分的大小顺序选择四面体：w1 >= w2 >= w3
+    uint32_t w1, w2, w3, offset1, offset2;
+    if (fr >= fg) {
+        if (fg >= fb) {
+            w1 = fr; w2 = fg; w3 = fb;
+            offset1 = strideR; offset2 = strideG;
+        } else if (fr >= fb) {
+            w1 = fr; w2 = fb; w3 = fg;
+            offset1 = strideR; offset2 = strideB;
+        } else {
+            w1 = fb; w2 = fr; w3 = fg;
+            offset1 = strideB; offset2 = strideR;
+        }
+    } else {
+        if (fb >= fg) {
+            w1 = fb; w2 = fg; w3 = fr;
+            offset1 = strideB; offset2 = strideG;
+        } else if (fb >= fr) {
+            w1 = fg; w2 = fb; w3 = fr;
+            offset1 = strideG; offset2 = strideB;
+        } else {
+            w1 = fg; w2 = fr; w3 = fb;
+            offset1 = strideG; offset2 = strideR;
+        }
+    }
+
+    const uint16_t *c0 = bakedLut.data.data() +
+                         bakedLut.offsetR[red] + bakedLut.offsetG[green] + bakedLut.offsetB[blue];
+    const uint16_t *c1 = c0 + offset1;
+    const uint16_t *c2 = c1 + offset2;
+    const uint16_t *c3 = c0 + strideR + strideG + strideB;
+
+    // 权重之和为256，网格值上限为255*256，累加结果加上小于2^16的量化偏移后不超过2^24
+    const uint32_t k0 = 256 - w1;
+    const uint32_t k1 = w1 - w2;
+    const uint32_t k2 = w2 - w3;
+    const uint32_t k3 = w3;
+
+    outputPixel[3] = inputPixel[3]; // 保持Alpha通道
+    outputPixel[2] = static_cast<uint8_t>(
+            (k0 * c0[0] + k1 * c1[0] + k2 * c2[0] + k3 * c3[0] + rounding) >> 16);
+    outputPixel[1] = static_cast<uint8_t>(
+            (k0 * c0[1] + k1 * c1[1] + k2 * c2[1] + k3 * c3[1] + rounding) >> 16);
+    outputPixel[0] = static_cast<uint8_t>(
+            (k0 * c0[2] + k1 * c1[2] + k2 * c2[2] + k3 * c3[2] + rounding) >> 16);
+}
+
+void LutBaker::processPixelTrilinear(
+        const uint8_t *inputPixel,
+        uint8_t *outputPixel,
+        const BakedLutData &bakedLut,
+        uint32_t rounding
+) {
+    // ARGB_8888格式：A=3, R=2, G=1, B=0
+    const uint8_t red = inputPixel[2];
+    const uint8_t green = inputPixel[1];
+    const uint8_t blue = inputPixel[0];
+
+    const uint32_t fr = bakedLut.fraction[red];
+    const uint32_t fg = bakedLut.fraction[green];
+    const uint32_t fb = bakedLut.fraction[blue];
+
+    const uint32_t strideR = static_cast<uint32_t>(bakedLut.size * bakedLut.size * 3);
+    const uint32_t strideG = static_cast<uint32_t>(bakedLut.size * 3);
+    const uint32_t strideB = 3;
+
+    const uint16_t *c000 = bakedLut.data.data() +
+                           bakedLut.offsetR[red] + bakedLut.offsetG[green] + bakedLut.offsetB[blue];
+    const uint16_t *c010 = c000 + strideG;
+    const uint16_t *c100 = c000 + strideR;
+    const uint16_t *c110 = c100 + strideG;
+
+    outputPixel[3] = inputPixel[3]; // 保持Alpha通道
+    for (int channel = 0; channel < 3; ++channel) {
+        // 与浮点三线性插值相同的顺序：先沿B轴，再沿G轴，最后沿R轴
+        // 每级乘以不超过256的权重：2^16 -> 2^24 -> 2^32，最后一级用64位累加
+        const uint32_t b00 = (256 - fb) * c000[channel] + fb * c000[channel + strideB];
+        const uint32_t b01 = (256 - fb) * c010[channel] + fb * c010[channel + strideB];
+        const uint32_t b10 = (256 - fb) * c100[channel] + fb * c100[channel + strideB];
+        const uint32_t b11 = (256 - fb) * c110[channel] + fb * c110[channel + strideB];
+
+        const uint32_t g0 = (256 - fg) * b00 + fg * b01;
+        const uint32_t g1 = (256 - fg) * b10 + fg * b11;
+
+        const uint64_t value = static_cast<uint64_t>(256 - fr) * g0 +
+                               static_cast<uint64_t>(fr) * g1;
+        outputPixel[2 - channel] = static_cast<uint8_t>(
+                (value + (static_cast<uint64_t>(rounding) << 16)) >> 32);
+    }
+}
+
+int LutBaker::selectGridSize(
+        const LutData &primaryLut,
+        const LutData &secondaryLut,
+        const ProcessingParams &params
+) {
+    // 两级LUT串联后不再是分段线性，节点之间的误差随网格变粗而增大，直接使用最大网格
+    if (secondaryLut.isLoaded && params.lut2Strength > 0.0f) {
+        return MAX_GRID_SIZE;
+    }
+
+    // 单LUT时网格与源LUT一致即可保留全部节点
+    return std::clamp(primaryLut.size, MIN_GRID_SIZE, MAX_GRID_SIZE);
+}
@@ -0,0 +1,140 @@
+#ifndef LUT_BAKER_H
+#define LUT_BAKER_H
+
+#include "../include/native_lut_processor.h"
+#include "../utils/dither_matrix.h"
+#include <cstdint>
+
+/**
+ * LUT烘焙器
+ * 将主LUT、第二LUT以及强度混合预先合成为一张定点网格，
+ * 逐像素处理只剩整数插值（按interpolationMode选择三线性或四面体），不再有浮点运算
+ */
+class LutBaker {
+public:
+    // 烘焙路径与浮点处理链相比的最大通道差异（8位色阶）。
+    // 单LUT时网格保留源LUT的全部节点，只有定点舍入误差
+    static constexpr int MAX_SINGLE_LUT_ERROR = 1;
+    // 两级LUT串联后节点之间不再是分段线性，按最大网格烘焙时平滑LUT的插值误差不超过此值
+    static constexpr int MAX_CHAINED_LUT_ERROR = 4;
+
+    /**
+     * 烘焙合成LUT
+     * @param primaryLut 主LUT数据
+     * @param secondaryLut 第二LUT数据
+     * @param params 处理参数（使用其中的strength、lut2Strength和interpolationMode）
+     * @param bakedLut 输出的烘焙数据
+     * @param gridSize 网格边长，0表示按源LUT尺寸自动选择
+     * @return 是否成功
+     */
+    static bool bake(
+            const LutData &primaryLut,
+            const LutData &secondaryLut,
+            const ProcessingParams &params,
+            BakedLutData &bakedLut,
+            int gridSize = 0
+    );
+
+    /**
+     * 判断烘焙数据是否与当前参数匹配
+     * @param bakedLut 烘焙数据
+     * @param secondaryLut 第二LUT数据
+     * @param params 处理参数
+     * @return 是否可以直接复用
+     */
+    static bool isBakeCurrent(
+            const BakedLutData &bakedLut,
+            const LutData &secondaryLut,
+            const ProcessingParams &params
+    );
+
+    /**
+     * 当前CPU上默认处理是否应走烘焙路径
+     * 烘焙查表逐像素做标量整数插值，检测到NEON/SSE4.1/AVX2时浮点向量内核更快，只在标量回退时使用
+     * @return 是否应烘焙
+     */
+    static bool isPreferred();
+
+    /**
+     * 使用烘焙数据批量处理像素（ARGB_8888）
+     * @param inputPixels 输入像素数据
+     * @param outputPixels 输出像素数据
+     * @param pixelCount 像素数量
+     * @param bakedLut 烘焙数据
+     * @param dither 有序抖动阈值行（不抖动时为空）
+     */
+    static void processPixels(
+            const uint8_t *inputPixels,
+            uint8_t *outputPixels,
+            int pixelCount,
+            const BakedLutData &bakedLut,
+            const OrderedDitherRow &dither = OrderedDitherRow()
+    );
+
+    /**
+     * 使用烘焙数据处理单个像素（ARGB_8888），插值方式由bakedLut.interpolationMode决定
+     * @param inputPixel 输入像素
+     * @param outputPixel 输出像素
+     * @param bakedLut 烘焙数据
+     * @param rounding 16位小数的量化偏移（四舍五入为32768，有序抖动时为 阈值*256+128）
+     */
+    static void processPixel(
+            const uint8_t *inputPixel,
+            uint8_t *outputPixel,
+            const BakedLutData &bakedLut,
+            uint32_t rounding = 32768
+    );
+
+    /**
+     * 整数四面体插值（interpolationMode == 1），参数同processPixel
+     */
+    static void processPixelTetrahedral(
+            const uint8_t *inputPixel,
+            uint8_t *outputPixel,
+            const BakedLutData &bakedLut,
+            uint32_t rounding
+    );
+
+    /**
+     * 整数三线性插值（interpolationMode == 0），参数同processPixel
+     */
+    static void processPixelTrilinear(
+            const uint8_t *inputPixel,
+            uint8_t *outputPixel,
+            const BakedLutData &bakedLut,
+            uint32_t rounding
+    );
+
+private:
+    using PixelKernel = void (*)(const uint8_t *, uint8_t *, const BakedLutData &, uint32_t);
+
+    /**
+     * 以固定的插值内核处理一批像素
+     */
+    template<PixelKernel kernel>
+    static void processPixelsWith(
+            const uint8_t *inputPixels,
+            uint8_t *outputPixels,
+            int pixelCount,
+            const BakedLutData &bakedLut,
+            const OrderedDitherRow &dither
+    );
+
+    /**
+     * 计算自动网格边长
+     * @param primaryLut 主LUT数据
+     * @param secondaryLut 第二LUT数据
+     * @param params 处理参数
+     * @return 网格边长
+     */
+    static int selectGridSize(
+            const LutData &primaryLut,
+            const LutData &secondaryLut,
+            const ProcessingParams &params
+    );
+
+    static constexpr int MIN_GRID_SIZE = 17;
+    static constexpr int MAX_GRID_SIZE = 65;
+};
+
+#endif // LUT_BAKER_H
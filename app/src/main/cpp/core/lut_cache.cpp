@@ -0,0 +1,341 @@
+#include "lut_cache.h"
+#include "../utils/file_utils.h"
+#include <android/log.h>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// 静态成员初始化
+std::string LutCache::cacheDirectory_;
+LutCache::PayloadFormat LutCache::payloadFormat_ = LutCache::PayloadFormat::FLOAT32;
+std::mutex LutCache::mutex_;
+
+static const char LUT_CACHE_MAGIC[4] = {'L', '2', 'P', 'L'};
+
+void LutCache::setCacheDirectory(const std::string &directory) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cacheDirectory_ = directory;
+    while (cacheDirectory_.size() > 1 && cacheDirectory_.back() == '/') {
+        cacheDirectory_.pop_back();
+    }
+
+    if (!cacheDirectory_.empty()) {
+        mkdir(cacheDirectory_.c_str(), 0700);
+        LOGD("LUT缓存目录: %s", cacheDirectory_.c_str());
+    } else {
+        LOGD("LUT缓存已禁用");
+    }
+}
+
+std::string LutCache::getCacheDirectory() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cacheDirectory_;
+}
+
+void LutCache::setPayloadFormat(PayloadFormat format) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    payloadFormat_ = format;
+}
+
+bool LutCache::isEnabled() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return !cacheDirectory_.empty();
+}
+
+std::string LutCache::getCachePath(const std::string &lutPath) {
+    std::string directory = getCacheDirectory();
+    if (directory.empty()) {
+        return "";
+    }
+
+    // 以源路径的FNV-1a哈希作为文件名，源文件是否变化由文件头中的大小和修改时间判断
+    const uint64_t hash = FileUtils::fnv1a64(lutPath.data(), lutPath.size());
+
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.l2plut", static_cast<unsigned long long>(hash));
+    return directory + "/" + name;
+}
+
+ProcessResult LutCache::loadFromCache(const std::string &lutPath, LutData &lutData) {
+    std::string cachePath = getCachePath(lutPath);
+    if (cachePath.empty()) {
+        return ProcessResult::ERROR_LUT_NOT_LOADED;
+    }
+
+    uint64_t sourceSize = 0;
+    int64_t sourceMtime = 0;
+    if (!statSource(lutPath, sourceSize, sourceMtime)) {
+        return ProcessResult::ERROR_LUT_NOT_LOADED;
+    }
+
+    LutData cached;
+    LutCacheHeader header;
+    ProcessResult result = readCacheFile(cachePath, cached, &header);
+    if (result != ProcessResult::SUCCESS) {
+        return result;
+    }
+
+    if (header.sourceSize != sourceSize || header.sourceMtime != sourceMtime) {
+        LOGD("LUT缓存已过期: %s", lutPath.c_str());
+        unlink(cachePath.c_str());
+        return ProcessResult::ERROR_LUT_NOT_LOADED;
+    }
+
+    lutData = std::move(cached);
+    LOGD("LUT缓存命中: %s", lutPath.c_str());
+    return ProcessResult::SUCCESS;
+}
+
+bool LutCache::writeToCache(const std::string &lutPath, const LutData &lutData) {
+    std::string cachePath = getCachePath(lutPath);
+    if (cachePath.empty()) {
+        return false;
+    }
+
+    uint64_t sourceSize = 0;
+    int64_t sourceMtime = 0;
+    if (!statSource(lutPath, sourceSize, sourceMtime)) {
+        return false;
+    }
+
+    PayloadFormat format;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        format = payloadFormat_;
+    }
+
+    return writeCacheFile(cachePath, lutData, format, sourceSize, sourceMtime);
+}
+
+ProcessResult LutCache::readCacheFile(
+        const std::string &cachePath,
+        LutData &lutData,
+        LutCacheHeader *header
+) {
+    int fd = open(cachePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return ProcessResult::ERROR_LUT_NOT_LOADED;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(LutCacheHeader)) {
+        close(fd);
+        LOGW("LUT缓存文件无效: %s", cachePath.c_str());
+        return ProcessResult::ERROR_LUT_NOT_LOADED;
+    }
+
+    const size_t fileSize = static_cast<size_t>(st.st_size);
+    void *mapped = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        LOGE("LUT缓存mmap失败: %s", cachePath.c_str());
+        return ProcessResult::ERROR_LUT_NOT_LOADED;
+    }
+    madvise(mapped, fileSize, MADV_SEQUENTIAL);
+
+    const uint8_t *bytes = static_cast<const uint8_t *>(mapped);
+    LutCacheHeader fileHeader;
+    std::memcpy(&fileHeader, bytes, sizeof(LutCacheHeader));
+
+    ProcessResult result = ProcessResult::SUCCESS;
+    const size_t elementSize =
+            fileHeader.payloadFormat == static_cast<uint16_t>(PayloadFormat::FLOAT16) ? 2 : 4;
+    const uint64_t entryCount = static_cast<uint64_t>(fileHeader.lutSize) *
+                                fileHeader.lutSize * fileHeader.lutSize * 3;
+
+    if (std::memcmp(fileHeader.magic, LUT_CACHE_MAGIC, sizeof(LUT_CACHE_MAGIC)) != 0 ||
+        fileHeader.version != CURRENT_VERSION ||
+        fileHeader.payloadFormat > static_cast<uint16_t>(PayloadFormat::FLOAT16) ||
+        fileHeader.headerSize < sizeof(LutCacheHeader)) {
+        LOGW("LUT缓存文件头不匹配: %s", cachePath.c_str());
+        result = ProcessResult::ERROR_LUT_NOT_LOADED;
+    } else if (fileHeader.headerSize > sizeof(LutCacheHeader) + MAX_TITLE_BYTES ||
+               fileHeader.lutSize < 2 || fileHeader.lutSize > 256 ||
+               fileHeader.payloadBytes != entryCount * elementSize ||
+               fileSize != fileHeader.headerSize + fileHeader.payloadBytes) {
+        LOGW("LUT缓存尺寸不一致: %s", cachePath.c_str());
+        result = ProcessResult::ERROR_LUT_NOT_LOADED;
+    } else {
+        const uint8_t *payload = bytes + fileHeader.headerSize;
+        if (FileUtils::fnv1a64(payload, fileHeader.payloadBytes) != fileHeader.checksum) {
+            LOGW("LUT缓存校验失败: %s", cachePath.c_str());
+            result = ProcessResult::ERROR_LUT_NOT_LOADED;
+        } else {
+            lutData.clear();
+            lutData.size = static_cast<int>(fileHeader.lutSize);
+            lutData.data.resize(entryCount);
+
+            if (elementSize == 4) {
+                std::memcpy(lutData.data.data(), payload, fileHeader.payloadBytes);
+            } else {
+                for (uint64_t i = 0; i < entryCount; ++i) {
+                    uint16_t half;
+                    std::memcpy(&half, payload + i * 2, sizeof(half));
+                    lutData.data[i] = halfToFloat(half);
+                }
+            }
+
+            for (int i = 0; i < 3; ++i) {
+                lutData.domainMin[i] = fileHeader.domainMin[i];
+                lutData.domainMax[i] = fileHeader.domainMax[i];
+            }
+
+            // 标题位于固定头部之后，末尾的0为补齐
+            const char *title = reinterpret_cast<const char *>(bytes + sizeof(LutCacheHeader));
+            const size_t titleBytes = fileHeader.headerSize - sizeof(LutCacheHeader);
+            lutData.title.assign(title, strnlen(title, titleBytes));
+            lutData.isLoaded = true;
+
+            if (header) {
+                *header = fileHeader;
+            }
+        }
+    }
+
+    munmap(mapped, fileSize);
+    return result;
+}
+
+bool LutCache::writeCacheFile(
+        const std::string &cachePath,
+        const LutData &lutData,
+        PayloadFormat format,
+        uint64_t sourceSize,
+        int64_t sourceMtime
+) {
+    if (!lutData.isLoaded || lutData.size < 2 ||
+        lutData.data.size() != static_cast<size_t>(lutData.size) * lutData.size * lutData.size * 3) {
+        LOGE("LUT数据无效，无法写入缓存");
+        return false;
+    }
+
+    // 准备负载
+    std::vector<uint8_t> payload;
+    if (format == PayloadFormat::FLOAT16) {
+        payload.resize(lutData.data.size() * 2);
+        for (size_t i = 0; i < lutData.data.size(); ++i) {
+            uint16_t half = floatToHalf(lutData.data[i]);
+            std::memcpy(&payload[i * 2], &half, sizeof(half));
+        }
+    } else {
+        payload.resize(lutData.data.size() * sizeof(float));
+        std::memcpy(payload.data(), lutData.data.data(), payload.size());
+    }
+
+    // 标题补齐到4字节，负载保持对齐
+    std::vector<char> title(lutData.title.begin(),
+                            lutData.title.begin() +
+                            std::min(lutData.title.size(), MAX_TITLE_BYTES));
+    title.resize((title.size() + 3) & ~static_cast<size_t>(3), '\0');
+
+    LutCacheHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, LUT_CACHE_MAGIC, sizeof(LUT_CACHE_MAGIC));
+    header.version = CURRENT_VERSION;
+    header.payloadFormat = static_cast<uint16_t>(format);
+    header.lutSize = static_cast<uint32_t>(lutData.size);
+    header.headerSize = static_cast<uint32_t>(sizeof(LutCacheHeader) + title.size());
+    for (int i = 0; i < 3; ++i) {
+        header.domainMin[i] = lutData.domainMin[i];
+        header.domainMax[i] = lutData.domainMax[i];
+    }
+    header.sourceSize = sourceSize;
+    header.sourceMtime = sourceMtime;
+    header.payloadBytes = payload.size();
+    header.checksum = FileUtils::fnv1a64(payload.data(), payload.size());
+
+    if (!FileUtils::writeAtomically(cachePath, {{&header, sizeof(header)},
+                                                {title.data(), title.size()},
+                                                {payload.data(), payload.size()}})) {
+        LOGE("写入LUT缓存失败: %s", cachePath.c_str());
+        return false;
+    }
+
+    LOGD("LUT缓存已写入: %s (%zu 字节)", cachePath.c_str(), header.headerSize + payload.size());
+    return true;
+}
+
+uint16_t LutCache::floatToHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    const uint32_t sign = (bits >> 16) & 0x8000u;
+    const int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xFFu) - 127 + 15;
+    uint32_t mantissa = bits & 0x7FFFFFu;
+
+    if (((bits >> 23) & 0xFFu) == 0xFFu) {
+        // Inf / NaN
+        return static_cast<uint16_t>(sign | 0x7C00u | (mantissa ? 0x200u : 0u));
+    }
+    if (exponent >= 0x1F) {
+        // 溢出为Inf
+        return static_cast<uint16_t>(sign | 0x7C00u);
+    }
+    if (exponent <= 0) {
+        // 非规格化数或下溢为0
+        if (exponent < -10) {
+            return static_cast<uint16_t>(sign);
+        }
+        mantissa |= 0x800000u;
+        const int shift = 14 - exponent;
+        uint32_t halfMantissa = mantissa >> shift;
+        const uint32_t remainder = mantissa & ((1u << shift) - 1u);
+        const uint32_t halfway = 1u << (shift - 1);
+        if (remainder > halfway || (remainder == halfway && (halfMantissa & 1u))) {
+            halfMantissa++;
+        }
+        return static_cast<uint16_t>(sign | halfMantissa);
+    }
+
+    uint32_t half = sign | (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+    const uint32_t remainder = mantissa & 0x1FFFu;
+    if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u))) {
+        half++; // 进位可能溢出到指数位，结果仍然正确（最大变为Inf）
+    }
+    return static_cast<uint16_t>(half);
+}
+
+float LutCache::halfToFloat(uint16_t value) {
+    const uint32_t sign = static_cast<uint32_t>(value & 0x8000u) << 16;
+    uint32_t exponent = (value >> 10) & 0x1Fu;
+    uint32_t mantissa = value & 0x3FFu;
+    uint32_t bits;
+
+    if (exponent == 0) {
+        if (mantissa == 0) {
+            bits = sign;
+        } else {
+            // 非规格化数：规格化后转换
+            exponent = 127 - 15 + 1;
+            while ((mantissa & 0x400u) == 0) {
+                mantissa <<= 1;
+                exponent--;
+            }
+            mantissa &= 0x3FFu;
+            bits = sign | (exponent << 23) | (mantissa << 13);
+        }
+    } else if (exponent == 0x1F) {
+        bits = sign | 0x7F800000u | (mantissa << 13);
+    } else {
+        bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+    }
+
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+bool LutCache::statSource(const std::string &lutPath, uint64_t &size, int64_t &mtime) {
+    struct stat st;
+    if (stat(lutPath.c_str(), &st) != 0) {
+        return false;
+    }
+    size = static_cast<uint64_t>(st.st_size);
+    mtime = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+    return true;
+}
@@ -0,0 +1,148 @@
+#ifndef LUT_CACHE_H
+#define LUT_CACHE_H
+
+#include "../include/native_lut_processor.h"
+#include <string>
+#include <mutex>
+#include <cstdint>
+
+/**
+ * LUT二进制缓存文件头
+ * 文件布局：头部（固定72字节）+ 标题（UTF-8，以0补齐到4字节，headerSize包含这部分）
+ *          + 负载（size^3 * 3个float32或float16）
+ */
+struct LutCacheHeader {
+    char magic[4];              // "L2PL"
+    uint16_t version;           // 格式版本
+    uint16_t payloadFormat;     // 0=FLOAT32, 1=FLOAT16
+    uint32_t lutSize;           // LUT立方体边长
+    uint32_t headerSize;        // 头部字节数，用于后续版本扩展
+    float domainMin[3];         // 输入定义域下限
+    float domainMax[3];         // 输入定义域上限
+    uint64_t sourceSize;        // 源文件大小，用于判断缓存是否过期
+    int64_t sourceMtime;        // 源文件修改时间（纳秒）
+    uint64_t payloadBytes;      // 负载字节数
+    uint64_t checksum;          // 负载校验和
+};
+
+static_assert(sizeof(LutCacheHeader) == 72, "LutCacheHeader布局必须固定");
+
+/**
+ * LUT二进制缓存
+ * 首次解析.cube/.3dl后写入缓存文件，之后通过mmap直接读取，跳过文本解析
+ */
+class LutCache {
+public:
+    enum class PayloadFormat : uint16_t {
+        FLOAT32 = 0,
+        FLOAT16 = 1
+    };
+
+    // 版本2：负载由单遍分词器解析（识别TITLE、DOMAIN_MIN/MAX并按定义域重采样），
+    // 旧解析器写入的缓存数据不同，需要重新解析
+    static constexpr uint16_t CURRENT_VERSION = 2;
+
+    // 缓存中保存的标题上限，超出部分截断
+    static constexpr size_t MAX_TITLE_BYTES = 1024;
+
+    /**
+     * 设置缓存目录，空字符串表示禁用缓存
+     * @param directory 缓存目录（通常为应用的cacheDir）
+     */
+    static void setCacheDirectory(const std::string &directory);
+
+    /**
+     * 获取缓存目录
+     * @return 缓存目录
+     */
+    static std::string getCacheDirectory();
+
+    /**
+     * 设置新写入缓存使用的负载格式
+     * @param format 负载格式
+     */
+    static void setPayloadFormat(PayloadFormat format);
+
+    /**
+     * 缓存是否已启用
+     * @return 是否启用
+     */
+    static bool isEnabled();
+
+    /**
+     * 获取源LUT文件对应的缓存文件路径
+     * @param lutPath 源LUT文件路径
+     * @return 缓存文件路径，未启用时为空
+     */
+    static std::string getCachePath(const std::string &lutPath);
+
+    /**
+     * 从缓存加载源LUT文件对应的数据，源文件大小或修改时间变化时视为未命中
+     * @param lutPath 源LUT文件路径
+     * @param lutData 输出的LUT数据
+     * @return 处理结果
+     */
+    static ProcessResult loadFromCache(const std::string &lutPath, LutData &lutData);
+
+    /**
+     * 为源LUT文件写入缓存
+     * @param lutPath 源LUT文件路径
+     * @param lutData 已解析的LUT数据
+     * @return 是否成功
+     */
+    static bool writeToCache(const std::string &lutPath, const LutData &lutData);
+
+    /**
+     * 读取缓存文件（mmap）
+     * @param cachePath 缓存文件路径
+     * @param lutData 输出的LUT数据
+     * @param header 输出的文件头，可为nullptr
+     * @return 处理结果
+     */
+    static ProcessResult readCacheFile(
+            const std::string &cachePath,
+            LutData &lutData,
+            LutCacheHeader *header = nullptr
+    );
+
+    /**
+     * 写入缓存文件（先写唯一命名的临时文件再重命名，避免读到半写入的文件，
+     * 多个线程或进程同时写同一缓存时也不会互相覆盖临时文件）
+     * @param cachePath 缓存文件路径
+     * @param lutData LUT数据
+     * @param format 负载格式
+     * @param sourceSize 源文件大小
+     * @param sourceMtime 源文件修改时间（纳秒）
+     * @return 是否成功
+     */
+    static bool writeCacheFile(
+            const std::string &cachePath,
+            const LutData &lutData,
+            PayloadFormat format,
+            uint64_t sourceSize = 0,
+            int64_t sourceMtime = 0
+    );
+
+private:
+    /**
+     * float32转float16（IEEE 754 binary16，就近舍入）
+     */
+    static uint16_t floatToHalf(float value);
+
+    /**
+     * float16转float32
+     */
+    static float halfToFloat(uint16_t value);
+
+    /**
+     * 读取源文件的大小和修改时间（纳秒精度，同一秒内的修改也能识别）
+     * @return 是否成功
+     */
+    static bool statSource(const std::string &lutPath, uint64_t &size, int64_t &mtime);
+
+    static std::string cacheDirectory_;
+    static PayloadFormat payloadFormat_;
+    static std::mutex mutex_;
+};
+
+#endif // LUT_CACHE_H
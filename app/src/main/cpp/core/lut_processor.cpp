@@ -1,14 +1,21 @@
 #include "lut_processor.h"
+#include "lut_cache.h"
+#include "lut_tokenizer.h"
 #include <android/log.h>
 #include <fstream>
 #include <sstream>
 #include <algorithm>
 #include <cmath>
-#include <cctype>
 
 ProcessResult LutProcessor::loadLutFromFile(const std::string &lutPath, LutData &lutData) {
     LOGD("开始从文件加载LUT: %s", lutPath.c_str());
 
+    // 优先使用二进制缓存，跳过文本解析
+    if (LutCache::isEnabled() &&
+        LutCache::loadFromCache(lutPath, lutData) == ProcessResult::SUCCESS) {
+        return ProcessResult::SUCCESS;
+    }
+
     std::ifstream file(lutPath, std::ios::binary);
     if (!file.is_open()) {
         LOGE("无法打开LUT文件: %s", lutPath.c_str());
@@ -24,7 +31,14 @@ ProcessResult LutProcessor::loadLutFromFile(const std::string &lutPath, LutData
     file.read(reinterpret_cast<char *>(buffer.data()), fileSize);
     file.close();
 
-    return loadLutFromMemory(buffer.data(), fileSize, lutData);
+    ProcessResult result = loadLutFromMemory(buffer.data(), fileSize, lutData);
+
+    // 首次解析成功后写入缓存
+    if (result == ProcessResult::SUCCESS && LutCache::isEnabled()) {
+        LutCache::writeToCache(lutPath, lutData);
+    }
+
+    return result;
 }
 
 ProcessResult
@@ -34,29 +48,13 @@ LutProcessor::loadLutFromMemory(const uint8_t *lutBytes, size_t size, LutData &l
         return ProcessResult::ERROR_INVALID_PARAMETERS;
     }
 
-    // 转换为字符串
-    std::string content(reinterpret_cast<const char *>(lutBytes), size);
-
-    // 检测文件格式
-    std::string lowerContent = toLowerCase(content);
-    bool isCube = lowerContent.find("lut_3d_size") != std::string::npos;
-    bool is3dl = lowerContent.find("3dl") != std::string::npos ||
-                 content.find("\t") != std::string::npos;
-
-    bool success = false;
-    if (isCube) {
-        LOGD("检测到.cube格式LUT");
-        success = parseCubeLut(content, lutData);
-    } else if (is3dl) {
-        LOGD("检测到.3dl格式LUT");
-        success = parse3dlLut(content, lutData);
-    } else {
-        LOGD("尝试解析为.cube格式");
-        success = parseCubeLut(content, lutData);
-        if (!success) {
-            LOGD("尝试解析为.3dl格式");
-            success = parse3dlLut(content, lutData);
-        }
+    const char *text = reinterpret_cast<const char *>(lutBytes);
+
+    // .cube解析器在数据行之前没有找到尺寸关键字时立即返回，此时按.3dl解析
+    bool success = parseCubeLut(text, size, lutData);
+    if (!success) {
+        LOGD("尝试解析为.3dl格式");
+        success = parse3dlLut(text, size, lutData);
     }
 
     if (success) {
@@ -72,7 +70,8 @@ LutProcessor::loadLutFromMemory(const uint8_t *lutBytes, size_t size, LutData &l
 void LutProcessor::applyLut(
         float r, float g, float b,
         float &outR, float &outG, float &outB,
-        const LutData &lutData
+        const LutData &lutData,
+        int interpolationMode
 ) {
     if (!lutData.isLoaded || lutData.data.empty()) {
         outR = r;
@@ -81,6 +80,15 @@ void LutProcessor::applyLut(
         return;
     }
 
+    if (interpolationMode == 1 && lutData.size >= 2) {
+        // 使用四面体插值
+        tetrahedralInterpolation(std::clamp(r, 0.0f, 1.0f),
+                                 std::clamp(g, 0.0f, 1.0f),
+                                 std::clamp(b, 0.0f, 1.0f),
+                                 lutData, outR, outG, outB);
+        return;
+    }
+
     // 将输入值映射到LUT索引空间
     float x = std::clamp(r, 0.0f, 1.0f) * (lutData.size - 1);
     float y = std::clamp(g, 0.0f, 1.0f) * (lutData.size - 1);
@@ -114,158 +122,248 @@ std::string LutProcessor::getLutInfo(const LutData &lutData) {
     return oss.str();
 }
 
-bool LutProcessor::parseCubeLut(const std::string &content, LutData &lutData) {
-    std::istringstream iss(content);
-    std::string line;
-    std::vector<std::string> lines;
+bool LutProcessor::parseCubeLut(const char *text, size_t length, LutData &lutData) {
+    LutTokenizer tokenizer(text, text + length);
 
-    // 读取所有行
-    while (std::getline(iss, line)) {
-        lines.push_back(trim(line));
-    }
+    int size3d = 0;
+    int size1d = 0;
+    float domainMin[3] = {0.0f, 0.0f, 0.0f};
+    float domainMax[3] = {1.0f, 1.0f, 1.0f};
+    std::string_view title;
 
-    if (lines.empty()) {
-        LOGE(".cube文件为空");
-        return false;
-    }
+    // 解析头部关键字，遇到第一个数据行时停止
+    bool hasPendingLine = false;
+    while (tokenizer.nextLine()) {
+        if (tokenizer.lineStartsWithNumber()) {
+            hasPendingLine = true;
+            break;
+        }
 
-    size_t lineIndex = 0;
-    lutData.size = 0;
-
-    // 解析头部信息
-    while (lineIndex < lines.size()) {
-        lineIndex = skipEmptyAndComments(lines, lineIndex);
-        if (lineIndex >= lines.size()) break;
-
-        std::string currentLine = toLowerCase(lines[lineIndex]);
-
-        if (currentLine.find("lut_3d_size") == 0) {
-            std::vector<std::string> parts = split(lines[lineIndex], ' ');
-            if (parts.size() >= 2) {
-                try {
-                    lutData.size = std::stoi(parts[1]);
-                    LOGD("解析到LUT尺寸: %d", lutData.size);
-                } catch (const std::exception &e) {
-                    LOGE("解析LUT尺寸失败: %s", e.what());
-                    return false;
-                }
+        bool valid = true;
+        if (tokenizer.consumeKeyword("LUT_3D_SIZE")) {
+            valid = tokenizer.readInt(size3d);
+        } else if (tokenizer.consumeKeyword("LUT_1D_SIZE")) {
+            valid = tokenizer.readInt(size1d);
+        } else if (tokenizer.consumeKeyword("DOMAIN_MIN")) {
+            valid = tokenizer.readFloat(domainMin[0]) &&
+                    tokenizer.readFloat(domainMin[1]) &&
+                    tokenizer.readFloat(domainMin[2]);
+        } else if (tokenizer.consumeKeyword("DOMAIN_MAX")) {
+            valid = tokenizer.readFloat(domainMax[0]) &&
+                    tokenizer.readFloat(domainMax[1]) &&
+                    tokenizer.readFloat(domainMax[2]);
+        } else if (tokenizer.consumeKeyword("TITLE")) {
+            title = tokenizer.rest();
+            if (title.size() >= 2 && title.front() == '"' && title.back() == '"') {
+                title = title.substr(1, title.size() - 2);
             }
-            lineIndex++;
-            break;
         }
-        lineIndex++;
+        // 其他关键字（如LUT_3D_INPUT_RANGE）忽略
+
+        if (!valid) {
+            LOGE(".cube头部解析失败，行 %zu", tokenizer.lineNumber());
+            return false;
+        }
     }
 
-    if (lutData.size <= 0 || lutData.size > 256) {
-        LOGE("无效的LUT尺寸: %d", lutData.size);
+    if (size3d == 0 && size1d == 0) {
+        LOGD("未找到LUT_3D_SIZE或LUT_1D_SIZE");
         return false;
     }
+    if (size3d != 0 && (size3d < 2 || size3d > 256)) {
+        LOGE("无效的LUT尺寸: %d", size3d);
+        return false;
+    }
+    if (size1d != 0 && (size1d < 2 || size1d > 65536)) {
+        LOGE("无效的一维LUT尺寸: %d", size1d);
+        return false;
+    }
+    for (int i = 0; i < 3; ++i) {
+        if (!(domainMax[i] > domainMin[i])) {
+            LOGE("无效的定义域: [%f, %f]", domainMin[i], domainMax[i]);
+            return false;
+        }
+    }
+
+    // 按行读取RGB条目，一维数据在前，三维数据在后
+    auto readEntries = [&](float *destination, int count) -> bool {
+        for (int i = 0; i < count; ++i) {
+            if (!hasPendingLine && !tokenizer.nextLine()) {
+                LOGE("LUT数据不完整，期望 %d 个条目，实际 %d 个", count, i);
+                return false;
+            }
+            hasPendingLine = false;
 
-    // 分配内存
-    const int totalEntries = lutData.size * lutData.size * lutData.size;
-    lutData.data.resize(totalEntries * 3);
-
-    // 解析LUT数据
-    int dataIndex = 0;
-    while (lineIndex < lines.size() && dataIndex < totalEntries) {
-        lineIndex = skipEmptyAndComments(lines, lineIndex);
-        if (lineIndex >= lines.size()) break;
-
-        std::vector<std::string> values = split(lines[lineIndex], ' ');
-        if (values.size() >= 3) {
-            try {
-                lutData.data[dataIndex * 3 + 0] = std::stof(values[0]); // R
-                lutData.data[dataIndex * 3 + 1] = std::stof(values[1]); // G
-                lutData.data[dataIndex * 3 + 2] = std::stof(values[2]); // B
-                dataIndex++;
-            } catch (const std::exception &e) {
-                LOGE("解析LUT数据失败，行 %zu: %s", lineIndex, e.what());
-                lutData.clear();
+            if (!tokenizer.readFloat(destination[i * 3 + 0]) ||  // R
+                !tokenizer.readFloat(destination[i * 3 + 1]) ||  // G
+                !tokenizer.readFloat(destination[i * 3 + 2])) {  // B
+                LOGE("解析LUT数据失败，行 %zu", tokenizer.lineNumber());
                 return false;
             }
         }
-        lineIndex++;
+        return true;
+    };
+
+    std::vector<float> shaper;
+    if (size1d > 0) {
+        shaper.resize(static_cast<size_t>(size1d) * 3);
+        if (!readEntries(shaper.data(), size1d)) {
+            return false;
+        }
     }
 
-    if (dataIndex != totalEntries) {
-        LOGE("LUT数据不完整，期望 %d 个条目，实际 %d 个", totalEntries, dataIndex);
-        lutData.clear();
-        return false;
+    std::vector<float> cube3d;
+    if (size3d > 0) {
+        cube3d.resize(static_cast<size_t>(size3d) * size3d * size3d * 3);
+        if (!readEntries(cube3d.data(), size3d * size3d * size3d)) {
+            return false;
+        }
+    }
+
+    bool defaultDomain = true;
+    for (int i = 0; i < 3; ++i) {
+        lutData.domainMin[i] = domainMin[i];
+        lutData.domainMax[i] = domainMax[i];
+        defaultDomain = defaultDomain && domainMin[i] == 0.0f && domainMax[i] == 1.0f;
     }
+    lutData.title.assign(title.data(), title.size());
 
-    LOGD(".cube LUT解析成功");
+    if (shaper.empty() && defaultDomain) {
+        lutData.size = size3d;
+        lutData.data = std::move(cube3d);
+    } else {
+        // 一维LUT展开为三维网格时，边长不超过65即可保留曲线形状
+        const int gridSize = size3d > 0 ? size3d : std::min(size1d, 65);
+        resampleCubeLut(std::move(cube3d), size3d, shaper, size1d, gridSize, lutData);
+        LOGD("定义域/一维LUT已合成到 %d^3 网格", gridSize);
+    }
+
+    LOGD(".cube LUT解析成功，尺寸: %d", lutData.size);
     return true;
 }
 
-bool LutProcessor::parse3dlLut(const std::string &content, LutData &lutData) {
-    std::istringstream iss(content);
-    std::string line;
-    std::vector<std::vector<float>> dataLines;
+bool LutProcessor::parse3dlLut(const char *text, size_t length, LutData &lutData) {
+    LutTokenizer tokenizer(text, text + length);
 
-    // 读取所有数据行
-    while (std::getline(iss, line)) {
-        line = trim(line);
-        if (line.empty() || line[0] == '#') continue;
+    // 每个条目约占12~16字节，按此预留，避免逐行扩容
+    std::vector<float> data;
+    data.reserve(length / 4);
 
-        std::vector<std::string> values = split(line, '\t');
-        if (values.empty()) {
-            values = split(line, ' ');
+    float maxValue = 0.0f;
+    while (tokenizer.nextLine()) {
+        // 关键字行（如3DMESH、Mesh）跳过
+        if (!tokenizer.lineStartsWithNumber()) {
+            continue;
         }
 
-        if (values.size() >= 3) {
-            std::vector<float> rgb;
-            try {
-                for (int i = 0; i < 3; ++i) {
-                    float value = std::stof(values[i]);
-                    // 3dl格式通常使用0-1023或0-4095范围，需要归一化
-                    if (value > 1.0f) {
-                        if (value <= 1023.0f) {
-                            value /= 1023.0f;
-                        } else if (value <= 4095.0f) {
-                            value /= 4095.0f;
-                        } else {
-                            value /= 65535.0f;
-                        }
-                    }
-                    rgb.push_back(value);
-                }
-                dataLines.push_back(rgb);
-            } catch (const std::exception &e) {
-                LOGE("解析3dl数据失败: %s", e.what());
-                continue;
-            }
+        float rgb[3];
+        if (!tokenizer.readFloat(rgb[0]) ||
+            !tokenizer.readFloat(rgb[1]) ||
+            !tokenizer.readFloat(rgb[2])) {
+            LOGD("跳过非数据行 %zu", tokenizer.lineNumber());
+            continue;
         }
+
+        // 超过三个数值的是输入网格定义行，不是数据条目
+        if (!tokenizer.atLineEnd()) {
+            continue;
+        }
+
+        data.insert(data.end(), rgb, rgb + 3);
+        maxValue = std::max({maxValue, rgb[0], rgb[1], rgb[2]});
     }
 
-    if (dataLines.empty()) {
+    if (data.empty()) {
         LOGE("3dl文件没有有效数据");
         return false;
     }
 
     // 推断LUT尺寸
-    int totalEntries = dataLines.size();
-    lutData.size = static_cast<int>(std::round(std::cbrt(totalEntries)));
-
-    if (lutData.size * lutData.size * lutData.size != totalEntries) {
+    const int totalEntries = static_cast<int>(data.size() / 3);
+    const int size = static_cast<int>(std::round(std::cbrt(totalEntries)));
+    if (size < 2 || size * size * size != totalEntries) {
         LOGE("3dl数据大小不是完美立方体: %d", totalEntries);
         return false;
     }
 
-    LOGD("推断3dl LUT尺寸: %d", lutData.size);
+    LOGD("推断3dl LUT尺寸: %d", size);
 
-    // 分配内存并复制数据
-    lutData.data.resize(totalEntries * 3);
+    // 3dl格式通常使用0-1023、0-4095或0-65535范围，按整个文件的最大值确定位深后统一归一化
+    if (maxValue > 1.0f) {
+        const float scale = maxValue <= 1023.0f ? 1.0f / 1023.0f :
+                            maxValue <= 4095.0f ? 1.0f / 4095.0f : 1.0f / 65535.0f;
+        for (float &value: data) {
+            value *= scale;
+        }
+    }
 
-    for (int i = 0; i < totalEntries; ++i) {
-        lutData.data[i * 3 + 0] = dataLines[i][0]; // R
-        lutData.data[i * 3 + 1] = dataLines[i][1]; // G
-        lutData.data[i * 3 + 2] = dataLines[i][2]; // B
+    lutData.size = size;
+    lutData.data = std::move(data);
+    lutData.title.clear();
+    for (int i = 0; i < 3; ++i) {
+        lutData.domainMin[i] = 0.0f;
+        lutData.domainMax[i] = 1.0f;
     }
 
     LOGD("3dl LUT解析成功");
     return true;
 }
 
+void LutProcessor::resampleCubeLut(
+        std::vector<float> cube3d, int size3d,
+        const std::vector<float> &shaper, int size1d,
+        int gridSize,
+        LutData &lutData
+) {
+    LutData source;
+    if (!cube3d.empty()) {
+        source.size = size3d;
+        source.data = std::move(cube3d);
+        source.isLoaded = true;
+    }
+
+    auto sampleShaper = [&](float x, int channel) -> float {
+        const float position = std::clamp(x, 0.0f, 1.0f) * (size1d - 1);
+        const int i0 = std::min(static_cast<int>(position), size1d - 2);
+        const float t = position - i0;
+        return shaper[i0 * 3 + channel] * (1.0f - t) + shaper[(i0 + 1) * 3 + channel] * t;
+    };
+
+    std::vector<float> data(static_cast<size_t>(gridSize) * gridSize * gridSize * 3);
+    const float maxIndex = static_cast<float>(gridSize - 1);
+
+    // .cube数据顺序为R变化最快：索引 = b*size*size + g*size + r
+    for (int b = 0; b < gridSize; ++b) {
+        for (int g = 0; g < gridSize; ++g) {
+            for (int r = 0; r < gridSize; ++r) {
+                float coord[3] = {r / maxIndex, g / maxIndex, b / maxIndex};
+                for (int c = 0; c < 3; ++c) {
+                    coord[c] = std::clamp((coord[c] - lutData.domainMin[c]) /
+                                          (lutData.domainMax[c] - lutData.domainMin[c]),
+                                          0.0f, 1.0f);
+                    if (!shaper.empty()) {
+                        coord[c] = sampleShaper(coord[c], c);
+                    }
+                }
+
+                float *out = &data[(static_cast<size_t>(b) * gridSize * gridSize +
+                                    g * gridSize + r) * 3];
+                if (source.isLoaded) {
+                    // applyLut的第一个坐标对应数据中变化最慢的轴，即.cube的B
+                    applyLut(coord[2], coord[1], coord[0], out[0], out[1], out[2], source);
+                } else {
+                    out[0] = coord[0];
+                    out[1] = coord[1];
+                    out[2] = coord[2];
+                }
+            }
+        }
+    }
+
+    lutData.size = gridSize;
+    lutData.data = std::move(data);
+}
+
 void LutProcessor::trilinearInterpolation(
         float x, float y, float z,
         const LutData &lutData,
@@ -320,6 +418,76 @@ void LutProcessor::trilinearInterpolation(
     }
 }
 
+void LutProcessor::tetrahedralInterpolation(
+        float x, float y, float z,
+        const LutData &lutData,
+        float &outR, float &outG, float &outB
+) {
+    const int size = lutData.size;
+    const float maxIndex = static_cast<float>(size - 1);
+
+    float fx = x * maxIndex;
+    float fy = y * maxIndex;
+    float fz = z * maxIndex;
+
+    // 基准顶点限制在[0, size-2]，保证+1的邻居总是有效，边界处小数部分为1
+    int x0 = std::min(static_cast<int>(fx), size - 2);
+    int y0 = std::min(static_cast<int>(fy), size - 2);
+    int z0 = std::min(static_cast<int>(fz), size - 2);
+
+    float dx = fx - x0;
+    float dy = fy - y0;
+    float dz = fz - z0;
+
+    // 各轴在数据数组中的步长（索引 = r*size*size + g*size + b，每项3个float）
+    const int strideR = size * size * 3;
+    const int strideG = size * 3;
+    const int strideB = 3;
+
+    // 按小数部分的大小顺序选择四面体：w1 >= w2 >= w3，
+    // 路径 c000 -> c000+offset1 -> c000+offset1+offset2 -> c111
+    float w1, w2, w3;
+    int offset1, offset2;
+    if (dx >= dy) {
+        if (dy >= dz) {
+            w1 = dx; w2 = dy; w3 = dz;
+            offset1 = strideR; offset2 = strideG;
+        } else if (dx >= dz) {
+            w1 = dx; w2 = dz; w3 = dy;
+            offset1 = strideR; offset2 = strideB;
+        } else {
+            w1 = dz; w2 = dx; w3 = dy;
+            offset1 = strideB; offset2 = strideR;
+        }
+    } else {
+        if (dz >= dy) {
+            w1 = dz; w2 = dy; w3 = dx;
+            offset1 = strideB; offset2 = strideG;
+        } else if (dz >= dx) {
+            w1 = dy; w2 = dz; w3 = dx;
+            offset1 = strideG; offset2 = strideB;
+        } else {
+            w1 = dy; w2 = dx; w3 = dz;
+            offset1 = strideG; offset2 = strideR;
+        }
+    }
+
+    const float *c0 = lutData.data.data() + (x0 * size * size + y0 * size + z0) * 3;
+    const float *c1 = c0 + offset1;
+    const float *c2 = c1 + offset2;
+    const float *c3 = c0 + strideR + strideG + strideB;
+
+    // 重心坐标权重
+    const float k0 = 1.0f - w1;
+    const float k1 = w1 - w2;
+    const float k2 = w2 - w3;
+    const float k3 = w3;
+
+    outR = k0 * c0[0] + k1 * c1[0] + k2 * c2[0] + k3 * c3[0];
+    outG = k0 * c0[1] + k1 * c1[1] + k2 * c2[1] + k3 * c3[1];
+    outB = k0 * c0[2] + k1 * c1[2] + k2 * c2[2] + k3 * c3[2];
+}
+
 void LutProcessor::getLutValue(
         int r, int g, int b,
         const LutData &lutData,
@@ -337,45 +505,3 @@ void LutProcessor::getLutValue(
     outG = lutData.data[index * 3 + 1];
     outB = lutData.data[index * 3 + 2];
 }
-
-size_t LutProcessor::skipEmptyAndComments(const std::vector<std::string> &lines, size_t index) {
-    while (index < lines.size()) {
-        std::string line = trim(lines[index]);
-        if (!line.empty() && line[0] != '#') {
-            break;
-        }
-        index++;
-    }
-    return index;
-}
-
-std::vector<std::string> LutProcessor::split(const std::string &str, char delimiter) {
-    std::vector<std::string> tokens;
-    std::istringstream iss(str);
-    std::string token;
-
-    while (std::getline(iss, token, delimiter)) {
-        token = trim(token);
-        if (!token.empty()) {
-            tokens.push_back(token);
-        }
-    }
-
-    return tokens;
-}
-
-std::string LutProcessor::trim(const std::string &str) {
-    size_t start = str.find_first_not_of(" \t\r\n");
-    if (start == std::string::npos) {
-        return "";
-    }
-
-    size_t end = str.find_last_not_of(" \t\r\n");
-    return str.substr(start, end - start + 1);
-}
-
-std::string LutProcessor::toLowerCase(const std::string &str) {
-    std::string result = str;
-    std::transform(result.begin(), result.end(), result.begin(), ::tolower);
-    return result;
-}
\ No newline at end of file
@@ -37,11 +37,13 @@ public:
      * @param outG 输出绿色值
      * @param outB 输出蓝色值
      * @param lutData LUT数据
+     * @param interpolationMode 插值模式（0=三线性，1=四面体）
      */
     static void applyLut(
             float r, float g, float b,
             float &outR, float &outG, float &outB,
-            const LutData &lutData
+            const LutData &lutData,
+            int interpolationMode = 0
     );
 
     /**
@@ -67,19 +69,39 @@ public:
 private:
     /**
      * 解析.cube格式LUT文件
-     * @param content 文件内容
+     * 支持TITLE、DOMAIN_MIN/DOMAIN_MAX、LUT_1D_SIZE与LUT_3D_SIZE，
+     * 一维LUT与非默认定义域在解析时合成到[0,1]定义域的三维网格中
+     * @param text 文件内容
+     * @param length 内容长度
      * @param lutData 输出的LUT数据
      * @return 是否成功
      */
-    static bool parseCubeLut(const std::string &content, LutData &lutData);
+    static bool parseCubeLut(const char *text, size_t length, LutData &lutData);
 
     /**
      * 解析.3dl格式LUT文件
-     * @param content 文件内容
+     * @param text 文件内容
+     * @param length 内容长度
      * @param lutData 输出的LUT数据
      * @return 是否成功
      */
-    static bool parse3dlLut(const std::string &content, LutData &lutData);
+    static bool parse3dlLut(const char *text, size_t length, LutData &lutData);
+
+    /**
+     * 将定义域映射和一维预处理曲线合成到新的三维网格（数据按.cube文件顺序，R变化最快）
+     * @param cube3d 源三维数据，为空表示只有一维LUT
+     * @param size3d 源三维边长
+     * @param shaper 一维曲线数据（每项RGB三个分量），为空表示没有
+     * @param size1d 一维曲线长度
+     * @param gridSize 输出网格边长
+     * @param lutData 输出的LUT数据（使用其中的domainMin/domainMax）
+     */
+    static void resampleCubeLut(
+            std::vector<float> cube3d, int size3d,
+            const std::vector<float> &shaper, int size1d,
+            int gridSize,
+            LutData &lutData
+    );
 
     /**
      * 三线性插值
@@ -93,6 +115,19 @@ private:
             float &outR, float &outG, float &outB
     );
 
+    /**
+     * 四面体插值
+     * 每个像素只读取所在四面体的4个顶点，索引在入口处一次性限定，顶点读取不再逐个钳制
+     * @param x, y, z 插值坐标 [0,1]
+     * @param lutData LUT数据
+     * @param outR, outG, outB 输出RGB值
+     */
+    static void tetrahedralInterpolation(
+            float x, float y, float z,
+            const LutData &lutData,
+            float &outR, float &outG, float &outB
+    );
+
     /**
      * 获取LUT中指定位置的RGB值
      * @param r, g, b 索引位置
@@ -104,36 +139,6 @@ private:
             const LutData &lutData,
             float &outR, float &outG, float &outB
     );
-
-    /**
-     * 跳过空白行和注释
-     * @param lines 文件行数组
-     * @param index 当前行索引
-     * @return 下一个有效行索引
-     */
-    static size_t skipEmptyAndComments(const std::vector<std::string> &lines, size_t index);
-
-    /**
-     * 分割字符串
-     * @param str 输入字符串
-     * @param delimiter 分隔符
-     * @return 分割后的字符串数组
-     */
-    static std::vector<std::string> split(const std::string &str, char delimiter);
-
-    /**
-     * 去除字符串首尾空白
-     * @param str 输入字符串
-     * @return 处理后的字符串
-     */
-    static std::string trim(const std::string &str);
-
-    /**
-     * 字符串转小写
-     * @param str 输入字符串
-     * @return 小写字符串
-     */
-    static std::string toLowerCase(const std::string &str);
 };
 
 #endif // LUT_PROCESSOR_H
\ No newline at end of file
@@ -0,0 +1,181 @@
+#ifndef LUT_TOKENIZER_H
+#define LUT_TOKENIZER_H
+
+#include <charconv>
+#include <cstring>
+#include <cstddef>
+#include <string_view>
+#include <system_error>
+
+/**
+ * LUT文本分词器
+ * 在原始字节缓冲区上单次前向扫描：行与词元都以指针区间表示，
+ * 数值直接用std::from_chars解析，不产生任何逐行或逐词元的堆分配
+ */
+class LutTokenizer {
+public:
+    /**
+     * @param begin 文本起始位置
+     * @param end 文本结束位置（不要求以'\0'结尾）
+     */
+    LutTokenizer(const char *begin, const char *end)
+            : cursor_(begin), end_(end), lineBegin_(begin), lineEnd_(begin), pos_(begin) {}
+
+    /**
+     * 前进到下一个非空、非注释行，并去除首尾空白
+     * @return 是否还有有效行
+     */
+    bool nextLine() {
+        while (cursor_ < end_) {
+            const char *newline = static_cast<const char *>(
+                    std::memchr(cursor_, '\n', static_cast<size_t>(end_ - cursor_)));
+            const char *lineEnd = newline ? newline : end_;
+
+            lineBegin_ = cursor_;
+            lineEnd_ = lineEnd;
+            cursor_ = newline ? newline + 1 : end_;
+            ++lineNumber_;
+
+            while (lineBegin_ < lineEnd_ && isSpace(*lineBegin_)) ++lineBegin_;
+            while (lineEnd_ > lineBegin_ && isSpace(lineEnd_[-1])) --lineEnd_;
+
+            if (lineBegin_ < lineEnd_ && *lineBegin_ != '#') {
+                pos_ = lineBegin_;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * 当前行是否以指定关键字开头（不区分大小写），匹配时跳过关键字
+     * @param keyword 大写关键字
+     * @return 是否匹配
+     */
+    bool consumeKeyword(const char *keyword) {
+        const size_t length = std::strlen(keyword);
+        if (static_cast<size_t>(lineEnd_ - lineBegin_) < length) {
+            return false;
+        }
+        for (size_t i = 0; i < length; ++i) {
+            char c = lineBegin_[i];
+            if (c >= 'a' && c <= 'z') c = static_cast<char>(c - 'a' + 'A');
+            if (c != keyword[i]) {
+                return false;
+            }
+        }
+        // 关键字后必须是空白或行尾，避免LUT_3D_SIZE匹配到LUT_3D_SIZE_X之类
+        if (lineBegin_ + length < lineEnd_ && !isSpace(lineBegin_[length])) {
+            return false;
+        }
+        pos_ = lineBegin_ + length;
+        return true;
+    }
+
+    /**
+     * 读取当前行的下一个浮点数
+     * @param value 输出值
+     * @return 是否成功
+     */
+    bool readFloat(float &value) {
+        const char *start = tokenStart();
+        if (!start) {
+            return false;
+        }
+        auto result = std::from_chars(start, lineEnd_, value);
+        return finishToken(result.ptr, result.ec);
+    }
+
+    /**
+     * 读取当前行的下一个整数
+     * @param value 输出值
+     * @return 是否成功
+     */
+    bool readInt(int &value) {
+        const char *start = tokenStart();
+        if (!start) {
+            return false;
+        }
+        auto result = std::from_chars(start, lineEnd_, value);
+        return finishToken(result.ptr, result.ec);
+    }
+
+    /**
+     * 当前行剩余的全部内容（已去除首尾空白），视图指向原始缓冲区
+     * @return 剩余内容
+     */
+    std::string_view rest() {
+        skipSpaces();
+        return std::string_view(pos_, static_cast<size_t>(lineEnd_ - pos_));
+    }
+
+    /**
+     * 当前行是否已没有更多词元
+     * @return 是否到达行尾
+     */
+    bool atLineEnd() {
+        skipSpaces();
+        return pos_ >= lineEnd_;
+    }
+
+    /**
+     * 当前行是否以数值开头（数据行），否则为关键字行
+     * @return 是否为数据行
+     */
+    bool lineStartsWithNumber() const {
+        const char c = *lineBegin_;
+        return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.';
+    }
+
+    /**
+     * 当前行号（从1开始，包含空行和注释行），用于错误日志
+     * @return 行号
+     */
+    size_t lineNumber() const {
+        return lineNumber_;
+    }
+
+private:
+    static bool isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v';
+    }
+
+    void skipSpaces() {
+        while (pos_ < lineEnd_ && isSpace(*pos_)) ++pos_;
+    }
+
+    /**
+     * 定位下一个词元的起点，from_chars不接受前导'+'，在此跳过
+     * @return 词元起点，行内没有更多词元时返回nullptr
+     */
+    const char *tokenStart() {
+        skipSpaces();
+        if (pos_ >= lineEnd_) {
+            return nullptr;
+        }
+        if (*pos_ == '+' && pos_ + 1 < lineEnd_) {
+            ++pos_;
+        }
+        return pos_;
+    }
+
+    /**
+     * 校验from_chars结果：词元必须完整解析到空白或行尾
+     */
+    bool finishToken(const char *ptr, std::errc ec) {
+        if (ec != std::errc() || (ptr < lineEnd_ && !isSpace(*ptr))) {
+            return false;
+        }
+        pos_ = ptr;
+        return true;
+    }
+
+    const char *cursor_;    // 下一行的起点
+    const char *end_;       // 缓冲区结束位置
+    const char *lineBegin_; // 当前行起点（已去除前导空白）
+    const char *lineEnd_;   // 当前行终点（已去除尾随空白）
+    const char *pos_;       // 当前行内的读取位置
+    size_t lineNumber_ = 0;
+};
+
+#endif // LUT_TOKENIZER_H
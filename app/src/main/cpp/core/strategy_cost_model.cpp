@@ -0,0 +1,271 @@
+#include "strategy_cost_model.h"
+#include "../utils/file_utils.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+/**
+ * 画像文件头，后接entryCount个StrategyProfileEntry
+ */
+struct StrategyProfileHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t entryCount;
+};
+
+static_assert(sizeof(StrategyProfileHeader) == 8, "StrategyProfileHeader布局必须固定");
+
+const char *strategyName(ProcessingStrategy strategy) {
+    return strategy == ProcessingStrategy::DIRECT ? "直接" : "分块";
+}
+
+} // namespace
+
+StrategyCostModel &StrategyCostModel::getInstance() {
+    static StrategyCostModel instance;
+    return instance;
+}
+
+void StrategyCostModel::setProfilePath(const std::string &path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (dirty_ && !profilePath_.empty() && profilePath_ != path) {
+        saveLocked();
+    }
+    profilePath_ = path;
+    if (!profilePath_.empty()) {
+        loadLocked();
+    }
+}
+
+std::string StrategyCostModel::getProfilePath() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return profilePath_;
+}
+
+size_t StrategyCostModel::directTransientPrior(int width, int height) {
+    return static_cast<size_t>(width) * height * 4;
+}
+
+StrategyProfileEntry *StrategyCostModel::findLocked(ProcessingStrategy strategy, int threadCount,
+                                                    int tileSize) {
+    for (auto &entry: entries_) {
+        if (entry.strategy == static_cast<uint8_t>(strategy) &&
+            entry.threadCount == static_cast<uint16_t>(threadCount) &&
+            entry.tileSize == static_cast<uint32_t>(tileSize)) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+StrategyChoice StrategyCostModel::choose(const StrategyQuery &query) {
+    const double megapixels = static_cast<double>(query.width) * query.height / 1e6;
+
+    StrategyChoice candidates[2];
+    candidates[0].strategy = ProcessingStrategy::DIRECT;
+    candidates[1].strategy = ProcessingStrategy::STREAMING;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        chooseCount_++;
+        for (StrategyChoice &candidate: candidates) {
+            const bool direct = candidate.strategy == ProcessingStrategy::DIRECT;
+            const StrategyProfileEntry *entry =
+                    direct ? findLocked(candidate.strategy, query.directThreads, 0)
+                           : findLocked(candidate.strategy, query.streamingThreads, query.tileSize);
+
+            size_t transient = direct ? directTransientPrior(query.width, query.height)
+                                      : query.streamingTransientPrior;
+            if (entry && entry->sampleCount > 0) {
+                candidate.predictedMs = entry->msPerMegapixel * megapixels;
+                transient = static_cast<size_t>(entry->peakTransientBytes);
+                // 落后的策略只有旧样本时会一直被排除，距上次记录满间隔时让它再运行一次；
+                // 运行后间隔重新计数，因此较慢的策略每个间隔只运行一次
+                const uint64_t lastSampled = lastSampled_[static_cast<int>(candidate.strategy)];
+                candidate.exploring = chooseCount_ - lastSampled >= RESAMPLE_INTERVAL;
+            } else {
+                candidate.exploring = true;
+            }
+            candidate.predictedPeakBytes = query.frameBytes + transient;
+        }
+    }
+
+    // 放得下的策略中，未校准的先运行一次，其余取预测最快的
+    const StrategyChoice *best = nullptr;
+    for (const StrategyChoice &candidate: candidates) {
+        if (candidate.predictedPeakBytes > query.memoryRoom) {
+            continue;
+        }
+        if (!best || (candidate.exploring && !best->exploring) ||
+            (candidate.exploring == best->exploring && !candidate.exploring &&
+             candidate.predictedMs < best->predictedMs)) {
+            best = &candidate;
+        }
+    }
+
+    // 都放不下时选峰值最小的，由准入控制器排队等待
+    if (!best) {
+        best = candidates[0].predictedPeakBytes < candidates[1].predictedPeakBytes
+               ? &candidates[0] : &candidates[1];
+    }
+
+    COST_LOGD("策略选择: %s, 预测耗时 %.1f ms, 预测峰值 %.2f MB, 内存余量 %.2f MB%s",
+              strategyName(best->strategy), best->predictedMs,
+              best->predictedPeakBytes / (1024.0 * 1024.0), query.memoryRoom / (1024.0 * 1024.0),
+              best->exploring ? "（校准）" : "");
+    return *best;
+}
+
+void StrategyCostModel::record(ProcessingStrategy strategy, int threadCount, int tileSize,
+                               double megapixels, double elapsedMs, size_t frameBytes,
+                               size_t scratchBytes) {
+    if (!(megapixels > 0.0) || !(elapsedMs > 0.0)) {
+        return;
+    }
+    const float msPerMegapixel = static_cast<float>(elapsedMs / megapixels);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    StrategyProfileEntry *entry = findLocked(strategy, threadCount, tileSize);
+    if (!entry) {
+        if (entries_.size() >= MAX_ENTRIES) {
+            // 淘汰样本最少的配置
+            auto victim = std::min_element(entries_.begin(), entries_.end(),
+                                           [](const StrategyProfileEntry &a,
+                                              const StrategyProfileEntry &b) {
+                                               return a.sampleCount < b.sampleCount;
+                                           });
+            entries_.erase(victim);
+        }
+        StrategyProfileEntry created;
+        created.strategy = static_cast<uint8_t>(strategy);
+        created.threadCount = static_cast<uint16_t>(threadCount);
+        created.tileSize = static_cast<uint32_t>(tileSize);
+        entries_.push_back(created);
+        entry = &entries_.back();
+    }
+
+    entry->msPerMegapixel = entry->sampleCount == 0
+                            ? msPerMegapixel
+                            : static_cast<float>(entry->msPerMegapixel * (1.0 - SMOOTHING) +
+                                                 msPerMegapixel * SMOOTHING);
+    // 图片缓冲区随每张图片变化，选择时按查询重新加上，画像只保存临时内存部分。
+    // 更大的样本立即采用，保证预留覆盖峰值；更小的样本只让峰值逐步回落
+    if (entry->sampleCount == 0 || scratchBytes >= entry->peakTransientBytes) {
+        entry->peakTransientBytes = scratchBytes;
+    } else {
+        entry->peakTransientBytes -= static_cast<uint64_t>(
+                (entry->peakTransientBytes - scratchBytes) * PEAK_DECAY);
+    }
+    entry->sampleCount++;
+    lastSampled_[static_cast<int>(strategy)] = chooseCount_;
+    dirty_ = true;
+
+    COST_LOGD("记录%s处理: %d 线程, 块 %d, %.1f ms/MP（平均 %.1f）, "
+              "内存峰值 %.2f MB（图片 %.2f MB + 临时 %.2f MB）, 临时内存画像 %.2f MB",
+              strategyName(strategy), threadCount, tileSize, msPerMegapixel,
+              entry->msPerMegapixel, (frameBytes + scratchBytes) / (1024.0 * 1024.0),
+              frameBytes / (1024.0 * 1024.0), scratchBytes / (1024.0 * 1024.0),
+              entry->peakTransientBytes / (1024.0 * 1024.0));
+
+    // 前几个样本立即保存，之后按间隔保存
+    const auto now = std::chrono::steady_clock::now();
+    if (!profilePath_.empty() && (entry->sampleCount <= 2 || now - lastFlush_ >= FLUSH_INTERVAL)) {
+        saveLocked();
+    }
+}
+
+bool StrategyCostModel::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (profilePath_.empty()) {
+        return false;
+    }
+    return !dirty_ || saveLocked();
+}
+
+void StrategyCostModel::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    dirty_ = false;
+    chooseCount_ = 0;
+    lastSampled_[0] = 0;
+    lastSampled_[1] = 0;
+}
+
+std::vector<StrategyProfileEntry> StrategyCostModel::getEntries() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_;
+}
+
+bool StrategyCostModel::loadLocked() {
+    FILE *file = fopen(profilePath_.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+
+    StrategyProfileHeader header;
+    std::vector<StrategyProfileEntry> loaded;
+    bool valid = fread(&header, sizeof(header), 1, file) == 1 &&
+                 std::memcmp(header.magic, PROFILE_MAGIC, sizeof(header.magic)) == 0 &&
+                 header.version == PROFILE_VERSION && header.entryCount <= MAX_ENTRIES;
+    if (valid) {
+        loaded.resize(header.entryCount);
+        valid = loaded.empty() ||
+                fread(loaded.data(), sizeof(StrategyProfileEntry), loaded.size(), file) ==
+                loaded.size();
+    }
+    fclose(file);
+
+    if (!valid) {
+        COST_LOGW("策略画像文件无效，忽略: %s", profilePath_.c_str());
+        return false;
+    }
+
+    // 逐项检查，损坏的项不交给选择与准入预留使用
+    const size_t total = loaded.size();
+    loaded.erase(std::remove_if(loaded.begin(), loaded.end(),
+                                [](const StrategyProfileEntry &entry) {
+                                    return !isEntryValid(entry);
+                                }),
+                 loaded.end());
+    if (loaded.size() != total) {
+        COST_LOGW("策略画像中 %zu 项无效，已丢弃", total - loaded.size());
+    }
+
+    entries_ = std::move(loaded);
+    dirty_ = false;
+    COST_LOGI("加载策略画像: %zu 项", entries_.size());
+    return true;
+}
+
+bool StrategyCostModel::isEntryValid(const StrategyProfileEntry &entry) {
+    const bool direct = entry.strategy == static_cast<uint8_t>(ProcessingStrategy::DIRECT);
+    const bool streaming = entry.strategy == static_cast<uint8_t>(ProcessingStrategy::STREAMING);
+    // NaN与任何值比较都为假，也会被拒绝
+    return (direct ? entry.tileSize == 0
+                   : streaming && entry.tileSize > 0 && entry.tileSize <= MAX_TILE_SIZE) &&
+           entry.threadCount > 0 && entry.threadCount <= MAX_THREADS &&
+           entry.sampleCount > 0 &&
+           entry.msPerMegapixel > 0.0f && entry.msPerMegapixel <= MAX_MS_PER_MEGAPIXEL &&
+           entry.peakTransientBytes <= MAX_TRANSIENT_BYTES;
+}
+
+bool StrategyCostModel::saveLocked() {
+    StrategyProfileHeader header;
+    std::memcpy(header.magic, PROFILE_MAGIC, sizeof(header.magic));
+    header.version = PROFILE_VERSION;
+    header.entryCount = static_cast<uint16_t>(entries_.size());
+
+    if (!FileUtils::writeAtomically(profilePath_,
+                                    {{&header, sizeof(header)},
+                                     {entries_.data(),
+                                      entries_.size() * sizeof(StrategyProfileEntry)}})) {
+        COST_LOGW("写入策略画像失败: %s", profilePath_.c_str());
+        return false;
+    }
+
+    dirty_ = false;
+    lastFlush_ = std::chrono::steady_clock::now();
+    return true;
+}
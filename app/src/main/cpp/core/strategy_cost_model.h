@@ -0,0 +1,164 @@
+#ifndef STRATEGY_COST_MODEL_H
+#define STRATEGY_COST_MODEL_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <android/log.h>
+
+#define COST_MODEL_TAG "StrategyCostModel"
+#define COST_LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, COST_MODEL_TAG, __VA_ARGS__)
+#define COST_LOGI(...) __android_log_print(ANDROID_LOG_INFO, COST_MODEL_TAG, __VA_ARGS__)
+#define COST_LOGW(...) __android_log_print(ANDROID_LOG_WARN, COST_MODEL_TAG, __VA_ARGS__)
+
+/**
+ * 处理策略
+ */
+enum class ProcessingStrategy : uint8_t {
+    DIRECT = 0,    // 整图一次处理
+    STREAMING = 1  // 分块处理
+};
+
+/**
+ * 一种运行配置的实测画像
+ * 同一策略在不同线程数与块尺寸下的速度差别很大，因此分开记录
+ */
+struct StrategyProfileEntry {
+    uint8_t strategy = 0;        // ProcessingStrategy
+    uint8_t reserved = 0;
+    uint16_t threadCount = 0;
+    uint32_t tileSize = 0;       // 块边长，直接处理为0
+    uint32_t sampleCount = 0;
+    float msPerMegapixel = 0.0f; // 指数滑动平均
+    uint64_t peakTransientBytes = 0; // 图片缓冲区之外的临时内存峰值，衰减最大值（见PEAK_DECAY）
+};
+
+static_assert(sizeof(StrategyProfileEntry) == 24, "StrategyProfileEntry布局必须固定");
+
+/**
+ * 一次选择所需的输入
+ */
+struct StrategyQuery {
+    int width = 0;
+    int height = 0;
+    size_t frameBytes = 0;       // 输入与输出缓冲区的总字节数（原地处理只算一份）
+    size_t memoryRoom = 0;       // 当前还能预留的内存
+    int directThreads = 1;       // 两种策略的并行度不同，分别作为画像的键
+    int streamingThreads = 1;
+    int tileSize = 0;            // 分块处理将使用的块边长
+    size_t streamingTransientPrior = 0; // 分块处理尚无实测时的临时内存估计
+};
+
+/**
+ * 选择结果
+ */
+struct StrategyChoice {
+    ProcessingStrategy strategy = ProcessingStrategy::STREAMING;
+    double predictedMs = -1.0;   // 无实测数据时为-1
+    size_t predictedPeakBytes = 0; // 图片缓冲区加临时内存，用于向准入控制器预留
+    bool exploring = false;      // 该配置尚无实测数据或到了重新测量的间隔，本次运行用于校准
+};
+
+/**
+ * 处理策略代价模型
+ * 每次处理结束后按（策略, 线程数, 块尺寸）记录实测的每百万像素耗时与临时内存峰值，
+ * 选择时在放得进当前内存余量的策略中取预测最快的一个，只跑一遍，不再先直接处理失败后再分块重跑。
+ * 尚无实测的配置只要放得下就优先运行一次以获得数据，较慢的一方也定期重新测量；
+ * 没有任何策略放得下时选择峰值最小的一个。
+ * 画像保存在缓存目录下的小文件中，应用重启后无需重新校准
+ */
+class StrategyCostModel {
+public:
+    static constexpr char PROFILE_MAGIC[4] = {'L', '2', 'P', 'S'};
+    static constexpr uint16_t PROFILE_VERSION = 1;
+    static constexpr size_t MAX_ENTRIES = 64;
+    static constexpr double SMOOTHING = 0.25; // 新样本在滑动平均中的权重
+    static constexpr uint32_t RESAMPLE_INTERVAL = 32; // 较慢的策略每隔这么多次选择重新测量一次
+    // 新样本低于临时内存峰值时，峰值每次向样本回落差值的这一比例，偶发的异常大任务不会永久抬高预留
+    static constexpr double PEAK_DECAY = 0.125;
+    // 画像文件中超出这些范围的项视为损坏，加载时丢弃
+    static constexpr uint16_t MAX_THREADS = 256;
+    static constexpr uint32_t MAX_TILE_SIZE = 16384;
+    static constexpr float MAX_MS_PER_MEGAPIXEL = 60000.0f;
+    static constexpr uint64_t MAX_TRANSIENT_BYTES = 16ULL * 1024 * 1024 * 1024;
+
+    static StrategyCostModel &getInstance();
+
+    /**
+     * 设置画像文件路径并加载其中的数据，空字符串表示只在内存中记录
+     */
+    void setProfilePath(const std::string &path);
+
+    std::string getProfilePath() const;
+
+    /**
+     * 选择策略
+     * @param query 图片尺寸、内存余量与运行配置
+     * @return 选择的策略及其预测
+     */
+    StrategyChoice choose(const StrategyQuery &query);
+
+    /**
+     * 记录一次成功处理的实测结果，满足间隔时写回画像文件
+     * @param strategy 实际使用的策略
+     * @param threadCount 线程数
+     * @param tileSize 块边长，直接处理为0
+     * @param megapixels 图片的百万像素数
+     * @param elapsedMs 耗时
+     * @param frameBytes 本次处理的输入与输出缓冲区字节数（原地处理只算一份）
+     * @param scratchBytes 本次处理在图片缓冲区之外实际使用的临时内存峰值
+     */
+    void record(ProcessingStrategy strategy, int threadCount, int tileSize,
+                double megapixels, double elapsedMs, size_t frameBytes, size_t scratchBytes);
+
+    /**
+     * 立即把未保存的数据写回画像文件
+     * @return 是否成功，未设置路径时返回false
+     */
+    bool flush();
+
+    /**
+     * 清空内存中的画像（不删除文件）
+     */
+    void clear();
+
+    std::vector<StrategyProfileEntry> getEntries() const;
+
+    /**
+     * 直接处理尚无实测时的临时内存估计：再加一份整图的处理缓冲区
+     */
+    static size_t directTransientPrior(int width, int height);
+
+private:
+    StrategyCostModel() = default;
+
+    StrategyCostModel(const StrategyCostModel &) = delete;
+
+    StrategyCostModel &operator=(const StrategyCostModel &) = delete;
+
+    StrategyProfileEntry *findLocked(ProcessingStrategy strategy, int threadCount, int tileSize);
+
+    bool loadLocked();
+
+    static bool isEntryValid(const StrategyProfileEntry &entry);
+
+    bool saveLocked();
+
+    // 写回文件的最短间隔，批处理时不必每张图片都写一次
+    static constexpr auto FLUSH_INTERVAL = std::chrono::seconds(30);
+
+    mutable std::mutex mutex_;
+    std::vector<StrategyProfileEntry> entries_;
+    std::string profilePath_;
+    bool dirty_ = false;
+    std::chrono::steady_clock::time_point lastFlush_;
+
+    // 选择次数与各策略最近一次记录样本时的选择序号（按ProcessingStrategy索引），只在内存中保存
+    uint64_t chooseCount_ = 0;
+    uint64_t lastSampled_[2] = {0, 0};
+};
+
+#endif // STRATEGY_COST_MODEL_H
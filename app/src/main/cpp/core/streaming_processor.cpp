@@ -1,10 +1,15 @@
 #include "streaming_processor.h"
 #include "lut_processor.h"
+#include "strategy_cost_model.h"
+#include "tile_autotuner.h"
+#include "../utils/thread_pool.h"
+#include "../utils/large_page_allocator.h"
 #include <algorithm>
 #include <thread>
 #include <future>
 #include <chrono>
 #include <cmath>
+#include <cstring>
 
 StreamingProcessor::StreamingProcessor() {
     imageProcessor_ = std::make_unique<ImageProcessor>();
@@ -12,7 +17,6 @@ StreamingProcessor::StreamingProcessor() {
 }
 
 StreamingProcessor::~StreamingProcessor() {
-    cleanupTileCache();
     STREAM_LOGI("流式处理器销毁，处理统计 - 总图片: %zu, 流式处理: %zu, 直接处理: %zu",
                 stats_.totalImagesProcessed, stats_.streamingProcessCount,
                 stats_.directProcessCount);
@@ -20,9 +24,9 @@ StreamingProcessor::~StreamingProcessor() {
 
 void StreamingProcessor::setConfig(const StreamingConfig &config) {
     config_ = config;
-    STREAM_LOGI("更新流式处理配置 - 最大块大小: %.2f MB, 重叠: %d px, 并发块数: %d",
+    STREAM_LOGI("更新流式处理配置 - 最大块大小: %.2f MB, 光晕: %d px, 内存预算: %.2f MB",
                 config_.maxTileSize / (1024.0 * 1024.0), config_.tileOverlap,
-                config_.maxConcurrentTiles);
+                config_.maxMemoryUsage / (1024.0 * 1024.0));
 }
 
 ProcessResult StreamingProcessor::processImageOptimized(
@@ -31,66 +35,99 @@ ProcessResult StreamingProcessor::processImageOptimized(
         const LutData &primaryLut,
         const LutData &secondaryLut,
         const ProcessingParams &params,
-        ProgressCallback progressCallback
+        ProgressCallback progressCallback,
+        StreamingCancelCallback cancelCallback
 ) {
     auto startTime = std::chrono::high_resolution_clock::now();
 
-    // 选择最优处理策略
-    auto strategy = ProcessingStrategySelector::selectOptimalStrategy(
-            input.width, input.height,
-            config_.maxMemoryUsage, params
-    );
+    // 本次任务的临时缓冲区都从这里分配，函数返回时一次性释放
+    JobArena arena;
+
+    // 按实测画像选择放得进当前内存余量的最快策略，并按其预测峰值预留，只处理一遍
+    MemoryAdmissionController &admission = MemoryAdmissionController::getInstance();
+    const AdmissionStats admissionStats = admission.getStats();
+    const size_t budget = admission.getBudget();
+    const TileLayout layout = computeTileLayout(input, params);
+    const int workerCount = ThreadPool::getInstance().getWorkerCount();
+
+    StrategyQuery query;
+    query.width = input.width;
+    query.height = input.height;
+    query.frameBytes = static_cast<size_t>(input.stride) * input.height;
+    if (output.pixels != input.pixels) {
+        query.frameBytes += static_cast<size_t>(output.stride) * output.height;
+    }
+    query.memoryRoom = budget > admissionStats.reservedBytes
+                       ? budget - admissionStats.reservedBytes : 0;
+    query.tileSize = layout.tileWidth;
+    query.streamingTransientPrior = streamingReservation(input.width, input.height);
+
+    const int directThreads = params.useMultiThreading ? workerCount + 1 : 1;
+    const int streamingThreads =
+            config_.enableParallelProcessing && layout.count() > 1 ? workerCount + 1 : 1;
+    query.directThreads = directThreads;
+    query.streamingThreads = streamingThreads;
+
+    StrategyCostModel &costModel = StrategyCostModel::getInstance();
+    StrategyChoice choice = costModel.choose(query);
+
+    // 准入控制器还会检查系统可用内存、内存压力与内存池，以及是否有任务在排队；
+    // 选中的策略不能立即准入时改选峰值更小的策略（即分块处理），再排队等待
+    MemoryAdmissionController::Reservation reservation =
+            admission.tryReserve(choice.predictedPeakBytes);
+    if (!reservation.isValid()) {
+        if (choice.predictedPeakBytes > 0) {
+            query.memoryRoom = std::min(query.memoryRoom, choice.predictedPeakBytes - 1);
+            choice = costModel.choose(query);
+        }
+        STREAM_LOGI("内存余量不足以立即准入，按%s策略排队（%.2f MB）",
+                    choice.strategy == ProcessingStrategy::DIRECT ? "直接" : "流式",
+                    choice.predictedPeakBytes / (1024.0 * 1024.0));
+        reservation = admission.reserve(choice.predictedPeakBytes, std::chrono::minutes(5),
+                                        cancelCallback);
+        if (!reservation.isValid()) {
+            return ProcessResult::ERROR_MEMORY_ALLOCATION;
+        }
+    }
+    const ProcessingStrategy strategy = choice.strategy;
 
+    const auto processStart = std::chrono::high_resolution_clock::now();
     ProcessResult result;
 
-    switch (strategy) {
-        case ProcessingStrategySelector::Strategy::DIRECT:
-            STREAM_LOGI("使用直接处理策略 - 图片尺寸: %dx%d", input.width, input.height);
-            result = processImageDirect(input, output, primaryLut, secondaryLut, params,
-                                        progressCallback);
-            stats_.directProcessCount++;
-            break;
-
-        case ProcessingStrategySelector::Strategy::STREAMING:
-            STREAM_LOGI("使用流式处理策略 - 图片尺寸: %dx%d", input.width, input.height);
-            result = processImageStreaming(input, output, primaryLut, secondaryLut, params,
-                                           [progressCallback](const StreamingProgress &progress) {
-                                               if (progressCallback) {
-                                                   progressCallback(
-                                                           static_cast<float>(progress.getProgress()),
-                                                           "流式处理中...");
-                                               }
-                                           });
-            stats_.streamingProcessCount++;
-            break;
-
-        case ProcessingStrategySelector::Strategy::HYBRID:
-            STREAM_LOGI("使用混合处理策略 - 图片尺寸: %dx%d", input.width, input.height);
-            // 对于混合策略，优先尝试直接处理，失败时回退到流式处理
-            result = processImageDirect(input, output, primaryLut, secondaryLut, params,
-                                        progressCallback);
-            if (result != ProcessResult::SUCCESS) {
-                STREAM_LOGW("直接处理失败，回退到流式处理");
-                result = processImageStreaming(input, output, primaryLut, secondaryLut, params,
-                                               [progressCallback](
-                                                       const StreamingProgress &progress) {
-                                                   if (progressCallback) {
-                                                       progressCallback(
-                                                               static_cast<float>(progress.getProgress()),
-                                                               "混合处理中...");
-                                                   }
-                                               });
-                stats_.streamingProcessCount++;
-            } else {
-                stats_.directProcessCount++;
-            }
-            break;
+    if (strategy == ProcessingStrategy::DIRECT) {
+        STREAM_LOGI("使用直接处理策略 - 图片尺寸: %dx%d", input.width, input.height);
+        result = processImageDirect(input, output, primaryLut, secondaryLut, params, arena,
+                                    progressCallback);
+        stats_.directProcessCount++;
+    } else {
+        STREAM_LOGI("使用流式处理策略 - 图片尺寸: %dx%d", input.width, input.height);
+        result = processTiled(input, output, primaryLut, secondaryLut, params, arena,
+                              [progressCallback](const StreamingProgress &progress) {
+                                  if (progressCallback) {
+                                      progressCallback(
+                                              static_cast<float>(progress.getProgress()),
+                                              "流式处理中...");
+                                  }
+                              }, cancelCallback);
+        stats_.streamingProcessCount++;
     }
 
     // 更新统计信息
     auto endTime = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration<double>(endTime - startTime).count();
 
+    // 只用成功的处理校准画像，耗时不含准入排队；
+    // 两种策略的临时缓冲区都从本次任务的arena分配，实际峰值为输入与输出加arena峰值
+    if (result == ProcessResult::SUCCESS) {
+        const double processMs =
+                std::chrono::duration<double, std::milli>(endTime - processStart).count();
+        const bool direct = strategy == ProcessingStrategy::DIRECT;
+        costModel.record(strategy, direct ? directThreads : streamingThreads,
+                         direct ? 0 : layout.tileWidth,
+                         static_cast<double>(input.width) * input.height / 1e6, processMs,
+                         query.frameBytes, arena.getPeakBytesReserved());
+    }
+
     stats_.totalImagesProcessed++;
     stats_.totalBytesProcessed += static_cast<size_t>(input.width) * input.height * 4;
     stats_.averageProcessingTime =
@@ -102,11 +139,10 @@ ProcessResult StreamingProcessor::processImageOptimized(
     double currentMemoryUsage =
             static_cast<double>(poolStats.totalAllocated) / config_.maxMemoryUsage;
     stats_.peakMemoryUsage = std::max(stats_.peakMemoryUsage, currentMemoryUsage);
+    recordJobMemory(arena);
 
     STREAM_LOGI("图片处理完成 - 耗时: %.2fs, 策略: %s, 内存使用: %.1f%%",
-                duration,
-                strategy == ProcessingStrategySelector::Strategy::DIRECT ? "直接" :
-                strategy == ProcessingStrategySelector::Strategy::STREAMING ? "流式" : "混合",
+                duration, strategy == ProcessingStrategy::DIRECT ? "直接" : "流式",
                 currentMemoryUsage * 100);
 
     return result;
@@ -120,6 +156,37 @@ ProcessResult StreamingProcessor::processImageStreaming(
         const ProcessingParams &params,
         StreamingProgressCallback progressCallback,
         StreamingCancelCallback cancelCallback
+) {
+    MemoryAdmissionController::Reservation reservation =
+            MemoryAdmissionController::getInstance().reserve(
+                    streamingReservation(input.width, input.height),
+                    std::chrono::minutes(5), cancelCallback);
+    if (!reservation.isValid()) {
+        return ProcessResult::ERROR_MEMORY_ALLOCATION;
+    }
+
+    JobArena arena;
+    ProcessResult result = processTiled(input, output, primaryLut, secondaryLut, params, arena,
+                                        progressCallback, cancelCallback);
+    recordJobMemory(arena);
+    return result;
+}
+
+void StreamingProcessor::recordJobMemory(const JobArena &arena) {
+    const size_t peak = arena.getPeakBytesReserved();
+    stats_.peakJobMemory = std::max(stats_.peakJobMemory, peak);
+    STREAM_LOGD("任务内存峰值: %.2f MB", peak / (1024.0 * 1024.0));
+}
+
+ProcessResult StreamingProcessor::processTiled(
+        const ImageInfo &input,
+        ImageInfo &output,
+        const LutData &primaryLut,
+        const LutData &secondaryLut,
+        const ProcessingParams &params,
+        JobArena &arena,
+        StreamingProgressCallback progressCallback,
+        StreamingCancelCallback cancelCallback
 ) {
     std::lock_guard<std::mutex> lock(processingMutex_);
     isProcessing_ = true;
@@ -128,34 +195,33 @@ ProcessResult StreamingProcessor::processImageStreaming(
                 input.width, input.height,
                 estimateMemoryRequirement(input.width, input.height) / (1024.0 * 1024.0));
 
-    // 创建分块
-    auto inputTiles = createTiles(input);
-    std::vector<ImageTile> outputTiles(inputTiles.size());
+    // 只计算分块布局，块在取块阶段按需生成
+    const TileLayout layout = computeTileLayout(input, params);
 
-    STREAM_LOGI("创建了 %zu 个处理块", inputTiles.size());
+    STREAM_LOGI("分块布局: %dx%d 个块", layout.columns, layout.rows);
+
+    TileScratchSlots scratch(arena, scratchSlotSize(layout, input));
+
+    // 块按行优先顺序读取原图，整帧大小的输入提示内核顺序预读，处理结束后恢复
+    const size_t inputBytes = static_cast<size_t>(input.stride) * input.height;
+    const bool adviseInput = LargePageAllocator::shouldUse(inputBytes);
+    if (adviseInput) {
+        LargePageAllocator::adviseSequential(input.pixels, inputBytes);
+    }
 
     ProcessResult result;
 
     // 根据配置选择处理方式
-    if (config_.enableParallelProcessing && inputTiles.size() > 1) {
-        result = processParallel(inputTiles, outputTiles, primaryLut, secondaryLut, params,
-                                 progressCallback, cancelCallback);
+    if (config_.enableParallelProcessing && layout.count() > 1) {
+        result = processPipelined(layout, input, output, primaryLut, secondaryLut, params, arena,
+                                  scratch, progressCallback, cancelCallback);
     } else {
-        result = processSequential(inputTiles, outputTiles, primaryLut, secondaryLut, params,
-                                   progressCallback, cancelCallback);
+        result = processSequential(layout, input, output, primaryLut, secondaryLut, params,
+                                   scratch, progressCallback, cancelCallback);
     }
 
-    // 合成最终结果
-    if (result == ProcessResult::SUCCESS) {
-        result = assembleTiles(outputTiles, output);
-    }
-
-    // 清理分块数据
-    for (auto &tile: inputTiles) {
-        deallocateTileData(tile);
-    }
-    for (auto &tile: outputTiles) {
-        deallocateTileData(tile);
+    if (adviseInput) {
+        LargePageAllocator::adviseSequential(input.pixels, inputBytes, false);
     }
 
     isProcessing_ = false;
@@ -168,16 +234,10 @@ ProcessResult StreamingProcessor::processImageDirect(
         const LutData &primaryLut,
         const LutData &secondaryLut,
         const ProcessingParams &params,
+        JobArena &arena,
         ProgressCallback progressCallback
 ) {
-    // 检查内存是否足够进行直接处理
-    size_t requiredMemory = estimateMemoryRequirement(input.width, input.height);
-    if (requiredMemory > config_.maxMemoryUsage) {
-        STREAM_LOGW("内存不足进行直接处理，需要: %.2f MB, 可用: %.2f MB",
-                    requiredMemory / (1024.0 * 1024.0),
-                    config_.maxMemoryUsage / (1024.0 * 1024.0));
-        return ProcessResult::ERROR_MEMORY_ALLOCATION;
-    }
+    // 内存是否足够已在选择策略时由准入控制器按实测峰值判断
 
     // 创建NativeProgressCallback适配器
     NativeProgressCallback nativeCallback = nullptr;
@@ -195,265 +255,390 @@ ProcessResult StreamingProcessor::processImageDirect(
     // 使用标准图像处理器进行处理
     if (params.useMultiThreading) {
         return imageProcessor_->processMultiThreaded(input, output, primaryLut, secondaryLut,
-                                                     params, nativeCallback);
+                                                     params, nativeCallback, &arena);
     } else {
         return imageProcessor_->processSingleThreaded(input, output, primaryLut, secondaryLut,
                                                       params, nativeCallback);
     }
 }
 
-std::vector<ImageTile> StreamingProcessor::createTiles(const ImageInfo &image) const {
-    std::vector<ImageTile> tiles;
+TileLayout StreamingProcessor::computeTileLayout(
+        const ImageInfo &image,
+        const ProcessingParams &params
+) const {
+    TileLayout layout;
 
     // 计算最优分块尺寸
-    int tileWidth, tileHeight;
     size_t pixelsPerTile = config_.maxTileSize / 4; // RGBA = 4 bytes per pixel
 
     // 尝试创建正方形块
     int tileSide = static_cast<int>(std::sqrt(pixelsPerTile));
+    if (config_.autoTuneTileSize) {
+        const TileTuning tuning = TileAutotuner::getInstance().getTuning();
+        if (tuning.tuned) {
+            tileSide = std::min(tileSide, tuning.tileSide);
+        }
+    }
     tileSide = std::min(tileSide, std::min(image.width, image.height));
     tileSide = std::max(tileSide, config_.minTileSize);
 
-    tileWidth = std::min(tileSide, image.width);
-    tileHeight = std::min(tileSide, image.height);
-
-    STREAM_LOGD("计算分块尺寸: %dx%d, 重叠: %d px", tileWidth, tileHeight, config_.tileOverlap);
-
-    // 创建分块
-    for (int y = 0; y < image.height; y += tileHeight - config_.tileOverlap) {
-        for (int x = 0; x < image.width; x += tileWidth - config_.tileOverlap) {
-            ImageTile tile;
-            tile.originalX = x;
-            tile.originalY = y;
-            tile.x = 0;
-            tile.y = 0;
-            tile.width = std::min(tileWidth, image.width - x);
-            tile.height = std::min(tileHeight, image.height - y);
-            tile.dataSize = static_cast<size_t>(tile.width) * tile.height * 4;
-
-            // 分配块数据
-            if (allocateTileData(tile)) {
-                // 复制像素数据
-                const uint8_t *srcPixels = static_cast<const uint8_t *>(image.pixels);
-                uint8_t *dstPixels = static_cast<uint8_t *>(tile.data);
-
-                for (int row = 0; row < tile.height; ++row) {
-                    const uint8_t *srcRow = srcPixels + ((y + row) * image.stride) + (x * 4);
-                    uint8_t *dstRow = dstPixels + (row * tile.width * 4);
-                    std::memcpy(dstRow, srcRow, tile.width * 4);
-                }
+    layout.tileWidth = std::max(1, std::min(tileSide, image.width));
+    layout.tileHeight = std::max(1, std::min(tileSide, image.height));
 
-                tiles.push_back(tile);
-            } else {
-                STREAM_LOGE("分配块数据失败: %dx%d", tile.width, tile.height);
-            }
-        }
+    // 逐点处理的块直接读写原图，互不重叠；Floyd-Steinberg误差从上方与左右两侧扩散进来，
+    // 因此在这三个方向上加光晕，使块内误差在输出区域之前已经积累，
+    // 另在下方多处理一行，因为抖动不处理区域的最后一行
+    layout.halo = params.ditherType == 1 ? std::max(config_.tileOverlap, 0) : 0;
+
+    layout.columns = (image.width + layout.tileWidth - 1) / layout.tileWidth;
+    layout.rows = (image.height + layout.tileHeight - 1) / layout.tileHeight;
+
+    STREAM_LOGD("计算分块尺寸: %dx%d, 光晕: %d px", layout.tileWidth, layout.tileHeight,
+                layout.halo);
+
+    return layout;
+}
+
+ImageTile StreamingProcessor::fetchTile(
+        const TileLayout &layout,
+        const ImageInfo &image,
+        int index
+) const {
+    const int x = (index % layout.columns) * layout.tileWidth;
+    const int y = (index / layout.columns) * layout.tileHeight;
+
+    ImageTile tile;
+    tile.originalX = x;
+    tile.originalY = y;
+    tile.width = std::min(layout.tileWidth, image.width - x);
+    tile.height = std::min(layout.tileHeight, image.height - y);
+    tile.dataSize = static_cast<size_t>(tile.width) * tile.height * 4;
+
+    tile.x = std::min(layout.halo, x);
+    tile.y = std::min(layout.halo, y);
+    const int rightHalo = std::min(layout.halo, image.width - x - tile.width);
+    const int bottomHalo = std::min(layout.halo > 0 ? 1 : 0, image.height - y - tile.height);
+    tile.regionWidth = tile.x + tile.width + rightHalo;
+    tile.regionHeight = tile.y + tile.height + bottomHalo;
+
+    return tile;
+}
+
+size_t StreamingProcessor::tileMemoryCost(const ImageTile &tile) const {
+    const size_t regionSize = static_cast<size_t>(tile.regionWidth) * tile.regionHeight * 4;
+    return regionSize + tile.dataSize + (tile.needsScratch() ? regionSize : 0);
+}
+
+size_t StreamingProcessor::scratchSlotSize(const TileLayout &layout,
+                                           const ImageInfo &image) const {
+    if (layout.halo == 0) {
+        return 0;
     }
+    // 处理区域最大为左右各加光晕、上方加光晕且下方加一行
+    const int regionWidth = std::min(layout.tileWidth + 2 * layout.halo, image.width);
+    const int regionHeight = std::min(layout.tileHeight + layout.halo + 1, image.height);
+    return static_cast<size_t>(regionWidth) * regionHeight * 4;
+}
 
-    return tiles;
+TileScratchSlots::TileScratchSlots(JobArena &arena, size_t slotSize)
+        : arena_(arena), slotSize_(slotSize) {
 }
 
-bool StreamingProcessor::allocateTileData(ImageTile &tile) const {
-    tile.data = MemoryPool::getInstance().allocate(tile.dataSize, 32);
-    return tile.data != nullptr;
+void *TileScratchSlots::acquire() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!freeSlots_.empty()) {
+            void *slot = freeSlots_.back();
+            freeSlots_.pop_back();
+            return slot;
+        }
+    }
+    return arena_.allocate(slotSize_);
 }
 
-void StreamingProcessor::deallocateTileData(ImageTile &tile) const {
-    if (tile.data) {
-        MemoryPool::getInstance().deallocate(tile.data);
-        tile.data = nullptr;
+void TileScratchSlots::release(void *slot) {
+    if (slot) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        freeSlots_.push_back(slot);
     }
 }
 
-ProcessResult StreamingProcessor::processParallel(
-        const std::vector<ImageTile> &inputTiles,
-        std::vector<ImageTile> &outputTiles,
+ProcessResult StreamingProcessor::processPipelined(
+        const TileLayout &layout,
+        const ImageInfo &input,
+        ImageInfo &output,
         const LutData &primaryLut,
         const LutData &secondaryLut,
         const ProcessingParams &params,
+        JobArena &arena,
+        TileScratchSlots &scratch,
         StreamingProgressCallback progressCallback,
         StreamingCancelCallback cancelCallback
 ) {
-    const int maxConcurrent = std::min(config_.maxConcurrentTiles,
-                                       static_cast<int>(inputTiles.size()));
-    std::vector<std::future<ProcessResult>> futures;
-    std::atomic<int> completedTiles{0};
-
-    STREAM_LOGI("开始并行处理 - 并发数: %d, 总块数: %zu", maxConcurrent, inputTiles.size());
-
-    // 分批处理块
-    for (size_t i = 0; i < inputTiles.size(); i += maxConcurrent) {
-        futures.clear();
-
-        // 启动当前批次的处理
-        size_t batchEnd = std::min(i + maxConcurrent, inputTiles.size());
-        for (size_t j = i; j < batchEnd; ++j) {
-            // 为输出块分配内存
-            outputTiles[j] = inputTiles[j]; // 复制基本信息
-            if (!allocateTileData(outputTiles[j])) {
-                STREAM_LOGE("分配输出块数据失败: %zu", j);
-                return ProcessResult::ERROR_MEMORY_ALLOCATION;
-            }
-
-            // 异步处理块
-            futures.push_back(std::async(std::launch::async,
-                                         [this, &inputTiles, &outputTiles, &primaryLut, &secondaryLut, &params, j]() {
-                                             return processTile(inputTiles[j], outputTiles[j],
-                                                                primaryLut, secondaryLut, params);
-                                         }));
+    const int totalTiles = layout.count();
+    const size_t totalBytes = static_cast<size_t>(input.width) * input.height * 4;
+    const size_t memoryBudget = config_.maxMemoryUsage;
+    // 提交给线程池的块数不超过工作线程数，调用线程自己也处理块
+    const int maxQueuedTiles = std::max(1, ThreadPool::getInstance().getWorkerCount());
+
+    // 处理阶段完成的块，由调用线程在退块阶段回收
+    struct CompletedTile {
+        size_t cost;
+        size_t dataSize;
+        ProcessResult result;
+    };
+    // 同时完成的块不超过提交数，两个列表预先从任务内存中分配好容量，之后不再扩容
+    using CompletedList = std::vector<CompletedTile, ArenaAllocator<CompletedTile>>;
+    std::mutex completedMutex;
+    std::condition_variable completedCondition;
+    CompletedList completedTiles{ArenaAllocator<CompletedTile>(arena)};
+    CompletedList completed{ArenaAllocator<CompletedTile>(arena)};
+    completedTiles.reserve(maxQueuedTiles);
+    completed.reserve(maxQueuedTiles);
+
+    STREAM_LOGI("开始流水线处理 - 内存预算: %.2f MB, 总块数: %d",
+                memoryBudget / (1024.0 * 1024.0), totalTiles);
+
+    int nextTile = 0;
+    int queuedTiles = 0;
+    int retiredTiles = 0;
+    size_t inFlightBytes = 0;
+    size_t processedBytes = 0;
+    size_t peakInFlightBytes = 0;
+    ProcessResult result = ProcessResult::SUCCESS;
+    bool stopFetching = false;
+
+    auto runTile = [this, &input, &output, &primaryLut, &secondaryLut, &params, &scratch](
+            const ImageTile &tile) {
+        try {
+            return processTile(tile, input, output, primaryLut, secondaryLut, params, scratch);
+        } catch (const std::exception &e) {
+            STREAM_LOGE("块处理异常: %s", e.what());
+            return ProcessResult::ERROR_PROCESSING_FAILED;
         }
-
-        // 等待当前批次完成
-        for (size_t j = 0; j < futures.size(); ++j) {
-            ProcessResult result = futures[j].get();
-            if (result != ProcessResult::SUCCESS) {
-                STREAM_LOGE("块处理失败: %zu", i + j);
-                return result;
+    };
+
+    // 退块阶段：回收预算、通知进度并检查取消，第一个错误之后不再取新块
+    auto retireTile = [&](const CompletedTile &completed) {
+        inFlightBytes -= completed.cost;
+        processedBytes += completed.dataSize;
+        retiredTiles++;
+
+        if (completed.result != ProcessResult::SUCCESS) {
+            if (result == ProcessResult::SUCCESS) {
+                STREAM_LOGE("块处理失败，已完成 %d/%d", retiredTiles, totalTiles);
+                result = completed.result;
             }
+            stopFetching = true;
+            return;
+        }
 
-            completedTiles++;
+        reportProgress(progressCallback, retiredTiles, totalTiles, processedBytes, totalBytes);
 
-            // 更新进度
-            if (progressCallback) {
-                StreamingProgress progress;
-                progress.processedTiles = completedTiles.load();
-                progress.totalTiles = static_cast<int>(inputTiles.size());
-                progress.processedBytes =
-                        static_cast<size_t>(completedTiles.load()) * inputTiles[0].dataSize;
-                progress.totalBytes = inputTiles.size() * inputTiles[0].dataSize;
+        if (!stopFetching && cancelCallback && cancelCallback()) {
+            STREAM_LOGI("处理被用户取消");
+            result = ProcessResult::ERROR_PROCESSING_FAILED;
+            stopFetching = true;
+        }
+    };
+
+    // 预算允许时至少要有一个块在处理，保证单个块超出预算时仍能推进
+    auto canFetch = [&](size_t cost) {
+        return !stopFetching && nextTile < totalTiles &&
+               (inFlightBytes == 0 || inFlightBytes + cost <= memoryBudget);
+    };
+
+    while (true) {
+        // 取块阶段：在预算内不断把新块交给线程池
+        while (queuedTiles < maxQueuedTiles && nextTile < totalTiles) {
+            ImageTile tile = fetchTile(layout, input, nextTile);
+            const size_t cost = tileMemoryCost(tile);
+            if (!canFetch(cost)) {
+                break;
+            }
 
-                auto poolStats = MemoryPool::getInstance().getStats();
-                progress.memoryUsage =
-                        static_cast<double>(poolStats.totalAllocated) / config_.maxMemoryUsage;
+            nextTile++;
+            queuedTiles++;
+            inFlightBytes += cost;
+            peakInFlightBytes = std::max(peakInFlightBytes, inFlightBytes);
+
+            // 各块输出区域互不重叠，可以直接写入输出图片
+            ThreadPool::getInstance().submit(
+                    [&, tile, cost]() {
+                        ProcessResult tileResult = runTile(tile);
+                        std::lock_guard<std::mutex> lock(completedMutex);
+                        completedTiles.push_back({cost, tile.dataSize, tileResult});
+                        completedCondition.notify_one();
+                    });
+        }
 
-                progressCallback(progress);
+        // 线程池已满但预算仍有余量时，调用线程自己处理一个块，而不是空等
+        bool processedInline = false;
+        if (nextTile < totalTiles) {
+            ImageTile tile = fetchTile(layout, input, nextTile);
+            const size_t cost = tileMemoryCost(tile);
+            if (canFetch(cost)) {
+                nextTile++;
+                inFlightBytes += cost;
+                peakInFlightBytes = std::max(peakInFlightBytes, inFlightBytes);
+                retireTile({cost, tile.dataSize, runTile(tile)});
+                processedInline = true;
             }
+        }
 
-            // 检查取消请求
-            if (cancelCallback && cancelCallback()) {
-                STREAM_LOGI("处理被用户取消");
-                return ProcessResult::ERROR_PROCESSING_FAILED;
+        // 退块阶段
+        completed.clear();
+        {
+            std::unique_lock<std::mutex> lock(completedMutex);
+            if (!processedInline) {
+                if (queuedTiles == 0) {
+                    break; // 没有在处理的块，也不能再取新块
+                }
+                completedCondition.wait(lock, [&]() { return !completedTiles.empty(); });
             }
+            completed.swap(completedTiles);
         }
-
-        // 检查内存压力
-        if (checkMemoryPressure()) {
-            STREAM_LOGW("检测到内存压力，触发优化");
-            optimizeMemoryUsage();
+        for (const auto &tile: completed) {
+            queuedTiles--;
+            retireTile(tile);
         }
     }
 
-    return ProcessResult::SUCCESS;
+    STREAM_LOGI("流水线处理结束 - 完成 %d/%d 块, 工作集峰值: %.2f MB", retiredTiles, totalTiles,
+                peakInFlightBytes / (1024.0 * 1024.0));
+
+    return result;
 }
 
 ProcessResult StreamingProcessor::processSequential(
-        const std::vector<ImageTile> &inputTiles,
-        std::vector<ImageTile> &outputTiles,
+        const TileLayout &layout,
+        const ImageInfo &input,
+        ImageInfo &output,
         const LutData &primaryLut,
         const LutData &secondaryLut,
         const ProcessingParams &params,
+        TileScratchSlots &scratch,
         StreamingProgressCallback progressCallback,
         StreamingCancelCallback cancelCallback
 ) {
-    STREAM_LOGI("开始串行处理 - 总块数: %zu", inputTiles.size());
+    const int totalTiles = layout.count();
+    const size_t totalBytes = static_cast<size_t>(input.width) * input.height * 4;
+    size_t processedBytes = 0;
 
-    for (size_t i = 0; i < inputTiles.size(); ++i) {
-        // 为输出块分配内存
-        outputTiles[i] = inputTiles[i];
-        if (!allocateTileData(outputTiles[i])) {
-            STREAM_LOGE("分配输出块数据失败: %zu", i);
-            return ProcessResult::ERROR_MEMORY_ALLOCATION;
-        }
+    STREAM_LOGI("开始串行处理 - 总块数: %d", totalTiles);
 
+    for (int i = 0; i < totalTiles; ++i) {
         // 处理块
-        ProcessResult result = processTile(inputTiles[i], outputTiles[i], primaryLut, secondaryLut,
-                                           params);
+        const ImageTile tile = fetchTile(layout, input, i);
+        ProcessResult result = processTile(tile, input, output, primaryLut, secondaryLut, params,
+                                           scratch);
         if (result != ProcessResult::SUCCESS) {
-            STREAM_LOGE("块处理失败: %zu", i);
+            STREAM_LOGE("块处理失败: %d", i);
             return result;
         }
 
         // 更新进度
-        if (progressCallback) {
-            StreamingProgress progress;
-            progress.processedTiles = static_cast<int>(i + 1);
-            progress.totalTiles = static_cast<int>(inputTiles.size());
-            progress.processedBytes = (i + 1) * inputTiles[0].dataSize;
-            progress.totalBytes = inputTiles.size() * inputTiles[0].dataSize;
-
-            auto poolStats = MemoryPool::getInstance().getStats();
-            progress.memoryUsage =
-                    static_cast<double>(poolStats.totalAllocated) / config_.maxMemoryUsage;
-
-            progressCallback(progress);
-        }
+        processedBytes += tile.dataSize;
+        reportProgress(progressCallback, i + 1, totalTiles, processedBytes, totalBytes);
 
         // 检查取消请求
         if (cancelCallback && cancelCallback()) {
             STREAM_LOGI("处理被用户取消");
             return ProcessResult::ERROR_PROCESSING_FAILED;
         }
-
-        // 定期检查内存压力
-        if (i % 4 == 0 && checkMemoryPressure()) {
-            STREAM_LOGW("检测到内存压力，触发优化");
-            optimizeMemoryUsage();
-        }
     }
 
     return ProcessResult::SUCCESS;
 }
 
+void StreamingProcessor::reportProgress(
+        const StreamingProgressCallback &progressCallback,
+        int processedTiles,
+        int totalTiles,
+        size_t processedBytes,
+        size_t totalBytes
+) const {
+    if (!progressCallback) {
+        return;
+    }
+
+    StreamingProgress progress;
+    progress.processedTiles = processedTiles;
+    progress.totalTiles = totalTiles;
+    progress.processedBytes = processedBytes;
+    progress.totalBytes = totalBytes;
+
+    auto poolStats = MemoryPool::getInstance().getStats();
+    progress.memoryUsage = static_cast<double>(poolStats.totalAllocated) / config_.maxMemoryUsage;
+
+    progressCallback(progress);
+}
+
 ProcessResult StreamingProcessor::processTile(
-        const ImageTile &inputTile,
-        ImageTile &outputTile,
+        const ImageTile &tile,
+        const ImageInfo &input,
+        ImageInfo &output,
         const LutData &primaryLut,
         const LutData &secondaryLut,
-        const ProcessingParams &params
+        const ProcessingParams &params,
+        TileScratchSlots &scratch
 ) {
-    // 创建临时ImageInfo结构
-    ImageInfo inputInfo, outputInfo;
-
-    inputInfo.width = inputTile.width;
-    inputInfo.height = inputTile.height;
-    inputInfo.stride = inputTile.width * 4;
-    inputInfo.format = ANDROID_BITMAP_FORMAT_RGBA_8888;
-    inputInfo.pixels = inputTile.data;
-    inputInfo.pixelSize = inputTile.dataSize;
-
-    outputInfo = inputInfo;
-    outputInfo.pixels = outputTile.data;
-
-    // 使用单线程处理（块已经足够小）
-    return imageProcessor_->processSingleThreaded(inputInfo, outputInfo, primaryLut, secondaryLut,
-                                                  params, nullptr);
-}
-
-ProcessResult StreamingProcessor::assembleTiles(
-        const std::vector<ImageTile> &tiles,
-        ImageInfo &output
-) const {
-    STREAM_LOGI("开始合成 %zu 个块到最终图片", tiles.size());
+    // 处理区域在原图中的起点（含光晕）
+    const int regionX = tile.originalX - tile.x;
+    const int regionY = tile.originalY - tile.y;
+
+    // 输入为原图上的跨度视图
+    ImageInfo inputInfo;
+    inputInfo.width = tile.regionWidth;
+    inputInfo.height = tile.regionHeight;
+    inputInfo.stride = input.stride;
+    inputInfo.format = input.format;
+    inputInfo.pixels = static_cast<uint8_t *>(input.pixels) +
+                       static_cast<size_t>(regionY) * input.stride + regionX * 4;
+    inputInfo.pixelSize = static_cast<size_t>(tile.regionWidth) * tile.regionHeight * 4;
+
+    // 有序抖动按整图坐标取阈值，保证块之间图案连续
+    ProcessingParams tileParams = params;
+    tileParams.ditherOriginX = params.ditherOriginX + regionX;
+    tileParams.ditherOriginY = params.ditherOriginY + regionY;
+
+    uint8_t *outputRegion = static_cast<uint8_t *>(output.pixels) +
+                            static_cast<size_t>(tile.originalY) * output.stride +
+                            tile.originalX * 4;
+
+    ImageInfo outputInfo = inputInfo;
+    if (!tile.needsScratch()) {
+        // 逐点处理直接写入输出图片（使用单线程处理，块已经足够小）
+        outputInfo.stride = output.stride;
+        outputInfo.pixels = outputRegion;
+        return imageProcessor_->processSingleThreaded(inputInfo, outputInfo, primaryLut,
+                                                      secondaryLut, tileParams, nullptr);
+    }
 
-    uint8_t *outputPixels = static_cast<uint8_t *>(output.pixels);
+    // 带光晕的块先处理到暂存区槽位，再只把输出区域写回
+    outputInfo.stride = tile.regionWidth * 4;
+    outputInfo.pixels = scratch.acquire();
+    if (!outputInfo.pixels) {
+        STREAM_LOGE("分配暂存块失败: %dx%d", tile.regionWidth, tile.regionHeight);
+        return ProcessResult::ERROR_MEMORY_ALLOCATION;
+    }
 
-    for (const auto &tile: tiles) {
-        const uint8_t *tilePixels = static_cast<const uint8_t *>(tile.data);
+    ProcessResult result = imageProcessor_->processSingleThreaded(
+            inputInfo, outputInfo, primaryLut, secondaryLut, tileParams, nullptr);
 
-        // 复制块数据到输出图片
+    if (result == ProcessResult::SUCCESS) {
+        const uint8_t *scratchPixels = static_cast<const uint8_t *>(outputInfo.pixels);
         for (int row = 0; row < tile.height; ++row) {
-            int outputRow = tile.originalY + row;
-            if (outputRow >= output.height) break;
-
-            const uint8_t *srcRow = tilePixels + (row * tile.width * 4);
-            uint8_t *dstRow = outputPixels + (outputRow * output.stride) + (tile.originalX * 4);
-
-            int copyWidth = std::min(tile.width, output.width - tile.originalX);
-            std::memcpy(dstRow, srcRow, copyWidth * 4);
+            const uint8_t *srcRow = scratchPixels +
+                                    static_cast<size_t>(tile.y + row) * outputInfo.stride +
+                                    tile.x * 4;
+            std::memcpy(outputRegion + static_cast<size_t>(row) * output.stride, srcRow,
+                        tile.width * 4);
         }
     }
 
-    return ProcessResult::SUCCESS;
+    scratch.release(outputInfo.pixels);
+    return result;
 }
 
 bool StreamingProcessor::shouldUseStreamingForImage(int width, int height) const {
@@ -467,87 +652,176 @@ size_t StreamingProcessor::estimateMemoryRequirement(int width, int height) cons
     return imageSize * 3; // 3倍安全系数
 }
 
-bool StreamingProcessor::checkMemoryPressure() const {
-    auto poolStats = MemoryPool::getInstance().getStats();
-    double usage = static_cast<double>(poolStats.totalAllocated) / config_.maxMemoryUsage;
-    return usage > config_.memoryPressureThreshold;
+size_t StreamingProcessor::streamingReservation(int width, int height) const {
+    return std::min(config_.maxMemoryUsage, estimateMemoryRequirement(width, height));
 }
 
 void StreamingProcessor::optimizeMemoryUsage() {
     // 清理内存池
     MemoryPool::getInstance().cleanup(false);
 
-    // 清理块缓存
-    cleanupTileCache();
-
     STREAM_LOGI("内存优化完成");
 }
 
-void StreamingProcessor::cleanupTileCache() {
-    tileCache_.clear();
-}
-
 void StreamingProcessor::resetStats() {
     stats_ = ProcessingStats{};
     STREAM_LOGI("处理统计已重置");
 }
 
-// ProcessingStrategySelector 实现
-ProcessingStrategySelector::Strategy ProcessingStrategySelector::selectOptimalStrategy(
-        int width, int height,
-        size_t availableMemory,
-        const ProcessingParams &params
-) {
-    (void) params; // 抑制未使用参数警告
-    size_t directMemory = calculateDirectMemoryRequirement(width, height);
+// StripStreamingSession 实现
+StripStreamingSession::StripStreamingSession(
+        int width,
+        int height,
+        const LutData &primaryLut,
+        const LutData &secondaryLut,
+        const ProcessingParams &params,
+        StripSinkCallback sink
+) : width_(width),
+    height_(height),
+    primaryLut_(primaryLut),
+    secondaryLut_(secondaryLut),
+    params_(params),
+    sink_(std::move(sink)),
+    bufferStride_(width * 4) {
+    STREAM_LOGI("开始行带流式处理 - 图片尺寸: %dx%d", width_, height_);
+}
+
+StripStreamingSession::~StripStreamingSession() {
+    releaseBuffer();
+}
 
-    // 如果直接处理内存需求在可用内存的70%以内，使用直接处理
-    if (directMemory <= availableMemory * 0.7) {
-        return Strategy::DIRECT;
+ProcessResult StripStreamingSession::pushRows(const ImageInfo &rows) {
+    if (failed_ || !sink_ || width_ <= 0) {
+        return ProcessResult::ERROR_PROCESSING_FAILED;
+    }
+    if (!rows.pixels || rows.width != width_ || rows.height <= 0 ||
+        rows.height > height_ - rowsReceived_) {
+        STREAM_LOGE("无效的行带: %dx%d, 已接收 %d/%d 行", rows.width, rows.height,
+                    rowsReceived_, height_);
+        failed_ = true;
+        return ProcessResult::ERROR_INVALID_PARAMETERS;
     }
 
-    // 如果图片非常大，强制使用流式处理
-    size_t imageSize = static_cast<size_t>(width) * height * 4;
-    if (imageSize > 128 * 1024 * 1024) { // 128MB
-        return Strategy::STREAMING;
+    if (!ensureBuffer(carriedRows_ + rows.height)) {
+        STREAM_LOGE("分配行带缓冲区失败: %d 行", carriedRows_ + rows.height);
+        failed_ = true;
+        return ProcessResult::ERROR_MEMORY_ALLOCATION;
+    }
+
+    // LUT结果写在承接行之后；有序抖动按整图行号取阈值
+    const bool errorDiffusion = params_.ditherType == 1;
+    ProcessingParams bandParams = params_;
+    bandParams.ditherOriginY = params_.ditherOriginY + rowsReceived_;
+    if (errorDiffusion) {
+        bandParams.ditherType = 0; // 误差扩散跨越行带边界，由下面统一处理
     }
 
-    // 其他情况使用混合策略
-    return Strategy::HYBRID;
+    ImageInfo bandOutput;
+    bandOutput.width = width_;
+    bandOutput.height = rows.height;
+    bandOutput.stride = bufferStride_;
+    bandOutput.format = rows.format;
+    bandOutput.pixels = buffer_ + static_cast<size_t>(carriedRows_) * bufferStride_;
+    bandOutput.pixelSize = static_cast<size_t>(rows.height) * bufferStride_;
+
+    ProcessResult result = params_.useMultiThreading
+                           ? ImageProcessor::processMultiThreaded(rows, bandOutput, primaryLut_,
+                                                                  secondaryLut_, bandParams)
+                           : ImageProcessor::processSingleThreaded(rows, bandOutput, primaryLut_,
+                                                                   secondaryLut_, bandParams);
+    if (result != ProcessResult::SUCCESS) {
+        failed_ = true;
+        return result;
+    }
+    rowsReceived_ += rows.height;
+
+    const int bufferedRows = carriedRows_ + rows.height;
+    if (!errorDiffusion) {
+        carriedRows_ = 0;
+        return emitRows(bufferedRows);
+    }
+
+    // Floyd-Steinberg逐行扩散：除最后一行外都已收到全部误差，最后一行留到下一段继续扩散，
+    // 与整图串行抖动逐字节一致（整图的最后一行同样不抖动）
+    ImageProcessor::applyDithering(buffer_, width_, bufferedRows, bufferStride_, params_);
+
+    const bool lastBand = rowsReceived_ == height_;
+    const int readyRows = lastBand ? bufferedRows : bufferedRows - 1;
+    result = emitRows(readyRows);
+    if (result != ProcessResult::SUCCESS || lastBand) {
+        carriedRows_ = 0;
+        return result;
+    }
+
+    std::memmove(buffer_, buffer_ + static_cast<size_t>(readyRows) * bufferStride_,
+                 bufferStride_);
+    carriedRows_ = 1;
+    return ProcessResult::SUCCESS;
 }
 
-StreamingConfig ProcessingStrategySelector::generateOptimalConfig(
-        int width, int height,
-        size_t availableMemory
-) {
-    StreamingConfig config;
+ProcessResult StripStreamingSession::finish() {
+    releaseBuffer();
 
-    // 根据可用内存调整配置
-    config.maxMemoryUsage = availableMemory;
-    config.maxTileSize = std::min(config.maxTileSize, availableMemory / 8); // 最多使用1/8内存作为单个块
+    if (failed_) {
+        return ProcessResult::ERROR_PROCESSING_FAILED;
+    }
+    if (rowsReceived_ != height_) {
+        STREAM_LOGW("行带流式处理提前结束: 已接收 %d/%d 行", rowsReceived_, height_);
+        failed_ = true;
+        return ProcessResult::ERROR_INVALID_PARAMETERS;
+    }
 
-    // 根据图片尺寸调整并发数
-    size_t imageSize = static_cast<size_t>(width) * height * 4;
-    if (imageSize > 256 * 1024 * 1024) { // 256MB+
-        config.maxConcurrentTiles = 2;
-    } else if (imageSize > 64 * 1024 * 1024) { // 64MB+
-        config.maxConcurrentTiles = 3;
-    } else {
-        config.maxConcurrentTiles = 4;
+    STREAM_LOGI("行带流式处理完成 - 输出 %d 行", rowsEmitted_);
+    return ProcessResult::SUCCESS;
+}
+
+bool StripStreamingSession::ensureBuffer(int rows) {
+    if (rows <= bufferRows_) {
+        return true;
+    }
+
+    auto *newBuffer = static_cast<uint8_t *>(
+            MemoryPool::getInstance().allocate(static_cast<size_t>(rows) * bufferStride_, 32));
+    if (!newBuffer) {
+        return false;
     }
 
-    return config;
+    if (buffer_ && carriedRows_ > 0) {
+        std::memcpy(newBuffer, buffer_, static_cast<size_t>(carriedRows_) * bufferStride_);
+    }
+    releaseBuffer();
+    buffer_ = newBuffer;
+    bufferRows_ = rows;
+    return true;
 }
 
-size_t ProcessingStrategySelector::calculateDirectMemoryRequirement(int width, int height) {
-    size_t imageSize = static_cast<size_t>(width) * height * 4;
-    return imageSize * 3; // 输入 + 输出 + 处理缓冲区
+ProcessResult StripStreamingSession::emitRows(int count) {
+    if (count <= 0) {
+        return ProcessResult::SUCCESS;
+    }
+
+    ImageInfo strip;
+    strip.width = width_;
+    strip.height = count;
+    strip.stride = bufferStride_;
+    strip.format = ANDROID_BITMAP_FORMAT_RGBA_8888;
+    strip.pixels = buffer_;
+    strip.pixelSize = static_cast<size_t>(count) * bufferStride_;
+
+    if (!sink_(strip, rowsEmitted_)) {
+        STREAM_LOGI("行带输出被回调中止，已输出 %d 行", rowsEmitted_);
+        failed_ = true;
+        return ProcessResult::ERROR_PROCESSING_FAILED;
+    }
+
+    rowsEmitted_ += count;
+    return ProcessResult::SUCCESS;
 }
 
-size_t ProcessingStrategySelector::calculateStreamingMemoryRequirement(int width, int height,
-                                                                       int tileSize) {
-    (void) width; // 抑制未使用参数警告
-    (void) height; // 抑制未使用参数警告
-    size_t tileMemory = static_cast<size_t>(tileSize) * tileSize * 4 * 2; // 输入 + 输出块
-    return tileMemory * 4; // 最多4个并发块
-}
\ No newline at end of file
+void StripStreamingSession::releaseBuffer() {
+    if (buffer_) {
+        MemoryPool::getInstance().deallocate(buffer_);
+        buffer_ = nullptr;
+        bufferRows_ = 0;
+    }
+}
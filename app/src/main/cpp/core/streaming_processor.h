@@ -3,6 +3,9 @@
 
 #include "image_processor.h"
 #include "../utils/memory_pool.h"
+#include "../utils/job_arena.h"
+#include "../utils/memory_admission.h"
+#include "strategy_cost_model.h"
 #include "../interfaces/media_processor_interface.h"
 #include <vector>
 #include <memory>
@@ -17,16 +20,70 @@
 
 /**
  * 图像块信息
+ * 块本身不持有像素，处理时直接以跨度视图读写原图的输入与输出；
+ * 只有误差扩散抖动需要光晕，此时按处理区域临时分配暂存区
  */
 struct ImageTile {
-    int x, y;           // 块的起始坐标
-    int width, height;  // 块的尺寸
-    int originalX, originalY; // 在原图中的坐标
-    size_t dataSize;    // 数据大小
-    void *data;         // 像素数据
+    int x, y;           // 输出区域在处理区域中的偏移（即左侧与上方光晕宽度）
+    int width, height;  // 输出区域尺寸
+    int originalX, originalY; // 输出区域在原图中的坐标
+    int regionWidth, regionHeight; // 处理区域尺寸（含光晕）
+    size_t dataSize;    // 输出区域数据大小
 
     ImageTile() : x(0), y(0), width(0), height(0),
-                  originalX(0), originalY(0), dataSize(0), data(nullptr) {}
+                  originalX(0), originalY(0), regionWidth(0), regionHeight(0), dataSize(0) {}
+
+    /**
+     * 是否需要暂存区（处理区域大于输出区域）
+     */
+    bool needsScratch() const {
+        return regionWidth != width || regionHeight != height;
+    }
+};
+
+/**
+ * 分块布局，块按行优先的索引在需要时生成
+ */
+struct TileLayout {
+    int tileWidth = 0;
+    int tileHeight = 0;
+    int halo = 0;     // 误差扩散抖动的光晕宽度，逐点处理时为0
+    int columns = 0;
+    int rows = 0;
+
+    int count() const {
+        return columns * rows;
+    }
+};
+
+/**
+ * 一次分块处理任务的暂存区槽位
+ * 槽位按最大处理区域的大小从任务的JobArena中切出，块完成后放回空闲列表供后续块复用，
+ * 因此暂存区峰值只取决于同时处理的块数，任务结束时随JobArena一次性释放
+ */
+class TileScratchSlots {
+public:
+    /**
+     * @param arena 任务内存
+     * @param slotSize 每个槽位的字节数，不小于任何块的处理区域
+     */
+    TileScratchSlots(JobArena &arena, size_t slotSize);
+
+    /**
+     * 取一个空闲槽位，没有时从任务内存中切出新槽位
+     * @return 槽位地址，失败时返回nullptr
+     */
+    void *acquire();
+
+    void release(void *slot);
+
+    size_t getSlotSize() const { return slotSize_; }
+
+private:
+    JobArena &arena_;
+    const size_t slotSize_;
+    std::mutex mutex_;
+    std::vector<void *> freeSlots_;
 };
 
 /**
@@ -34,16 +91,15 @@ struct ImageTile {
  */
 struct StreamingConfig {
     size_t maxTileSize = 32 * 1024 * 1024;  // 32MB 最大块大小
-    int tileOverlap = 16;                   // 块之间的重叠像素数
-    int minTileSize = 512;                  // 最小块尺寸
+    int tileOverlap = 16;                   // 误差扩散抖动的光晕像素数
+    int minTileSize = 256;                  // 最小块尺寸
+    bool autoTuneTileSize = true;           // 按TileAutotuner实测的缓存友好边长分块，不超过maxTileSize
     bool enableParallelProcessing = true;   // 启用并行处理
-    int maxConcurrentTiles = 4;             // 最大并发处理块数
     bool enableProgressiveOutput = false;   // 启用渐进式输出
     int threadCount = 4;                    // 线程数量
 
     // 内存管理配置
-    size_t maxMemoryUsage = 128 * 1024 * 1024; // 128MB 最大内存使用
-    double memoryPressureThreshold = 0.8;      // 内存压力阈值
+    size_t maxMemoryUsage = 128 * 1024 * 1024; // 128MB 最大内存使用，同时是并行处理中块工作集的预算
 };
 
 /**
@@ -64,6 +120,14 @@ struct StreamingProgress {
 typedef std::function<void(const StreamingProgress &)> StreamingProgressCallback;
 typedef std::function<bool()> StreamingCancelCallback; // 返回true表示取消处理
 
+/**
+ * 行带输出回调
+ * @param rows 处理完成的连续行，缓冲区只在回调期间有效
+ * @param firstRow 第一行在整图中的行号
+ * @return 返回false表示中止处理
+ */
+typedef std::function<bool(const ImageInfo &rows, int firstRow)> StripSinkCallback;
+
 /**
  * 流式图像处理器
  * 专为大图片处理设计，支持分块处理和内存优化
@@ -90,14 +154,18 @@ public:
             StreamingCancelCallback cancelCallback = nullptr
     );
 
-    // 内存优化处理（自动选择最佳策略）
+    /**
+     * 内存优化处理（自动选择最佳策略）
+     * 选中的策略不能立即准入时降级为分块处理并排队，cancelCallback可在排队或分块处理期间中止任务
+     */
     ProcessResult processImageOptimized(
             const ImageInfo &input,
             ImageInfo &output,
             const LutData &primaryLut,
             const LutData &secondaryLut,
             const ProcessingParams &params,
-            ProgressCallback progressCallback = nullptr
+            ProgressCallback progressCallback = nullptr,
+            StreamingCancelCallback cancelCallback = nullptr
     );
 
     // 工具方法
@@ -118,6 +186,7 @@ public:
         size_t directProcessCount = 0;
         double averageProcessingTime = 0.0;
         double peakMemoryUsage = 0.0;
+        size_t peakJobMemory = 0; // 单个任务JobArena持有的最大字节数
     };
 
     ProcessingStats getStats() const { return stats_; }
@@ -125,69 +194,112 @@ public:
     void resetStats();
 
 private:
+    /**
+     * 分块处理一张图片，所有临时缓冲区都从调用方持有的任务内存中分配
+     * @param arena 本次任务的内存，由processImageStreaming或processImageOptimized持有
+     */
+    ProcessResult processTiled(
+            const ImageInfo &input,
+            ImageInfo &output,
+            const LutData &primaryLut,
+            const LutData &secondaryLut,
+            const ProcessingParams &params,
+            JobArena &arena,
+            StreamingProgressCallback progressCallback,
+            StreamingCancelCallback cancelCallback
+    );
+
+    /**
+     * 任务结束时记录任务内存的峰值
+     */
+    void recordJobMemory(const JobArena &arena);
+
     // 内部处理方法
+    /**
+     * 整图处理，临时缓冲区同样从调用方持有的任务内存中分配
+     */
     ProcessResult processImageDirect(
             const ImageInfo &input,
             ImageInfo &output,
             const LutData &primaryLut,
             const LutData &secondaryLut,
             const ProcessingParams &params,
+            JobArena &arena,
             ProgressCallback progressCallback
     );
 
     ProcessResult processTile(
-            const ImageTile &inputTile,
-            ImageTile &outputTile,
+            const ImageTile &tile,
+            const ImageInfo &input,
+            ImageInfo &output,
             const LutData &primaryLut,
             const LutData &secondaryLut,
-            const ProcessingParams &params
+            const ProcessingParams &params,
+            TileScratchSlots &scratch
     );
 
-    // 分块管理
-    std::vector<ImageTile> createTiles(const ImageInfo &image) const;
-
-    bool allocateTileData(ImageTile &tile) const;
-
-    void deallocateTileData(ImageTile &tile) const;
-
-    // 内存管理
-    bool checkMemoryPressure() const;
-
-    void cleanupTileCache();
-
-    // 并行处理
-    ProcessResult processParallel(
-            const std::vector<ImageTile> &inputTiles,
-            std::vector<ImageTile> &outputTiles,
+    // 分块管理（只计算块的几何信息，不复制像素）
+    TileLayout computeTileLayout(const ImageInfo &image, const ProcessingParams &params) const;
+
+    /**
+     * 取块阶段：按索引生成块
+     */
+    ImageTile fetchTile(const TileLayout &layout, const ImageInfo &image, int index) const;
+
+    /**
+     * 块处理期间的内存工作集：输入与输出区域，带光晕时另加暂存区
+     */
+    size_t tileMemoryCost(const ImageTile &tile) const;
+
+    /**
+     * 暂存区槽位大小：布局中最大处理区域的字节数，逐点处理时为0
+     */
+    size_t scratchSlotSize(const TileLayout &layout, const ImageInfo &image) const;
+
+    /**
+     * 流式处理需要预留的工作集：块工作集预算，不超过直接处理的需求
+     */
+    size_t streamingReservation(int width, int height) const;
+
+    /**
+     * 流水线并行处理：调用线程按内存预算取块并提交到线程池，
+     * 每完成一块就回收其预算并立即补充新块，没有批次边界
+     */
+    ProcessResult processPipelined(
+            const TileLayout &layout,
+            const ImageInfo &input,
+            ImageInfo &output,
             const LutData &primaryLut,
             const LutData &secondaryLut,
             const ProcessingParams &params,
+            JobArena &arena,
+            TileScratchSlots &scratch,
             StreamingProgressCallback progressCallback,
             StreamingCancelCallback cancelCallback
     );
 
     // 串行处理
     ProcessResult processSequential(
-            const std::vector<ImageTile> &inputTiles,
-            std::vector<ImageTile> &outputTiles,
+            const TileLayout &layout,
+            const ImageInfo &input,
+            ImageInfo &output,
             const LutData &primaryLut,
             const LutData &secondaryLut,
             const ProcessingParams &params,
+            TileScratchSlots &scratch,
             StreamingProgressCallback progressCallback,
             StreamingCancelCallback cancelCallback
     );
 
-    // 输出合成
-    ProcessResult assembleTiles(
-            const std::vector<ImageTile> &tiles,
-            ImageInfo &output
-    ) const;
-
-    // 边缘处理（处理块之间的重叠区域）
-    void blendTileEdges(
-            const ImageTile &tile1,
-            const ImageTile &tile2,
-            ImageInfo &output
+    /**
+     * 退块阶段的进度通知
+     */
+    void reportProgress(
+            const StreamingProgressCallback &progressCallback,
+            int processedTiles,
+            int totalTiles,
+            size_t processedBytes,
+            size_t totalBytes
     ) const;
 
     // 成员变量
@@ -195,10 +307,6 @@ private:
     std::unique_ptr<ImageProcessor> imageProcessor_;
     mutable ProcessingStats stats_;
 
-    // 缓存管理
-    std::vector<std::unique_ptr<ImageTile>> tileCache_;
-    size_t maxCacheSize_ = 8; // 最多缓存8个块
-
     // 线程管理
     mutable std::mutex processingMutex_;
     std::atomic<bool> isProcessing_{false};
@@ -210,31 +318,83 @@ private:
 };
 
 /**
- * 自适应处理策略选择器
+ * 行带流式处理会话
+ * 调用方按从上到下的顺序推入解码好的行带（例如逐步解码的JPEG），处理结果按顺序通过回调交回。
+ * 会话只持有一个行带大小的输出缓冲区，Floyd-Steinberg抖动时另外保留一行承接向下扩散的误差，
+ * 因此峰值内存只与行带高度×宽度有关，不需要完整的输入或输出图片；
+ * 各种抖动模式的结果与整图处理一致（随机抖动除外）。
+ * LUT以引用保存，会话结束前必须保持有效
  */
-class ProcessingStrategySelector {
+class StripStreamingSession {
 public:
-    enum class Strategy {
-        DIRECT,      // 直接处理
-        STREAMING,   // 流式处理
-        HYBRID       // 混合策略
-    };
-
-    static Strategy selectOptimalStrategy(
-            int width, int height,
-            size_t availableMemory,
-            const ProcessingParams &params
+    /**
+     * @param width 图片宽度
+     * @param height 图片总行数
+     * @param primaryLut 主LUT数据
+     * @param secondaryLut 次LUT数据
+     * @param params 处理参数
+     * @param sink 行带输出回调
+     */
+    StripStreamingSession(
+            int width,
+            int height,
+            const LutData &primaryLut,
+            const LutData &secondaryLut,
+            const ProcessingParams &params,
+            StripSinkCallback sink
     );
 
-    static StreamingConfig generateOptimalConfig(
-            int width, int height,
-            size_t availableMemory
-    );
+    ~StripStreamingSession();
 
-private:
-    static size_t calculateDirectMemoryRequirement(int width, int height);
+    StripStreamingSession(const StripStreamingSession &) = delete;
+
+    StripStreamingSession &operator=(const StripStreamingSession &) = delete;
+
+    /**
+     * 推入下一段行带，处理完成的行在返回前交给输出回调
+     * @param rows 行带像素，宽度必须与图片相同，跨度可以任意
+     * @return 处理结果，失败后会话不再接受新的行带
+     */
+    ProcessResult pushRows(const ImageInfo &rows);
+
+    /**
+     * 结束会话并释放缓冲区
+     * @return 行数不足时返回ERROR_INVALID_PARAMETERS
+     */
+    ProcessResult finish();
 
-    static size_t calculateStreamingMemoryRequirement(int width, int height, int tileSize);
+    int getRowsReceived() const { return rowsReceived_; }
+
+    int getRowsEmitted() const { return rowsEmitted_; }
+
+private:
+    /**
+     * 保证输出缓冲区至少容纳指定行数，扩容时保留承接行
+     */
+    bool ensureBuffer(int rows);
+
+    /**
+     * 将缓冲区开头的若干行交给输出回调
+     */
+    ProcessResult emitRows(int count);
+
+    void releaseBuffer();
+
+    const int width_;
+    const int height_;
+    const LutData &primaryLut_;
+    const LutData &secondaryLut_;
+    const ProcessingParams params_;
+    StripSinkCallback sink_;
+
+    uint8_t *buffer_ = nullptr;
+    int bufferRows_ = 0;
+    const int bufferStride_;
+    int carriedRows_ = 0; // Floyd-Steinberg承接行数（0或1）
+
+    int rowsReceived_ = 0;
+    int rowsEmitted_ = 0;
+    bool failed_ = false;
 };
 
 #endif // STREAMING_PROCESSOR_H
\ No newline at end of file
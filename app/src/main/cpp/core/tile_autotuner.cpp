@@ -0,0 +1,379 @@
+#include "tile_autotuner.h"
+#include "image_processor.h"
+#include "lut_baker.h"
+#include "../utils/file_utils.h"
+#include "../utils/memory_admission.h"
+#include "../utils/thread_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+/**
+ * 画像文件内容，缓存大小与核心数用于判断是否为同一设备
+ */
+struct TileTuningRecord {
+    char magic[4];
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t cpuCount;
+    int32_t tileSide;
+    uint64_t l2CacheBytes;
+    uint64_t l3CacheBytes;
+    uint64_t bandBytes;
+};
+
+static_assert(sizeof(TileTuningRecord) == 40, "TileTuningRecord布局必须固定");
+
+// 合成图片宽度；高度按缓存大小换算，保证整帧远大于L3
+constexpr int BENCHMARK_WIDTH = 2048;
+constexpr size_t MIN_BENCHMARK_BYTES = 16 * 1024 * 1024;
+constexpr size_t MAX_BENCHMARK_BYTES = 32 * 1024 * 1024;
+constexpr size_t MAX_L3_TARGET = 16 * 1024 * 1024;
+constexpr int BENCHMARK_REPEATS = 2;
+
+/**
+ * 带轻微曲线的33点LUT，使查表不退化为恒等映射
+ */
+LutData createBenchmarkLut() {
+    const int size = 33;
+    LutData lut;
+    lut.size = size;
+    lut.data.resize(static_cast<size_t>(size) * size * size * 3);
+    for (int r = 0; r < size; ++r) {
+        for (int g = 0; g < size; ++g) {
+            for (int b = 0; b < size; ++b) {
+                const size_t index = (static_cast<size_t>(r) * size * size + g * size + b) * 3;
+                lut.data[index] = std::pow(r / (size - 1.0f), 0.9f);
+                lut.data[index + 1] = g / (size - 1.0f);
+                lut.data[index + 2] = std::sqrt(b / (size - 1.0f));
+            }
+        }
+    }
+    lut.isLoaded = true;
+    return lut;
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+            .count();
+}
+
+} // namespace
+
+TileAutotuner &TileAutotuner::getInstance() {
+    static TileAutotuner instance;
+    return instance;
+}
+
+TileAutotuner::TileAutotuner() {
+    // 后台调优用到的单例须先于本实例构造，退出时才会在本实例join之后析构
+    CpuTopology::getSystemTopology();
+    ThreadPool::getInstance();
+    MemoryAdmissionController::getInstance();
+}
+
+TileAutotuner::~TileAutotuner() {
+    stopping_ = true;
+    if (tuneThread_.joinable()) {
+        tuneThread_.join();
+    }
+}
+
+void TileAutotuner::setProfilePath(const std::string &path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    profilePath_ = path;
+    if (profilePath_.empty() || loadLocked()) {
+        return;
+    }
+    if (tuning_.tuned) {
+        // 已在之前的路径下调优过，直接写入新路径
+        saveLocked();
+    } else if (enabled_) {
+        startBackgroundTuneLocked();
+    }
+}
+
+TileTuning TileAutotuner::getTuning() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!enabled_) {
+        return TileTuning();
+    }
+    if (!tuning_.tuned) {
+        startBackgroundTuneLocked();
+    }
+    return tuning_;
+}
+
+TileTuning TileAutotuner::tune(TileTuningReport *report) {
+    std::lock_guard<std::mutex> tuneLock(tuneMutex_);
+    const TileTuning result = runBenchmark(report);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!result.tuned) {
+        return tuning_;
+    }
+    tuning_ = result;
+    if (!profilePath_.empty()) {
+        saveLocked();
+    }
+    return result;
+}
+
+void TileAutotuner::startBackgroundTuneLocked() {
+    if (tuneStarted_ || std::chrono::steady_clock::now() < nextAttempt_) {
+        return;
+    }
+    // 上一次被跳过的调优线程已经退出
+    if (tuneThread_.joinable()) {
+        tuneThread_.join();
+    }
+    tuneStarted_ = true;
+    tuneThread_ = std::thread([this]() {
+        tune(nullptr);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!tuning_.tuned) {
+            tuneStarted_ = false;
+            nextAttempt_ = std::chrono::steady_clock::now() + RETRY_INTERVAL;
+        }
+    });
+}
+
+void TileAutotuner::setEnabled(bool enabled) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    enabled_ = enabled;
+}
+
+bool TileAutotuner::isEnabled() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return enabled_;
+}
+
+std::vector<size_t> TileAutotuner::workingSetTargets(const CpuTopologyInfo &topology) {
+    const size_t l2 = topology.l2CacheBytes > 0 ? topology.l2CacheBytes : DEFAULT_L2_BYTES;
+    const size_t l3 = std::min(topology.l3CacheBytes, MAX_L3_TARGET);
+
+    std::vector<size_t> targets = {l2 / 2, l2, l2 * 2};
+    if (l3 > l2 * 2) {
+        targets.push_back(l3 / 2);
+        targets.push_back(l3);
+    }
+    return targets;
+}
+
+std::vector<int> TileAutotuner::candidateTileSides(const CpuTopologyInfo &topology) {
+    std::vector<int> sides;
+    for (size_t target: workingSetTargets(topology)) {
+        // 边长取32的倍数
+        int side = static_cast<int>(std::sqrt(static_cast<double>(target) / BYTES_PER_PIXEL_PASS));
+        side = std::clamp(side / 32 * 32, MIN_TILE_SIDE, MAX_TILE_SIDE);
+        if (std::find(sides.begin(), sides.end(), side) == sides.end()) {
+            sides.push_back(side);
+        }
+    }
+    std::sort(sides.begin(), sides.end());
+    return sides;
+}
+
+std::vector<size_t> TileAutotuner::candidateBandBytes(const CpuTopologyInfo &topology) {
+    std::vector<size_t> bands = workingSetTargets(topology);
+    std::sort(bands.begin(), bands.end());
+    bands.erase(std::unique(bands.begin(), bands.end()), bands.end());
+    return bands;
+}
+
+int TileAutotuner::bandRows(size_t bandBytes, int width) {
+    if (width <= 0) {
+        return 1;
+    }
+    const size_t rowBytes = static_cast<size_t>(width) * BYTES_PER_PIXEL_PASS;
+    return std::max(1, static_cast<int>(bandBytes / rowBytes));
+}
+
+TileTuning TileAutotuner::runBenchmark(TileTuningReport *report) {
+    const CpuTopologyInfo &topology = CpuTopology::getSystemTopology();
+    const std::vector<int> tileSides = candidateTileSides(topology);
+    const std::vector<size_t> bandSizes = candidateBandBytes(topology);
+
+    // 合成图片：约为L3的4倍（上限32MB），每次处理都要从内存读入
+    const size_t l3 = std::min(topology.l3CacheBytes, MAX_L3_TARGET);
+    const size_t frameBytes = std::clamp(l3 * 4, MIN_BENCHMARK_BYTES, MAX_BENCHMARK_BYTES);
+    const int width = BENCHMARK_WIDTH;
+    const int height = static_cast<int>(frameBytes / (static_cast<size_t>(width) * 4));
+    const int stride = width * 4;
+
+    // 输入与输出两块缓冲区与实际处理一样先预留，内存紧张时不为调优挤占处理任务
+    MemoryAdmissionController::Reservation reservation =
+            MemoryAdmissionController::getInstance().tryReserve(
+                    static_cast<size_t>(stride) * height * 2);
+    if (!reservation.isValid()) {
+        TUNE_LOGW("内存预留失败，跳过本次调优");
+        return TileTuning();
+    }
+
+    std::vector<uint8_t> input(static_cast<size_t>(stride) * height);
+    std::vector<uint8_t> output(input.size());
+    uint32_t state = 0x9e3779b9u;
+    for (uint8_t &value: input) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        value = static_cast<uint8_t>(state);
+    }
+
+    // 按实际处理的常见路径：与NativeLutProcessor相同地选择SIMD内核或烘焙查表，
+    // 随后在同一块或行带上做随机抖动
+    const LutData lut = createBenchmarkLut();
+    const LutData emptyLut;
+    ProcessingParams params;
+    params.ditherType = 2;
+    BakedLutData baked;
+    if (LutBaker::isPreferred()) {
+        LutBaker::bake(lut, emptyLut, params, baked);
+    }
+    params.bakedLut = baked.isBaked ? &baked : nullptr;
+
+    ThreadPool &pool = ThreadPool::getInstance();
+    const auto startTime = std::chrono::steady_clock::now();
+
+    TileTuning result;
+    double bestTileMs = 0.0;
+    for (int side: tileSides) {
+        const int columns = (width + side - 1) / side;
+        const int rows = (height + side - 1) / side;
+        double best = 0.0;
+        for (int repeat = 0; repeat < BENCHMARK_REPEATS; ++repeat) {
+            if (!waitForIdlePool(pool)) {
+                TUNE_LOGW("线程池持续繁忙，放弃本次调优");
+                return TileTuning();
+            }
+            const auto start = std::chrono::steady_clock::now();
+            pool.parallelFor(0, columns * rows, 1, [&](int begin, int end) {
+                for (int index = begin; index < end; ++index) {
+                    const int x = (index % columns) * side;
+                    const int y = (index / columns) * side;
+                    ImageInfo tileInput;
+                    tileInput.width = std::min(side, width - x);
+                    tileInput.height = std::min(side, height - y);
+                    tileInput.stride = stride;
+                    tileInput.pixels = input.data() + static_cast<size_t>(y) * stride + x * 4;
+                    ImageInfo tileOutput = tileInput;
+                    tileOutput.pixels = output.data() + static_cast<size_t>(y) * stride + x * 4;
+                    ImageProcessor::processSingleThreaded(tileInput, tileOutput, lut, emptyLut,
+                                                          params, nullptr);
+                }
+            });
+            const double ms = elapsedMs(start);
+            best = repeat == 0 ? ms : std::min(best, ms);
+        }
+        if (report) {
+            report->tileTimings.emplace_back(side, best);
+        }
+        if (result.tileSide == 0 || best < bestTileMs) {
+            result.tileSide = side;
+            bestTileMs = best;
+        }
+    }
+
+    double bestBandMs = 0.0;
+    for (size_t bandBytes: bandSizes) {
+        const int rows = bandRows(bandBytes, width);
+        double best = 0.0;
+        for (int repeat = 0; repeat < BENCHMARK_REPEATS; ++repeat) {
+            if (!waitForIdlePool(pool)) {
+                TUNE_LOGW("线程池持续繁忙，放弃本次调优");
+                return TileTuning();
+            }
+            const auto start = std::chrono::steady_clock::now();
+            pool.parallelFor(0, height, rows, [&](int startRow, int endRow) {
+                ImageProcessor::processBand(input.data(), output.data(), startRow, endRow, width,
+                                            stride, stride, lut, emptyLut, params);
+            });
+            const double ms = elapsedMs(start);
+            best = repeat == 0 ? ms : std::min(best, ms);
+        }
+        if (report) {
+            report->bandTimings.emplace_back(bandBytes, best);
+        }
+        if (result.bandBytes == 0 || best < bestBandMs) {
+            result.bandBytes = bandBytes;
+            bestBandMs = best;
+        }
+    }
+
+    result.tuned = true;
+    if (report) {
+        report->tuning = result;
+    }
+
+    TUNE_LOGI("调优完成（%.0f ms）: 块边长 %d（%.2f ms）, 行带 %zu KB（%.2f ms）, L2 %zu KB, L3 %zu KB",
+              elapsedMs(startTime), result.tileSide, bestTileMs, result.bandBytes / 1024,
+              bestBandMs, topology.l2CacheBytes / 1024, topology.l3CacheBytes / 1024);
+    return result;
+}
+
+bool TileAutotuner::waitForIdlePool(ThreadPool &pool) const {
+    const auto deadline = std::chrono::steady_clock::now() + IDLE_WAIT_TIMEOUT;
+    while (!pool.isIdle()) {
+        if (stopping_.load() || std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(IDLE_POLL_INTERVAL);
+    }
+    return !stopping_.load();
+}
+
+bool TileAutotuner::loadLocked() {
+    FILE *file = fopen(profilePath_.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+
+    TileTuningRecord record;
+    const bool read = fread(&record, sizeof(record), 1, file) == 1;
+    fclose(file);
+
+    const CpuTopologyInfo &topology = CpuTopology::getSystemTopology();
+    if (!read || std::memcmp(record.magic, PROFILE_MAGIC, sizeof(record.magic)) != 0 ||
+        record.version != PROFILE_VERSION || record.tileSide < MIN_TILE_SIDE ||
+        record.tileSide > MAX_TILE_SIDE || record.bandBytes == 0) {
+        TUNE_LOGW("调优画像文件无效，忽略: %s", profilePath_.c_str());
+        return false;
+    }
+    if (record.cpuCount != static_cast<uint32_t>(topology.cpuCount) ||
+        record.l2CacheBytes != topology.l2CacheBytes ||
+        record.l3CacheBytes != topology.l3CacheBytes) {
+        TUNE_LOGI("缓存配置与画像不一致，将重新调优");
+        return false;
+    }
+
+    tuning_.tileSide = record.tileSide;
+    tuning_.bandBytes = static_cast<size_t>(record.bandBytes);
+    tuning_.tuned = true;
+    TUNE_LOGI("加载调优画像: 块边长 %d, 行带 %zu KB", tuning_.tileSide, tuning_.bandBytes / 1024);
+    return true;
+}
+
+bool TileAutotuner::saveLocked() {
+    const CpuTopologyInfo &topology = CpuTopology::getSystemTopology();
+    TileTuningRecord record;
+    std::memset(&record, 0, sizeof(record));
+    std::memcpy(record.magic, PROFILE_MAGIC, sizeof(record.magic));
+    record.version = PROFILE_VERSION;
+    record.cpuCount = static_cast<uint32_t>(topology.cpuCount);
+    record.tileSide = tuning_.tileSide;
+    record.l2CacheBytes = topology.l2CacheBytes;
+    record.l3CacheBytes = topology.l3CacheBytes;
+    record.bandBytes = tuning_.bandBytes;
+
+    if (!FileUtils::writeAtomically(profilePath_, {{&record, sizeof(record)}})) {
+        TUNE_LOGW("写入调优画像失败: %s", profilePath_.c_str());
+        return false;
+    }
+
+    return true;
+}
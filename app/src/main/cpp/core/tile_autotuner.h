@@ -0,0 +1,159 @@
+#ifndef TILE_AUTOTUNER_H
+#define TILE_AUTOTUNER_H
+
+#include "../utils/cpu_topology.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <android/log.h>
+
+class ThreadPool;
+
+#define TILE_TUNER_TAG "TileAutotuner"
+#define TUNE_LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, TILE_TUNER_TAG, __VA_ARGS__)
+#define TUNE_LOGI(...) __android_log_print(ANDROID_LOG_INFO, TILE_TUNER_TAG, __VA_ARGS__)
+#define TUNE_LOGW(...) __android_log_print(ANDROID_LOG_WARN, TILE_TUNER_TAG, __VA_ARGS__)
+
+/**
+ * 调优结果
+ */
+struct TileTuning {
+    int tileSide = 0;      // 分块处理的块边长
+    size_t bandBytes = 0;  // 多线程行带的目标工作集（输入加输出），行数按图片宽度换算
+    bool tuned = false;    // 未调优时调用方沿用原有的默认尺寸
+};
+
+/**
+ * 一次调优的各候选耗时
+ */
+struct TileTuningReport {
+    std::vector<std::pair<int, double>> tileTimings;    // 块边长 -> 毫秒
+    std::vector<std::pair<size_t, double>> bandTimings; // 行带字节数 -> 毫秒
+    TileTuning tuning;
+};
+
+/**
+ * 块与行带尺寸自动调优
+ * 默认的32MB块和按线程数均分的行带远大于移动端的L2/L3，LUT查表后的抖动或暂存区回写
+ * 再读一遍时已经不在缓存中。首次使用时按sysfs读到的缓存大小生成几组候选，
+ * 在合成图片上实测“LUT查表+随机抖动”两遍处理的耗时，取最快的块边长和行带大小，
+ * 连同缓存大小写入画像文件，同一设备之后直接加载；缓存大小变化（换机恢复数据）时重新调优。
+ * 实测在后台线程进行，完成前调用方沿用默认尺寸，处理不会等待调优。
+ * 合成图片的两块缓冲区先向MemoryAdmissionController预留，放不下时跳过本次调优；
+ * 每个候选只在线程池空闲时实测，不与正在进行的处理争抢工作线程，等待过久则放弃，稍后重试
+ */
+class TileAutotuner {
+public:
+    static constexpr char PROFILE_MAGIC[4] = {'L', '2', 'P', 'T'};
+    static constexpr uint16_t PROFILE_VERSION = 1;
+
+    // 块边长下限，误差扩散抖动的光晕开销不超过约20%
+    static constexpr int MIN_TILE_SIDE = 256;
+    static constexpr int MAX_TILE_SIDE = 2048;
+    // 读不到缓存大小时假设的L2
+    static constexpr size_t DEFAULT_L2_BYTES = 512 * 1024;
+    // 每像素的工作集：输入与输出各4字节
+    static constexpr size_t BYTES_PER_PIXEL_PASS = 8;
+    // 等待线程池空闲的轮询间隔与上限
+    static constexpr std::chrono::milliseconds IDLE_POLL_INTERVAL{50};
+    static constexpr std::chrono::milliseconds IDLE_WAIT_TIMEOUT{10000};
+    // 后台调优被跳过后，至少间隔这么久才再次尝试
+    static constexpr std::chrono::milliseconds RETRY_INTERVAL{60000};
+
+    static TileAutotuner &getInstance();
+
+    ~TileAutotuner();
+
+    /**
+     * 设置画像文件路径，缓存大小一致时加载其中的调优结果，
+     * 没有可用画像时在后台启动调优（通常在应用启动时调用，此时CPU较空闲）
+     */
+    void setProfilePath(const std::string &path);
+
+    /**
+     * 获取调优结果，不阻塞：尚未调优时在后台启动一次调优并返回未调优的结果
+     * 关闭调优时返回未调优的结果
+     */
+    TileTuning getTuning();
+
+    /**
+     * 在调用线程上立即重新调优并保存，与后台调优串行
+     * 内存预留失败或线程池一直繁忙时不改变已有结果
+     * @param report 输出各候选的耗时，可为nullptr
+     * @return 当前的调优结果
+     */
+    TileTuning tune(TileTuningReport *report = nullptr);
+
+    /**
+     * 启用或关闭调优（关闭后调用方使用原有的默认尺寸）
+     */
+    void setEnabled(bool enabled);
+
+    bool isEnabled() const;
+
+    /**
+     * 按缓存大小生成候选块边长（从小到大）
+     */
+    static std::vector<int> candidateTileSides(const CpuTopologyInfo &topology);
+
+    /**
+     * 按缓存大小生成候选行带工作集（从小到大）
+     */
+    static std::vector<size_t> candidateBandBytes(const CpuTopologyInfo &topology);
+
+    /**
+     * 把行带工作集换算为指定宽度下的行数
+     */
+    static int bandRows(size_t bandBytes, int width);
+
+private:
+    TileAutotuner();
+
+    TileAutotuner(const TileAutotuner &) = delete;
+
+    TileAutotuner &operator=(const TileAutotuner &) = delete;
+
+    /**
+     * 候选尺寸依据的工作集目标：L2的一半到L3，L3取值上限为16MB
+     */
+    static std::vector<size_t> workingSetTargets(const CpuTopologyInfo &topology);
+
+    /**
+     * 在合成图片上实测各候选，不持有mutex_
+     * @return 预留内存失败、线程池一直繁忙或正在析构时返回未调优的结果
+     */
+    TileTuning runBenchmark(TileTuningReport *report);
+
+    /**
+     * 等待线程池空闲
+     * @return 超时或正在析构时返回false
+     */
+    bool waitForIdlePool(ThreadPool &pool) const;
+
+    /**
+     * 尚未启动过时在后台线程上调优
+     */
+    void startBackgroundTuneLocked();
+
+    bool loadLocked();
+
+    bool saveLocked();
+
+    mutable std::mutex mutex_;
+    std::mutex tuneMutex_;      // 串行化实测，避免后台与手动调优同时占用线程池
+    std::thread tuneThread_;
+    bool tuneStarted_ = false;
+    std::chrono::steady_clock::time_point nextAttempt_; // 后台调优被跳过后的下次尝试时间
+    std::atomic<bool> stopping_{false};
+    std::string profilePath_;
+    TileTuning tuning_;
+    bool enabled_ = true;
+};
+
+#endif // TILE_AUTOTUNER_H
@@ -6,6 +6,9 @@
 #include <android/log.h>
 #include <memory>
 #include <vector>
+#include <string>
+#include <mutex>
+#include <functional>
 #include <cstdint>
 
 // 日志宏定义
@@ -25,15 +28,21 @@ enum class ProcessResult {
     ERROR_INVALID_PARAMETERS = -5
 };
 
+struct BakedLutData;
+
 // 处理参数结构
 struct ProcessingParams {
     // 原有参数
     float strength = 1.0f;
     float lut2Strength = 1.0f;
     int quality = 90;
-    int ditherType = 0; // 0=NONE, 1=FLOYD_STEINBERG, 2=RANDOM
+    int ditherType = 0; // 0=NONE, 1=FLOYD_STEINBERG, 2=RANDOM, 3=BAYER, 4=BLUE_NOISE
+    int ditherOriginX = 0; // 有序抖动阈值图的起点（分块处理时为块在整图中的位置）
+    int ditherOriginY = 0;
+    int interpolationMode = 0; // 0=TRILINEAR, 1=TETRAHEDRAL
     bool useMultiThreading = true;
     int threadCount = 0; // 0表示自动检测
+    int schedulerMode = 0; // 0=AUTO（异构CPU时自适应分块）, 1=WORK_STEALING, 2=ADAPTIVE
 
     // LutImageProcessor需要的参数
     const uint8_t *inputData = nullptr;
@@ -43,6 +52,10 @@ struct ProcessingParams {
     int channels = 4;
     float intensity = 1.0f;
     bool enableDithering = false;
+
+    // 预烘焙LUT：LUT组合与强度固定时使用整数查表路径
+    bool useBakedLut = true;
+    const BakedLutData *bakedLut = nullptr; // 由NativeLutProcessor在处理前填充
 };
 
 // LUT数据结构
@@ -51,10 +64,49 @@ struct LutData {
     int size = 0; // LUT立方体的边长（通常是32或64）
     bool isLoaded = false;
 
+    // 输入定义域（.cube的DOMAIN_MIN/DOMAIN_MAX，默认[0,1]）
+    // 解析时数据已重采样到[0,1]，这里仅记录文件声明的定义域
+    float domainMin[3] = {0.0f, 0.0f, 0.0f};
+    float domainMax[3] = {1.0f, 1.0f, 1.0f};
+
+    std::string title; // .cube的TITLE
+
     void clear() {
         data.clear();
         size = 0;
         isLoaded = false;
+        title.clear();
+        for (int i = 0; i < 3; ++i) {
+            domainMin[i] = 0.0f;
+            domainMax[i] = 1.0f;
+        }
+    }
+};
+
+// 预烘焙LUT数据结构
+// 主LUT、第二LUT及两级强度混合预先合成到一张定点网格中（值域为 [0, 255*256]），
+// 8位输入到网格偏移/小数部分的映射同样预先计算，逐像素只需整数插值
+struct BakedLutData {
+    std::vector<uint16_t> data;
+    int size = 0;
+    bool isBaked = false;
+
+    // 每个8位输入值对应的网格基准偏移（已乘以各轴步长）和小数部分（0-256）
+    uint32_t offsetR[256] = {};
+    uint32_t offsetG[256] = {};
+    uint32_t offsetB[256] = {};
+    uint16_t fraction[256] = {};
+
+    // 烘焙时使用的参数，用于判断缓存是否仍然有效
+    float strength = 1.0f;
+    float lut2Strength = 1.0f;
+    int interpolationMode = 0;
+    bool hasSecondaryLut = false;
+
+    void clear() {
+        data.clear();
+        size = 0;
+        isBaked = false;
     }
 };
 
@@ -71,6 +123,9 @@ struct ImageInfo {
 // 进度回调类型
 typedef void (*NativeProgressCallback)(float progress);
 
+// 取消回调类型，返回true表示取消处理，只在调用processImage的线程上调用
+typedef std::function<bool()> NativeCancelCallback;
+
 // Native处理器类声明
 class NativeLutProcessor {
 public:
@@ -90,7 +145,8 @@ public:
             const ImageInfo &inputImage,
             ImageInfo &outputImage,
             const ProcessingParams &params,
-            NativeProgressCallback callback = nullptr
+            NativeProgressCallback callback = nullptr,
+            const NativeCancelCallback &cancelCallback = nullptr
     );
 
     // 内存管理
@@ -128,6 +184,9 @@ public:
 
     bool loadLut(const char *lutPath);
 
+    // 用Native解析器解析.cube/.3dl文本（无文件路径、不经过二进制缓存）
+    bool loadLutFromText(const uint8_t *lutBytes, size_t size);
+
     bool loadLutFromMemory(const void *lutData, size_t dataSize);
 
     void unloadLut();
@@ -135,6 +194,8 @@ public:
 private:
     LutData primaryLut_;
     LutData secondaryLut_;
+    std::shared_ptr<const BakedLutData> bakedLut_; // 不可变快照，替换时正在处理的任务仍持有旧对象
+    std::mutex bakeMutex_;
     size_t nativeMemoryUsage_;
 
     // 配置成员变量
@@ -143,6 +204,17 @@ private:
     float intensity_ = 1.0f;
     bool ditheringEnabled_ = false;
 
+    // 整图处理等待内存准入的最长时间，超时后改为流式处理
+    static constexpr int ADMISSION_WAIT_MS = 2000;
+    // 流式处理的块工作集预算，远小于整图处理需要的输入与输出
+    static constexpr size_t STREAMING_FALLBACK_MEMORY = 64 * 1024 * 1024;
+
+    // 主/第二LUT变化后丢弃烘焙结果
+    void invalidateBakedLut();
+
+    // 以新加载的数据替换主LUT
+    void replacePrimaryLut(LutData &&loaded);
+
     // 内部处理方法
     ProcessResult processImageSingleThreaded(
             const ImageInfo &input,
@@ -158,6 +230,15 @@ private:
             NativeProgressCallback callback
     );
 
+    // 整图处理未能准入时分块流式处理，只需预留块工作集
+    ProcessResult processImageStreamingFallback(
+            const ImageInfo &input,
+            ImageInfo &output,
+            const ProcessingParams &params,
+            NativeProgressCallback callback,
+            const NativeCancelCallback &cancelCallback
+    );
+
     // SIMD优化方法
     void processPixelsSIMD(
             const uint8_t *input,
@@ -200,11 +281,27 @@ Java_cn_alittlecookie_lut2photo_lut2photo_core_NativeLutProcessor_nativeLoadLut(
                                                                                 jfloatArray lutData,
                                                                                 jint lutSize);
 
+JNIEXPORT jint JNICALL
+Java_cn_alittlecookie_lut2photo_lut2photo_core_NativeLutProcessor_nativeLoadLutBytes(
+        JNIEnv *env, jobject thiz, jlong handle, jbyteArray lutBytes);
+
+JNIEXPORT void JNICALL
+Java_cn_alittlecookie_lut2photo_lut2photo_core_NativeLutProcessor_nativeSetLutCacheDirectory(
+        JNIEnv *env, jobject thiz, jstring cacheDir);
+
+JNIEXPORT void JNICALL
+Java_cn_alittlecookie_lut2photo_lut2photo_core_NativeLutProcessor_nativeSetCorePinning(
+        JNIEnv *env, jobject thiz, jboolean enabled);
+
+JNIEXPORT jbyteArray JNICALL
+Java_cn_alittlecookie_lut2photo_lut2photo_core_NativeLutProcessor_nativeGetDitherMatrix(
+        JNIEnv *env, jclass clazz, jint ditherType);
+
 JNIEXPORT jint JNICALL
 Java_cn_alittlecookie_lut2photo_lut2photo_core_NativeLutProcessor_nativeProcessBitmap(
         JNIEnv *env, jobject thiz, jlong handle, jobject inputBitmap, jobject outputBitmap,
         jfloat strength, jfloat lut2Strength, jint quality, jint ditherType,
-        jboolean useMultiThreading
+        jboolean useMultiThreading, jint interpolationMode, jint schedulerMode, jobject job
 );
 
 JNIEXPORT jlong JNICALL
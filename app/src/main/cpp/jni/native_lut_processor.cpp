@@ -5,12 +5,21 @@
 #include "../utils/exception_handler.h"
 #include "../core/image_processor.h"
 #include "../core/lut_processor.h"
+#include "../core/lut_baker.h"
+#include "../core/lut_cache.h"
+#include "../core/strategy_cost_model.h"
+#include "../core/streaming_processor.h"
+#include "../core/tile_autotuner.h"
 #include "../utils/bitmap_utils.h"
+#include "../utils/memory_admission.h"
+#include "../utils/thread_pool.h"
+#include "../utils/dither_matrix.h"
 #include <sstream>
 #include <memory>
 #include <map>
 #include <mutex>
 #include <algorithm>
+#include <cstring>
 
 // 全局变量
 static std::map<jlong, std::unique_ptr<LutImageProcessor>> g_enhanced_processors;
@@ -75,6 +84,7 @@ ProcessResult NativeLutProcessor::loadLutFromArray(const float *lutData, int lut
     }
 
     try {
+        invalidateBakedLut();
         primaryLut_.size = lutSize;
         size_t dataSize = lutSize * lutSize * lutSize * 3;
 
@@ -113,6 +123,7 @@ ProcessResult NativeLutProcessor::loadSecondaryLutFromArray(const float *lutData
     }
 
     try {
+        invalidateBakedLut();
         secondaryLut_.size = lutSize;
         size_t dataSize = lutSize * lutSize * lutSize * 3;
 
@@ -140,6 +151,8 @@ ProcessResult NativeLutProcessor::loadSecondaryLutFromArray(const float *lutData
 }
 
 void NativeLutProcessor::clearLuts() {
+    invalidateBakedLut();
+
     if (primaryLut_.isLoaded) {
         size_t dataSize = primaryLut_.data.size() * sizeof(float);
         primaryLut_.data.clear();
@@ -161,7 +174,8 @@ ProcessResult NativeLutProcessor::processImage(
         const ImageInfo &inputImage,
         ImageInfo &outputImage,
         const ProcessingParams &params,
-        NativeProgressCallback callback
+        NativeProgressCallback callback,
+        const NativeCancelCallback &cancelCallback
 ) {
     if (!primaryLut_.isLoaded) {
         LOGE("主LUT未加载");
@@ -169,17 +183,52 @@ ProcessResult NativeLutProcessor::processImage(
     }
 
     try {
-        // 检查内存压力
-        if (g_global_memory_manager && g_global_memory_manager->isMemoryPressureHigh()) {
-            LOGW("内存压力高，触发优化");
-            g_global_memory_manager->handleMemoryPressure();
+        // 只在没有SIMD内核时烘焙（见LutBaker::isPreferred），否则直接走NEON/AVX2/SSE4.1浮点内核。
+        // LUT组合与强度不变时复用烘焙结果；只在烘焙期间持锁，处理使用不可变快照，
+        // 其他参数的请求重新烘焙时替换的是新对象，不影响正在处理的图片
+        ProcessingParams effectiveParams = params;
+        std::shared_ptr<const BakedLutData> bakedSnapshot;
+        if (params.useBakedLut && LutBaker::isPreferred()) {
+            {
+                std::lock_guard<std::mutex> bakeLock(bakeMutex_);
+                if (!bakedLut_ || !LutBaker::isBakeCurrent(*bakedLut_, secondaryLut_, params)) {
+                    auto baked = std::make_shared<BakedLutData>();
+                    bakedLut_.reset();
+                    if (LutBaker::bake(primaryLut_, secondaryLut_, params, *baked)) {
+                        bakedLut_ = std::move(baked);
+                    }
+                }
+                bakedSnapshot = bakedLut_;
+            }
+            effectiveParams.bakedLut = bakedSnapshot.get();
+        }
+
+        // 按输入与输出图片预留工作集，放不下时只短暂排队，仍放不下则改为流式处理，
+        // 而不是长时间阻塞调用线程或处理中途再清理
+        size_t workingSet = static_cast<size_t>(inputImage.stride) * inputImage.height;
+        if (outputImage.pixels != inputImage.pixels) {
+            workingSet += static_cast<size_t>(outputImage.stride) * outputImage.height;
+        }
+        MemoryAdmissionController::Reservation reservation =
+                MemoryAdmissionController::getInstance().reserve(
+                        workingSet, std::chrono::milliseconds(ADMISSION_WAIT_MS),
+                        cancelCallback);
+        if (!reservation.isValid()) {
+            if (cancelCallback && cancelCallback()) {
+                LOGI("处理在等待内存准入时被取消");
+                return ProcessResult::ERROR_PROCESSING_FAILED;
+            }
+            LOGW("整图处理未能准入（%.2f MB），改为流式处理",
+                 workingSet / (1024.0 * 1024.0));
+            return processImageStreamingFallback(inputImage, outputImage, effectiveParams,
+                                                 callback, cancelCallback);
         }
 
         // 根据参数选择处理方式
         if (params.useMultiThreading && getOptimalThreadCount() > 1) {
-            return processImageMultiThreaded(inputImage, outputImage, params, callback);
+            return processImageMultiThreaded(inputImage, outputImage, effectiveParams, callback);
         } else {
-            return processImageSingleThreaded(inputImage, outputImage, params, callback);
+            return processImageSingleThreaded(inputImage, outputImage, effectiveParams, callback);
         }
     } catch (const std::exception &e) {
         LOGE("图片处理时发生异常: %s", e.what());
@@ -187,6 +236,11 @@ ProcessResult NativeLutProcessor::processImage(
     }
 }
 
+void NativeLutProcessor::invalidateBakedLut() {
+    std::lock_guard<std::mutex> lock(bakeMutex_);
+    bakedLut_.reset();
+}
+
 void *NativeLutProcessor::allocateNativeMemory(size_t size) {
     if (g_global_memory_manager) {
         return g_global_memory_manager->allocate(size);
@@ -238,11 +292,36 @@ ProcessResult NativeLutProcessor::processImageMultiThreaded(
         const ProcessingParams &params,
         NativeProgressCallback callback
 ) {
+    // 本次处理的临时缓冲区从任务内存中分配，返回时一次性归还内存池
+    JobArena arena;
     return ImageProcessor::processMultiThreaded(
-            input, output, primaryLut_, secondaryLut_, params, callback
+            input, output, primaryLut_, secondaryLut_, params, callback, &arena
     );
 }
 
+ProcessResult NativeLutProcessor::processImageStreamingFallback(
+        const ImageInfo &input,
+        ImageInfo &output,
+        const ProcessingParams &params,
+        NativeProgressCallback callback,
+        const NativeCancelCallback &cancelCallback
+) {
+    StreamingConfig config;
+    config.maxMemoryUsage = STREAMING_FALLBACK_MEMORY;
+    config.enableParallelProcessing = params.useMultiThreading;
+
+    StreamingProcessor streamingProcessor;
+    streamingProcessor.setConfig(config);
+    return streamingProcessor.processImageStreaming(
+            input, output, primaryLut_, secondaryLut_, params,
+            [callback](const StreamingProgress &progress) {
+                if (callback) {
+                    callback(static_cast<float>(progress.getProgress()));
+                }
+            },
+            cancelCallback);
+}
+
 // 配置方法实现
 void NativeLutProcessor::setMultiThreadingEnabled(bool enabled) {
     multiThreadingEnabled_ = enabled;
@@ -277,9 +356,43 @@ bool NativeLutProcessor::isDitheringEnabled() const {
 }
 
 bool NativeLutProcessor::loadLut(const char *lutPath) {
-    // TODO: 实现从文件加载LUT的逻辑
-    (void) lutPath; // 抑制未使用参数警告
-    return false;
+    if (!lutPath) {
+        LOGE("LUT文件路径为空");
+        return false;
+    }
+
+    // 解析（或从二进制缓存读取）到临时对象，成功后再替换当前主LUT
+    LutData loaded;
+    if (LutProcessor::loadLutFromFile(lutPath, loaded) != ProcessResult::SUCCESS) {
+        LOGE("从文件加载LUT失败: %s", lutPath);
+        return false;
+    }
+
+    replacePrimaryLut(std::move(loaded));
+    LOGI("主LUT从文件加载成功，尺寸: %d", primaryLut_.size);
+    return true;
+}
+
+bool NativeLutProcessor::loadLutFromText(const uint8_t *lutBytes, size_t size) {
+    // 没有文件路径时无法使用二进制缓存，直接用Native解析器解析.cube/.3dl文本
+    LutData loaded;
+    if (LutProcessor::loadLutFromMemory(lutBytes, size, loaded) != ProcessResult::SUCCESS) {
+        LOGE("从内存解析LUT失败");
+        return false;
+    }
+
+    replacePrimaryLut(std::move(loaded));
+    LOGI("主LUT从内存解析成功，尺寸: %d", primaryLut_.size);
+    return true;
+}
+
+void NativeLutProcessor::replacePrimaryLut(LutData &&loaded) {
+    invalidateBakedLut();
+    if (primaryLut_.isLoaded) {
+        nativeMemoryUsage_ -= primaryLut_.data.size() * sizeof(float);
+    }
+    primaryLut_ = std::move(loaded);
+    nativeMemoryUsage_ += primaryLut_.data.size() * sizeof(float);
 }
 
 bool NativeLutProcessor::loadLutFromMemory(const void *lutData, size_t dataSize) {
@@ -381,11 +494,87 @@ Java_cn_alittlecookie_lut2photo_lut2photo_core_NativeLutProcessor_nativeLoadLut(
     return static_cast<jint>(result);
 }
 
+JNIEXPORT jint JNICALL
+Java_cn_alittlecookie_lut2photo_lut2photo_core_NativeLutProcessor_nativeLoadLutBytes(
+        JNIEnv *env, jobject thiz, jlong handle, jbyteArray lutBytes
+) {
+    (void) thiz; // 抑制未使用参数警告
+    if (handle == 0 || lutBytes == nullptr) {
+        LOGE("无效的处理器句柄或LUT数据");
+        return static_cast<jint>(ProcessResult::ERROR_INVALID_PARAMETERS);
+    }
+
+    auto processor = reinterpret_cast<NativeLutProcessor *>(handle);
+
+    jsize length = env->GetArrayLength(lutBytes);
+    jbyte *bytes = env->GetByteArrayElements(lutBytes, nullptr);
+    if (!bytes) {
+        return static_cast<jint>(ProcessResult::ERROR_INVALID_PARAMETERS);
+    }
+
+    bool success = processor->loadLutFromText(reinterpret_cast<const uint8_t *>(bytes),
+                                              static_cast<size_t>(length));
+    env->ReleaseByteArrayElements(lutBytes, bytes, JNI_ABORT);
+
+    return static_cast<jint>(success ? ProcessResult::SUCCESS
+                                     : ProcessResult::ERROR_LUT_NOT_LOADED);
+}
+
+JNIEXPORT void JNICALL
+Java_cn_alittlecookie_lut2photo_lut2photo_core_NativeLutProcessor_nativeSetLutCacheDirectory(
+        JNIEnv *env, jobject thiz, jstring cacheDir
+) {
+    (void) thiz; // 抑制未使用参数警告
+    if (cacheDir == nullptr) {
+        LutCache::setCacheDirectory("");
+        StrategyCostModel::getInstance().setProfilePath("");
+        TileAutotuner::getInstance().setProfilePath("");
+        return;
+    }
+
+    const char *dir = env->GetStringUTFChars(cacheDir, nullptr);
+    if (dir) {
+        LutCache::setCacheDirectory(dir);
+        // 处理策略与分块尺寸的实测画像与LUT缓存放在同一目录
+        StrategyCostModel::getInstance().setProfilePath(std::string(dir) + "/strategy_profile.bin");
+        TileAutotuner::getInstance().setProfilePath(std::string(dir) + "/tile_tuning.bin");
+        env->ReleaseStringUTFChars(cacheDir, dir);
+    }
+}
+
+JNIEXPORT void JNICALL
+Java_cn_alittlecookie_lut2photo_lut2photo_core_NativeLutProcessor_nativeSetCorePinning(
+        JNIEnv *env, jobject thiz, jboolean enabled
+) {
+    (void) env;
+    (void) thiz; // 抑制未使用参数警告
+    // 绑核是线程池的进程级设置，由应用设置一次，不随单个任务切换
+    ThreadPool::getInstance().setCorePinning(enabled == JNI_TRUE);
+}
+
+JNIEXPORT jbyteArray JNICALL
+Java_cn_alittlecookie_lut2photo_lut2photo_core_NativeLutProcessor_nativeGetDitherMatrix(
+        JNIEnv *env, jclass clazz, jint ditherType
+) {
+    (void) clazz; // 抑制未使用参数警告
+    const uint8_t *matrix = DitherMatrix::getMatrix(ditherType);
+    if (!matrix) {
+        return nullptr;
+    }
+
+    const jsize length = DitherMatrix::SIZE * DitherMatrix::SIZE;
+    jbyteArray result = env->NewByteArray(length);
+    if (result) {
+        env->SetByteArrayRegion(result, 0, length, reinterpret_cast<const jbyte *>(matrix));
+    }
+    return result;
+}
+
 JNIEXPORT jint JNICALL
 Java_cn_alittlecookie_lut2photo_lut2photo_core_NativeLutProcessor_nativeProcessBitmap(
         JNIEnv *env, jobject thiz, jlong handle, jobject inputBitmap, jobject outputBitmap,
         jfloat strength, jfloat lut2Strength, jint quality, jint ditherType,
-        jboolean useMultiThreading
+        jboolean useMultiThreading, jint interpolationMode, jint schedulerMode, jobject job
 ) {
     (void) thiz; // 抑制未使用参数警告
     if (handle == 0) {
@@ -428,9 +617,33 @@ Java_cn_alittlecookie_lut2photo_lut2photo_core_NativeLutProcessor_nativeProcessB
     params.quality = quality;
     params.ditherType = ditherType;
     params.useMultiThreading = useMultiThreading;
+    params.interpolationMode = interpolationMode;
+    params.schedulerMode = schedulerMode;
+
+    // 调用方协程的Job被取消时放弃排队与后续分块；取消回调只在当前线程上调用，可直接使用env
+    NativeCancelCallback cancelCallback;
+    if (job) {
+        jclass jobClass = env->GetObjectClass(job);
+        jmethodID isActive = env->GetMethodID(jobClass, "isActive", "()Z");
+        env->DeleteLocalRef(jobClass);
+        if (isActive) {
+            cancelCallback = [env, job, isActive]() {
+                const bool active = env->CallBooleanMethod(job, isActive);
+                if (env->ExceptionCheck()) {
+                    env->ExceptionClear();
+                    return false;
+                }
+                return !active;
+            };
+        } else {
+            env->ExceptionClear();
+            LOGW("无法获取Job.isActive，处理不响应取消");
+        }
+    }
 
     // 执行处理
-    ProcessResult result = processor->processImage(inputInfo, outputInfo, params);
+    ProcessResult result = processor->processImage(inputInfo, outputInfo, params, nullptr,
+                                                   cancelCallback);
 
     // 解锁Bitmap像素
     AndroidBitmap_unlockPixels(env, inputBitmap);
@@ -483,6 +696,8 @@ Java_cn_alittlecookie_lut2photo_lut2photo_core_NativeLutProcessor_nativeSetMemor
     }
 
     g_global_memory_manager->setMemoryLimit(static_cast<size_t>(limitBytes));
+    // 同时作为所有处理任务预留总量的上限
+    MemoryAdmissionController::getInstance().setBudget(static_cast<size_t>(limitBytes));
 
     LOGD("设置Native内存限制: %ld bytes (%.2f MB)",
          static_cast<long>(limitBytes), limitBytes / (1024.0 * 1024.0));
@@ -807,6 +1022,7 @@ Java_cn_alittlecookie_lut2photo_lut2photo_core_NativeLutProcessor_nativeCleanupG
         std::lock_guard<std::mutex> lock(g_processor_mutex);
         g_enhanced_processors.clear();
         g_global_memory_manager = nullptr;
+        StrategyCostModel::getInstance().flush();
         g_init_flag = false;
         return 0;
     } catch (const std::exception &e) {
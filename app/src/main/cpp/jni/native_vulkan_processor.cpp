@@ -39,6 +39,7 @@ Java_cn_alittlecookie_lut2photo_lut2photo_gpu_VulkanLutProcessor_nativeIsVulkanA
 ) {
     LOGD("Checking Vulkan availability...");
     
+    // 只探测实例与物理设备，结果在进程内缓存
     bool supported = vulkan::VkContext::isVulkanSupported();
     LOGI("Vulkan supported: %s", supported ? "true" : "false");
     
@@ -50,7 +51,7 @@ Java_cn_alittlecookie_lut2photo_lut2photo_gpu_VulkanLutProcessor_nativeIsVulkanA
  */
 JNIEXPORT jlong JNICALL
 Java_cn_alittlecookie_lut2photo_lut2photo_gpu_VulkanLutProcessor_nativeCreate(
-    JNIEnv* env, jobject thiz, jobject assetManager
+    JNIEnv* env, jobject thiz, jobject assetManager, jstring cacheDir
 ) {
     LOGI("Creating Vulkan processor...");
     
@@ -86,6 +87,16 @@ Java_cn_alittlecookie_lut2photo_lut2photo_gpu_VulkanLutProcessor_nativeCreate(
             processor->computePipeline->setAssetManager(processor->assetManager);
         }
         
+        // 管线缓存保存在应用缓存目录
+        if (cacheDir != nullptr) {
+            const char* dir = env->GetStringUTFChars(cacheDir, nullptr);
+            if (dir) {
+                processor->computePipeline->setPipelineCachePath(
+                    std::string(dir) + "/vk_pipeline_cache.bin");
+                env->ReleaseStringUTFChars(cacheDir, dir);
+            }
+        }
+        
         if (!processor->computePipeline->initialize()) {
             LOGE("Failed to initialize compute pipeline");
             return 0;
@@ -335,6 +346,119 @@ Java_cn_alittlecookie_lut2photo_lut2photo_gpu_VulkanLutProcessor_nativeProcessIm
     }
 }
 
+/**
+ * 批量处理图像（同一组参数），多帧在途使上传、计算与回读相互重叠
+ * @return 每张图像是否成功，参数无效时返回nullptr
+ */
+JNIEXPORT jbooleanArray JNICALL
+Java_cn_alittlecookie_lut2photo_lut2photo_gpu_VulkanLutProcessor_nativeProcessBatch(
+    JNIEnv* env, jobject thiz, jlong handle,
+    jobjectArray inputBitmaps, jobjectArray outputBitmaps,
+    jfloat lutStrength, jfloat lut2Strength, jint ditherType,
+    jboolean grainEnabled, jfloat grainStrength, jfloat grainSize, jfloat grainSeed
+) {
+    if (handle == 0 || inputBitmaps == nullptr || outputBitmaps == nullptr) {
+        LOGE("Invalid arguments for process batch");
+        return nullptr;
+    }
+
+    const jsize count = env->GetArrayLength(inputBitmaps);
+    if (count == 0 || env->GetArrayLength(outputBitmaps) != count) {
+        LOGE("Input and output bitmap counts don't match");
+        return nullptr;
+    }
+
+    LOGI("Processing batch of %d images with Vulkan...", count);
+
+    try {
+        auto processor = reinterpret_cast<VulkanProcessor*>(handle);
+        if (!processor->initialized || !processor->computePipeline) {
+            LOGE("Processor not initialized");
+            return nullptr;
+        }
+
+        // 逐张锁定像素，格式或尺寸不符的项直接标记失败，不影响其余各项
+        std::vector<vulkan::VkComputePipeline::BatchItem> items;
+        std::vector<jsize> itemIndices;
+        std::vector<jobject> lockedBitmaps;
+        std::vector<jboolean> results(count, JNI_FALSE);
+        items.reserve(count);
+
+        for (jsize index = 0; index < count; ++index) {
+            jobject inputBitmap = env->GetObjectArrayElement(inputBitmaps, index);
+            jobject outputBitmap = env->GetObjectArrayElement(outputBitmaps, index);
+
+            AndroidBitmapInfo inputInfo;
+            AndroidBitmapInfo outputInfo;
+            if (inputBitmap == nullptr || outputBitmap == nullptr ||
+                AndroidBitmap_getInfo(env, inputBitmap, &inputInfo) != ANDROID_BITMAP_RESULT_SUCCESS ||
+                AndroidBitmap_getInfo(env, outputBitmap, &outputInfo) != ANDROID_BITMAP_RESULT_SUCCESS ||
+                inputInfo.format != ANDROID_BITMAP_FORMAT_RGBA_8888 ||
+                outputInfo.width != inputInfo.width || outputInfo.height != inputInfo.height) {
+                LOGE("Invalid bitmap pair at index %d", index);
+                continue;
+            }
+
+            void* inputPixels;
+            if (AndroidBitmap_lockPixels(env, inputBitmap, &inputPixels) != ANDROID_BITMAP_RESULT_SUCCESS) {
+                LOGE("Failed to lock input bitmap %d", index);
+                continue;
+            }
+            void* outputPixels;
+            if (AndroidBitmap_lockPixels(env, outputBitmap, &outputPixels) != ANDROID_BITMAP_RESULT_SUCCESS) {
+                LOGE("Failed to lock output bitmap %d", index);
+                AndroidBitmap_unlockPixels(env, inputBitmap);
+                continue;
+            }
+            lockedBitmaps.push_back(inputBitmap);
+            lockedBitmaps.push_back(outputBitmap);
+
+            vulkan::VkComputePipeline::BatchItem item;
+            item.width = static_cast<int>(inputInfo.width);
+            item.height = static_cast<int>(inputInfo.height);
+            item.inputPixels = static_cast<const uint8_t*>(inputPixels);
+            item.outputPixels = static_cast<uint8_t*>(outputPixels);
+            items.push_back(item);
+            itemIndices.push_back(index);
+        }
+
+        vulkan::VkComputePipeline::ProcessingParams params;
+        params.lutStrength = lutStrength;
+        params.lut2Strength = lut2Strength;
+        params.ditherType = ditherType;
+        params.grainEnabled = grainEnabled ? 1 : 0;
+        params.grainStrength = grainStrength;
+        params.grainSize = grainSize;
+        params.grainSeed = grainSeed;
+
+        if (!items.empty()) {
+            processor->computePipeline->processBatch(items, params);
+        }
+
+        for (jobject bitmap : lockedBitmaps) {
+            AndroidBitmap_unlockPixels(env, bitmap);
+        }
+
+        size_t succeeded = 0;
+        for (size_t i = 0; i < items.size(); ++i) {
+            if (items[i].success) {
+                results[itemIndices[i]] = JNI_TRUE;
+                ++succeeded;
+            }
+        }
+        LOGI("Batch processed: %zu/%d images succeeded", succeeded, count);
+
+        jbooleanArray resultArray = env->NewBooleanArray(count);
+        if (resultArray != nullptr) {
+            env->SetBooleanArrayRegion(resultArray, 0, count, results.data());
+        }
+        return resultArray;
+    } catch (const std::exception& e) {
+        LOGE("Exception processing batch: %s", e.what());
+        return nullptr;
+    }
+}
+
 /**
  * 释放资源
  */
@@ -368,30 +492,56 @@ Java_cn_alittlecookie_lut2photo_lut2photo_gpu_VulkanLutProcessor_nativeRelease(
 }
 
 /**
- * 创建用于查询的轻量级Vulkan上下文
+ * 选择存储缓冲区或存储图像计算路径
+ */
+JNIEXPORT jboolean JNICALL
+Java_cn_alittlecookie_lut2photo_lut2photo_gpu_VulkanLutProcessor_nativeSetStorageBufferPath(
+    JNIEnv* env, jobject thiz, jlong handle, jboolean enabled
+) {
+    if (handle == 0) {
+        return JNI_FALSE;
+    }
+    
+    try {
+        auto processor = reinterpret_cast<VulkanProcessor*>(handle);
+        if (!processor->initialized || !processor->computePipeline) {
+            return JNI_FALSE;
+        }
+        
+        const auto path = enabled ? vulkan::VkComputePipeline::ComputePath::STORAGE_BUFFER
+                                  : vulkan::VkComputePipeline::ComputePath::STORAGE_IMAGE;
+        return processor->computePipeline->setComputePath(path) ? JNI_TRUE : JNI_FALSE;
+    } catch (const std::exception& e) {
+        LOGE("Exception setting compute path: %s", e.what());
+        return JNI_FALSE;
+    }
+}
+
+/**
+ * 创建用于查询的设备信息（只探测实例与物理设备，不创建逻辑设备）
  */
 JNIEXPORT jlong JNICALL
 Java_cn_alittlecookie_lut2photo_lut2photo_core_ProcessorSelectionStrategy_nativeCreateForQuery(
         JNIEnv *env, jclass thiz
 ) {
-    LOGI("Creating Vulkan context for query...");
+    LOGI("Probing Vulkan device for query...");
     
     try {
-        auto context = std::make_unique<vulkan::VkContext>();
-        if (!context->initialize()) {
-            LOGE("Failed to initialize Vulkan context for query");
+        auto probe = std::make_unique<vulkan::VkContext::DeviceProbe>(vulkan::VkContext::probe());
+        if (!probe->available) {
+            LOGE("No suitable Vulkan device for query");
             return 0;
         }
         
-        return reinterpret_cast<jlong>(context.release());
+        return reinterpret_cast<jlong>(probe.release());
     } catch (const std::exception& e) {
-        LOGE("Exception creating Vulkan context for query: %s", e.what());
+        LOGE("Exception probing Vulkan device for query: %s", e.what());
         return 0;
     }
 }
 
 /**
- * 销毁查询用的Vulkan上下文
+ * 销毁查询用的设备信息
  */
 JNIEXPORT void JNICALL
 Java_cn_alittlecookie_lut2photo_lut2photo_core_ProcessorSelectionStrategy_nativeDestroyForQuery(
@@ -401,13 +551,7 @@ Java_cn_alittlecookie_lut2photo_lut2photo_core_ProcessorSelectionStrategy_native
         return;
     }
     
-    try {
-        auto context = reinterpret_cast<vulkan::VkContext*>(handle);
-        context->cleanup();
-        delete context;
-    } catch (const std::exception& e) {
-        LOGE("Exception destroying Vulkan context for query: %s", e.what());
-    }
+    delete reinterpret_cast<vulkan::VkContext::DeviceProbe*>(handle);
 }
 
 /**
@@ -422,8 +566,8 @@ Java_cn_alittlecookie_lut2photo_lut2photo_core_ProcessorSelectionStrategy_native
     }
     
     try {
-        auto context = reinterpret_cast<vulkan::VkContext*>(handle);
-        return static_cast<jint>(context->getMaxImageDimension2D());
+        auto probe = reinterpret_cast<vulkan::VkContext::DeviceProbe*>(handle);
+        return static_cast<jint>(probe->properties.limits.maxImageDimension2D);
     } catch (const std::exception& e) {
         LOGE("Exception getting max texture size: %s", e.what());
         return 4096;
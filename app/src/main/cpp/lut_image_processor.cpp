@@ -5,8 +5,10 @@
 #endif
 
 #include "native_lut_processor.h"
+#include "utils/job_arena.h"
 #include <chrono>
 #include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <future>
 
@@ -146,7 +148,8 @@ LutImageProcessor::processFrameAsync(const MediaFrame &input) {
         return future;
     }
 
-    // 创建输入帧的副本
+    // 输入帧的副本属于本次任务的临时内存，任务结束时随JobArena一起释放
+    auto arena = std::make_shared<JobArena>();
     auto inputCopy = std::make_unique<MediaFrame>();
     inputCopy->width = input.width;
     inputCopy->height = input.height;
@@ -154,7 +157,7 @@ LutImageProcessor::processFrameAsync(const MediaFrame &input) {
     inputCopy->dataSize = input.dataSize;
 
     if (input.data && input.dataSize > 0) {
-        inputCopy->data = memoryManager_->allocate(input.dataSize);
+        inputCopy->data = arena->allocate(input.dataSize);
         if (!inputCopy->data) {
             promise->set_exception(std::make_exception_ptr(
                     MemoryException(ExceptionType::MEMORY_ALLOCATION_FAILED,
@@ -163,16 +166,12 @@ LutImageProcessor::processFrameAsync(const MediaFrame &input) {
         }
 
         std::memcpy(inputCopy->data, input.data, input.dataSize);
-        inputCopy->ownsData = true;
-        inputCopy->deleter = [this, data = inputCopy->data]() {
-            memoryManager_->deallocate(data);
-        };
     }
 
     // 添加任务到队列
     {
         std::lock_guard<std::mutex> lock(taskMutex_);
-        taskQueue_.push([this, promise, inputPtr = inputCopy.release()]() mutable {
+        taskQueue_.push([this, promise, arena, inputPtr = inputCopy.release()]() mutable {
             std::unique_ptr<MediaFrame> inputCopy(inputPtr);
             try {
                 auto result = processFrame(*inputCopy);
@@ -180,6 +179,8 @@ LutImageProcessor::processFrameAsync(const MediaFrame &input) {
             } catch (...) {
                 promise->set_exception(std::current_exception());
             }
+            inputCopy.reset();
+            arena->reset();
         });
     }
 
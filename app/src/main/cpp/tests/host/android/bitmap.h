@@ -0,0 +1,41 @@
+#ifndef HOST_ANDROID_BITMAP_H
+#define HOST_ANDROID_BITMAP_H
+
+/**
+ * 主机测试用的Bitmap替身，主机上没有Java Bitmap，所有操作均失败
+ */
+
+#include <cstdint>
+#include <jni.h>
+
+enum AndroidBitmapFormat {
+    ANDROID_BITMAP_FORMAT_NONE = 0,
+    ANDROID_BITMAP_FORMAT_RGBA_8888 = 1,
+};
+
+enum {
+    ANDROID_BITMAP_RESULT_SUCCESS = 0,
+    ANDROID_BITMAP_RESULT_BAD_PARAMETER = -1,
+};
+
+typedef struct {
+    uint32_t width;
+    uint32_t height;
+    uint32_t stride;
+    int32_t format;
+    uint32_t flags;
+} AndroidBitmapInfo;
+
+inline int AndroidBitmap_getInfo(JNIEnv *, jobject, AndroidBitmapInfo *) {
+    return ANDROID_BITMAP_RESULT_BAD_PARAMETER;
+}
+
+inline int AndroidBitmap_lockPixels(JNIEnv *, jobject, void **) {
+    return ANDROID_BITMAP_RESULT_BAD_PARAMETER;
+}
+
+inline int AndroidBitmap_unlockPixels(JNIEnv *, jobject) {
+    return ANDROID_BITMAP_RESULT_BAD_PARAMETER;
+}
+
+#endif // HOST_ANDROID_BITMAP_H
@@ -0,0 +1,36 @@
+#ifndef HOST_ANDROID_LOG_H
+#define HOST_ANDROID_LOG_H
+
+/**
+ * 主机测试用的日志替身，按"级别/标签: 消息"输出到stderr
+ */
+
+#include <cstdarg>
+#include <cstdio>
+
+enum android_LogPriority {
+    ANDROID_LOG_UNKNOWN = 0,
+    ANDROID_LOG_DEFAULT,
+    ANDROID_LOG_VERBOSE,
+    ANDROID_LOG_DEBUG,
+    ANDROID_LOG_INFO,
+    ANDROID_LOG_WARN,
+    ANDROID_LOG_ERROR,
+    ANDROID_LOG_FATAL,
+    ANDROID_LOG_SILENT,
+};
+
+__attribute__((format(printf, 3, 4)))
+inline int __android_log_print(int prio, const char *tag, const char *fmt, ...) {
+    static const char levels[] = "??VDIWEFS";
+    const char level = prio >= 0 && prio <= ANDROID_LOG_SILENT ? levels[prio] : '?';
+    std::fprintf(stderr, "%c/%s: ", level, tag);
+    va_list args;
+    va_start(args, fmt);
+    const int written = std::vfprintf(stderr, fmt, args);
+    va_end(args);
+    std::fputc('\n', stderr);
+    return written;
+}
+
+#endif // HOST_ANDROID_LOG_H
@@ -0,0 +1,112 @@
+#ifndef HOST_JNI_H
+#define HOST_JNI_H
+
+/**
+ * 主机测试用的JNI替身
+ * 只提供本库源文件用到的类型与JNIEnv方法，使JNI入口函数能在主机上编译；
+ * 主机测试直接调用C++接口，不会经过这些入口，方法均返回空值
+ */
+
+#include <cstdint>
+#include <cstddef>
+
+typedef uint8_t jboolean;
+typedef int8_t jbyte;
+typedef int32_t jint;
+typedef int64_t jlong;
+typedef float jfloat;
+typedef double jdouble;
+typedef jint jsize;
+
+struct _jobject {
+};
+typedef _jobject *jobject;
+typedef jobject jclass;
+typedef jobject jstring;
+typedef jobject jthrowable;
+typedef jobject jarray;
+typedef jarray jobjectArray;
+typedef jarray jbooleanArray;
+typedef jarray jbyteArray;
+typedef jarray jintArray;
+typedef jarray jlongArray;
+typedef jarray jfloatArray;
+
+typedef struct _jmethodID *jmethodID;
+typedef struct _jfieldID *jfieldID;
+
+#define JNIEXPORT __attribute__((visibility("default")))
+#define JNICALL
+
+#define JNI_FALSE 0
+#define JNI_TRUE 1
+#define JNI_OK 0
+#define JNI_EDETACHED (-2)
+#define JNI_ABORT 2
+#define JNI_VERSION_1_6 0x00010006
+
+struct JNIEnv {
+    jclass FindClass(const char *) { return nullptr; }
+
+    jclass GetObjectClass(jobject) { return nullptr; }
+
+    void DeleteLocalRef(jobject) {}
+
+    jboolean ExceptionCheck() { return JNI_FALSE; }
+
+    void ExceptionClear() {}
+
+    jmethodID GetMethodID(jclass, const char *, const char *) { return nullptr; }
+
+    jmethodID GetStaticMethodID(jclass, const char *, const char *) { return nullptr; }
+
+    jfieldID GetFieldID(jclass, const char *, const char *) { return nullptr; }
+
+    jint GetIntField(jobject, jfieldID) { return 0; }
+
+    jobject NewObject(jclass, jmethodID, ...) { return nullptr; }
+
+    jboolean CallBooleanMethod(jobject, jmethodID, ...) { return JNI_FALSE; }
+
+    void CallStaticVoidMethod(jclass, jmethodID, ...) {}
+
+    jstring NewStringUTF(const char *) { return nullptr; }
+
+    const char *GetStringUTFChars(jstring, jboolean *) { return ""; }
+
+    void ReleaseStringUTFChars(jstring, const char *) {}
+
+    jsize GetArrayLength(jarray) { return 0; }
+
+    jobjectArray NewObjectArray(jsize, jclass, jobject) { return nullptr; }
+
+    jobject GetObjectArrayElement(jobjectArray, jsize) { return nullptr; }
+
+    void SetObjectArrayElement(jobjectArray, jsize, jobject) {}
+
+    jbooleanArray NewBooleanArray(jsize) { return nullptr; }
+
+    void SetBooleanArrayRegion(jbooleanArray, jsize, jsize, const jboolean *) {}
+
+    jbyteArray NewByteArray(jsize) { return nullptr; }
+
+    void SetByteArrayRegion(jbyteArray, jsize, jsize, const jbyte *) {}
+
+    jbyte *GetByteArrayElements(jbyteArray, jboolean *) { return nullptr; }
+
+    void ReleaseByteArrayElements(jbyteArray, jbyte *, jint) {}
+
+    jfloat *GetFloatArrayElements(jfloatArray, jboolean *) { return nullptr; }
+
+    void ReleaseFloatArrayElements(jfloatArray, jfloat *, jint) {}
+};
+
+struct JavaVM {
+    jint GetEnv(void **, jint) { return JNI_EDETACHED; }
+
+    jint AttachCurrentThread(JNIEnv **, void *) { return -1; }
+
+    jint DetachCurrentThread() { return JNI_OK; }
+};
+
+#endif // HOST_JNI_H
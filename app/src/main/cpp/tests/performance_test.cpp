@@ -1,8 +1,29 @@
 #include "performance_test.h"
-#include "../memory_manager.h"
+#include "../utils/memory_manager.h"
 #include "../lut_image_processor.h"
-#include "../media_processor_interface.h"
-#include "../exception_handler.h"
+#include "../interfaces/media_processor_interface.h"
+#include "../utils/exception_handler.h"
+#include "../core/lut_processor.h"
+#include "../core/image_processor.h"
+#include "../core/lut_baker.h"
+#include "../core/lut_cache.h"
+#include "../core/streaming_processor.h"
+#include "../core/strategy_cost_model.h"
+#include "../core/tile_autotuner.h"
+#include "../utils/simd_utils.h"
+#include "../utils/thread_pool.h"
+#include "../utils/cpu_topology.h"
+#include "../utils/dither_matrix.h"
+#include "../utils/job_arena.h"
+#include "../utils/large_page_allocator.h"
+#include "../utils/memory_pool.h"
+#include "../utils/memory_admission.h"
+#ifdef VULKAN_ENABLED
+#include "../vulkan/vk_context.h"
+#include "../vulkan/vk_memory_pool.h"
+#include "../vulkan/vk_staging_ring.h"
+#include "../vulkan/vk_compute_pipeline.h"
+#endif
 
 #include <algorithm>
 #include <numeric>
@@ -13,6 +34,22 @@
 #include <future>
 #include <random>
 #include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sys/stat.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+// 前面的头文件也定义了同名日志宏，这里统一换成测试自己的
+#undef LOGI
+#undef LOGE
 
 #ifdef __ANDROID__
 
@@ -54,7 +91,7 @@ PerformanceResult PerformanceTestSuite::testMemoryAllocation() {
             // 写入数据验证分配成功
             memset(ptr, 0xAA, size);
 
-            memoryManager_->deallocate(ptr, size);
+            memoryManager_->deallocate(ptr);
             return true;
         } catch (...) {
             return false;
@@ -70,7 +107,7 @@ PerformanceResult PerformanceTestSuite::testMemoryDeallocation() {
             if (!ptr) return false;
 
             BenchmarkTool::Timer timer;
-            memoryManager_->deallocate(ptr, size);
+            memoryManager_->deallocate(ptr);
 
             return timer.elapsedMs() < 10.0; // 期望释放时间小于10ms
         } catch (...) {
@@ -89,7 +126,7 @@ PerformanceResult PerformanceTestSuite::testMemoryPoolPerformance() {
             // 验证是否从内存池分配
             size_t poolAllocated = memoryManager_->getPoolAllocatedBytes();
 
-            memoryManager_->deallocate(ptr, size);
+            memoryManager_->deallocate(ptr);
             return poolAllocated > 0;
         } catch (...) {
             return false;
@@ -105,7 +142,7 @@ PerformanceResult PerformanceTestSuite::testStreamingProcessorPerformance() {
 
             ProcessingConfig config;
             config.enableStreaming = true;
-            config.memoryLimit = 128 * 1024 * 1024; // 128MB
+            config.maxMemoryUsage = 128 * 1024 * 1024; // 128MB
 
             processor_->updateConfig(config);
 
@@ -123,11 +160,8 @@ PerformanceResult PerformanceTestSuite::testLutProcessingPerformance() {
             auto testImage = createTestImage(1920, 1080);
             if (!testImage) return false;
 
-            // 创建测试LUT
-            std::vector<float> lutData(256 * 256 * 256 * 3);
-            std::iota(lutData.begin(), lutData.end(), 0.0f);
-
-            processor_->loadLut(lutData.data(), 256);
+            // 加载测试LUT
+            if (!loadTestLut()) return false;
 
             auto result = processor_->processFrame(*testImage);
             return result != nullptr;
@@ -143,12 +177,12 @@ PerformanceResult PerformanceTestSuite::testBatchProcessingPerformance() {
             auto testBatch = createTestImageBatch(10, 1920, 1080);
             if (testBatch.empty()) return false;
 
-            std::vector<MediaFrame *> frames;
+            std::vector<std::reference_wrapper<const MediaFrame>> frames;
             for (auto &frame: testBatch) {
-                frames.push_back(frame.get());
+                frames.push_back(std::cref(*frame));
             }
 
-            auto results = processor_->processBatch(frames);
+            auto results = processor_->processFrames(frames);
             return results.size() == frames.size();
         } catch (...) {
             return false;
@@ -172,6 +206,2418 @@ PerformanceResult PerformanceTestSuite::testAsyncProcessingPerformance() {
     });
 }
 
+PerformanceResult PerformanceTestSuite::testTetrahedralInterpolationPerformance() {
+    // 33点非线性LUT，两种插值方式处理同一张1080p图片
+    LutData lut = createTestLut(33);
+    LutData emptyLut;
+
+    const int width = 1920;
+    const int height = 1080;
+    std::vector<uint8_t> input = PerformanceTestUtils::generateTestImageData(width, height, 4);
+    std::vector<uint8_t> trilinearOutput(input.size());
+    std::vector<uint8_t> tetrahedralOutput(input.size());
+
+    ProcessingParams trilinearParams;
+    trilinearParams.interpolationMode = 0;
+    ProcessingParams tetrahedralParams;
+    tetrahedralParams.interpolationMode = 1;
+
+    auto runPass = [&](const ProcessingParams &params, std::vector<uint8_t> &output) {
+        ImageProcessor::processPixelsBatch(input.data(), output.data(), width * height,
+                                           lut, emptyLut, params);
+    };
+
+    BenchmarkTool::Comparison comparison;
+    PerformanceResult result = runTimedTest("Tetrahedral Interpolation Performance", [&]() -> bool {
+        comparison.timeBaseline([&]() { runPass(trilinearParams, trilinearOutput); });
+        comparison.timeCandidate([&]() { runPass(tetrahedralParams, tetrahedralOutput); });
+        return true;
+    }, 10);
+
+    // 两种插值结果的最大差异（8位量化后）
+    int maxDifference = 0;
+    for (size_t i = 0; i < input.size(); ++i) {
+        maxDifference = std::max(maxDifference,
+                                 std::abs(trilinearOutput[i] - tetrahedralOutput[i]));
+    }
+
+    // 格点上两种插值都应精确取到LUT值：18点LUT的格点间距为15个8位色阶，输入逐一取遍所有格点
+    LutData latticeLut = createTestLut(18);
+    // 格点值对齐到8位色阶，量化时不会恰好落在半个色阶上而被浮点舍入误差左右
+    for (float &value: latticeLut.data) {
+        value = std::round(value * 255.0f) / 255.0f;
+    }
+    const int latticeStep = 255 / (latticeLut.size - 1);
+    const int latticePixels = latticeLut.size * latticeLut.size * latticeLut.size;
+    std::vector<uint8_t> latticeInput(latticePixels * 4);
+    for (int i = 0; i < latticePixels; ++i) {
+        latticeInput[i * 4 + 0] = static_cast<uint8_t>(i / (latticeLut.size * latticeLut.size) *
+                                                       latticeStep);
+        latticeInput[i * 4 + 1] = static_cast<uint8_t>(i / latticeLut.size % latticeLut.size *
+                                                       latticeStep);
+        latticeInput[i * 4 + 2] = static_cast<uint8_t>(i % latticeLut.size * latticeStep);
+        latticeInput[i * 4 + 3] = 255;
+    }
+    std::vector<uint8_t> latticeTrilinear(latticeInput.size());
+    std::vector<uint8_t> latticeTetrahedral(latticeInput.size());
+    ImageProcessor::processPixelsBatch(latticeInput.data(), latticeTrilinear.data(),
+                                       latticePixels, latticeLut, emptyLut, trilinearParams);
+    ImageProcessor::processPixelsBatch(latticeInput.data(), latticeTetrahedral.data(),
+                                       latticePixels, latticeLut, emptyLut, tetrahedralParams);
+    int latticeDifference = 0;
+    for (size_t i = 0; i < latticeInput.size(); ++i) {
+        latticeDifference = std::max(latticeDifference,
+                                     std::abs(latticeTrilinear[i] - latticeTetrahedral[i]));
+    }
+
+    // 格点之间四面体插值与三线性插值只允许很小的偏差，超过说明四面体选择或权重有误
+    if (maxDifference > 2 || latticeDifference != 0) {
+        result.markFailed();
+    }
+
+    comparison.addMetrics(result, "trilinear_ms", "tetrahedral_ms");
+    result.customMetrics["max_channel_difference"] = maxDifference;
+    result.customMetrics["lattice_max_difference"] = latticeDifference;
+
+    LOGI("插值对比: 三线性 %.2fms, 四面体 %.2fms, 最大通道差异 %d, 格点差异 %d",
+         comparison.baselineMs(), comparison.candidateMs(), maxDifference, latticeDifference);
+
+    return result;
+}
+
+PerformanceResult PerformanceTestSuite::testBakedLutPerformance() {
+    // 主LUT + 第二LUT，对比浮点处理链与烘焙后的整数查表路径
+    LutData primaryLut = createTestLut(33);
+    LutData secondaryLut = createTestLut(17);
+    for (float &value: secondaryLut.data) {
+        value = 1.0f - value;
+    }
+
+    ProcessingParams params;
+    params.strength = 0.8f;
+    params.lut2Strength = 0.5f;
+    params.interpolationMode = 1;
+
+    BenchmarkTool::Timer bakeTimer;
+    BakedLutData bakedLut;
+    if (!LutBaker::bake(primaryLut, secondaryLut, params, bakedLut)) {
+        LOGE("LUT烘焙失败");
+        return PerformanceResult();
+    }
+    double bakeMs = bakeTimer.elapsedMs();
+
+    const int width = 1920;
+    const int height = 1080;
+    std::vector<uint8_t> input = PerformanceTestUtils::generateTestImageData(width, height, 4);
+    std::vector<uint8_t> floatOutput(input.size());
+    std::vector<uint8_t> bakedOutput(input.size());
+
+    ProcessingParams bakedParams = params;
+    bakedParams.bakedLut = &bakedLut;
+
+    BenchmarkTool::Comparison comparison;
+    PerformanceResult result = runTimedTest("Baked LUT Performance", [&]() -> bool {
+        comparison.timeBaseline([&]() {
+            ImageProcessor::processPixelsBatch(input.data(), floatOutput.data(), width * height,
+                                               primaryLut, secondaryLut, params);
+        });
+        comparison.timeCandidate([&]() {
+            ImageProcessor::processPixelsBatch(input.data(), bakedOutput.data(), width * height,
+                                               primaryLut, secondaryLut, bakedParams);
+        });
+        return true;
+    }, 10);
+
+    int maxDifference = 0;
+    for (size_t i = 0; i < input.size(); ++i) {
+        maxDifference = std::max(maxDifference, std::abs(floatOutput[i] - bakedOutput[i]));
+    }
+    // 两级LUT串联，差异不能超过烘焙器声明的串联误差上限
+    if (maxDifference > LutBaker::MAX_CHAINED_LUT_ERROR) {
+        result.markFailed();
+    }
+
+    result.customMetrics["bake_ms"] = bakeMs;
+    comparison.addMetrics(result, "float_path_ms", "baked_path_ms");
+    result.customMetrics["max_channel_difference"] = maxDifference;
+
+    LOGI("烘焙LUT: 烘焙 %.2fms, 浮点路径 %.2fms, 整数路径 %.2fms, 最大通道差异 %d",
+         bakeMs, comparison.baselineMs(), comparison.candidateMs(), maxDifference);
+
+    return result;
+}
+
+PerformanceResult PerformanceTestSuite::testBakedLutDefaultParity() {
+    // 默认参数（三线性插值）下烘焙路径必须与浮点路径一致，烘焙不能改变插值方式
+    LutData primaryLut = createTestLut(33);
+    LutData emptyLut;
+
+    const int width = 1024;
+    const int height = 1024;
+    std::vector<uint8_t> input = PerformanceTestUtils::generateTestImageData(width, height, 4);
+    std::vector<uint8_t> floatOutput(input.size());
+    std::vector<uint8_t> bakedOutput(input.size());
+
+    int maxDifference[2] = {0, 0};
+    PerformanceResult result = runTimedTest("Baked LUT Default Parity", [&]() -> bool {
+        for (int mode = 0; mode < 2; ++mode) {
+            ProcessingParams params;
+            params.interpolationMode = mode;
+
+            BakedLutData bakedLut;
+            if (!LutBaker::bake(primaryLut, emptyLut, params, bakedLut)) {
+                return false;
+            }
+            ProcessingParams bakedParams = params;
+            bakedParams.bakedLut = &bakedLut;
+
+            ImageProcessor::processPixelsBatch(input.data(), floatOutput.data(), width * height,
+                                               primaryLut, emptyLut, params);
+            ImageProcessor::processPixelsBatch(input.data(), bakedOutput.data(), width * height,
+                                               primaryLut, emptyLut, bakedParams);
+
+            for (size_t i = 0; i < input.size(); ++i) {
+                maxDifference[mode] = std::max(maxDifference[mode],
+                                               std::abs(floatOutput[i] - bakedOutput[i]));
+            }
+        }
+        return maxDifference[0] <= LutBaker::MAX_SINGLE_LUT_ERROR &&
+               maxDifference[1] <= LutBaker::MAX_SINGLE_LUT_ERROR;
+    }, 3);
+
+    result.customMetrics["trilinear_max_difference"] = maxDifference[0];
+    result.customMetrics["tetrahedral_max_difference"] = maxDifference[1];
+
+    LOGI("烘焙LUT默认参数一致性: 三线性最大差异 %d, 四面体最大差异 %d",
+         maxDifference[0], maxDifference[1]);
+
+    return result;
+}
+
+PerformanceResult PerformanceTestSuite::testSimdKernelPerformance() {
+    // 对比逐像素标量处理与按运行时SIMD级别分派的批处理内核
+    LutData primaryLut = createTestLut(33);
+    const SimdLevel level = SIMDUtils::getSimdLevel();
+
+    ProcessingParams params;
+    params.strength = 0.8f;
+    params.interpolationMode = 1;
+    params.useBakedLut = false;
+
+    const int width = 1920;
+    const int height = 1080;
+    const int pixelCount = width * height;
+    std::vector<uint8_t> input = PerformanceTestUtils::generateTestImageData(width, height, 4);
+    std::vector<uint8_t> scalarOutput(input.size());
+    std::vector<uint8_t> simdOutput(input.size());
+    LutData emptyLut;
+
+    BenchmarkTool::Comparison comparison;
+    int maxDifference = 0;
+
+    PerformanceResult result = runTimedTest("SIMD Kernel Performance", [&]() -> bool {
+        comparison.timeBaseline([&]() {
+            for (int i = 0; i < pixelCount; ++i) {
+                ImageProcessor::processPixel(&input[i * 4], &scalarOutput[i * 4],
+                                             primaryLut, emptyLut, params);
+            }
+        });
+        comparison.timeCandidate([&]() {
+            SIMDUtils::processPixels(input.data(), simdOutput.data(), pixelCount,
+                                     primaryLut, emptyLut, params);
+        });
+
+        // 向量内核与逐像素标量实现只允许浮点舍入带来的1级差异
+        for (size_t i = 0; i < input.size(); ++i) {
+            maxDifference = std::max(maxDifference, std::abs(scalarOutput[i] - simdOutput[i]));
+        }
+        return maxDifference <= 1;
+    }, 10);
+
+    const double simdMs = comparison.candidateMs();
+    result.customMetrics["simd_level"] = static_cast<double>(level);
+    comparison.addMetrics(result, "scalar_ms", "simd_ms");
+    result.customMetrics["megapixels_per_second"] =
+            simdMs > 0.0 ? pixelCount / (simdMs * 1000.0) : 0.0;
+    result.customMetrics["max_channel_difference"] = maxDifference;
+
+    LOGI("SIMD内核(%s): 标量 %.2fms, SIMD %.2fms, 最大通道差异 %d",
+         SIMDUtils::getSimdLevelName(level), comparison.baselineMs(), simdMs, maxDifference);
+
+    return result;
+}
+
+#if USE_NEON_SIMD
+PerformanceResult PerformanceTestSuite::testNeonKernelParity() {
+    // NEON内核与标量实现逐像素对比：像素数不是16的倍数时尾部走标量路径，
+    // 有序抖动的起点不为0时尾部阈值行必须按dither.advanced()正确偏移
+    LutData primaryLut = createTestLut(33);
+    LutData secondaryLut = createTestLut(17);
+    LutData emptyLut;
+
+    const int pixelCounts[] = {1, 15, 16, 17, 31, 1000 * 16 + 13};
+    const int maxPixelCount = 1000 * 16 + 13;
+    std::vector<uint8_t> input = PerformanceTestUtils::generateTestImageData(maxPixelCount, 1, 4);
+    std::vector<uint8_t> scalarOutput(input.size());
+    std::vector<uint8_t> neonOutput(input.size());
+
+    int maxBodyDifference = 0;
+    int maxTailDifference = 0;
+    PerformanceResult result = runTimedTest("NEON Kernel Parity", [&]() -> bool {
+        for (int mode = 0; mode < 2; ++mode) {
+            for (int ditherType: {0, DitherMatrix::DITHER_BAYER, DitherMatrix::DITHER_BLUE_NOISE}) {
+                for (bool useSecondary: {false, true}) {
+                    ProcessingParams params;
+                    params.strength = 0.8f;
+                    params.lut2Strength = 0.6f;
+                    params.interpolationMode = mode;
+                    params.ditherType = ditherType;
+                    const LutData &secondary = useSecondary ? secondaryLut : emptyLut;
+                    // 起点列坐标取奇数，尾部阈值行的相位不会恰好回到0
+                    const OrderedDitherRow dither = DitherMatrix::isOrdered(ditherType)
+                                                    ? OrderedDitherRow(ditherType, 37, 5)
+                                                    : OrderedDitherRow();
+
+                    for (int pixelCount: pixelCounts) {
+                        SIMDUtils::processPixelsScalar(input.data(), scalarOutput.data(),
+                                                       pixelCount, primaryLut, secondary,
+                                                       params, dither);
+                        SIMDUtils::processPixelsNeon(input.data(), neonOutput.data(),
+                                                     pixelCount, primaryLut, secondary,
+                                                     params, dither);
+
+                        // 尾部与标量实现完全一致，向量部分只允许浮点舍入带来的1级差异
+                        const int tailStart = pixelCount - pixelCount % 16;
+                        for (int i = 0; i < pixelCount * 4; ++i) {
+                            const int difference = std::abs(scalarOutput[i] - neonOutput[i]);
+                            int &maxDifference = i / 4 < tailStart ? maxBodyDifference
+                                                                   : maxTailDifference;
+                            maxDifference = std::max(maxDifference, difference);
+                        }
+                    }
+                }
+            }
+        }
+        return maxBodyDifference <= 1 && maxTailDifference == 0;
+    }, 3);
+
+    result.customMetrics["body_max_difference"] = maxBodyDifference;
+    result.customMetrics["tail_max_difference"] = maxTailDifference;
+
+    LOGI("NEON内核一致性: 向量部分最大差异 %d, 尾部最大差异 %d",
+         maxBodyDifference, maxTailDifference);
+
+    return result;
+}
+#endif // USE_NEON_SIMD
+
+PerformanceResult PerformanceTestSuite::testDefaultPathPerformance() {
+    // NativeLutProcessor按默认参数处理时不能比直接调用SIMD内核慢：
+    // 有SIMD内核时不应烘焙，只有标量回退时才走烘焙查表
+    NativeLutProcessor processor;
+    LutData lut = createTestLut(33);
+    LutData emptyLut;
+    processor.loadLutFromArray(lut.data.data(), lut.size);
+
+    const int width = 1920;
+    const int height = 1080;
+    std::vector<uint8_t> input = PerformanceTestUtils::generateTestImageData(width, height, 4);
+    std::vector<uint8_t> defaultOutput(input.size());
+    std::vector<uint8_t> simdOutput(input.size());
+
+    ImageInfo inputInfo;
+    inputInfo.width = width;
+    inputInfo.height = height;
+    inputInfo.stride = width * 4;
+    inputInfo.pixels = input.data();
+    ImageInfo defaultInfo = inputInfo;
+    defaultInfo.pixels = defaultOutput.data();
+    ImageInfo simdInfo = inputInfo;
+    simdInfo.pixels = simdOutput.data();
+
+    // 单线程比较，避免线程调度的波动掩盖内核差异
+    ProcessingParams defaultParams;
+    defaultParams.useMultiThreading = false;
+    ProcessingParams simdParams = defaultParams;
+    simdParams.useBakedLut = false;
+
+    std::vector<double> defaultTimings;
+    std::vector<double> simdTimings;
+    int maxDifference = 0;
+
+    PerformanceResult result = runTimedTest("Default Path Performance", [&]() -> bool {
+        BenchmarkTool::Timer defaultTimer;
+        const bool processed = processor.processImage(inputInfo, defaultInfo, defaultParams) ==
+                               ProcessResult::SUCCESS;
+        defaultTimings.push_back(defaultTimer.elapsedMs());
+
+        BenchmarkTool::Timer simdTimer;
+        ImageProcessor::processSingleThreaded(inputInfo, simdInfo, lut, emptyLut, simdParams,
+                                              nullptr);
+        simdTimings.push_back(simdTimer.elapsedMs());
+
+        for (size_t i = 0; i < input.size(); ++i) {
+            maxDifference = std::max(maxDifference, std::abs(defaultOutput[i] - simdOutput[i]));
+        }
+        return processed;
+    }, 10);
+
+    // 取最快的一次，比较稳态下的内核开销
+    const double defaultMs = *std::min_element(defaultTimings.begin(), defaultTimings.end());
+    const double simdMs = *std::min_element(simdTimings.begin(), simdTimings.end());
+    const bool usesSimd = !LutBaker::isPreferred();
+
+    // 两者同为SIMD内核时输出应完全一致；标量回退时烘焙定点误差不超过1
+    const bool outputValid = maxDifference <= (usesSimd ? 0 : LutBaker::MAX_SINGLE_LUT_ERROR);
+    const bool speedValid = defaultMs <= simdMs * 1.2;
+    if (!outputValid || !speedValid) {
+        result.markFailed();
+    }
+
+    result.customMetrics["default_path_ms"] = defaultMs;
+    result.customMetrics["simd_path_ms"] = simdMs;
+    result.customMetrics["uses_simd"] = usesSimd ? 1.0 : 0.0;
+    result.customMetrics["max_channel_difference"] = maxDifference;
+
+    LOGI("默认路径(%s): 默认 %.2fms, SIMD %.2fms, 最大通道差异 %d",
+         usesSimd ? SIMDUtils::getSimdLevelName(SIMDUtils::getSimdLevel()) : "烘焙",
+         defaultMs, simdMs, maxDifference);
+
+    return result;
+}
+
+PerformanceResult PerformanceTestSuite::testThreadPoolDispatchPerformance() {
+    // 对比每次创建线程静态分行与持久线程池按行带窃取的调度开销（使用较小图片突出固定开销）
+    LutData primaryLut = createTestLut(33);
+    LutData emptyLut;
+    ProcessingParams params;
+    params.useBakedLut = false;
+
+    const int width = 640;
+    const int height = 480;
+    std::vector<uint8_t> input = PerformanceTestUtils::generateTestImageData(width, height, 4);
+    std::vector<uint8_t> spawnOutput(input.size());
+    std::vector<uint8_t> poolOutput(input.size());
+
+    ThreadPool &pool = ThreadPool::getInstance();
+    const int threadCount = pool.getWorkerCount() + 1;
+
+    BenchmarkTool::Comparison comparison;
+    PerformanceResult result = runTimedTest("Thread Pool Dispatch", [&]() -> bool {
+        comparison.timeBaseline([&]() {
+            std::vector<std::thread> threads;
+            const int rowsPerThread = height / threadCount;
+            for (int i = 0; i < threadCount; ++i) {
+                const int startRow = i * rowsPerThread;
+                const int endRow = (i == threadCount - 1) ? height : startRow + rowsPerThread;
+                threads.emplace_back([&, startRow, endRow]() {
+                    ImageProcessor::processPixelsBatch(&input[startRow * width * 4],
+                                                       &spawnOutput[startRow * width * 4],
+                                                       (endRow - startRow) * width,
+                                                       primaryLut, emptyLut, params);
+                });
+            }
+            for (auto &thread: threads) {
+                thread.join();
+            }
+        });
+        comparison.timeCandidate([&]() {
+            pool.parallelFor(0, height, 8, [&](int startRow, int endRow) {
+                ImageProcessor::processPixelsBatch(&input[startRow * width * 4],
+                                                   &poolOutput[startRow * width * 4],
+                                                   (endRow - startRow) * width,
+                                                   primaryLut, emptyLut, params);
+            });
+        });
+        // 只是调度方式不同，输出必须逐字节一致
+        return spawnOutput == poolOutput;
+    }, 50);
+
+    result.customMetrics["threads"] = threadCount;
+    comparison.addMetrics(result, "spawn_ms", "pool_ms");
+
+    LOGI("线程池调度: 创建线程 %.2fms, 线程池 %.2fms (%d线程)", comparison.baselineMs(),
+         comparison.candidateMs(), threadCount);
+
+    return result;
+}
+
+PerformanceResult PerformanceTestSuite::testAdaptiveSchedulingPerformance() {
+    // 先用模拟的1+3+4簇拓扑目录验证簇检测，再对比工作窃取与自适应分块两种调度模式
+    const std::string cacheDir = LutCache::getCacheDirectory();
+    const std::string topologyRoot = (cacheDir.empty() ? "/data/local/tmp" : cacheDir) +
+                                     "/perf_test_topology";
+    const long frequencies[] = {1800000, 1800000, 1800000, 1800000,
+                                2400000, 2400000, 2400000, 3200000};
+
+    bool topologyValid = true;
+    mkdir(topologyRoot.c_str(), 0755);
+    for (int cpu = 0; cpu < 8; ++cpu) {
+        const std::string cpuDir = topologyRoot + "/cpu" + std::to_string(cpu);
+        mkdir(cpuDir.c_str(), 0755);
+        mkdir((cpuDir + "/cpufreq").c_str(), 0755);
+        std::ofstream(cpuDir + "/cpufreq/cpuinfo_max_freq") << frequencies[cpu] << "\n";
+    }
+
+    CpuTopologyInfo topology;
+    if (!CpuTopology::detect(topologyRoot, topology) || topology.cpuCount != 8 ||
+        topology.clusters.size() != 3 || topology.clusters[0].cpus != std::vector<int>{7} ||
+        topology.clusters[2].cpus.size() != 4) {
+        LOGE("模拟拓扑检测结果不正确");
+        topologyValid = false;
+    }
+
+    // 大核离线时只统计online列表中的核心
+    std::ofstream(topologyRoot + "/online") << "0-5\n";
+    if (!CpuTopology::detect(topologyRoot, topology) || topology.cpuCount != 6 ||
+        topology.clusters.size() != 2 || topology.clusters[0].cpus != std::vector<int>{4, 5}) {
+        LOGE("模拟拓扑未排除离线核心");
+        topologyValid = false;
+    }
+    std::remove((topologyRoot + "/online").c_str());
+
+    for (int cpu = 0; cpu < 8; ++cpu) {
+        const std::string cpuDir = topologyRoot + "/cpu" + std::to_string(cpu);
+        std::remove((cpuDir + "/cpufreq/cpuinfo_max_freq").c_str());
+        rmdir((cpuDir + "/cpufreq").c_str());
+        rmdir(cpuDir.c_str());
+    }
+    rmdir(topologyRoot.c_str());
+
+    LutData primaryLut = createTestLut(33);
+    LutData emptyLut;
+    ProcessingParams params;
+    params.useBakedLut = false;
+
+    const int width = 2048;
+    const int height = 1536;
+    std::vector<uint8_t> input = PerformanceTestUtils::generateTestImageData(width, height, 4);
+    std::vector<uint8_t> stealingOutput(input.size());
+    std::vector<uint8_t> adaptiveOutput(input.size());
+
+    ImageInfo inputInfo;
+    inputInfo.width = width;
+    inputInfo.height = height;
+    inputInfo.stride = width * 4;
+    inputInfo.pixels = input.data();
+    ImageInfo stealingInfo = inputInfo;
+    stealingInfo.pixels = stealingOutput.data();
+    ImageInfo adaptiveInfo = inputInfo;
+    adaptiveInfo.pixels = adaptiveOutput.data();
+
+    BenchmarkTool::Comparison comparison;
+    PerformanceResult result = runTimedTest("Adaptive Scheduling", [&]() -> bool {
+        params.schedulerMode = 1;
+        comparison.timeBaseline([&]() {
+            ImageProcessor::processMultiThreaded(inputInfo, stealingInfo, primaryLut, emptyLut,
+                                                 params);
+        });
+
+        params.schedulerMode = 2;
+        comparison.timeCandidate([&]() {
+            ImageProcessor::processMultiThreaded(inputInfo, adaptiveInfo, primaryLut, emptyLut,
+                                                 params);
+        });
+
+        return topologyValid && stealingOutput == adaptiveOutput;
+    }, 10);
+
+    const CpuTopologyInfo &systemTopology = CpuTopology::getSystemTopology();
+    result.customMetrics["clusters"] = systemTopology.clusters.size();
+    comparison.addMetrics(result, "stealing_ms", "adaptive_ms");
+
+    LOGI("调度模式: 工作窃取 %.2fms, 自适应 %.2fms (%zu个CPU簇)", comparison.baselineMs(),
+         comparison.candidateMs(), systemTopology.clusters.size());
+
+    return result;
+}
+
+PerformanceResult PerformanceTestSuite::testWavefrontDitheringPerformance() {
+    // 对比多线程LUT后串行Floyd-Steinberg与融合的波前并行抖动，两者输出必须逐字节一致
+    LutData primaryLut = createTestLut(33);
+    LutData emptyLut;
+    ProcessingParams params;
+    params.useBakedLut = false;
+
+    const int width = 2048;
+    const int height = 1536;
+    std::vector<uint8_t> input = PerformanceTestUtils::generateTestImageData(width, height, 4);
+    std::vector<uint8_t> serialOutput(input.size());
+    std::vector<uint8_t> wavefrontOutput(input.size());
+
+    ImageInfo inputInfo;
+    inputInfo.width = width;
+    inputInfo.height = height;
+    inputInfo.stride = width * 4;
+    inputInfo.pixels = input.data();
+    ImageInfo serialInfo = inputInfo;
+    serialInfo.pixels = serialOutput.data();
+    ImageInfo wavefrontInfo = inputInfo;
+    wavefrontInfo.pixels = wavefrontOutput.data();
+
+    BenchmarkTool::Comparison comparison;
+    PerformanceResult result = runTimedTest("Wavefront Dithering", [&]() -> bool {
+        comparison.timeBaseline([&]() {
+            params.ditherType = 0;
+            ImageProcessor::processMultiThreaded(inputInfo, serialInfo, primaryLut, emptyLut,
+                                                 params);
+            params.ditherType = 1;
+            ImageProcessor::applyDithering(serialOutput.data(), width, height, width * 4, params);
+        });
+
+        comparison.timeCandidate([&]() {
+            ImageProcessor::processMultiThreaded(inputInfo, wavefrontInfo, primaryLut, emptyLut,
+                                                 params);
+        });
+
+        return serialOutput == wavefrontOutput;
+    }, 10);
+
+    comparison.addMetrics(result, "serial_dither_ms", "wavefront_ms");
+
+    LOGI("Floyd-Steinberg: 串行抖动 %.2fms, 波前融合 %.2fms", comparison.baselineMs(),
+         comparison.candidateMs());
+
+    return result;
+}
+
+PerformanceResult PerformanceTestSuite::testOrderedDitheringPerformance() {
+    // 对比不抖动、独立一遍的随机抖动与融合在量化中的蓝噪声抖动
+    // 有序抖动只改变量化偏移，每个通道与不抖动的结果最多相差1
+    LutData primaryLut = createTestLut(33);
+    LutData emptyLut;
+    ProcessingParams params;
+    params.useBakedLut = false;
+
+    const int width = 2048;
+    const int height = 1536;
+    std::vector<uint8_t> input = PerformanceTestUtils::generateTestImageData(width, height, 4);
+    std::vector<uint8_t> plainOutput(input.size());
+    std::vector<uint8_t> randomOutput(input.size());
+    std::vector<uint8_t> blueNoiseOutput(input.size());
+
+    ImageInfo inputInfo;
+    inputInfo.width = width;
+    inputInfo.height = height;
+    inputInfo.stride = width * 4;
+    inputInfo.pixels = input.data();
+    ImageInfo plainInfo = inputInfo;
+    plainInfo.pixels = plainOutput.data();
+    ImageInfo randomInfo = inputInfo;
+    randomInfo.pixels = randomOutput.data();
+    ImageInfo blueNoiseInfo = inputInfo;
+    blueNoiseInfo.pixels = blueNoiseOutput.data();
+
+    std::vector<double> plainTimings;
+    std::vector<double> randomTimings;
+    std::vector<double> blueNoiseTimings;
+
+    PerformanceResult result = runTimedTest("Ordered Dithering", [&]() -> bool {
+        params.ditherType = 0;
+        BenchmarkTool::Timer plainTimer;
+        ImageProcessor::processMultiThreaded(inputInfo, plainInfo, primaryLut, emptyLut, params);
+        plainTimings.push_back(plainTimer.elapsedMs());
+
+        params.ditherType = 2;
+        BenchmarkTool::Timer randomTimer;
+        ImageProcessor::processMultiThreaded(inputInfo, randomInfo, primaryLut, emptyLut, params);
+        randomTimings.push_back(randomTimer.elapsedMs());
+
+        params.ditherType = DitherMatrix::DITHER_BLUE_NOISE;
+        BenchmarkTool::Timer blueNoiseTimer;
+        ImageProcessor::processMultiThreaded(inputInfo, blueNoiseInfo, primaryLut, emptyLut,
+                                             params);
+        blueNoiseTimings.push_back(blueNoiseTimer.elapsedMs());
+
+        for (size_t i = 0; i < plainOutput.size(); ++i) {
+            if (std::abs(plainOutput[i] - blueNoiseOutput[i]) > 1) {
+                return false;
+            }
+        }
+        return true;
+    }, 10);
+
+    double plainAvg = std::accumulate(plainTimings.begin(), plainTimings.end(), 0.0) /
+                      plainTimings.size();
+    double randomAvg = std::accumulate(randomTimings.begin(), randomTimings.end(), 0.0) /
+                       randomTimings.size();
+    double blueNoiseAvg = std::accumulate(blueNoiseTimings.begin(), blueNoiseTimings.end(), 0.0) /
+                          blueNoiseTimings.size();
+
+    result.customMetrics["no_dither_ms"] = plainAvg;
+    result.customMetrics["random_ms"] = randomAvg;
+    result.customMetrics["blue_noise_ms"] = blueNoiseAvg;
+    result.customMetrics["blue_noise_overhead"] = plainAvg > 0.0 ? blueNoiseAvg / plainAvg : 0.0;
+
+    LOGI("抖动: 不抖动 %.2fms, 随机 %.2fms, 蓝噪声 %.2fms", plainAvg, randomAvg, blueNoiseAvg);
+
+    return result;
+}
+
+PerformanceResult PerformanceTestSuite::testStreamingTileViewPerformance() {
+    // 分块直接读写原图：逐点处理的输出必须与整图处理一致，且处理期间内存池不应增长
+    LutData primaryLut = createTestLut(33);
+    LutData emptyLut;
+    ProcessingParams params;
+    params.useBakedLut = false;
+
+    const int width = 4096;
+    const int height = 3072;
+    std::vector<uint8_t> input = PerformanceTestUtils::generateTestImageData(width, height, 4);
+    std::vector<uint8_t> directOutput(input.size());
+    std::vector<uint8_t> streamingOutput(input.size());
+
+    ImageInfo inputInfo;
+    inputInfo.width = width;
+    inputInfo.height = height;
+    inputInfo.stride = width * 4;
+    inputInfo.pixels = input.data();
+    ImageInfo directInfo = inputInfo;
+    directInfo.pixels = directOutput.data();
+    ImageInfo streamingInfo = inputInfo;
+    streamingInfo.pixels = streamingOutput.data();
+
+    ImageProcessor::processMultiThreaded(inputInfo, directInfo, primaryLut, emptyLut, params);
+
+    StreamingProcessor streamingProcessor;
+    StreamingConfig streamingConfig;
+    streamingConfig.maxTileSize = 4 * 1024 * 1024;
+    streamingProcessor.setConfig(streamingConfig);
+
+    const size_t baselineAllocated = MemoryPool::getInstance().getStats().totalAllocated;
+    size_t peakGrowth = 0;
+
+    PerformanceResult result = runTimedTest("Streaming Tile Views", [&]() -> bool {
+        ProcessResult processResult = streamingProcessor.processImageStreaming(
+                inputInfo, streamingInfo, primaryLut, emptyLut, params,
+                [&](const StreamingProgress &) {
+                    size_t allocated = MemoryPool::getInstance().getStats().totalAllocated;
+                    if (allocated > baselineAllocated) {
+                        peakGrowth = std::max(peakGrowth, allocated - baselineAllocated);
+                    }
+                });
+        return processResult == ProcessResult::SUCCESS && streamingOutput == directOutput;
+    }, 10);
+
+    result.customMetrics["image_mb"] = input.size() / (1024.0 * 1024.0);
+    result.customMetrics["pool_growth_mb"] = peakGrowth / (1024.0 * 1024.0);
+
+    LOGI("流式分块视图: 图片 %.2f MB, 内存池增长 %.2f MB", input.size() / (1024.0 * 1024.0),
+         peakGrowth / (1024.0 * 1024.0));
+
+    return result;
+}
+
+PerformanceResult PerformanceTestSuite::testStreamingPipelinePerformance() {
+    // 同一张图分别以只容纳约两个块的小预算和宽裕预算流水线处理，输出必须一致
+    LutData primaryLut = createTestLut(33);
+    LutData emptyLut;
+    ProcessingParams params;
+    params.useBakedLut = false;
+
+    const int width = 4096;
+    const int height = 3072;
+    std::vector<uint8_t> input = PerformanceTestUtils::generateTestImageData(width, height, 4);
+    std::vector<uint8_t> tightOutput(input.size());
+    std::vector<uint8_t> wideOutput(input.size());
+
+    ImageInfo inputInfo;
+    inputInfo.width = width;
+    inputInfo.height = height;
+    inputInfo.stride = width * 4;
+    inputInfo.pixels = input.data();
+    ImageInfo tightInfo = inputInfo;
+    tightInfo.pixels = tightOutput.data();
+    ImageInfo wideInfo = inputInfo;
+    wideInfo.pixels = wideOutput.data();
+
+    const size_t tileSize = 1024 * 1024 * 4;
+
+    StreamingConfig tightConfig;
+    tightConfig.maxTileSize = tileSize;
+    tightConfig.maxMemoryUsage = tileSize * 4; // 每个块的工作集为输入加输出
+    StreamingProcessor tightProcessor;
+    tightProcessor.setConfig(tightConfig);
+
+    StreamingConfig wideConfig = tightConfig;
+    wideConfig.maxMemoryUsage = tileSize * 64;
+    StreamingProcessor wideProcessor;
+    wideProcessor.setConfig(wideConfig);
+
+    BenchmarkTool::Comparison comparison;
+    PerformanceResult result = runTimedTest("Streaming Pipeline", [&]() -> bool {
+        ProcessResult tightResult = ProcessResult::SUCCESS;
+        comparison.timeBaseline([&]() {
+            tightResult = tightProcessor.processImageStreaming(inputInfo, tightInfo, primaryLut,
+                                                               emptyLut, params);
+        });
+
+        ProcessResult wideResult = ProcessResult::SUCCESS;
+        comparison.timeCandidate([&]() {
+            wideResult = wideProcessor.processImageStreaming(inputInfo, wideInfo, primaryLut,
+                                                             emptyLut, params);
+        });
+
+        return tightResult == ProcessResult::SUCCESS && wideResult == ProcessResult::SUCCESS &&
+               tightOutput == wideOutput;
+    }, 10);
+
+    comparison.addMetrics(result, "tight_budget_ms", "wide_budget_ms");
+
+    LOGI("流水线分块: 小预算 %.2fms, 宽裕预算 %.2fms", comparison.baselineMs(),
+         comparison.candidateMs());
+
+    return result;
+}
+
+PerformanceResult PerformanceTestSuite::testStripStreamingPerformance() {
+    // 按64行一段推入行带，结果（含跨行带的Floyd-Steinberg误差扩散）必须与整图处理一致
+    LutData primaryLut = createTestLut(33);
+    LutData emptyLut;
+    ProcessingParams params;
+    params.useBakedLut = false;
+    params.ditherType = 1;
+
+    const int width = 4096;
+    const int height = 3072;
+    const int stripRows = 64;
+    std::vector<uint8_t> input = PerformanceTestUtils::generateTestImageData(width, height, 4);
+    std::vector<uint8_t> directOutput(input.size());
+    std::vector<uint8_t> stripOutput(input.size());
+
+    ImageInfo inputInfo;
+    inputInfo.width = width;
+    inputInfo.height = height;
+    inputInfo.stride = width * 4;
+    inputInfo.pixels = input.data();
+    ImageInfo directInfo = inputInfo;
+    directInfo.pixels = directOutput.data();
+
+    ImageProcessor::processMultiThreaded(inputInfo, directInfo, primaryLut, emptyLut, params);
+
+    PerformanceResult result = runTimedTest("Strip Streaming", [&]() -> bool {
+        StripStreamingSession session(
+                width, height, primaryLut, emptyLut, params,
+                [&](const ImageInfo &rows, int firstRow) {
+                    for (int row = 0; row < rows.height; ++row) {
+                        std::memcpy(&stripOutput[static_cast<size_t>(firstRow + row) * width * 4],
+                                    static_cast<const uint8_t *>(rows.pixels) +
+                                    static_cast<size_t>(row) * rows.stride,
+                                    width * 4);
+                    }
+                    return true;
+                });
+
+        for (int y = 0; y < height; y += stripRows) {
+            ImageInfo strip = inputInfo;
+            strip.height = std::min(stripRows, height - y);
+            strip.pixels = input.data() + static_cast<size_t>(y) * inputInfo.stride;
+            if (session.pushRows(strip) != ProcessResult::SUCCESS) {
+                return false;
+            }
+        }
+
+        return session.finish() == ProcessResult::SUCCESS && stripOutput == directOutput;
+    }, 10);
+
+    // 会话只持有一个行带加一行承接行的缓冲区
+    const double bufferMb = (stripRows + 1) * width * 4 / (1024.0 * 1024.0);
+    result.customMetrics["image_mb"] = input.size() / (1024.0 * 1024.0);
+    result.customMetrics["strip_buffer_mb"] = bufferMb;
+
+    LOGI("行带流式处理: 图片 %.2f MB, 行带缓冲区 %.2f MB", input.size() / (1024.0 * 1024.0),
+         bufferMb);
+
+    return result;
+}
+
+PerformanceResult PerformanceTestSuite::testMemoryPoolThroughputPerformance() {
+    // 在1k、10k、100k个存活块下测量随机释放+分配一对操作的耗时，
+    // 释放为O(1)时耗时不应随存活块数线性增长
+    MemoryPool &pool = MemoryPool::getInstance();
+    const size_t previousMaxPoolSize = pool.getMaxPoolSize();
+    pool.setMaxPoolSize(previousMaxPoolSize + 256 * 1024 * 1024);
+
+    const int liveCounts[] = {1000, 10000, 100000};
+    const int operations = 200000;
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<size_t> sizeDistribution(64, 2048);
+
+    PerformanceResult result = runTimedTest("Memory Pool Throughput", [&]() -> bool {
+        bool success = true;
+        for (int liveCount: liveCounts) {
+            std::vector<void *> blocks(liveCount);
+            for (auto &block: blocks) {
+                block = pool.allocate(sizeDistribution(rng));
+                success = success && block != nullptr;
+            }
+
+            std::uniform_int_distribution<int> slotDistribution(0, liveCount - 1);
+            BenchmarkTool::Timer timer;
+            for (int i = 0; i < operations; ++i) {
+                void *&block = blocks[slotDistribution(rng)];
+                pool.deallocate(block);
+                block = pool.allocate(sizeDistribution(rng));
+                success = success && block != nullptr;
+            }
+            const double nsPerPair = timer.elapsedMs() * 1e6 / operations;
+
+            for (void *block: blocks) {
+                pool.deallocate(block);
+            }
+
+            result.customMetrics["ns_per_free_alloc_" + std::to_string(liveCount)] = nsPerPair;
+            LOGI("内存池: %d 个存活块, 释放+分配 %.1f ns", liveCount, nsPerPair);
+        }
+        return success;
+    }, 1);
+
+    // 略有不同的分块尺寸落在同一级别，应当复用同一个块
+    void *tile = pool.allocate(1000 * 1000 * 4);
+    pool.deallocate(tile);
+    void *neighbourTile = pool.allocate(1010 * 990 * 4);
+    if (tile != neighbourTile) {
+        result.markFailed();
+    }
+    result.customMetrics["edge_tile_reused"] = tile == neighbourTile ? 1.0 : 0.0;
+    pool.deallocate(neighbourTile);
+
+    pool.setMaxPoolSize(previousMaxPoolSize);
+    return result;
+}
+
+PerformanceResult PerformanceTestSuite::testMemoryPoolThreadCachePerformance() {
+    // 8个线程同时随机分配释放小块，大部分操作应在线程缓存中完成，很少争用全局锁
+    MemoryPool &pool = MemoryPool::getInstance();
+    const int threadCount = 8;
+    const int operationsPerThread = 100000;
+    const int liveSlots = 256;
+
+    pool.resetStats();
+
+    PerformanceResult result = runTimedTest("Memory Pool Thread Cache", [&]() -> bool {
+        std::atomic<bool> success{true};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadCount; ++t) {
+            threads.emplace_back([&, t]() {
+                std::mt19937 rng(t);
+                std::uniform_int_distribution<size_t> sizeDistribution(64, 8192);
+                std::vector<void *> live(liveSlots, nullptr);
+                for (int i = 0; i < operationsPerThread; ++i) {
+                    void *&block = live[rng() % liveSlots];
+                    if (block) {
+                        pool.deallocate(block);
+                        block = nullptr;
+                    } else {
+                        block = pool.allocate(sizeDistribution(rng));
+                        if (!block) {
+                            success = false;
+                        }
+                    }
+                }
+                for (void *block: live) {
+                    pool.deallocate(block);
+                }
+            });
+        }
+        for (auto &thread: threads) {
+            thread.join();
+        }
+        return success.load();
+    }, 3);
+
+    PoolStats stats = pool.getStats();
+    const size_t cacheLookups = stats.threadCacheHits + stats.threadCacheMisses;
+    result.customMetrics["thread_cache_hit_rate"] =
+            cacheLookups > 0 ? static_cast<double>(stats.threadCacheHits) / cacheLookups : 0.0;
+    result.customMetrics["lock_contentions"] = static_cast<double>(stats.lockContentions);
+
+    LOGI("线程缓存: 命中 %zu, 未命中 %zu, 锁争用 %zu", stats.threadCacheHits,
+         stats.threadCacheMisses, stats.lockContentions);
+
+    return result;
+}
+
+PerformanceResult PerformanceTestSuite::testJobArenaPerformance() {
+    // 模拟一个任务内的大量临时缓冲区：逐个从内存池分配释放，对比从JobArena切出后一次性释放
+    MemoryPool &pool = MemoryPool::getInstance();
+    const int jobs = 200;
+    const int buffersPerJob = 64;
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<size_t> sizeDistribution(4 * 1024, 512 * 1024);
+    std::vector<size_t> sizes(buffersPerJob);
+    for (auto &size: sizes) {
+        size = sizeDistribution(rng);
+    }
+
+    double poolMs = 0.0;
+    double arenaMs = 0.0;
+    size_t arenaPeak = 0;
+
+    PerformanceResult result = runTimedTest("Job Arena", [&]() -> bool {
+        bool success = true;
+        std::vector<void *> buffers(buffersPerJob);
+
+        BenchmarkTool::Timer poolTimer;
+        for (int job = 0; job < jobs; ++job) {
+            for (int i = 0; i < buffersPerJob; ++i) {
+                buffers[i] = pool.allocate(sizes[i]);
+                success = success && buffers[i] != nullptr;
+            }
+            for (void *buffer: buffers) {
+                pool.deallocate(buffer);
+            }
+        }
+        poolMs = poolTimer.elapsedMs();
+
+        BenchmarkTool::Timer arenaTimer;
+        for (int job = 0; job < jobs; ++job) {
+            JobArena arena;
+            for (int i = 0; i < buffersPerJob; ++i) {
+                buffers[i] = arena.allocate(sizes[i]);
+                success = success && buffers[i] != nullptr;
+            }
+            arenaPeak = std::max(arenaPeak, arena.getPeakBytesReserved());
+        }
+        arenaMs = arenaTimer.elapsedMs();
+
+        return success;
+    }, 3);
+
+    // 带光晕的流式处理：暂存区槽位复用，多次任务后单任务内存峰值保持不变
+    LutData primaryLut = createTestLut(33);
+    LutData emptyLut;
+    ProcessingParams params;
+    params.useBakedLut = false;
+    params.ditherType = 1;
+
+    const int width = 4096;
+    const int height = 3072;
+    std::vector<uint8_t> input = PerformanceTestUtils::generateTestImageData(width, height, 4);
+    std::vector<uint8_t> output(input.size());
+    ImageInfo inputInfo;
+    inputInfo.width = width;
+    inputInfo.height = height;
+    inputInfo.stride = width * 4;
+    inputInfo.pixels = input.data();
+    ImageInfo outputInfo = inputInfo;
+    outputInfo.pixels = output.data();
+
+    StreamingConfig config;
+    config.maxTileSize = 1024 * 1024 * 4;
+    StreamingProcessor processor;
+    processor.setConfig(config);
+
+    bool streamingSuccess = processor.processImageStreaming(
+            inputInfo, outputInfo, primaryLut, emptyLut, params) == ProcessResult::SUCCESS;
+    const size_t firstJobPeak = processor.getStats().peakJobMemory;
+    for (int i = 0; i < 4; ++i) {
+        streamingSuccess = streamingSuccess && processor.processImageStreaming(
+                inputInfo, outputInfo, primaryLut, emptyLut, params) == ProcessResult::SUCCESS;
+    }
+    const size_t jobPeak = processor.getStats().peakJobMemory;
+
+    // 整图波前抖动的行进度表从任务内存中分配，结果与使用堆内存时一致
+    std::vector<uint8_t> heapOutput(input.size());
+    ImageInfo heapInfo = inputInfo;
+    heapInfo.pixels = heapOutput.data();
+    JobArena directArena;
+    bool directSuccess =
+            ImageProcessor::processMultiThreaded(inputInfo, outputInfo, primaryLut, emptyLut,
+                                                 params, nullptr, &directArena) ==
+            ProcessResult::SUCCESS &&
+            ImageProcessor::processMultiThreaded(inputInfo, heapInfo, primaryLut, emptyLut,
+                                                 params) == ProcessResult::SUCCESS;
+    directSuccess = directSuccess && output == heapOutput && directArena.getBytesUsed() > 0;
+
+    if (!streamingSuccess || !directSuccess || jobPeak != firstJobPeak) {
+        result.markFailed();
+    }
+    result.customMetrics["streaming_success"] = streamingSuccess ? 1.0 : 0.0;
+    result.customMetrics["direct_success"] = directSuccess ? 1.0 : 0.0;
+    result.customMetrics["direct_arena_kb"] = directArena.getPeakBytesReserved() / 1024.0;
+    result.customMetrics["pool_ms_per_job"] = poolMs / jobs;
+    result.customMetrics["arena_ms_per_job"] = arenaMs / jobs;
+    result.customMetrics["arena_peak_mb"] = arenaPeak / (1024.0 * 1024.0);
+    result.customMetrics["streaming_job_peak_mb"] = jobPeak / (1024.0 * 1024.0);
+    result.customMetrics["streaming_job_peak_stable"] = jobPeak == firstJobPeak ? 1.0 : 0.0;
+
+    LOGI("任务内存: 内存池 %.3f ms/任务, JobArena %.3f ms/任务, 流式处理单任务峰值 %.2f MB",
+         poolMs / jobs, arenaMs / jobs, jobPeak / (1024.0 * 1024.0));
+
+    return result;
+}
+
+// 统计调用线程的dTLB读未命中次数，内核不允许perf_event时读数为-1
+class DtlbMissCounter {
+public:
+    DtlbMissCounter() {
+#ifdef __linux__
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_DTLB |
+                      (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+
+    ~DtlbMissCounter() {
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+    }
+
+    void start() {
+#ifdef __linux__
+        if (fd_ >= 0) {
+            ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    double stop() {
+#ifdef __linux__
+        long long count = 0;
+        if (fd_ >= 0) {
+            ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(fd_, &count, sizeof(count)) == sizeof(count)) {
+                return static_cast<double>(count);
+            }
+        }
+#endif
+        return -1.0;
+    }
+
+private:
+    int fd_ = -1;
+};
+
+static long minorPageFaults() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_minflt;
+}
+
+PerformanceResult PerformanceTestSuite::testLargePageBufferPerformance() {
+    // 4500万像素整帧RGBA缓冲区：首次写入后顺序读两遍，
+    // 对比普通对齐分配与按2MB对齐映射并设置MADV_HUGEPAGE的缺页数、dTLB未命中数与耗时
+    const size_t frameSize = static_cast<size_t>(8192) * 5464 * 4;
+
+    struct PassMetrics {
+        double pageFaults = 0.0;
+        double dtlbMisses = 0.0;
+        double timeMs = 0.0;
+    };
+
+    // 按帧处理的访问方式：逐字节写入整帧，再按缓存行顺序读取
+    auto touchFrame = [&](uint8_t *frame, PassMetrics &metrics) -> bool {
+        DtlbMissCounter counter;
+        const long faultsBefore = minorPageFaults();
+        BenchmarkTool::Timer timer;
+        counter.start();
+
+        std::memset(frame, 0x5a, frameSize);
+        uint64_t checksum = 0;
+        for (int pass = 0; pass < 2; ++pass) {
+            for (size_t offset = 0; offset < frameSize; offset += 64) {
+                checksum += frame[offset];
+            }
+        }
+
+        metrics.dtlbMisses = counter.stop();
+        metrics.timeMs = timer.elapsedMs();
+        metrics.pageFaults = static_cast<double>(minorPageFaults() - faultsBefore);
+        return checksum == 2ull * 0x5a * (frameSize / 64);
+    };
+
+    PassMetrics baseline;
+    PassMetrics largePage;
+    const size_t poolBlockSize = 16 * 1024 * 1024;
+    bool poolFirstPageCleared = false;
+    bool poolBlockAligned = false;
+    double poolReuseFaults = 0.0;
+
+    PerformanceResult result = runTimedTest("Large Page Buffer", [&]() -> bool {
+        void *plain = nullptr;
+        if (posix_memalign(&plain, 64, frameSize) != 0) {
+            return false;
+        }
+        bool success = touchFrame(static_cast<uint8_t *>(plain), baseline);
+        free(plain);
+
+        void *mapped = LargePageAllocator::allocate(frameSize);
+        if (!mapped) {
+            return false;
+        }
+        success = touchFrame(static_cast<uint8_t *>(mapped), largePage) && success;
+
+        // 丢弃页之后再次访问得到清零的页
+        LargePageAllocator::discard(mapped, frameSize);
+        success = success && static_cast<uint8_t *>(mapped)[frameSize / 2] == 0;
+        LargePageAllocator::deallocate(mapped);
+
+        // 内存池中按大页映射的块：返回地址应2MB对齐（16MB的级别恰好占8个大页，不多映射一个），
+        // 归还后整段丢弃，再次取出时开头也应是清零的新页
+        MemoryPool &pool = MemoryPool::getInstance();
+        auto *pooled = static_cast<uint8_t *>(pool.allocate(poolBlockSize));
+        if (!pooled) {
+            return false;
+        }
+        poolBlockAligned = reinterpret_cast<uintptr_t>(pooled) % LargePageAllocator::HUGE_PAGE_SIZE == 0;
+        std::memset(pooled, 0x5a, poolBlockSize);
+        pool.deallocate(pooled);
+        const long faultsBefore = minorPageFaults();
+        auto *reused = static_cast<uint8_t *>(pool.allocate(poolBlockSize));
+        if (!reused) {
+            return false;
+        }
+        poolFirstPageCleared = reused[0] == 0 && reused[poolBlockSize - 1] == 0;
+        std::memset(reused, 0x5a, poolBlockSize);
+        poolReuseFaults = static_cast<double>(minorPageFaults() - faultsBefore);
+        pool.deallocate(reused);
+        return success && poolFirstPageCleared && poolBlockAligned;
+    }, 3);
+
+    const LargePageStats stats = LargePageAllocator::getStats();
+    result.customMetrics["baseline_page_faults"] = baseline.pageFaults;
+    result.customMetrics["large_page_faults"] = largePage.pageFaults;
+    result.customMetrics["baseline_dtlb_misses"] = baseline.dtlbMisses;
+    result.customMetrics["large_page_dtlb_misses"] = largePage.dtlbMisses;
+    result.customMetrics["baseline_ms"] = baseline.timeMs;
+    result.customMetrics["large_page_ms"] = largePage.timeMs;
+    result.customMetrics["huge_page_mappings"] = static_cast<double>(stats.hugePageMappings);
+    result.customMetrics["pool_first_page_cleared"] = poolFirstPageCleared ? 1.0 : 0.0;
+    result.customMetrics["pool_block_huge_aligned"] = poolBlockAligned ? 1.0 : 0.0;
+    result.customMetrics["pool_reuse_page_faults"] = poolReuseFaults;
+
+    LOGI("大页缓冲区: 缺页 %.0f -> %.0f, dTLB未命中 %.0f -> %.0f, 耗时 %.2fms -> %.2fms",
+         baseline.pageFaults, largePage.pageFaults, baseline.dtlbMisses, largePage.dtlbMisses,
+         baseline.timeMs, largePage.timeMs);
+
+    return result;
+}
+
+PerformanceResult PerformanceTestSuite::testMemoryAdmissionPerformance() {
+    // 先用模拟的meminfo与PSI文件验证系统状态解析，再让8个并发任务在只够3个任务的预算下申请预留，
+    // 检查预留峰值不超过预算、多余任务排队而不是失败，以及超时与取消路径、排队顺序与内存池用量
+    MemoryAdmissionController &controller = MemoryAdmissionController::getInstance();
+    const std::string cacheDir = LutCache::getCacheDirectory();
+    const std::string procRoot = (cacheDir.empty() ? "/data/local/tmp" : cacheDir) +
+                                 "/perf_test_proc";
+    const std::string meminfoPath = procRoot + "/meminfo";
+    const std::string pressurePath = procRoot + "/pressure_memory";
+
+    bool statusValid = true;
+    mkdir(procRoot.c_str(), 0755);
+    std::ofstream(meminfoPath) << "MemTotal:        7812500 kB\n"
+                                  "MemFree:          123456 kB\n"
+                                  "MemAvailable:    3906250 kB\n";
+    std::ofstream(pressurePath) << "some avg10=35.50 avg60=12.00 avg300=3.00 total=123456\n"
+                                   "full avg10=5.00 avg60=1.00 avg300=0.20 total=4567\n";
+
+    SystemMemoryStatus status;
+    if (!MemoryAdmissionController::readSystemMemoryStatus(meminfoPath, pressurePath, status) ||
+        !status.hasMemInfo || status.totalBytes != static_cast<size_t>(7812500) * 1024 ||
+        status.availableBytes != static_cast<size_t>(3906250) * 1024 || !status.hasPressure ||
+        std::fabs(status.pressureAvg10 - 35.5) > 1e-6) {
+        LOGE("模拟内存状态解析结果不正确");
+        statusValid = false;
+    }
+
+    const size_t jobBytes = 64 * 1024 * 1024;
+    const size_t budget = 3 * jobBytes;
+    const size_t previousBudget = controller.getBudget();
+    controller.setBudget(budget);
+
+    // 内存压力高于阈值时只允许一个任务运行
+    bool pressureValid = true;
+    controller.setSystemSources(meminfoPath, pressurePath);
+    {
+        MemoryAdmissionController::Reservation first = controller.tryReserve(jobBytes);
+        MemoryAdmissionController::Reservation second = controller.tryReserve(jobBytes);
+        pressureValid = first.isValid() && !second.isValid();
+    }
+    controller.setSystemSources("", "");
+    std::remove(meminfoPath.c_str());
+    std::remove(pressurePath.c_str());
+    rmdir(procRoot.c_str());
+
+    const int jobCount = 8;
+    std::atomic<size_t> overBudget{0};
+    std::atomic<size_t> failedJobs{0};
+    AdmissionStats stats;
+    controller.resetStats();
+
+    PerformanceResult result = runTimedTest("Memory Admission", [&]() -> bool {
+        std::vector<std::thread> workers;
+        for (int job = 0; job < jobCount; ++job) {
+            workers.emplace_back([&]() {
+                MemoryAdmissionController::Reservation reservation =
+                        controller.reserve(jobBytes, std::chrono::seconds(10));
+                if (!reservation.isValid()) {
+                    failedJobs++;
+                    return;
+                }
+                if (controller.getStats().reservedBytes > budget) {
+                    overBudget++;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            });
+        }
+        for (auto &worker: workers) {
+            worker.join();
+        }
+        return failedJobs.load() == 0 && overBudget.load() == 0;
+    }, 1);
+    stats = controller.getStats();
+
+    // 预算被占满时，超时与取消都应返回无效的预留
+    bool timeoutValid = true;
+    {
+        MemoryAdmissionController::Reservation holder = controller.reserve(budget);
+        BenchmarkTool::Timer timer;
+        MemoryAdmissionController::Reservation timedOut =
+                controller.reserve(jobBytes, std::chrono::milliseconds(100));
+        const double waitedMs = timer.elapsedMs();
+        MemoryAdmissionController::Reservation cancelled =
+                controller.reserve(jobBytes, std::chrono::seconds(10), []() { return true; });
+        timeoutValid = holder.isValid() && !timedOut.isValid() && !cancelled.isValid() &&
+                       waitedMs >= 100.0 && waitedMs < 2000.0;
+        holder.release();
+        timeoutValid = timeoutValid && controller.tryReserve(jobBytes).isValid();
+    }
+
+    // 大任务排队时，后到的小任务即使放得下也不能越过它准入；归还后大任务先准入
+    bool fifoValid = true;
+    {
+        MemoryAdmissionController::Reservation holder = controller.reserve(budget - jobBytes);
+        std::atomic<bool> largeAdmitted{false};
+        std::thread largeJob([&]() {
+            MemoryAdmissionController::Reservation large =
+                    controller.reserve(2 * jobBytes, std::chrono::seconds(10));
+            largeAdmitted = large.isValid();
+        });
+        for (int i = 0; i < 200 && controller.getStats().waitingJobs == 0; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        fifoValid = controller.getStats().waitingJobs == 1 &&
+                    !controller.tryReserve(jobBytes / 2).isValid();
+        holder.release();
+        largeJob.join();
+        fifoValid = fifoValid && largeAdmitted.load() && controller.getStats().waitingJobs == 0;
+    }
+
+    // 内存池中未经准入的使用量占用预算，归还到池中的空闲块不占用
+    bool poolValid = true;
+    {
+        MemoryPool &pool = MemoryPool::getInstance();
+        MemoryAdmissionController::Reservation running = controller.tryReserve(1024 * 1024);
+        void *untracked = pool.allocate(2 * jobBytes);
+        poolValid = running.isValid() && untracked != nullptr &&
+                    !controller.tryReserve(jobBytes + 1024 * 1024).isValid();
+        pool.deallocate(untracked);
+        poolValid = poolValid && controller.tryReserve(jobBytes + 1024 * 1024).isValid();
+    }
+
+    // 余量放不下整图处理的输入与输出、但放得下块工作集时，NativeLutProcessor应短暂等待后改为流式处理，
+    // 结果与整图处理一致；预算被占满且调用方已取消时应立即放弃
+    bool fallbackValid = true;
+    double fallbackMs = 0.0;
+    double cancelMs = 0.0;
+    {
+        NativeLutProcessor processor;
+        LutData lut = createTestLut(33);
+        processor.loadLutFromArray(lut.data.data(), lut.size);
+
+        const int width = 4096;
+        const int height = 3072;
+        std::vector<uint8_t> input = PerformanceTestUtils::generateTestImageData(width, height, 4);
+        std::vector<uint8_t> directOutput(input.size());
+        std::vector<uint8_t> fallbackOutput(input.size());
+
+        ImageInfo inputInfo;
+        inputInfo.width = width;
+        inputInfo.height = height;
+        inputInfo.stride = width * 4;
+        inputInfo.pixels = input.data();
+        ImageInfo directInfo = inputInfo;
+        directInfo.pixels = directOutput.data();
+        ImageInfo fallbackInfo = inputInfo;
+        fallbackInfo.pixels = fallbackOutput.data();
+
+        ProcessingParams params;
+        fallbackValid = processor.processImage(inputInfo, directInfo, params) ==
+                        ProcessResult::SUCCESS;
+
+        MemoryAdmissionController::Reservation holder =
+                controller.reserve(budget - 80 * 1024 * 1024);
+        BenchmarkTool::Timer fallbackTimer;
+        fallbackValid = fallbackValid && holder.isValid() &&
+                        processor.processImage(inputInfo, fallbackInfo, params) ==
+                        ProcessResult::SUCCESS && fallbackOutput == directOutput;
+        fallbackMs = fallbackTimer.elapsedMs();
+        holder.release();
+
+        holder = controller.reserve(budget);
+        BenchmarkTool::Timer cancelTimer;
+        fallbackValid = fallbackValid &&
+                        processor.processImage(inputInfo, fallbackInfo, params, nullptr,
+                                               []() { return true; }) != ProcessResult::SUCCESS;
+        // 自动选择策略的处理在排队时同样可以取消
+        StreamingProcessor streamingProcessor;
+        fallbackValid = fallbackValid &&
+                        streamingProcessor.processImageOptimized(
+                                inputInfo, fallbackInfo, lut, LutData(), params, nullptr,
+                                []() { return true; }) == ProcessResult::ERROR_MEMORY_ALLOCATION;
+        cancelMs = cancelTimer.elapsedMs();
+        fallbackValid = fallbackValid && cancelMs < 1000.0;
+    }
+
+    controller.setSystemSources(MemoryAdmissionController::PROC_MEMINFO,
+                                MemoryAdmissionController::PROC_PRESSURE_MEMORY);
+    controller.setBudget(previousBudget);
+
+    if (!statusValid || !pressureValid || !timeoutValid || !fifoValid || !poolValid ||
+        !fallbackValid) {
+        result.markFailed();
+    }
+    result.customMetrics["status_valid"] = statusValid ? 1.0 : 0.0;
+    result.customMetrics["pressure_valid"] = pressureValid ? 1.0 : 0.0;
+    result.customMetrics["timeout_valid"] = timeoutValid ? 1.0 : 0.0;
+    result.customMetrics["fifo_valid"] = fifoValid ? 1.0 : 0.0;
+    result.customMetrics["pool_valid"] = poolValid ? 1.0 : 0.0;
+    result.customMetrics["fallback_valid"] = fallbackValid ? 1.0 : 0.0;
+    result.customMetrics["fallback_ms"] = fallbackMs;
+    result.customMetrics["cancel_ms"] = cancelMs;
+    result.customMetrics["peak_reserved_mb"] = stats.peakReservedBytes / (1024.0 * 1024.0);
+    result.customMetrics["budget_mb"] = budget / (1024.0 * 1024.0);
+    result.customMetrics["queued_jobs"] = static_cast<double>(stats.queuedJobs);
+    result.customMetrics["failed_jobs"] = static_cast<double>(failedJobs.load());
+    result.customMetrics["avg_wait_ms"] =
+            stats.queuedJobs > 0 ? stats.totalWaitMs / stats.queuedJobs : 0.0;
+
+    LOGI("内存准入: 预留峰值 %.0f MB / 预算 %.0f MB, 排队 %zu 个任务, 平均等待 %.1f ms",
+         stats.peakReservedBytes / (1024.0 * 1024.0), budget / (1024.0 * 1024.0),
+         stats.queuedJobs, result.customMetrics["avg_wait_ms"]);
+
+    return result;
+}
+
+PerformanceResult PerformanceTestSuite::testStrategyCostModelPerformance() {
+    // 先用人工样本验证代价模型的选择与画像文件的保存加载，
+    // 再用同一处理器连续处理多张图片：前两张分别校准两种策略，之后每张只按预测最快的策略处理一遍
+    StrategyCostModel &model = StrategyCostModel::getInstance();
+    const std::string cacheDir = LutCache::getCacheDirectory();
+    const std::string profilePath = (cacheDir.empty() ? "/data/local/tmp" : cacheDir) +
+                                    "/perf_test_strategy_profile.bin";
+    // 先保存应用自己的画像，测试结束后重新加载
+    const std::string savedProfilePath = model.getProfilePath();
+    model.flush();
+
+    const int width = 4000;
+    const int height = 3000;
+    const size_t frameBytes = static_cast<size_t>(width) * height * 4 * 2;
+    const size_t tileTransient = 16 * 1024 * 1024;
+
+    StrategyQuery query;
+    query.width = width;
+    query.height = height;
+    query.frameBytes = frameBytes;
+    query.memoryRoom = frameBytes * 4;
+    query.directThreads = 8;
+    query.streamingThreads = 8;
+    query.tileSize = 2048;
+    query.streamingTransientPrior = tileTransient;
+
+    bool modelValid = true;
+    model.setProfilePath("");
+    model.clear();
+
+    // 未校准时先试直接处理，校准后试分块处理
+    modelValid = modelValid && model.choose(query).strategy == ProcessingStrategy::DIRECT &&
+                 model.choose(query).exploring;
+    model.record(ProcessingStrategy::DIRECT, 8, 0, 12.0, 360.0, frameBytes, 0);
+    modelValid = modelValid && model.choose(query).strategy == ProcessingStrategy::STREAMING &&
+                 model.choose(query).exploring;
+    model.record(ProcessingStrategy::STREAMING, 8, 2048, 12.0, 240.0, frameBytes, tileTransient);
+
+    // 两者都放得下时选更快的分块处理，余量只够直接处理时选直接处理
+    StrategyChoice fastest = model.choose(query);
+    modelValid = modelValid && fastest.strategy == ProcessingStrategy::STREAMING &&
+                 !fastest.exploring && std::fabs(fastest.predictedMs - 240.0) < 1.0 &&
+                 fastest.predictedPeakBytes == frameBytes + tileTransient;
+    query.memoryRoom = frameBytes + tileTransient / 2;
+    modelValid = modelValid && model.choose(query).strategy == ProcessingStrategy::DIRECT;
+
+    // 滑动平均：再记录一次更慢的分块处理
+    model.record(ProcessingStrategy::STREAMING, 8, 2048, 12.0, 480.0, frameBytes,
+                 tileTransient);
+    query.memoryRoom = frameBytes * 4;
+    fastest = model.choose(query);
+    modelValid = modelValid && std::fabs(fastest.predictedMs - 300.0) < 1.0;
+
+    // 画像写入文件后重新加载
+    model.setProfilePath(profilePath);
+    bool persistenceValid = model.flush();
+    model.clear();
+    model.setProfilePath(profilePath);
+    const std::vector<StrategyProfileEntry> loaded = model.getEntries();
+    persistenceValid = persistenceValid && loaded.size() == 2 &&
+                       model.choose(query).strategy == fastest.strategy;
+    model.setProfilePath("");
+    std::remove(profilePath.c_str());
+    model.clear();
+
+    // 两种策略都有样本后，较慢的策略每RESAMPLE_INTERVAL次选择只重新测量一次
+    model.record(ProcessingStrategy::DIRECT, 8, 0, 12.0, 360.0, frameBytes, 0);
+    model.record(ProcessingStrategy::STREAMING, 8, 2048, 12.0, 240.0, frameBytes, tileTransient);
+    const int resampleRuns = static_cast<int>(StrategyCostModel::RESAMPLE_INTERVAL) * 10;
+    int slowerRuns = 0;
+    for (int i = 0; i < resampleRuns; ++i) {
+        const bool direct = model.choose(query).strategy == ProcessingStrategy::DIRECT;
+        slowerRuns += direct ? 1 : 0;
+        model.record(direct ? ProcessingStrategy::DIRECT : ProcessingStrategy::STREAMING, 8,
+                     direct ? 0 : 2048, 12.0, direct ? 360.0 : 240.0, frameBytes,
+                     direct ? 0 : tileTransient);
+    }
+    const bool resampleValid = slowerRuns >= 9 && slowerRuns <= 11;
+    model.clear();
+
+    // 临时内存峰值：一次异常大的样本立即抬高预留，之后随正常样本逐步回落，而不是永久保持
+    auto streamingPeak = [&model]() -> uint64_t {
+        for (const auto &entry: model.getEntries()) {
+            if (entry.strategy == static_cast<uint8_t>(ProcessingStrategy::STREAMING)) {
+                return entry.peakTransientBytes;
+            }
+        }
+        return 0;
+    };
+    model.record(ProcessingStrategy::STREAMING, 8, 2048, 12.0, 240.0, frameBytes, tileTransient);
+    model.record(ProcessingStrategy::STREAMING, 8, 2048, 12.0, 240.0, frameBytes,
+                 tileTransient * 8);
+    const uint64_t raisedPeak = streamingPeak();
+    for (int i = 0; i < 40; ++i) {
+        model.record(ProcessingStrategy::STREAMING, 8, 2048, 12.0, 240.0, frameBytes,
+                     tileTransient);
+    }
+    const uint64_t decayedPeak = streamingPeak();
+    const bool decayValid = raisedPeak == tileTransient * 8 && decayedPeak >= tileTransient &&
+                            decayedPeak < tileTransient + tileTransient / 10;
+    model.clear();
+
+    // 损坏的画像项（NaN或负的耗时、零样本、离谱的内存峰值）加载时被丢弃，只保留有效项
+    bool corruptValid = false;
+    {
+        std::vector<StrategyProfileEntry> written(5);
+        for (auto &entry: written) {
+            entry.strategy = static_cast<uint8_t>(ProcessingStrategy::DIRECT);
+            entry.threadCount = 8;
+            entry.sampleCount = 4;
+            entry.msPerMegapixel = 30.0f;
+            entry.peakTransientBytes = tileTransient;
+        }
+        written[1].msPerMegapixel = std::nanf("");
+        written[2].msPerMegapixel = -5.0f;
+        written[3].sampleCount = 0;
+        written[4].peakTransientBytes = ~0ULL;
+        const uint16_t version = StrategyCostModel::PROFILE_VERSION;
+        const auto count = static_cast<uint16_t>(written.size());
+        std::ofstream file(profilePath, std::ios::binary);
+        file.write(StrategyCostModel::PROFILE_MAGIC, sizeof(StrategyCostModel::PROFILE_MAGIC));
+        file.write(reinterpret_cast<const char *>(&version), sizeof(version));
+        file.write(reinterpret_cast<const char *>(&count), sizeof(count));
+        file.write(reinterpret_cast<const char *>(written.data()),
+                   written.size() * sizeof(StrategyProfileEntry));
+        file.close();
+
+        model.setProfilePath(profilePath);
+        const std::vector<StrategyProfileEntry> accepted = model.getEntries();
+        corruptValid = accepted.size() == 1 && accepted[0].msPerMegapixel == 30.0f;
+        model.setProfilePath("");
+        std::remove(profilePath.c_str());
+        model.clear();
+    }
+
+    // 实际处理：统计每种策略的处理次数与耗时
+    LutData primaryLut = createTestLut(33);
+    LutData emptyLut;
+    ProcessingParams params;
+    params.useBakedLut = false;
+
+    std::vector<uint8_t> input = PerformanceTestUtils::generateTestImageData(width, height, 4);
+    std::vector<uint8_t> output(input.size());
+    ImageInfo inputInfo;
+    inputInfo.width = width;
+    inputInfo.height = height;
+    inputInfo.stride = width * 4;
+    inputInfo.pixels = input.data();
+    ImageInfo outputInfo = inputInfo;
+    outputInfo.pixels = output.data();
+
+    StreamingProcessor processor;
+    std::vector<double> timings;
+
+    PerformanceResult result = runTimedTest("Strategy Cost Model", [&]() -> bool {
+        BenchmarkTool::Timer timer;
+        ProcessResult processResult = processor.processImageOptimized(
+                inputInfo, outputInfo, primaryLut, emptyLut, params);
+        timings.push_back(timer.elapsedMs());
+        return processResult == ProcessResult::SUCCESS;
+    }, 6);
+
+    const StreamingProcessor::ProcessingStats stats = processor.getStats();
+    const std::vector<StrategyProfileEntry> calibrated = model.getEntries();
+    double directMsPerMegapixel = 0.0;
+    double streamingMsPerMegapixel = 0.0;
+    uint64_t directScratchBytes = 0;
+    uint64_t streamingScratchBytes = 0;
+    for (const auto &entry: calibrated) {
+        if (entry.strategy == static_cast<uint8_t>(ProcessingStrategy::DIRECT)) {
+            directMsPerMegapixel = entry.msPerMegapixel;
+            directScratchBytes = entry.peakTransientBytes;
+        } else {
+            streamingMsPerMegapixel = entry.msPerMegapixel;
+            streamingScratchBytes = entry.peakTransientBytes;
+        }
+    }
+    const double calibratedAvg =
+            timings.size() > 2 ? std::accumulate(timings.begin() + 2, timings.end(), 0.0) /
+                                 (timings.size() - 2) : 0.0;
+
+    model.clear();
+    model.setProfilePath(savedProfilePath);
+
+    if (!modelValid || !persistenceValid || !resampleValid || !decayValid || !corruptValid) {
+        result.markFailed();
+    }
+
+    result.customMetrics["model_valid"] = modelValid ? 1.0 : 0.0;
+    result.customMetrics["persistence_valid"] = persistenceValid ? 1.0 : 0.0;
+    result.customMetrics["resample_valid"] = resampleValid ? 1.0 : 0.0;
+    result.customMetrics["decay_valid"] = decayValid ? 1.0 : 0.0;
+    result.customMetrics["corrupt_profile_valid"] = corruptValid ? 1.0 : 0.0;
+    result.customMetrics["decayed_peak_mb"] = decayedPeak / (1024.0 * 1024.0);
+    result.customMetrics["slower_runs"] = slowerRuns;
+    result.customMetrics["direct_runs"] = static_cast<double>(stats.directProcessCount);
+    result.customMetrics["streaming_runs"] = static_cast<double>(stats.streamingProcessCount);
+    result.customMetrics["passes_per_image"] =
+            stats.totalImagesProcessed > 0
+            ? static_cast<double>(stats.directProcessCount + stats.streamingProcessCount) /
+              stats.totalImagesProcessed : 0.0;
+    result.customMetrics["direct_ms_per_mp"] = directMsPerMegapixel;
+    result.customMetrics["streaming_ms_per_mp"] = streamingMsPerMegapixel;
+    result.customMetrics["direct_scratch_mb"] = directScratchBytes / (1024.0 * 1024.0);
+    result.customMetrics["streaming_scratch_mb"] = streamingScratchBytes / (1024.0 * 1024.0);
+    result.customMetrics["calibrated_avg_ms"] = calibratedAvg;
+
+    LOGI("策略代价模型: 直接 %.1f ms/MP, 分块 %.1f ms/MP, 直接 %zu 次, 分块 %zu 次, 校准后平均 %.2fms",
+         directMsPerMegapixel, streamingMsPerMegapixel, stats.directProcessCount,
+         stats.streamingProcessCount, calibratedAvg);
+
+    return result;
+}
+
+PerformanceResult PerformanceTestSuite::testTileAutotunePerformance() {
+    // 先用模拟的sysfs缓存目录验证缓存大小解析与候选尺寸，再实测调优，
+    // 最后对比调优前后的多线程行带（整图随机抖动第二遍 vs 行带内融合）与分块处理耗时
+    const std::string cacheDir = LutCache::getCacheDirectory();
+    const std::string topologyRoot = (cacheDir.empty() ? "/data/local/tmp" : cacheDir) +
+                                     "/perf_test_caches";
+    const std::string cpuDir = topologyRoot + "/cpu0";
+    const char *levels[] = {"1", "1", "2", "3"};
+    const char *types[] = {"Data", "Instruction", "Unified", "Unified"};
+    const char *sizes[] = {"64K", "64K", "512K", "8M"};
+
+    mkdir(topologyRoot.c_str(), 0755);
+    mkdir(cpuDir.c_str(), 0755);
+    mkdir((cpuDir + "/cache").c_str(), 0755);
+    for (int index = 0; index < 4; ++index) {
+        const std::string indexDir = cpuDir + "/cache/index" + std::to_string(index);
+        mkdir(indexDir.c_str(), 0755);
+        std::ofstream(indexDir + "/level") << levels[index] << "\n";
+        std::ofstream(indexDir + "/type") << types[index] << "\n";
+        std::ofstream(indexDir + "/size") << sizes[index] << "\n";
+    }
+
+    CpuTopologyInfo topology;
+    bool cachesValid = CpuTopology::detect(topologyRoot, topology) &&
+                       topology.l1dCacheBytes == 64 * 1024 &&
+                       topology.l2CacheBytes == 512 * 1024 &&
+                       topology.l3CacheBytes == 8 * 1024 * 1024;
+    const std::vector<int> sides = TileAutotuner::candidateTileSides(topology);
+    cachesValid = cachesValid && !sides.empty() && sides.front() == TileAutotuner::MIN_TILE_SIDE &&
+                  sides.back() == 1024;
+    if (!cachesValid) {
+        LOGE("模拟缓存检测结果不正确");
+    }
+
+    for (int index = 0; index < 4; ++index) {
+        const std::string indexDir = cpuDir + "/cache/index" + std::to_string(index);
+        std::remove((indexDir + "/level").c_str());
+        std::remove((indexDir + "/type").c_str());
+        std::remove((indexDir + "/size").c_str());
+        rmdir(indexDir.c_str());
+    }
+    rmdir((cpuDir + "/cache").c_str());
+    rmdir(cpuDir.c_str());
+    rmdir(topologyRoot.c_str());
+
+    TileAutotuner &tuner = TileAutotuner::getInstance();
+    ThreadPool &pool = ThreadPool::getInstance();
+
+    // 已有处理任务占用预算时，调优的缓冲区预留失败，应跳过实测而不是挤占内存
+    MemoryAdmissionController &admission = MemoryAdmissionController::getInstance();
+    const size_t previousBudget = admission.getBudget();
+    admission.setBudget(8 * 1024 * 1024);
+    TileTuningReport skippedReport;
+    {
+        MemoryAdmissionController::Reservation runningJob = admission.tryReserve(1024 * 1024);
+        tuner.tune(&skippedReport);
+    }
+    admission.setBudget(previousBudget);
+    const bool admissionValid = !skippedReport.tuning.tuned && skippedReport.tileTimings.empty();
+
+    // 线程池有任务在执行时不空闲，调优的实测会等到空闲后再进行
+    bool idleValid = pool.isIdle();
+    {
+        std::promise<void> release;
+        std::shared_future<void> released = release.get_future().share();
+        std::future<void> blocker = pool.submit([released]() { released.wait(); });
+        idleValid = idleValid && !pool.isIdle();
+        release.set_value();
+        blocker.get();
+    }
+
+    TileTuningReport report;
+    BenchmarkTool::Timer tuneTimer;
+    const TileTuning tuning = tuner.tune(&report);
+    const double tuneMs = tuneTimer.elapsedMs();
+
+    LutData primaryLut = createTestLut(33);
+    LutData emptyLut;
+    ProcessingParams params;
+    params.ditherType = 2;
+    BakedLutData baked;
+    LutBaker::bake(primaryLut, emptyLut, params, baked);
+    params.bakedLut = &baked;
+
+    const int width = 4096;
+    const int height = 3072;
+    std::vector<uint8_t> input = PerformanceTestUtils::generateTestImageData(width, height, 4);
+    std::vector<uint8_t> output(input.size());
+    ImageInfo inputInfo;
+    inputInfo.width = width;
+    inputInfo.height = height;
+    inputInfo.stride = width * 4;
+    inputInfo.pixels = input.data();
+    ImageInfo outputInfo = inputInfo;
+    outputInfo.pixels = output.data();
+
+    const int parallelism = pool.getWorkerCount() + 1;
+    const int legacyGrain = std::max(8, height / (parallelism * 4));
+    const int tunedGrain = std::clamp(TileAutotuner::bandRows(tuning.bandBytes, width), 8,
+                                      legacyGrain);
+
+    StreamingConfig legacyConfig;
+    legacyConfig.autoTuneTileSize = false;
+    StreamingProcessor legacyProcessor;
+    legacyProcessor.setConfig(legacyConfig);
+    StreamingProcessor tunedProcessor;
+
+    std::vector<double> legacyBandTimings;
+    std::vector<double> tunedBandTimings;
+    std::vector<double> legacyTileTimings;
+    std::vector<double> tunedTileTimings;
+
+    PerformanceResult result = runTimedTest("Tile Autotune", [&]() -> bool {
+        // 调优前：按线程数均分的大行带只做查表，随后整图做随机抖动
+        ProcessingParams lutOnly = params;
+        lutOnly.ditherType = 0;
+        BenchmarkTool::Timer legacyTimer;
+        pool.parallelFor(0, height, legacyGrain, [&](int startRow, int endRow) {
+            ImageProcessor::processBand(input.data(), output.data(), startRow, endRow, width,
+                                        inputInfo.stride, outputInfo.stride, primaryLut,
+                                        emptyLut, lutOnly);
+        });
+        ImageProcessor::applyDithering(output.data(), width, height, outputInfo.stride, params);
+        legacyBandTimings.push_back(legacyTimer.elapsedMs());
+
+        BenchmarkTool::Timer tunedTimer;
+        pool.parallelFor(0, height, tunedGrain, [&](int startRow, int endRow) {
+            ImageProcessor::processBand(input.data(), output.data(), startRow, endRow, width,
+                                        inputInfo.stride, outputInfo.stride, primaryLut,
+                                        emptyLut, params);
+        });
+        tunedBandTimings.push_back(tunedTimer.elapsedMs());
+
+        BenchmarkTool::Timer legacyTileTimer;
+        ProcessResult legacyResult = legacyProcessor.processImageStreaming(
+                inputInfo, outputInfo, primaryLut, emptyLut, params);
+        legacyTileTimings.push_back(legacyTileTimer.elapsedMs());
+
+        BenchmarkTool::Timer tunedTileTimer;
+        ProcessResult tunedResult = tunedProcessor.processImageStreaming(
+                inputInfo, outputInfo, primaryLut, emptyLut, params);
+        tunedTileTimings.push_back(tunedTileTimer.elapsedMs());
+
+        return legacyResult == ProcessResult::SUCCESS && tunedResult == ProcessResult::SUCCESS;
+    }, 5);
+
+    auto average = [](const std::vector<double> &values) {
+        return values.empty() ? 0.0 : std::accumulate(values.begin(), values.end(), 0.0) /
+                                      values.size();
+    };
+
+    if (!cachesValid || !admissionValid || !idleValid || !tuning.tuned) {
+        result.markFailed();
+    }
+
+    result.customMetrics["caches_valid"] = cachesValid ? 1.0 : 0.0;
+    result.customMetrics["admission_skip_valid"] = admissionValid ? 1.0 : 0.0;
+    result.customMetrics["pool_idle_valid"] = idleValid ? 1.0 : 0.0;
+    result.customMetrics["tuned_tile_side"] = tuning.tileSide;
+    result.customMetrics["tuned_band_kb"] = tuning.bandBytes / 1024.0;
+    result.customMetrics["tune_ms"] = tuneMs;
+    result.customMetrics["legacy_band_ms"] = average(legacyBandTimings);
+    result.customMetrics["tuned_band_ms"] = average(tunedBandTimings);
+    result.customMetrics["legacy_tile_ms"] = average(legacyTileTimings);
+    result.customMetrics["tuned_tile_ms"] = average(tunedTileTimings);
+    for (const auto &timing: report.tileTimings) {
+        result.customMetrics["tile_" + std::to_string(timing.first) + "_ms"] = timing.second;
+    }
+    for (const auto &timing: report.bandTimings) {
+        result.customMetrics["band_" + std::to_string(timing.first / 1024) + "kb_ms"] =
+                timing.second;
+    }
+
+    LOGI("分块调优（%.0fms）: 块边长 %d, 行带 %zu KB; 行带 %.2fms -> %.2fms, 分块 %.2fms -> %.2fms",
+         tuneMs, tuning.tileSide, tuning.bandBytes / 1024, average(legacyBandTimings),
+         average(tunedBandTimings), average(legacyTileTimings), average(tunedTileTimings));
+
+    return result;
+}
+
+#ifdef VULKAN_ENABLED
+PerformanceResult PerformanceTestSuite::testVulkanStagingRingPerformance() {
+    // 对比每帧创建、分配、映射再释放整图暂存缓冲区（旧的processImage流程）与持久映射的暂存环，
+    // 再用计算管线连续处理同尺寸图片，检查暂存环只创建一次
+    vulkan::VkContext context;
+    if (!context.initialize()) {
+        LOGI("设备不支持Vulkan，跳过暂存环测试");
+        PerformanceResult skipped;
+        skipped.testName = "Vulkan Staging Ring";
+        skipped.customMetrics["vulkan_available"] = 0.0;
+        return skipped;
+    }
+
+    VkDevice device = context.getDevice();
+    const int width = 4000;
+    const int height = 3000;
+    const VkDeviceSize frameBytes = static_cast<VkDeviceSize>(width) * height * 4;
+    std::vector<uint8_t> frame(static_cast<size_t>(frameBytes));
+    for (size_t i = 0; i < frame.size(); ++i) {
+        frame[i] = static_cast<uint8_t>(i * 31);
+    }
+
+    vulkan::VkStagingRing ring(&context, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, false);
+    BenchmarkTool::Comparison comparison;
+    uint64_t serial = 0;
+
+    PerformanceResult result = runTimedTest("Vulkan Staging Ring", [&]() -> bool {
+        bool legacyOk = false;
+        comparison.timeBaseline([&]() {
+            VkBufferCreateInfo bufferInfo = {};
+            bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+            bufferInfo.size = frameBytes;
+            bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+            bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+            VkBuffer buffer = VK_NULL_HANDLE;
+            if (vkCreateBuffer(device, &bufferInfo, nullptr, &buffer) != VK_SUCCESS) {
+                return;
+            }
+            VkMemoryRequirements memRequirements;
+            vkGetBufferMemoryRequirements(device, buffer, &memRequirements);
+
+            VkMemoryAllocateInfo allocInfo = {};
+            allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+            allocInfo.allocationSize = memRequirements.size;
+            allocInfo.memoryTypeIndex = context.findMemoryType(
+                    memRequirements.memoryTypeBits,
+                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+            VkDeviceMemory memory = VK_NULL_HANDLE;
+            void *data = nullptr;
+            legacyOk = vkAllocateMemory(device, &allocInfo, nullptr, &memory) == VK_SUCCESS &&
+                       vkBindBufferMemory(device, buffer, memory, 0) == VK_SUCCESS &&
+                       vkMapMemory(device, memory, 0, frameBytes, 0, &data) == VK_SUCCESS;
+            if (legacyOk) {
+                memcpy(data, frame.data(), frame.size());
+                vkUnmapMemory(device, memory);
+            }
+            if (memory != VK_NULL_HANDLE) {
+                vkFreeMemory(device, memory, nullptr);
+            }
+            vkDestroyBuffer(device, buffer, nullptr);
+        });
+
+        vulkan::VkStagingRing::Allocation upload;
+        comparison.timeCandidate([&]() {
+            const uint64_t frameSerial = ++serial;
+            upload = ring.allocate(frameBytes, frameSerial);
+            if (upload.isValid()) {
+                memcpy(upload.mappedData, frame.data(), frame.size());
+                ring.flush(upload);
+            }
+            ring.release(frameSerial);
+        });
+
+        // 两种方式上传的是同一帧，暂存环映射区中的内容必须与源数据一致
+        return legacyOk && upload.isValid() &&
+               memcmp(upload.mappedData, frame.data(), frame.size()) == 0;
+    }, 10);
+
+    const vulkan::VkStagingRing::Stats ringStats = ring.getStats();
+    ring.destroy();
+
+    // 同尺寸的图片连续处理，暂存环只应创建一次
+    bool pipelineReuse = false;
+    {
+        vulkan::VkMemoryPool memoryPool(&context);
+        vulkan::VkComputePipeline pipeline(&context, &memoryPool);
+        if (pipeline.initialize()) {
+            const int pipelineSide = 1024;
+            std::vector<uint8_t> input(static_cast<size_t>(pipelineSide) * pipelineSide * 4, 128);
+            std::vector<uint8_t> output(input.size());
+            vulkan::VkComputePipeline::ProcessingParams params;
+            bool processed = true;
+            for (int i = 0; i < 4 && processed; ++i) {
+                processed = pipeline.processImage(pipelineSide, pipelineSide, input.data(),
+                                                  output.data(), params);
+            }
+            const vulkan::VkStagingRing::Stats upload = pipeline.getUploadRingStats();
+            const vulkan::VkStagingRing::Stats readback = pipeline.getReadbackRingStats();
+            pipelineReuse = processed && upload.growCount == 1 && readback.growCount == 1 &&
+                            upload.allocations == 4 && readback.allocations == 4;
+        }
+    }
+
+    if (!pipelineReuse) {
+        result.markFailed();
+    }
+    result.customMetrics["vulkan_available"] = 1.0;
+    comparison.addMetrics(result, "legacy_staging_ms", "ring_staging_ms");
+    result.customMetrics["ring_grow_count"] = static_cast<double>(ringStats.growCount);
+    result.customMetrics["ring_capacity_mb"] = ringStats.capacity / (1024.0 * 1024.0);
+    result.customMetrics["pipeline_reuse_valid"] = pipelineReuse ? 1.0 : 0.0;
+
+    LOGI("Vulkan暂存: 每帧分配 %.2fms -> 暂存环 %.2fms, 扩容 %llu 次, 管线复用 %d",
+         comparison.baselineMs(), comparison.candidateMs(),
+         static_cast<unsigned long long>(ringStats.growCount), pipelineReuse ? 1 : 0);
+
+    return result;
+}
+
+PerformanceResult PerformanceTestSuite::testVulkanBatchPerformance() {
+    // 对比逐张processImage（每张提交后等待围栏）与多帧在途的processBatch，
+    // 两种方式的输出必须逐字节一致
+    vulkan::VkContext context;
+    if (!context.initialize()) {
+        LOGI("设备不支持Vulkan，跳过批处理测试");
+        PerformanceResult skipped;
+        skipped.testName = "Vulkan Batch Processing";
+        skipped.customMetrics["vulkan_available"] = 0.0;
+        return skipped;
+    }
+
+    vulkan::VkMemoryPool memoryPool(&context);
+    vulkan::VkComputePipeline pipeline(&context, &memoryPool);
+    // 非Android环境没有资源管理器，从文件加载着色器
+    if (const char *shaderPath = getenv("LUT2PHOTO_SPIRV_PATH")) {
+        pipeline.setShaderPath(shaderPath);
+    }
+    if (!pipeline.initialize()) {
+        LOGI("计算管线初始化失败，跳过批处理测试");
+        PerformanceResult skipped;
+        skipped.testName = "Vulkan Batch Processing";
+        skipped.customMetrics["vulkan_available"] = 0.0;
+        return skipped;
+    }
+
+    const int width = 2048;
+    const int height = 1536;
+    const int imageCount = 8;
+    const size_t imageBytes = static_cast<size_t>(width) * height * 4;
+    std::vector<std::vector<uint8_t>> inputs(imageCount, std::vector<uint8_t>(imageBytes));
+    std::vector<std::vector<uint8_t>> sequentialOutputs(imageCount,
+                                                        std::vector<uint8_t>(imageBytes));
+    std::vector<std::vector<uint8_t>> batchOutputs(imageCount, std::vector<uint8_t>(imageBytes));
+    for (int image = 0; image < imageCount; ++image) {
+        for (size_t i = 0; i < imageBytes; ++i) {
+            inputs[image][i] = static_cast<uint8_t>(i * 7 + image * 13);
+        }
+    }
+
+    vulkan::VkComputePipeline::ProcessingParams params;
+    BenchmarkTool::Comparison comparison;
+    bool outputsMatch = true;
+
+    PerformanceResult result = runTimedTest("Vulkan Batch Processing", [&]() -> bool {
+        bool sequentialOk = true;
+        comparison.timeBaseline([&]() {
+            for (int image = 0; image < imageCount && sequentialOk; ++image) {
+                sequentialOk = pipeline.processImage(width, height, inputs[image].data(),
+                                                     sequentialOutputs[image].data(), params);
+            }
+        });
+
+        std::vector<vulkan::VkComputePipeline::BatchItem> items(imageCount);
+        for (int image = 0; image < imageCount; ++image) {
+            items[image].width = width;
+            items[image].height = height;
+            items[image].inputPixels = inputs[image].data();
+            items[image].outputPixels = batchOutputs[image].data();
+        }
+
+        bool batchOk = false;
+        comparison.timeCandidate([&]() { batchOk = pipeline.processBatch(items, params); });
+
+        for (int image = 0; image < imageCount && outputsMatch; ++image) {
+            outputsMatch = memcmp(sequentialOutputs[image].data(), batchOutputs[image].data(),
+                                  imageBytes) == 0;
+        }
+        return sequentialOk && batchOk && outputsMatch;
+    }, 3);
+
+    result.customMetrics["vulkan_available"] = 1.0;
+    result.customMetrics["dedicated_transfer_queue"] = context.hasDedicatedTransferQueue() ? 1.0 : 0.0;
+    comparison.addMetrics(result, "sequential_ms", "batch_ms", "batch_speedup");
+    result.customMetrics["outputs_match"] = outputsMatch ? 1.0 : 0.0;
+
+    LOGI("Vulkan批处理（%d张 %dx%d, 独立传输队列 %d）: 逐张 %.2fms -> 批处理 %.2fms, 输出一致 %d",
+         imageCount, width, height, context.hasDedicatedTransferQueue() ? 1 : 0,
+         comparison.baselineMs(), comparison.candidateMs(), outputsMatch ? 1 : 0);
+
+    return result;
+}
+
+PerformanceResult PerformanceTestSuite::testVulkanTiledPerformance() {
+    // 把单块边长限制到1024，强制分块处理；开启颗粒与蓝噪声抖动，
+    // 分块结果必须与整图处理逐字节一致（块之间没有接缝）
+    vulkan::VkContext context;
+    if (!context.initialize()) {
+        LOGI("设备不支持Vulkan，跳过分块测试");
+        PerformanceResult skipped;
+        skipped.testName = "Vulkan Tiled Processing";
+        skipped.customMetrics["vulkan_available"] = 0.0;
+        return skipped;
+    }
+
+    vulkan::VkMemoryPool memoryPool(&context);
+    vulkan::VkComputePipeline pipeline(&context, &memoryPool);
+    if (const char *shaderPath = getenv("LUT2PHOTO_SPIRV_PATH")) {
+        pipeline.setShaderPath(shaderPath);
+    }
+    if (!pipeline.initialize()) {
+        LOGI("计算管线初始化失败，跳过分块测试");
+        PerformanceResult skipped;
+        skipped.testName = "Vulkan Tiled Processing";
+        skipped.customMetrics["vulkan_available"] = 0.0;
+        return skipped;
+    }
+
+    // 尺寸不是块边长的整数倍，包含边缘块
+    const int width = 3000;
+    const int height = 2000;
+    const uint32_t tileLimit = 1024;
+    const size_t imageBytes = static_cast<size_t>(width) * height * 4;
+    std::vector<uint8_t> input(imageBytes);
+    for (size_t i = 0; i < imageBytes; ++i) {
+        input[i] = static_cast<uint8_t>((i * 5) ^ (i >> 11));
+    }
+    std::vector<uint8_t> wholeOutput(imageBytes);
+    std::vector<uint8_t> tiledOutput(imageBytes);
+
+    vulkan::VkComputePipeline::ProcessingParams params;
+    params.ditherType = 4;
+    params.grainEnabled = 1;
+    params.grainStrength = 0.5f;
+    params.grainSeed = 7.0f;
+
+    BenchmarkTool::Comparison comparison;
+    bool outputsMatch = true;
+
+    PerformanceResult result = runTimedTest("Vulkan Tiled Processing", [&]() -> bool {
+        pipeline.setTileDimensionLimit(0);
+        bool wholeOk = false;
+        comparison.timeBaseline([&]() {
+            wholeOk = pipeline.processImage(width, height, input.data(), wholeOutput.data(),
+                                            params);
+        });
+
+        pipeline.setTileDimensionLimit(tileLimit);
+        bool tiledOk = false;
+        comparison.timeCandidate([&]() {
+            tiledOk = pipeline.processImage(width, height, input.data(), tiledOutput.data(),
+                                            params);
+        });
+
+        outputsMatch = outputsMatch &&
+                       memcmp(wholeOutput.data(), tiledOutput.data(), imageBytes) == 0;
+        return wholeOk && tiledOk && outputsMatch;
+    }, 3);
+    pipeline.setTileDimensionLimit(0);
+
+    result.customMetrics["vulkan_available"] = 1.0;
+    result.customMetrics["device_max_dimension"] = context.getMaxImageDimension2D();
+    comparison.addMetrics(result, "whole_ms", "tiled_ms");
+    result.customMetrics["outputs_match"] = outputsMatch ? 1.0 : 0.0;
+
+    LOGI("Vulkan分块（%dx%d, 块边长 %u）: 整图 %.2fms, 分块 %.2fms, 输出一致 %d",
+         width, height, tileLimit, comparison.baselineMs(), comparison.candidateMs(),
+         outputsMatch ? 1 : 0);
+
+    return result;
+}
+
+PerformanceResult PerformanceTestSuite::testVulkanStorageBufferPerformance() {
+    // 对比存储图像路径（暂存区与图像之间两次拷贝加布局转换）与直接读写暂存区的存储缓冲区路径，
+    // 两者的输出差异不应超过一个量化级（rgba8写入与packUnorm4x8的舍入可能不同）
+    vulkan::VkContext context;
+    if (!context.initialize()) {
+        LOGI("设备不支持Vulkan，跳过存储缓冲区测试");
+        PerformanceResult skipped;
+        skipped.testName = "Vulkan Storage Buffer Path";
+        skipped.customMetrics["vulkan_available"] = 0.0;
+        return skipped;
+    }
+
+    vulkan::VkMemoryPool memoryPool(&context);
+    vulkan::VkComputePipeline pipeline(&context, &memoryPool);
+    if (const char *shaderPath = getenv("LUT2PHOTO_SPIRV_PATH")) {
+        pipeline.setShaderPath(shaderPath);
+    }
+    if (!pipeline.initialize()) {
+        LOGI("计算管线初始化失败，跳过存储缓冲区测试");
+        PerformanceResult skipped;
+        skipped.testName = "Vulkan Storage Buffer Path";
+        skipped.customMetrics["vulkan_available"] = 0.0;
+        return skipped;
+    }
+
+    const int width = 4000;
+    const int height = 3000;
+    const int imageCount = 4;
+    const size_t imageBytes = static_cast<size_t>(width) * height * 4;
+    std::vector<std::vector<uint8_t>> inputs(imageCount, std::vector<uint8_t>(imageBytes));
+    std::vector<std::vector<uint8_t>> imageOutputs(imageCount, std::vector<uint8_t>(imageBytes));
+    std::vector<std::vector<uint8_t>> bufferOutputs(imageCount, std::vector<uint8_t>(imageBytes));
+    for (int image = 0; image < imageCount; ++image) {
+        for (size_t i = 0; i < imageBytes; ++i) {
+            inputs[image][i] = static_cast<uint8_t>(i * 3 + image * 29);
+        }
+    }
+
+    auto makeItems = [&](std::vector<std::vector<uint8_t>> &outputs) {
+        std::vector<vulkan::VkComputePipeline::BatchItem> items(imageCount);
+        for (int image = 0; image < imageCount; ++image) {
+            items[image].width = width;
+            items[image].height = height;
+            items[image].inputPixels = inputs[image].data();
+            items[image].outputPixels = outputs[image].data();
+        }
+        return items;
+    };
+
+    vulkan::VkComputePipeline::ProcessingParams params;
+    params.grainEnabled = 1;
+    params.grainStrength = 0.3f;
+    BenchmarkTool::Comparison comparison;
+    bool bufferAvailable = true;
+    int maxDifference = 0;
+
+    PerformanceResult result = runTimedTest("Vulkan Storage Buffer Path", [&]() -> bool {
+        pipeline.setComputePath(vulkan::VkComputePipeline::ComputePath::STORAGE_IMAGE);
+        std::vector<vulkan::VkComputePipeline::BatchItem> imageItems = makeItems(imageOutputs);
+        bool imageOk = false;
+        comparison.timeBaseline([&]() { imageOk = pipeline.processBatch(imageItems, params); });
+
+        bufferAvailable = pipeline.setComputePath(
+                vulkan::VkComputePipeline::ComputePath::STORAGE_BUFFER);
+        if (!bufferAvailable) {
+            return imageOk;
+        }
+        std::vector<vulkan::VkComputePipeline::BatchItem> bufferItems = makeItems(bufferOutputs);
+        bool bufferOk = false;
+        comparison.timeCandidate([&]() { bufferOk = pipeline.processBatch(bufferItems, params); });
+
+        for (int image = 0; image < imageCount; ++image) {
+            for (size_t i = 0; i < imageBytes; ++i) {
+                maxDifference = std::max(maxDifference,
+                                         std::abs(imageOutputs[image][i] - bufferOutputs[image][i]));
+            }
+        }
+        return imageOk && bufferOk && maxDifference <= 1;
+    }, 3);
+    pipeline.setComputePath(vulkan::VkComputePipeline::ComputePath::STORAGE_IMAGE);
+
+    result.customMetrics["vulkan_available"] = 1.0;
+    result.customMetrics["buffer_variant_available"] = bufferAvailable ? 1.0 : 0.0;
+    comparison.addMetrics(result, "image_path_ms", "buffer_path_ms", "buffer_speedup");
+    result.customMetrics["max_difference"] = maxDifference;
+
+    LOGI("Vulkan计算路径（%d张 %dx%d）: 存储图像 %.2fms, 存储缓冲区 %.2fms, 最大差异 %d%s",
+         imageCount, width, height, comparison.baselineMs(), comparison.candidateMs(),
+         maxDifference,
+         bufferAvailable ? "" : "（存储缓冲区变体不可用）");
+
+    return result;
+}
+
+PerformanceResult PerformanceTestSuite::testVulkanPipelineCachePerformance() {
+    // 冷启动：删除管线缓存文件后初始化计算管线；热启动：用上一次写回的文件再初始化一次，
+    // 热启动必须载入文件中的缓存，且两条管线处理同一张小图的结果必须逐字节一致。
+    // 另外对比完整上下文初始化与进程内缓存的轻量探测
+    BenchmarkTool::Timer contextTimer;
+    vulkan::VkContext context;
+    if (!context.initialize()) {
+        LOGI("设备不支持Vulkan，跳过管线缓存测试");
+        PerformanceResult skipped;
+        skipped.testName = "Vulkan Pipeline Cache";
+        skipped.customMetrics["vulkan_available"] = 0.0;
+        return skipped;
+    }
+    const double contextMs = contextTimer.elapsedMs();
+
+    BenchmarkTool::Timer probeTimer;
+    const vulkan::VkContext::DeviceProbe probe = vulkan::VkContext::probe();
+    const double probeMs = probeTimer.elapsedMs();
+
+    const std::string cacheDir = LutCache::getCacheDirectory();
+    const std::string cachePath = (cacheDir.empty() ? "/data/local/tmp" : cacheDir) +
+                                  "/perf_test_vk_pipeline_cache.bin";
+    const char *shaderPath = getenv("LUT2PHOTO_SPIRV_PATH");
+
+    const int side = 256;
+    std::vector<uint8_t> input(static_cast<size_t>(side) * side * 4);
+    for (size_t i = 0; i < input.size(); ++i) {
+        input[i] = static_cast<uint8_t>(i * 11);
+    }
+    std::vector<uint8_t> coldOutput(input.size());
+    std::vector<uint8_t> warmOutput(input.size());
+    vulkan::VkComputePipeline::ProcessingParams params;
+
+    vulkan::VkMemoryPool memoryPool(&context);
+    BenchmarkTool::Comparison comparison;
+    // 只对initialize计时；之后用这条管线处理小图，供冷热两次的输出对比
+    auto runPipeline = [&](bool warm, bool &loaded, std::vector<uint8_t> &output) -> bool {
+        vulkan::VkComputePipeline pipeline(&context, &memoryPool);
+        if (shaderPath) {
+            pipeline.setShaderPath(shaderPath);
+        }
+        pipeline.setPipelineCachePath(cachePath);
+        bool ok = false;
+        auto initialize = [&]() { ok = pipeline.initialize(); };
+        if (warm) {
+            comparison.timeCandidate(initialize);
+        } else {
+            comparison.timeBaseline(initialize);
+        }
+        loaded = ok && pipeline.isPipelineCacheLoaded();
+        ok = ok && pipeline.processImage(side, side, input.data(), output.data(), params);
+        pipeline.cleanup();
+        return ok;
+    };
+
+    bool warmLoaded = true;
+    bool outputsMatch = true;
+
+    PerformanceResult result = runTimedTest("Vulkan Pipeline Cache", [&]() -> bool {
+        unlink(cachePath.c_str());
+        bool coldLoaded = false;
+        const bool coldOk = runPipeline(false, coldLoaded, coldOutput);
+        bool loaded = false;
+        const bool warmOk = runPipeline(true, loaded, warmOutput);
+        if (!coldOk || !warmOk) {
+            return false;
+        }
+        warmLoaded = warmLoaded && loaded && !coldLoaded;
+        outputsMatch = outputsMatch && coldOutput == warmOutput;
+        return warmLoaded && outputsMatch;
+    }, 3);
+    unlink(cachePath.c_str());
+
+    result.customMetrics["vulkan_available"] = probe.available ? 1.0 : 0.0;
+    result.customMetrics["context_init_ms"] = contextMs;
+    result.customMetrics["probe_ms"] = probeMs;
+    comparison.addMetrics(result, "cold_pipeline_ms", "warm_pipeline_ms", "warm_speedup");
+    result.customMetrics["cache_loaded"] = warmLoaded ? 1.0 : 0.0;
+    result.customMetrics["outputs_match"] = outputsMatch ? 1.0 : 0.0;
+
+    LOGI("Vulkan冷启动: 上下文 %.2fms, 探测 %.3fms, 管线 冷 %.2fms -> 热 %.2fms, 载入缓存 %d, 输出一致 %d",
+         contextMs, probeMs, comparison.baselineMs(), comparison.candidateMs(),
+         warmLoaded ? 1 : 0, outputsMatch ? 1 : 0);
+
+    return result;
+}
+#endif // VULKAN_ENABLED
+
+// 旧版.cube解析流程（逐行std::string、split分配词元、std::stof），仅作为基准对照
+static bool legacyParseCube(const std::string &content, std::vector<float> &data) {
+    auto trim = [](const std::string &str) -> std::string {
+        size_t start = str.find_first_not_of(" \t\r\n");
+        if (start == std::string::npos) return "";
+        size_t end = str.find_last_not_of(" \t\r\n");
+        return str.substr(start, end - start + 1);
+    };
+    auto split = [&](const std::string &str) -> std::vector<std::string> {
+        std::vector<std::string> tokens;
+        std::istringstream iss(str);
+        std::string token;
+        while (std::getline(iss, token, ' ')) {
+            token = trim(token);
+            if (!token.empty()) tokens.push_back(token);
+        }
+        return tokens;
+    };
+
+    std::istringstream iss(content);
+    std::string line;
+    std::vector<std::string> lines;
+    while (std::getline(iss, line)) {
+        lines.push_back(trim(line));
+    }
+
+    int size = 0;
+    data.clear();
+    for (const std::string &current: lines) {
+        if (current.empty() || current[0] == '#') continue;
+        std::vector<std::string> parts = split(current);
+        if (size == 0) {
+            if (current.find("LUT_3D_SIZE") == 0 && parts.size() >= 2) {
+                size = std::stoi(parts[1]);
+                data.reserve(static_cast<size_t>(size) * size * size * 3);
+            }
+            continue;
+        }
+        if (parts.size() >= 3) {
+            data.push_back(std::stof(parts[0]));
+            data.push_back(std::stof(parts[1]));
+            data.push_back(std::stof(parts[2]));
+        }
+    }
+    return size > 0 && data.size() == static_cast<size_t>(size) * size * size * 3;
+}
+
+PerformanceResult PerformanceTestSuite::testLutParserPerformance() {
+    // 对比旧版逐行分配的解析流程与单次扫描的from_chars分词器
+    const int sizes[] = {17, 33, 65};
+    std::vector<std::string> cubeTexts;
+    for (int size: sizes) {
+        cubeTexts.push_back(PerformanceTestUtils::generateCubeText(createTestLut(size)));
+    }
+
+    std::map<int, BenchmarkTool::Comparison> comparisons;
+
+    PerformanceResult result = runTimedTest("LUT Parser Performance", [&]() -> bool {
+        bool success = true;
+        for (size_t i = 0; i < cubeTexts.size(); ++i) {
+            const std::string &text = cubeTexts[i];
+
+            BenchmarkTool::Comparison &comparison = comparisons[sizes[i]];
+
+            std::vector<float> legacyData;
+            comparison.timeBaseline([&]() {
+                success = legacyParseCube(text, legacyData) && success;
+            });
+
+            LutData lutData;
+            comparison.timeCandidate([&]() {
+                success = LutProcessor::loadLutFromMemory(
+                        reinterpret_cast<const uint8_t *>(text.data()), text.size(), lutData) ==
+                          ProcessResult::SUCCESS && success;
+            });
+
+            success = success && lutData.data == legacyData;
+        }
+        return success;
+    }, 10);
+
+    for (int size: sizes) {
+        const BenchmarkTool::Comparison &comparison = comparisons[size];
+        const std::string prefix = "cube" + std::to_string(size) + "_";
+        comparison.addMetrics(result, prefix + "legacy_ms", prefix + "tokenizer_ms",
+                              prefix + "speedup");
+
+        LOGI("LUT解析 %d^3: 旧版 %.2fms, 分词器 %.2fms", size, comparison.baselineMs(),
+             comparison.candidateMs());
+    }
+
+    return result;
+}
+
+PerformanceResult PerformanceTestSuite::testLutCachePerformance() {
+    // 写出一个65^3的.cube文本文件，对比文本解析与二进制缓存(mmap)加载
+    const std::string previousCacheDir = LutCache::getCacheDirectory();
+    const std::string workDir = previousCacheDir.empty() ? "/data/local/tmp" : previousCacheDir;
+    const std::string cubePath = workDir + "/perf_test_65.cube";
+
+    {
+        std::ofstream cube(cubePath);
+        if (!cube) {
+            LOGE("无法创建测试LUT文件: %s", cubePath.c_str());
+            return PerformanceResult();
+        }
+        cube << PerformanceTestUtils::generateCubeText(createTestLut(65));
+    }
+
+    BenchmarkTool::Comparison comparison;
+    bool cacheHit = true;
+
+    PerformanceResult result = runTimedTest("LUT Cache Performance", [&]() -> bool {
+        LutData parsed;
+        LutCache::setCacheDirectory("");
+        bool parseOk = false;
+        comparison.timeBaseline([&]() {
+            parseOk = LutProcessor::loadLutFromFile(cubePath, parsed) == ProcessResult::SUCCESS;
+        });
+
+        // 首次迭代写入缓存，之后的迭代均为缓存命中
+        LutCache::setCacheDirectory(workDir);
+        if (parseOk && !LutCache::writeToCache(cubePath, parsed)) {
+            return false;
+        }
+
+        LutData cached;
+        bool cacheOk = false;
+        comparison.timeCandidate([&]() {
+            cacheOk = LutCache::loadFromCache(cubePath, cached) == ProcessResult::SUCCESS;
+        });
+        cacheHit = cacheHit && cacheOk;
+
+        return parseOk && cacheOk && cached.data == parsed.data;
+    }, 10);
+
+    std::remove(LutCache::getCachePath(cubePath).c_str());
+    std::remove(cubePath.c_str());
+    LutCache::setCacheDirectory(previousCacheDir);
+
+    comparison.addMetrics(result, "parse_ms", "cache_load_ms");
+    result.customMetrics["cache_hit"] = cacheHit ? 1.0 : 0.0;
+
+    LOGI("LUT缓存: 文本解析 %.2fms, 缓存加载 %.2fms", comparison.baselineMs(),
+         comparison.candidateMs());
+
+    return result;
+}
+
 PerformanceResult PerformanceTestSuite::testMemoryPressureHandling() {
     return runMemoryTest("Memory Pressure Handling", [this]() -> bool {
         try {
@@ -194,7 +2640,7 @@ PerformanceResult PerformanceTestSuite::testMemoryPressureHandling() {
 
             // 清理分配的内存
             for (void *ptr: allocations) {
-                memoryManager_->deallocate(ptr, allocationSize);
+                memoryManager_->deallocate(ptr);
             }
 
             return pressureHandled;
@@ -212,7 +2658,7 @@ PerformanceResult PerformanceTestSuite::testLargeImageProcessing() {
 
             ProcessingConfig config;
             config.enableStreaming = true;
-            config.memoryLimit = 512 * 1024 * 1024; // 512MB
+            config.maxMemoryUsage = 512 * 1024 * 1024; // 512MB
 
             processor_->updateConfig(config);
 
@@ -234,7 +2680,7 @@ PerformanceResult PerformanceTestSuite::testMemoryLeakDetection() {
                 size_t size = (i + 1) * 1024; // 递增大小
                 void *ptr = memoryManager_->allocate(size);
                 if (ptr) {
-                    memoryManager_->deallocate(ptr, size);
+                    memoryManager_->deallocate(ptr);
                 }
             }
 
@@ -294,7 +2740,7 @@ PerformanceResult PerformanceTestSuite::testConcurrentMemoryAccess() {
                         // 模拟一些工作
                         std::this_thread::sleep_for(std::chrono::microseconds(100));
 
-                        memoryManager_->deallocate(ptr, size);
+                        memoryManager_->deallocate(ptr);
                     }
                     return true;
                 }));
@@ -323,7 +2769,8 @@ PerformanceResult PerformanceTestSuite::testExceptionHandlingOverhead() {
 
             // 启用异常处理
             auto &exceptionHandler = ExceptionHandler::getInstance();
-            exceptionHandler.setExceptionThreshold(ExceptionType::MEMORY_ALLOCATION_FAILED, 5);
+            exceptionHandler.setExceptionThreshold(ExceptionType::MEMORY_ALLOCATION_FAILED, 5,
+                                                   std::chrono::seconds(60));
 
             auto result = processor_->processFrame(*testImage);
             return result != nullptr;
@@ -334,7 +2781,9 @@ PerformanceResult PerformanceTestSuite::testExceptionHandlingOverhead() {
 }
 
 PerformanceResult PerformanceTestSuite::testErrorRecoveryPerformance() {
-    return runTimedTest("Error Recovery Performance", [this]() -> bool {
+    // 内存管理器是全局单例，测试结束后恢复原来的限制
+    const size_t previousLimit = memoryManager_->getMemoryLimit();
+    PerformanceResult result = runTimedTest("Error Recovery Performance", [this]() -> bool {
         try {
             // 模拟错误条件
             memoryManager_->setMemoryLimit(1024); // 极低内存限制
@@ -355,6 +2804,8 @@ PerformanceResult PerformanceTestSuite::testErrorRecoveryPerformance() {
             return false;
         }
     });
+    memoryManager_->setMemoryLimit(previousLimit);
+    return result;
 }
 
 std::vector<PerformanceResult> PerformanceTestSuite::runAllTests() {
@@ -377,6 +2828,37 @@ std::vector<PerformanceResult> PerformanceTestSuite::runAllTests() {
     results.push_back(testAsyncProcessingPerformance());
     results.push_back(testLargeImageProcessing());
     results.push_back(testMultiThreadedProcessing());
+    results.push_back(testTetrahedralInterpolationPerformance());
+    results.push_back(testBakedLutPerformance());
+    results.push_back(testBakedLutDefaultParity());
+    results.push_back(testSimdKernelPerformance());
+#if USE_NEON_SIMD
+    results.push_back(testNeonKernelParity());
+#endif
+    results.push_back(testDefaultPathPerformance());
+    results.push_back(testThreadPoolDispatchPerformance());
+    results.push_back(testAdaptiveSchedulingPerformance());
+    results.push_back(testWavefrontDitheringPerformance());
+    results.push_back(testOrderedDitheringPerformance());
+    results.push_back(testStreamingTileViewPerformance());
+    results.push_back(testStreamingPipelinePerformance());
+    results.push_back(testStripStreamingPerformance());
+    results.push_back(testMemoryPoolThroughputPerformance());
+    results.push_back(testMemoryPoolThreadCachePerformance());
+    results.push_back(testJobArenaPerformance());
+    results.push_back(testLargePageBufferPerformance());
+    results.push_back(testMemoryAdmissionPerformance());
+    results.push_back(testStrategyCostModelPerformance());
+    results.push_back(testTileAutotunePerformance());
+#ifdef VULKAN_ENABLED
+    results.push_back(testVulkanStagingRingPerformance());
+    results.push_back(testVulkanBatchPerformance());
+    results.push_back(testVulkanTiledPerformance());
+    results.push_back(testVulkanStorageBufferPerformance());
+    results.push_back(testVulkanPipelineCachePerformance());
+#endif
+    results.push_back(testLutParserPerformance());
+    results.push_back(testLutCachePerformance());
 
     // 异常处理测试
     results.push_back(testExceptionHandlingOverhead());
@@ -409,6 +2891,37 @@ std::vector<PerformanceResult> PerformanceTestSuite::runProcessingTests() {
     results.push_back(testAsyncProcessingPerformance());
     results.push_back(testLargeImageProcessing());
     results.push_back(testMultiThreadedProcessing());
+    results.push_back(testTetrahedralInterpolationPerformance());
+    results.push_back(testBakedLutPerformance());
+    results.push_back(testBakedLutDefaultParity());
+    results.push_back(testSimdKernelPerformance());
+#if USE_NEON_SIMD
+    results.push_back(testNeonKernelParity());
+#endif
+    results.push_back(testDefaultPathPerformance());
+    results.push_back(testThreadPoolDispatchPerformance());
+    results.push_back(testAdaptiveSchedulingPerformance());
+    results.push_back(testWavefrontDitheringPerformance());
+    results.push_back(testOrderedDitheringPerformance());
+    results.push_back(testStreamingTileViewPerformance());
+    results.push_back(testStreamingPipelinePerformance());
+    results.push_back(testStripStreamingPerformance());
+    results.push_back(testMemoryPoolThroughputPerformance());
+    results.push_back(testMemoryPoolThreadCachePerformance());
+    results.push_back(testJobArenaPerformance());
+    results.push_back(testLargePageBufferPerformance());
+    results.push_back(testMemoryAdmissionPerformance());
+    results.push_back(testStrategyCostModelPerformance());
+    results.push_back(testTileAutotunePerformance());
+#ifdef VULKAN_ENABLED
+    results.push_back(testVulkanStagingRingPerformance());
+    results.push_back(testVulkanBatchPerformance());
+    results.push_back(testVulkanTiledPerformance());
+    results.push_back(testVulkanStorageBufferPerformance());
+    results.push_back(testVulkanPipelineCachePerformance());
+#endif
+    results.push_back(testLutParserPerformance());
+    results.push_back(testLutCachePerformance());
 
     return results;
 }
@@ -449,6 +2962,31 @@ void PerformanceTestSuite::printSummary(const std::vector<PerformanceResult> &re
          static_cast<double>(successfulTests) / results.size() * 100.0);
 }
 
+bool PerformanceTestSuite::validatePerformanceRegression(
+        const std::vector<PerformanceResult> &currentResults,
+        const std::vector<PerformanceResult> &baselineResults,
+        double tolerancePercent) {
+    bool passed = true;
+    for (const auto &current: currentResults) {
+        auto baseline = std::find_if(baselineResults.begin(), baselineResults.end(),
+                                     [&current](const PerformanceResult &candidate) {
+                                         return candidate.testName == current.testName;
+                                     });
+        if (baseline == baselineResults.end()) {
+            continue;
+        }
+
+        const double improvement =
+                PerformanceTestUtils::calculatePerformanceImprovement(*baseline, current);
+        if (improvement < -tolerancePercent) {
+            LOGE("性能回退: %s 平均 %.2fms -> %.2fms (%.1f%%)", current.testName.c_str(),
+                 baseline->averageTimeMs, current.averageTimeMs, improvement);
+            passed = false;
+        }
+    }
+    return passed;
+}
+
 // 私有方法实现
 PerformanceResult PerformanceTestSuite::runTimedTest(const std::string &testName,
                                                      std::function<bool()> testFunction,
@@ -561,18 +3099,22 @@ std::unique_ptr<MediaFrame> PerformanceTestSuite::createTestImage(int width, int
     frame->width = width;
     frame->height = height;
     frame->format = PixelFormat::RGBA8888;
-    frame->channels = 4;
+    frame->stride = width * 4;
 
-    size_t dataSize = width * height * 4;
-    frame->data.resize(dataSize);
+    const size_t dataSize = static_cast<size_t>(width) * height * 4;
+    auto *pixels = new uint8_t[dataSize];
+    frame->data = pixels;
+    frame->dataSize = dataSize;
+    frame->ownsData = true;
+    frame->deleter = [pixels]() { delete[] pixels; };
 
     // 填充测试数据
     std::random_device rd;
     std::mt19937 gen(rd());
-    std::uniform_int_distribution<uint8_t> dis(0, 255);
+    std::uniform_int_distribution<int> dis(0, 255);
 
     for (size_t i = 0; i < dataSize; ++i) {
-        frame->data[i] = dis(gen);
+        pixels[i] = static_cast<uint8_t>(dis(gen));
     }
 
     return frame;
@@ -590,14 +3132,61 @@ PerformanceTestSuite::createTestImageBatch(size_t count, int width, int height)
     return batch;
 }
 
+LutData PerformanceTestSuite::createTestLut(int size) {
+    // 非线性且通道间相互耦合，避免插值方式之间的差异被掩盖
+    LutData lut;
+    lut.size = size;
+    lut.data.resize(size * size * size * 3);
+    for (int r = 0; r < size; ++r) {
+        for (int g = 0; g < size; ++g) {
+            for (int b = 0; b < size; ++b) {
+                const int index = (r * size * size + g * size + b) * 3;
+                const float fr = static_cast<float>(r) / (size - 1);
+                const float fg = static_cast<float>(g) / (size - 1);
+                const float fb = static_cast<float>(b) / (size - 1);
+                lut.data[index + 0] = std::sqrt(fr * fg);
+                lut.data[index + 1] = fg * fg * (1.0f - fb * 0.5f);
+                lut.data[index + 2] = 0.5f * (fr + fb);
+            }
+        }
+    }
+    lut.isLoaded = true;
+    return lut;
+}
+
+bool PerformanceTestSuite::loadTestLut() {
+    const std::string cacheDir = LutCache::getCacheDirectory();
+    const std::string cubePath = (cacheDir.empty() ? "/data/local/tmp" : cacheDir) +
+                                 "/perf_test_33.cube";
+    {
+        std::ofstream cube(cubePath);
+        if (!cube) {
+            LOGE("无法创建测试LUT文件: %s", cubePath.c_str());
+            return false;
+        }
+        cube << PerformanceTestUtils::generateCubeText(createTestLut(33));
+    }
+    return processor_->loadLut(cubePath);
+}
+
 void PerformanceTestSuite::setupTestEnvironment() {
-    // 初始化内存管理器
-    memoryManager_ = std::make_unique<MemoryManager>();
+#ifndef __ANDROID__
+    // 主机上没有/data/local/tmp，测试文件写到当前目录下
+    if (LutCache::getCacheDirectory().empty()) {
+        LutCache::setCacheDirectory("./perf_test_work");
+    }
+#endif
+
+    // 初始化内存管理器（全局单例）
+    memoryManager_ = &MemoryManager::getInstance();
     memoryManager_->setMemoryLimit(1024 * 1024 * 1024); // 1GB
 
     // 初始化处理器
     processor_ = std::make_unique<LutImageProcessor>();
-    processor_->initialize();
+    processor_->initialize(ProcessingConfig());
+    if (!loadTestLut()) {
+        LOGE("测试LUT加载失败，依赖LutImageProcessor的测试将失败");
+    }
 
     // 设置默认配置
     config_ = PerformanceTestUtils::createDefaultTestConfig();
@@ -611,9 +3200,11 @@ void PerformanceTestSuite::cleanupTestEnvironment() {
         processor_.reset();
     }
 
+    // LutImageProcessor会开启全局MemoryManager的自动优化线程，测试结束时停止
     if (memoryManager_) {
-        memoryManager_.reset();
+        memoryManager_->enableAutoOptimization(false);
     }
+    memoryManager_ = nullptr;
 
     LOGI("测试环境清理完成");
 }
@@ -798,13 +3389,30 @@ namespace PerformanceTestUtils {
         return data;
     }
 
+    std::string generateCubeText(const LutData &lutData) {
+        std::ostringstream cube;
+        cube << "TITLE \"Performance Test\"\n";
+        cube << "LUT_3D_SIZE " << lutData.size << "\n";
+        cube << std::fixed << std::setprecision(6);
+        for (size_t i = 0; i + 2 < lutData.data.size(); i += 3) {
+            cube << lutData.data[i] << ' ' << lutData.data[i + 1] << ' '
+                 << lutData.data[i + 2] << '\n';
+        }
+        return cube.str();
+    }
+
     std::unique_ptr<MediaFrame> createRandomTestImage(int width, int height) {
         auto frame = std::make_unique<MediaFrame>();
         frame->width = width;
         frame->height = height;
         frame->format = PixelFormat::RGBA8888;
-        frame->channels = 4;
-        frame->data = generateTestImageData(width, height, 4);
+        frame->stride = width * 4;
+
+        auto *pixels = new std::vector<uint8_t>(generateTestImageData(width, height, 4));
+        frame->data = pixels->data();
+        frame->dataSize = pixels->size();
+        frame->ownsData = true;
+        frame->deleter = [pixels]() { delete pixels; };
         return frame;
     }
 
@@ -844,4 +3452,66 @@ namespace PerformanceTestUtils {
             }
         }
     }
+
+    void
+    saveResultsToFile(const std::vector<PerformanceResult> &results, const std::string &filename) {
+        std::ofstream file(filename);
+        if (!file.is_open()) {
+            LOGE("无法创建结果文件: %s", filename.c_str());
+            return;
+        }
+
+        // 与CSV报告相同的列，可直接作为回归测试的基线
+        file << "测试名称,平均时间(ms),最小时间(ms),最大时间(ms),标准差,成功率(%),迭代次数,峰值内存(bytes),平均内存(bytes)\n";
+        for (const auto &result: results) {
+            if (result.isValid()) {
+                file << result.testName << ',' << std::fixed << std::setprecision(2)
+                     << result.averageTimeMs << ',' << result.minTimeMs << ','
+                     << result.maxTimeMs << ',' << result.standardDeviation << ','
+                     << std::setprecision(1) << result.successRate << ',' << result.iterations
+                     << ',' << result.peakMemoryUsage << ',' << result.averageMemoryUsage << '\n';
+            }
+        }
+    }
+
+    std::vector<PerformanceResult> loadResultsFromFile(const std::string &filename) {
+        std::vector<PerformanceResult> results;
+        std::ifstream file(filename);
+        if (!file.is_open()) {
+            LOGE("无法打开结果文件: %s", filename.c_str());
+            return results;
+        }
+
+        // 跳过表头，逐行解析CSV报告的各列
+        std::string line;
+        std::getline(file, line);
+        while (std::getline(file, line)) {
+            std::vector<std::string> fields;
+            std::istringstream row(line);
+            std::string field;
+            while (std::getline(row, field, ',')) {
+                fields.push_back(field);
+            }
+            if (fields.size() < 9) {
+                continue;
+            }
+
+            try {
+                PerformanceResult result;
+                result.testName = fields[0];
+                result.averageTimeMs = std::stod(fields[1]);
+                result.minTimeMs = std::stod(fields[2]);
+                result.maxTimeMs = std::stod(fields[3]);
+                result.standardDeviation = std::stod(fields[4]);
+                result.successRate = std::stod(fields[5]);
+                result.iterations = std::stoul(fields[6]);
+                result.peakMemoryUsage = std::stoull(fields[7]);
+                result.averageMemoryUsage = std::stoull(fields[8]);
+                results.push_back(result);
+            } catch (const std::exception &) {
+                LOGE("跳过无法解析的结果行: %s", line.c_str());
+            }
+        }
+        return results;
+    }
 }
\ No newline at end of file
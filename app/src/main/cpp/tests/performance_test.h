@@ -1,20 +1,23 @@
 #ifndef PERFORMANCE_TEST_H
 #define PERFORMANCE_TEST_H
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <vector>
 #include <string>
 #include <memory>
 #include <functional>
 #include <map>
+#include <numeric>
+#include "../utils/memory_manager.h"
 
 // 前向声明
-class MemoryManager;
-
 class LutImageProcessor;
 
 struct MediaFrame;
 struct ProcessingConfig;
+struct LutData;
 
 // 性能测试结果结构
 struct PerformanceResult {
@@ -47,6 +50,13 @@ struct PerformanceResult {
             successRate = static_cast<double>(successfulProcessing) / iterations * 100.0;
         }
     }
+
+    // 计时结束后的结果校验未通过时，整个测试记为失败
+    void markFailed() {
+        successfulProcessing = 0;
+        failedProcessing = iterations;
+        successRate = 0.0;
+    }
 };
 
 // 测试配置结构
@@ -102,6 +112,24 @@ public:
 
     PerformanceResult testAsyncProcessingPerformance();
 
+    // LUT插值性能测试
+    PerformanceResult testTetrahedralInterpolationPerformance();
+
+    PerformanceResult testBakedLutPerformance();
+
+    PerformanceResult testBakedLutDefaultParity();
+
+    PerformanceResult testSimdKernelPerformance();
+
+    // 仅在支持NEON的目标上编译与运行
+    PerformanceResult testNeonKernelParity();
+
+    PerformanceResult testDefaultPathPerformance();
+
+    PerformanceResult testLutParserPerformance();
+
+    PerformanceResult testLutCachePerformance();
+
     // 内存压力测试
     PerformanceResult testMemoryPressureHandling();
 
@@ -114,6 +142,46 @@ public:
 
     PerformanceResult testConcurrentMemoryAccess();
 
+    PerformanceResult testThreadPoolDispatchPerformance();
+
+    PerformanceResult testAdaptiveSchedulingPerformance();
+
+    PerformanceResult testWavefrontDitheringPerformance();
+
+    PerformanceResult testOrderedDitheringPerformance();
+
+    PerformanceResult testStreamingTileViewPerformance();
+
+    PerformanceResult testStreamingPipelinePerformance();
+
+    PerformanceResult testStripStreamingPerformance();
+
+    PerformanceResult testMemoryPoolThroughputPerformance();
+
+    PerformanceResult testMemoryPoolThreadCachePerformance();
+
+    PerformanceResult testJobArenaPerformance();
+
+    PerformanceResult testLargePageBufferPerformance();
+
+    PerformanceResult testMemoryAdmissionPerformance();
+
+    PerformanceResult testStrategyCostModelPerformance();
+
+    PerformanceResult testTileAutotunePerformance();
+
+#ifdef VULKAN_ENABLED
+    PerformanceResult testVulkanStagingRingPerformance();
+
+    PerformanceResult testVulkanBatchPerformance();
+
+    PerformanceResult testVulkanTiledPerformance();
+
+    PerformanceResult testVulkanStorageBufferPerformance();
+
+    PerformanceResult testVulkanPipelineCachePerformance();
+#endif
+
     // 异常处理性能测试
     PerformanceResult testExceptionHandlingOverhead();
 
@@ -144,7 +212,7 @@ public:
 
 private:
     TestConfig config_;
-    std::unique_ptr<MemoryManager> memoryManager_;
+    MemoryManager *memoryManager_ = nullptr; // 全局单例，不持有
     std::unique_ptr<LutImageProcessor> processor_;
 
     // 内部测试辅助方法
@@ -161,6 +229,13 @@ private:
     std::vector<std::unique_ptr<MediaFrame>>
     createTestImageBatch(size_t count, int width, int height);
 
+    LutData createTestLut(int size);
+
+    /**
+     * 把33^3的测试LUT写成.cube文件并加载到processor_（LutImageProcessor只能从文件加载LUT）
+     */
+    bool loadTestLut();
+
     void setupTestEnvironment();
 
     void cleanupTestEnvironment();
@@ -215,6 +290,53 @@ public:
         std::chrono::high_resolution_clock::time_point start_;
     };
 
+    // 两种实现的对比计时：逐次记录基准实现与新实现的耗时，汇总为平均耗时与加速比。
+    // 输出是否一致由各测试在迭代中自行检查并作为迭代结果返回
+    class Comparison {
+    public:
+        template<typename Func>
+        void timeBaseline(Func &&func) {
+            Timer timer;
+            func();
+            baselineTimings_.push_back(timer.elapsedMs());
+        }
+
+        template<typename Func>
+        void timeCandidate(Func &&func) {
+            Timer timer;
+            func();
+            candidateTimings_.push_back(timer.elapsedMs());
+        }
+
+        double baselineMs() const { return average(baselineTimings_); }
+
+        double candidateMs() const { return average(candidateTimings_); }
+
+        // 基准平均耗时 / 新实现平均耗时，没有数据时为0
+        double speedup() const {
+            const double candidate = candidateMs();
+            return candidate > 0.0 ? baselineMs() / candidate : 0.0;
+        }
+
+        // 写入两者的平均耗时与加速比
+        void addMetrics(PerformanceResult &result, const std::string &baselineKey,
+                        const std::string &candidateKey,
+                        const std::string &speedupKey = "speedup") const {
+            result.customMetrics[baselineKey] = baselineMs();
+            result.customMetrics[candidateKey] = candidateMs();
+            result.customMetrics[speedupKey] = speedup();
+        }
+
+    private:
+        static double average(const std::vector<double> &values) {
+            return values.empty() ? 0.0 : std::accumulate(values.begin(), values.end(), 0.0) /
+                                          values.size();
+        }
+
+        std::vector<double> baselineTimings_;
+        std::vector<double> candidateTimings_;
+    };
+
     // 内存使用监控器
     class MemoryMonitor {
     public:
@@ -234,8 +356,9 @@ public:
             return finalUsage_ > initialUsage_ ? finalUsage_ - initialUsage_ : 0;
         }
 
+        // MemoryManager不记录峰值，取当前已分配量与初始量中的较大者
         size_t getPeakUsage() const {
-            return manager_ ? manager_->getPeakMemoryUsage() : 0;
+            return manager_ ? std::max(initialUsage_, manager_->getTotalAllocatedBytes()) : 0;
         }
 
     private:
@@ -339,6 +462,8 @@ namespace PerformanceTestUtils {
 
     std::unique_ptr<MediaFrame> createRandomTestImage(int width, int height);
 
+    std::string generateCubeText(const LutData &lutData);
+
     // 结果比较
     bool
     compareResults(const PerformanceResult &a, const PerformanceResult &b, double tolerance = 5.0);
@@ -1,4 +1,8 @@
 #include "performance_test.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -26,8 +30,13 @@ public:
 
     ~TestRunner() = default;
 
+    // 以快速配置（较少的迭代与预热次数）运行后续测试，供ctest等需要在有限时间内结束的场景使用
+    void useQuickConfig() {
+        testSuite_->setTestConfig(PerformanceTestUtils::createQuickTestConfig());
+    }
+
     // 运行所有测试
-    void runAllTests() {
+    bool runAllTests() {
         LOGI("=== 开始运行完整性能测试套件 ===");
 
         auto startTime = std::chrono::high_resolution_clock::now();
@@ -37,7 +46,7 @@ public:
         auto endTime = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
 
-        LOGI("\n=== 测试完成，总耗时: %lld ms ===", duration.count());
+        LOGI("\n=== 测试完成，总耗时: %lld ms ===", static_cast<long long>(duration.count()));
 
         // 打印结果摘要
         testSuite_->printSummary(results);
@@ -47,10 +56,12 @@ public:
 
         // 分析结果
         analyzeResults(results);
+
+        return checkResults(results);
     }
 
     // 运行快速测试
-    void runQuickTests() {
+    bool runQuickTests() {
         LOGI("=== 开始运行快速性能测试 ===");
 
         // 设置快速测试配置
@@ -69,17 +80,19 @@ public:
         auto endTime = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
 
-        LOGI("\n=== 快速测试完成，总耗时: %lld ms ===", duration.count());
+        LOGI("\n=== 快速测试完成，总耗时: %lld ms ===", static_cast<long long>(duration.count()));
 
         // 打印结果
         PerformanceTestUtils::printResultTable(results);
 
         // 生成报告
         generateReports(results, "performance_test_quick");
+
+        return checkResults(results);
     }
 
     // 运行内存测试
-    void runMemoryTests() {
+    bool runMemoryTests() {
         LOGI("=== 开始运行内存性能测试 ===");
 
         auto startTime = std::chrono::high_resolution_clock::now();
@@ -89,7 +102,7 @@ public:
         auto endTime = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
 
-        LOGI("\n=== 内存测试完成，总耗时: %lld ms ===", duration.count());
+        LOGI("\n=== 内存测试完成，总耗时: %lld ms ===", static_cast<long long>(duration.count()));
 
         // 打印结果
         testSuite_->printSummary(results);
@@ -99,10 +112,12 @@ public:
 
         // 内存测试特定分析
         analyzeMemoryResults(results);
+
+        return checkResults(results);
     }
 
     // 运行处理测试
-    void runProcessingTests() {
+    bool runProcessingTests() {
         LOGI("=== 开始运行处理性能测试 ===");
 
         auto startTime = std::chrono::high_resolution_clock::now();
@@ -112,7 +127,7 @@ public:
         auto endTime = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
 
-        LOGI("\n=== 处理测试完成，总耗时: %lld ms ===", duration.count());
+        LOGI("\n=== 处理测试完成，总耗时: %lld ms ===", static_cast<long long>(duration.count()));
 
         // 打印结果
         testSuite_->printSummary(results);
@@ -122,10 +137,12 @@ public:
 
         // 处理测试特定分析
         analyzeProcessingResults(results);
+
+        return checkResults(results);
     }
 
     // 运行压力测试
-    void runStressTests() {
+    bool runStressTests() {
         LOGI("=== 开始运行压力测试 ===");
 
         // 设置压力测试配置
@@ -144,7 +161,7 @@ public:
         auto endTime = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
 
-        LOGI("\n=== 压力测试完成，总耗时: %lld ms ===", duration.count());
+        LOGI("\n=== 压力测试完成，总耗时: %lld ms ===", static_cast<long long>(duration.count()));
 
         // 打印结果
         testSuite_->printSummary(results);
@@ -154,17 +171,19 @@ public:
 
         // 压力测试特定分析
         analyzeStressResults(results);
+
+        return checkResults(results);
     }
 
     // 运行回归测试
-    void runRegressionTests(const std::string &baselineFile) {
+    bool runRegressionTests(const std::string &baselineFile) {
         LOGI("=== 开始运行回归测试 ===");
 
         // 加载基线结果
         auto baselineResults = PerformanceTestUtils::loadResultsFromFile(baselineFile);
         if (baselineResults.empty()) {
             LOGE("无法加载基线测试结果: %s", baselineFile.c_str());
-            return;
+            return false;
         }
 
         // 运行当前测试
@@ -181,11 +200,27 @@ public:
 
         // 生成回归测试报告
         generateRegressionReport(currentResults, baselineResults, "performance_regression_test");
+
+        return checkResults(currentResults) && passed;
     }
 
 private:
     std::unique_ptr<PerformanceTestSuite> testSuite_;
 
+    // 检查是否所有测试都成功：无效结果、任一次迭代失败都算失败
+    bool checkResults(const std::vector<PerformanceResult> &results) {
+        bool passed = true;
+        for (const auto &result: results) {
+            if (!result.isValid() || result.failedProcessing > 0 || result.successRate < 100.0) {
+                LOGE("测试失败: %s (失败 %zu 次, 成功率 %.1f%%)",
+                     result.testName.empty() ? "<无效结果>" : result.testName.c_str(),
+                     result.failedProcessing, result.successRate);
+                passed = false;
+            }
+        }
+        return passed;
+    }
+
     // 生成报告
     void
     generateReports(const std::vector<PerformanceResult> &results, const std::string &baseName) {
@@ -456,32 +491,37 @@ private:
 #ifndef __ANDROID__
 int main(int argc, char* argv[]) {
     TestRunner runner;
+    bool passed = false;
     
     if (argc > 1) {
         std::string testType = argv[1];
+        if (argc > 2 && std::string(argv[argc - 1]) == "--quick") {
+            runner.useQuickConfig();
+        }
         
         if (testType == "all") {
-            runner.runAllTests();
+            passed = runner.runAllTests();
         } else if (testType == "quick") {
-            runner.runQuickTests();
+            passed = runner.runQuickTests();
         } else if (testType == "memory") {
-            runner.runMemoryTests();
+            passed = runner.runMemoryTests();
         } else if (testType == "processing") {
-            runner.runProcessingTests();
+            passed = runner.runProcessingTests();
         } else if (testType == "stress") {
-            runner.runStressTests();
+            passed = runner.runStressTests();
         } else if (testType == "regression" && argc > 2) {
-            runner.runRegressionTests(argv[2]);
+            passed = runner.runRegressionTests(argv[2]);
         } else {
-            std::cout << "用法: " << argv[0] << " [all|quick|memory|processing|stress|regression <baseline_file>]" << std::endl;
+            std::cout << "用法: " << argv[0] << " [all|quick|memory|processing|stress|regression <baseline_file>] [--quick]" << std::endl;
             return 1;
         }
     } else {
         // 默认运行快速测试
-        runner.runQuickTests();
+        passed = runner.runQuickTests();
     }
     
-    return 0;
+    // 任一测试失败时返回非零，供ctest判定
+    return passed ? 0 : 1;
 }
 #endif
 
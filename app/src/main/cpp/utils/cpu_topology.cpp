@@ -0,0 +1,215 @@
+#include "cpu_topology.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <thread>
+#include <dirent.h>
+#include <sched.h>
+
+int CpuTopologyInfo::clusterOf(int cpu) const {
+    for (size_t i = 0; i < clusters.size(); ++i) {
+        const auto &cpus = clusters[i].cpus;
+        if (std::find(cpus.begin(), cpus.end(), cpu) != cpus.end()) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+bool CpuTopology::detect(const std::string &cpuRoot, CpuTopologyInfo &topology) {
+    topology = CpuTopologyInfo();
+
+    // 只统计在线核心：离线核心的目录仍然存在，但线程不会被调度到上面
+    std::vector<int> cpus;
+    if (!readCpuList(cpuRoot + "/online", cpus) && !listCpuDirectories(cpuRoot, cpus)) {
+        TOPO_LOGW("无法打开拓扑目录: %s", cpuRoot.c_str());
+        return false;
+    }
+
+    // 按最高频率分组，std::greater使大核簇排在前面
+    std::map<long, std::vector<int>, std::greater<long>> clustersByFreq;
+    for (int cpu: cpus) {
+        // 读不到频率（如cpufreq未暴露）的核心归入频率为0的同一簇
+        long maxFreq = 0;
+        readLong(cpuRoot + "/cpu" + std::to_string(cpu) + "/cpufreq/cpuinfo_max_freq", maxFreq);
+        clustersByFreq[maxFreq].push_back(cpu);
+    }
+
+    for (auto &entry: clustersByFreq) {
+        CpuCluster cluster;
+        cluster.maxFreqKHz = entry.first;
+        cluster.cpus = std::move(entry.second);
+        std::sort(cluster.cpus.begin(), cluster.cpus.end());
+        topology.cpuCount += static_cast<int>(cluster.cpus.size());
+        topology.clusters.push_back(std::move(cluster));
+    }
+
+    if (!topology.clusters.empty()) {
+        detectCaches(cpuRoot + "/cpu" + std::to_string(topology.clusters[0].cpus[0]), topology);
+    }
+
+    return topology.cpuCount > 0;
+}
+
+void CpuTopology::detectCaches(const std::string &cpuDir, CpuTopologyInfo &topology) {
+    for (int index = 0; index < 8; ++index) {
+        const std::string cacheDir = cpuDir + "/cache/index" + std::to_string(index);
+        long level = 0;
+        if (!readLong(cacheDir + "/level", level)) {
+            break;
+        }
+
+        char type[32] = {};
+        char size[32] = {};
+        if (!readWord(cacheDir + "/type", type, sizeof(type)) ||
+            !readWord(cacheDir + "/size", size, sizeof(size))) {
+            continue;
+        }
+        if (std::strcmp(type, "Instruction") == 0) {
+            continue;
+        }
+
+        // 大小形如"512K"或"2M"
+        char *unit = nullptr;
+        size_t bytes = std::strtoul(size, &unit, 10);
+        if (*unit == 'K' || *unit == 'k') {
+            bytes *= 1024;
+        } else if (*unit == 'M' || *unit == 'm') {
+            bytes *= 1024 * 1024;
+        }
+
+        if (level == 1) {
+            topology.l1dCacheBytes = bytes;
+        } else if (level == 2) {
+            topology.l2CacheBytes = bytes;
+        } else if (level == 3) {
+            topology.l3CacheBytes = bytes;
+        }
+    }
+}
+
+const CpuTopologyInfo &CpuTopology::getSystemTopology() {
+    static const CpuTopologyInfo topology = []() {
+        CpuTopologyInfo info;
+        if (!detect(SYSFS_CPU_ROOT, info)) {
+            const int cpuCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+            info = CpuTopologyInfo();
+            info.cpuCount = cpuCount;
+            info.clusters.emplace_back();
+            for (int cpu = 0; cpu < cpuCount; ++cpu) {
+                info.clusters.back().cpus.push_back(cpu);
+            }
+        }
+
+        for (const auto &cluster: info.clusters) {
+            TOPO_LOGI("CPU簇: %zu个核心, 最高频率 %ld kHz", cluster.cpus.size(),
+                      cluster.maxFreqKHz);
+        }
+        TOPO_LOGI("数据缓存: L1 %zu KB, L2 %zu KB, L3 %zu KB", info.l1dCacheBytes / 1024,
+                  info.l2CacheBytes / 1024, info.l3CacheBytes / 1024);
+        return info;
+    }();
+    return topology;
+}
+
+bool CpuTopology::pinCurrentThread(const std::vector<int> &cpus) {
+    if (cpus.empty()) {
+        return false;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu: cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &set);
+        }
+    }
+
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+        TOPO_LOGW("设置线程亲和性失败: %s", std::strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+bool CpuTopology::readCpuList(const std::string &path, std::vector<int> &cpus) {
+    FILE *file = fopen(path.c_str(), "r");
+    if (!file) {
+        return false;
+    }
+
+    // 格式形如"0-3,5,7-8"
+    cpus.clear();
+    long first = 0;
+    bool valid = true;
+    while (valid && fscanf(file, "%ld", &first) == 1) {
+        long last = first;
+        int separator = fgetc(file);
+        if (separator == '-') {
+            valid = fscanf(file, "%ld", &last) == 1;
+            separator = fgetc(file);
+        }
+        valid = valid && first >= 0 && last >= first && last < CPU_SETSIZE;
+        for (long cpu = first; valid && cpu <= last; ++cpu) {
+            cpus.push_back(static_cast<int>(cpu));
+        }
+        if (separator != ',') {
+            break;
+        }
+    }
+    fclose(file);
+
+    if (!valid || cpus.empty()) {
+        cpus.clear();
+        return false;
+    }
+    return true;
+}
+
+bool CpuTopology::listCpuDirectories(const std::string &cpuRoot, std::vector<int> &cpus) {
+    DIR *dir = opendir(cpuRoot.c_str());
+    if (!dir) {
+        return false;
+    }
+
+    cpus.clear();
+    while (dirent *entry = readdir(dir)) {
+        const char *name = entry->d_name;
+        if (std::strncmp(name, "cpu", 3) != 0 || name[3] < '0' || name[3] > '9') {
+            continue;
+        }
+        char *numberEnd = nullptr;
+        const long cpu = std::strtol(name + 3, &numberEnd, 10);
+        if (*numberEnd != '\0') {
+            continue; // cpufreq、cpuidle等非核心目录
+        }
+        cpus.push_back(static_cast<int>(cpu));
+    }
+    closedir(dir);
+    return !cpus.empty();
+}
+
+bool CpuTopology::readWord(const std::string &path, char *buffer, size_t bufferSize) {
+    FILE *file = fopen(path.c_str(), "r");
+    if (!file) {
+        return false;
+    }
+    char format[16];
+    snprintf(format, sizeof(format), "%%%zus", bufferSize - 1);
+    const bool success = fscanf(file, format, buffer) == 1;
+    fclose(file);
+    return success;
+}
+
+bool CpuTopology::readLong(const std::string &path, long &value) {
+    FILE *file = fopen(path.c_str(), "r");
+    if (!file) {
+        return false;
+    }
+    const bool success = fscanf(file, "%ld", &value) == 1;
+    fclose(file);
+    return success;
+}
@@ -0,0 +1,111 @@
+#ifndef CPU_TOPOLOGY_H
+#define CPU_TOPOLOGY_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <android/log.h>
+
+#define CPU_TOPOLOGY_TAG "CpuTopology"
+#define TOPO_LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, CPU_TOPOLOGY_TAG, __VA_ARGS__)
+#define TOPO_LOGI(...) __android_log_print(ANDROID_LOG_INFO, CPU_TOPOLOGY_TAG, __VA_ARGS__)
+#define TOPO_LOGW(...) __android_log_print(ANDROID_LOG_WARN, CPU_TOPOLOGY_TAG, __VA_ARGS__)
+
+/**
+ * CPU簇：最高频率相同的一组核心
+ */
+struct CpuCluster {
+    long maxFreqKHz = 0;
+    std::vector<int> cpus;
+};
+
+/**
+ * CPU拓扑信息，簇按最高频率从高到低排列（大核簇在前）
+ */
+struct CpuTopologyInfo {
+    std::vector<CpuCluster> clusters;
+    int cpuCount = 0;
+
+    // 大核簇第一个核心的数据缓存大小，sysfs未暴露cache目录时为0
+    size_t l1dCacheBytes = 0;
+    size_t l2CacheBytes = 0;
+    size_t l3CacheBytes = 0;
+
+    /**
+     * 是否为异构（big.LITTLE）拓扑
+     */
+    bool isHeterogeneous() const {
+        return clusters.size() > 1;
+    }
+
+    /**
+     * 查找核心所在的簇
+     * @param cpu 核心编号
+     * @return 簇索引，未找到时返回-1
+     */
+    int clusterOf(int cpu) const;
+};
+
+/**
+ * CPU拓扑检测与线程绑核工具
+ * 按sysfs的online列表枚举在线核心，通过每个核心的cpufreq/cpuinfo_max_freq按最高频率划分簇，
+ * 并从大核的cache/indexN读取各级数据缓存大小
+ */
+class CpuTopology {
+public:
+    static constexpr const char *SYSFS_CPU_ROOT = "/sys/devices/system/cpu";
+
+    /**
+     * 从指定目录检测拓扑，目录结构与/sys/devices/system/cpu相同，
+     * 因此可以传入模拟的拓扑目录进行测试
+     * @param cpuRoot 拓扑根目录，包含online文件与cpu0、cpu1...子目录（没有online文件时统计全部核心目录）
+     * @param topology 输出的拓扑信息
+     * @return 是否检测到至少一个核心
+     */
+    static bool detect(const std::string &cpuRoot, CpuTopologyInfo &topology);
+
+    /**
+     * 获取本机拓扑（首次调用时检测并缓存）
+     * 无法读取cpufreq时退化为单簇拓扑
+     */
+    static const CpuTopologyInfo &getSystemTopology();
+
+    /**
+     * 将当前线程绑定到指定核心集合
+     * @param cpus 核心编号列表，为空时不做任何操作
+     * @return 是否成功
+     */
+    static bool pinCurrentThread(const std::vector<int> &cpus);
+
+private:
+    /**
+     * 读取文件中的第一个整数
+     */
+    static bool readLong(const std::string &path, long &value);
+
+    /**
+     * 读取文件中的第一个单词
+     * @param bufferSize 缓冲区大小（含结尾的0）
+     */
+    static bool readWord(const std::string &path, char *buffer, size_t bufferSize);
+
+    /**
+     * 解析核心列表文件（如online），格式为"0-3,5,7-8"
+     * @return 是否读到至少一个核心
+     */
+    static bool readCpuList(const std::string &path, std::vector<int> &cpus);
+
+    /**
+     * 列出拓扑目录下的全部cpuN子目录
+     * @return 是否找到至少一个核心
+     */
+    static bool listCpuDirectories(const std::string &cpuRoot, std::vector<int> &cpus);
+
+    /**
+     * 读取核心各级数据缓存（Data或Unified）的大小
+     * @param cpuDir 核心目录，如/sys/devices/system/cpu/cpu7
+     */
+    static void detectCaches(const std::string &cpuDir, CpuTopologyInfo &topology);
+};
+
+#endif // CPU_TOPOLOGY_H
@@ -0,0 +1,92 @@
+#ifndef DITHER_MATRIX_H
+#define DITHER_MATRIX_H
+
+#include <cstdint>
+
+/**
+ * 有序抖动阈值图
+ * 64x64的蓝噪声与8x8的Bayer矩阵（平铺到64x64），每项为0-255的阈值。
+ * 量化时以 (阈值 + 0.5) / 256 代替四舍五入的0.5，按像素坐标查表，
+ * 无状态、线程安全，CPU与GPU（lut_processor.comp）使用同一份数据
+ */
+class DitherMatrix {
+public:
+    static constexpr int SIZE = 64;
+    static constexpr int MASK = SIZE - 1;
+    // 每行存储两遍，从任意相位开始都能连续读取至少SIZE个阈值
+    static constexpr int ROW_STRIDE = SIZE * 2;
+
+    static constexpr int DITHER_BAYER = 3;
+    static constexpr int DITHER_BLUE_NOISE = 4;
+
+    /**
+     * 是否为量化时直接应用的有序抖动
+     * @param ditherType 抖动类型
+     */
+    static bool isOrdered(int ditherType) {
+        return ditherType == DITHER_BAYER || ditherType == DITHER_BLUE_NOISE;
+    }
+
+    /**
+     * 获取第y行的阈值（ROW_STRIDE字节）
+     * @param ditherType 抖动类型
+     * @param y 像素行坐标（自动按SIZE平铺）
+     * @return 阈值行，非有序抖动时返回nullptr
+     */
+    static const uint8_t *getRow(int ditherType, int y);
+
+    /**
+     * 获取SIZE*SIZE的阈值表（行优先，不重复），用于上传到GPU
+     * @param ditherType 抖动类型
+     * @return 阈值表，非有序抖动时返回nullptr
+     */
+    static const uint8_t *getMatrix(int ditherType);
+};
+
+/**
+ * 一行像素的有序抖动阈值：第i个像素使用 thresholds[(phase + i) & MASK]
+ */
+struct OrderedDitherRow {
+    const uint8_t *thresholds = nullptr; // nullptr表示不抖动，按0.5四舍五入
+    int phase = 0;                       // 第一个像素的列坐标
+
+    OrderedDitherRow() = default;
+
+    /**
+     * @param ditherType 抖动类型
+     * @param x 第一个像素在整图中的列坐标
+     * @param y 像素行在整图中的坐标
+     */
+    OrderedDitherRow(int ditherType, int x, int y)
+            : thresholds(DitherMatrix::getRow(ditherType, y)), phase(x & DitherMatrix::MASK) {}
+
+    bool enabled() const {
+        return thresholds != nullptr;
+    }
+
+    /**
+     * 从第i个像素开始的连续阈值，至少可读取SIZE个
+     */
+    const uint8_t *at(int i) const {
+        return thresholds + ((phase + i) & DitherMatrix::MASK);
+    }
+
+    /**
+     * 跳过前count个像素后的阈值行
+     */
+    OrderedDitherRow advanced(int count) const {
+        OrderedDitherRow row;
+        row.thresholds = thresholds;
+        row.phase = (phase + count) & DitherMatrix::MASK;
+        return row;
+    }
+
+    /**
+     * 第i个像素的量化偏移（value * 255 + offset 后截断）
+     */
+    float offset(int i) const {
+        return thresholds ? (*at(i) + 0.5f) * (1.0f / 256.0f) : 0.5f;
+    }
+};
+
+#endif // DITHER_MATRIX_H
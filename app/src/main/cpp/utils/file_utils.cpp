@@ -0,0 +1,53 @@
+#include "file_utils.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+bool FileUtils::writeAtomically(const std::string &path, std::initializer_list<Chunk> chunks) {
+    std::string tempPath = path + ".XXXXXX";
+    int fd = mkstemp(&tempPath[0]);
+    if (fd < 0) {
+        return false;
+    }
+    FILE *file = fdopen(fd, "wb");
+    if (!file) {
+        close(fd);
+        unlink(tempPath.c_str());
+        return false;
+    }
+
+    bool success = true;
+    for (const Chunk &chunk: chunks) {
+        if (chunk.size > 0 && fwrite(chunk.data, 1, chunk.size, file) != chunk.size) {
+            success = false;
+            break;
+        }
+    }
+    success = (fclose(file) == 0) && success;
+
+    if (!success || rename(tempPath.c_str(), path.c_str()) != 0) {
+        unlink(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+uint64_t FileUtils::fnv1a64(const void *data, size_t size) {
+    const auto *bytes = static_cast<const uint8_t *>(data);
+    uint64_t hash = 1469598103934665603ULL;
+    const uint64_t prime = 1099511628211ULL;
+
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, bytes + i, sizeof(word));
+        hash ^= word;
+        hash *= prime;
+    }
+    for (; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= prime;
+    }
+    return hash;
+}
@@ -0,0 +1,41 @@
+#ifndef FILE_UTILS_H
+#define FILE_UTILS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+
+/**
+ * 持久化文件的公共工具
+ * LUT缓存、策略画像、调优画像和Vulkan管线缓存都用它原子地写文件并计算校验和
+ */
+class FileUtils {
+public:
+    /**
+     * 待写入的一段连续数据
+     */
+    struct Chunk {
+        const void *data;
+        size_t size;
+    };
+
+    /**
+     * 把各段数据依次写入同目录下唯一命名的临时文件（mkstemp），成功后原子重命名为目标文件。
+     * 多个线程或进程同时写同一目标时各自使用自己的临时文件，读者只会看到完整的旧文件或新文件
+     * @param path 目标文件路径
+     * @param chunks 按顺序写入的数据段
+     * @return 是否写入成功；失败时临时文件已删除，目标文件保持原样
+     */
+    static bool writeAtomically(const std::string &path, std::initializer_list<Chunk> chunks);
+
+    /**
+     * 64位FNV-1a哈希，按8字节为单位处理，剩余字节逐个处理
+     * @param data 数据
+     * @param size 字节数
+     * @return 哈希值
+     */
+    static uint64_t fnv1a64(const void *data, size_t size);
+};
+
+#endif // FILE_UTILS_H
@@ -0,0 +1,111 @@
+#include "job_arena.h"
+#include "memory_pool.h"
+#include <algorithm>
+
+JobArena::JobArena(size_t chunkSize)
+        : chunkSize_(std::max<size_t>(chunkSize, 4096)) {
+}
+
+JobArena::~JobArena() {
+    reset();
+}
+
+void *JobArena::carve(Chunk &chunk, size_t size, size_t alignment) {
+    const uintptr_t base = reinterpret_cast<uintptr_t>(chunk.data);
+    const uintptr_t aligned = (base + chunk.used + alignment - 1) & ~(uintptr_t(alignment) - 1);
+    const size_t end = static_cast<size_t>(aligned - base) + size;
+    if (end > chunk.size) {
+        return nullptr;
+    }
+    chunk.used = end;
+    return reinterpret_cast<void *>(aligned);
+}
+
+JobArena::Chunk *JobArena::addChunk(size_t size, size_t alignment) {
+    void *data = MemoryPool::getInstance().allocate(size, std::max<size_t>(alignment, 64));
+    if (!data) {
+        ARENA_LOGE("申请区块失败: %zu 字节", size);
+        return nullptr;
+    }
+
+    chunks_.push_back({static_cast<uint8_t *>(data), size, 0});
+    bytesReserved_ += size;
+    peakBytesReserved_ = std::max(peakBytesReserved_, bytesReserved_);
+    return &chunks_.back();
+}
+
+void *JobArena::allocate(size_t size, size_t alignment) {
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+        return nullptr;
+    }
+    size = std::max<size_t>(size, 1);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const size_t usedBefore = bytesUsed_;
+
+    if (bumpChunk_ >= 0) {
+        Chunk &chunk = chunks_[bumpChunk_];
+        const size_t chunkUsed = chunk.used;
+        if (void *ptr = carve(chunk, size, alignment)) {
+            bytesUsed_ = usedBefore + (chunk.used - chunkUsed);
+            return ptr;
+        }
+    }
+
+    // 大请求独占一个区块，不浪费当前区块的剩余空间
+    if (size > chunkSize_ / 2) {
+        Chunk *chunk = addChunk(size, alignment);
+        if (!chunk) {
+            return nullptr;
+        }
+        chunk->used = size;
+        bytesUsed_ += size;
+        return chunk->data;
+    }
+
+    Chunk *chunk = addChunk(chunkSize_, alignment);
+    if (!chunk) {
+        return nullptr;
+    }
+    bumpChunk_ = static_cast<int>(chunks_.size()) - 1;
+    void *ptr = carve(*chunk, size, alignment);
+    bytesUsed_ += chunk->used;
+    return ptr;
+}
+
+void JobArena::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!chunks_.empty()) {
+        ARENA_LOGD("释放任务内存: %zu 个区块, %.2f MB", chunks_.size(),
+                   bytesReserved_ / (1024.0 * 1024.0));
+    }
+
+    MemoryPool &pool = MemoryPool::getInstance();
+    for (const Chunk &chunk: chunks_) {
+        pool.deallocate(chunk.data);
+    }
+    chunks_.clear();
+    bumpChunk_ = -1;
+    bytesUsed_ = 0;
+    bytesReserved_ = 0;
+}
+
+size_t JobArena::getBytesUsed() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return bytesUsed_;
+}
+
+size_t JobArena::getBytesReserved() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return bytesReserved_;
+}
+
+size_t JobArena::getPeakBytesReserved() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return peakBytesReserved_;
+}
+
+size_t JobArena::getChunkCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return chunks_.size();
+}
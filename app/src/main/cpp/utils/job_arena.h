@@ -0,0 +1,125 @@
+#ifndef JOB_ARENA_H
+#define JOB_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <vector>
+#include <android/log.h>
+
+#define ARENA_TAG "JobArena"
+#define ARENA_LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, ARENA_TAG, __VA_ARGS__)
+#define ARENA_LOGE(...) __android_log_print(ANDROID_LOG_ERROR, ARENA_TAG, __VA_ARGS__)
+
+/**
+ * 单个处理任务的线性分配器
+ * 一次处理任务（一张图片）内的所有临时缓冲区都从这里按指针递增切出，不能单独释放，
+ * 任务结束时整体归还内存池。区块大小固定，超过半个区块的请求单独占用一个区块，
+ * 因此每个任务的峰值内存可预测，长时间批处理也不会在内存池中留下碎片。
+ * 分配是线程安全的，同一任务的多个块可以并行从中分配
+ */
+class JobArena {
+public:
+    static constexpr size_t DEFAULT_CHUNK_SIZE = 256 * 1024; // 256KB，落在内存池线程缓存的级别内
+
+    /**
+     * @param chunkSize 区块大小，小请求从同一区块连续切出
+     */
+    explicit JobArena(size_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+    ~JobArena();
+
+    JobArena(const JobArena &) = delete;
+
+    JobArena &operator=(const JobArena &) = delete;
+
+    /**
+     * 分配一段内存，生命周期到reset()或任务结束为止
+     * @param size 字节数
+     * @param alignment 对齐字节数，必须是2的幂
+     * @return 内存地址，失败时返回nullptr
+     */
+    void *allocate(size_t size, size_t alignment = 64);
+
+    template<typename T>
+    T *allocateArray(size_t count) {
+        return static_cast<T *>(allocate(count * sizeof(T), alignof(T) > 64 ? alignof(T) : 64));
+    }
+
+    /**
+     * 一次性把所有区块归还内存池，之前分配的指针全部失效
+     */
+    void reset();
+
+    // 统计信息
+    size_t getBytesUsed() const;      // 已切出的字节数（含对齐填充）
+    size_t getBytesReserved() const;  // 当前持有的区块总大小
+    size_t getPeakBytesReserved() const;
+    size_t getChunkCount() const;
+
+private:
+    struct Chunk {
+        uint8_t *data;
+        size_t size;
+        size_t used;
+    };
+
+    /**
+     * 在区块剩余空间中对齐切出一段，空间不足时返回nullptr
+     */
+    static void *carve(Chunk &chunk, size_t size, size_t alignment);
+
+    /**
+     * 从内存池申请新区块并加入列表
+     */
+    Chunk *addChunk(size_t size, size_t alignment);
+
+    const size_t chunkSize_;
+
+    mutable std::mutex mutex_;
+    std::vector<Chunk> chunks_;
+    int bumpChunk_ = -1; // 当前用于连续切分的区块，独占区块不参与切分
+    size_t bytesUsed_ = 0;
+    size_t bytesReserved_ = 0;
+    size_t peakBytesReserved_ = 0;
+};
+
+/**
+ * 从JobArena分配的STL分配器，适用于任务内的临时容器
+ * deallocate不做任何事，内存在任务结束时随JobArena一起释放，
+ * 因此容器应预先reserve，避免扩容留下废弃的旧缓冲区
+ */
+template<typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(JobArena &arena) : arena_(&arena) {}
+
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U> &other) : arena_(other.arena()) {}
+
+    T *allocate(size_t n) {
+        T *ptr = arena_->allocateArray<T>(n);
+        if (!ptr) {
+            throw std::bad_alloc();
+        }
+        return ptr;
+    }
+
+    void deallocate(T *, size_t) {}
+
+    JobArena *arena() const { return arena_; }
+
+    template<typename U>
+    bool operator==(const ArenaAllocator<U> &other) const { return arena_ == other.arena(); }
+
+    template<typename U>
+    bool operator!=(const ArenaAllocator<U> &other) const { return arena_ != other.arena(); }
+
+private:
+    JobArena *arena_;
+};
+
+#endif // JOB_ARENA_H
@@ -0,0 +1,194 @@
+#include "large_page_allocator.h"
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+std::atomic<bool> g_largePagesEnabled{true};
+
+size_t roundUp(size_t value, size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+size_t systemPageSize() {
+#ifndef _WIN32
+    static const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return pageSize;
+#else
+    return 4096;
+#endif
+}
+
+} // namespace
+
+std::mutex &LargePageAllocator::registryMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::unordered_map<void *, size_t> &LargePageAllocator::registry() {
+    static std::unordered_map<void *, size_t> mappings;
+    return mappings;
+}
+
+LargePageStats &LargePageAllocator::stats() {
+    static LargePageStats stats;
+    return stats;
+}
+
+bool LargePageAllocator::shouldUse(size_t size) {
+#ifdef _WIN32
+    (void) size;
+    return false;
+#else
+    return size >= LARGE_BUFFER_THRESHOLD && g_largePagesEnabled.load(std::memory_order_relaxed);
+#endif
+}
+
+void *LargePageAllocator::allocate(size_t size) {
+#ifdef _WIN32
+    (void) size;
+    return nullptr;
+#else
+    if (size == 0) {
+        return nullptr;
+    }
+
+    // 多映射一个大页再裁掉头尾，得到2MB对齐的起点
+    const size_t mappedSize = roundUp(size, HUGE_PAGE_SIZE);
+    const size_t reserveSize = mappedSize + HUGE_PAGE_SIZE;
+    void *reserved = mmap(nullptr, reserveSize, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (reserved == MAP_FAILED) {
+        LPA_LOGW("映射大缓冲区失败: %zu bytes, %s", size, std::strerror(errno));
+        return nullptr;
+    }
+
+    const uintptr_t reservedStart = reinterpret_cast<uintptr_t>(reserved);
+    const uintptr_t alignedStart = roundUp(reservedStart, HUGE_PAGE_SIZE);
+    const size_t headSize = alignedStart - reservedStart;
+    const size_t tailSize = reserveSize - headSize - mappedSize;
+    if (headSize > 0) {
+        munmap(reserved, headSize);
+    }
+    if (tailSize > 0) {
+        munmap(reinterpret_cast<void *>(alignedStart + mappedSize), tailSize);
+    }
+
+    void *ptr = reinterpret_cast<void *>(alignedStart);
+    bool hugePages = false;
+#ifdef MADV_HUGEPAGE
+    // 内核未开启透明大页时返回EINVAL，映射仍可正常使用
+    hugePages = madvise(ptr, mappedSize, MADV_HUGEPAGE) == 0;
+#endif
+
+    {
+        std::lock_guard<std::mutex> lock(registryMutex());
+        registry().emplace(ptr, mappedSize);
+        LargePageStats &current = stats();
+        current.mappedBytes += mappedSize;
+        current.mappingCount++;
+        if (hugePages) {
+            current.hugePageMappings++;
+        }
+    }
+
+    LPA_LOGD("映射大缓冲区: %.2f MB, 透明大页: %s", mappedSize / (1024.0 * 1024.0),
+             hugePages ? "是" : "否");
+    return ptr;
+#endif
+}
+
+bool LargePageAllocator::deallocate(void *ptr) {
+#ifdef _WIN32
+    (void) ptr;
+    return false;
+#else
+    if (!ptr) {
+        return false;
+    }
+
+    size_t mappedSize = 0;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex());
+        auto it = registry().find(ptr);
+        if (it == registry().end()) {
+            return false;
+        }
+        mappedSize = it->second;
+        registry().erase(it);
+        LargePageStats &current = stats();
+        current.mappedBytes -= mappedSize;
+        current.mappingCount--;
+    }
+
+    munmap(ptr, mappedSize);
+    return true;
+#endif
+}
+
+bool LargePageAllocator::owns(void *ptr) {
+    std::lock_guard<std::mutex> lock(registryMutex());
+    return registry().count(ptr) > 0;
+}
+
+void LargePageAllocator::adviseSequential(const void *ptr, size_t size, bool sequential) {
+#if !defined(_WIN32) && defined(MADV_SEQUENTIAL)
+    const size_t pageSize = systemPageSize();
+    const uintptr_t start = roundUp(reinterpret_cast<uintptr_t>(ptr), pageSize);
+    const uintptr_t end = (reinterpret_cast<uintptr_t>(ptr) + size) / pageSize * pageSize;
+    if (end > start) {
+        madvise(reinterpret_cast<void *>(start), end - start,
+                sequential ? MADV_SEQUENTIAL : MADV_NORMAL);
+    }
+#else
+    (void) ptr;
+    (void) size;
+    (void) sequential;
+#endif
+}
+
+size_t LargePageAllocator::discard(void *ptr, size_t size) {
+#ifndef _WIN32
+    // 只丢弃完整的大页，避免拆分头尾仍在使用的大页
+    const uintptr_t start = roundUp(reinterpret_cast<uintptr_t>(ptr), HUGE_PAGE_SIZE);
+    const uintptr_t end = (reinterpret_cast<uintptr_t>(ptr) + size) / HUGE_PAGE_SIZE *
+                          HUGE_PAGE_SIZE;
+    if (end <= start) {
+        return 0;
+    }
+
+    const size_t length = end - start;
+    if (madvise(reinterpret_cast<void *>(start), length, MADV_DONTNEED) != 0) {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(registryMutex());
+    stats().discardedBytes += length;
+    return length;
+#else
+    (void) ptr;
+    (void) size;
+    return 0;
+#endif
+}
+
+void LargePageAllocator::setEnabled(bool enabled) {
+    g_largePagesEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool LargePageAllocator::isEnabled() {
+    return g_largePagesEnabled.load(std::memory_order_relaxed);
+}
+
+LargePageStats LargePageAllocator::getStats() {
+    std::lock_guard<std::mutex> lock(registryMutex());
+    return stats();
+}
@@ -0,0 +1,92 @@
+#ifndef LARGE_PAGE_ALLOCATOR_H
+#define LARGE_PAGE_ALLOCATOR_H
+
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+#include <android/log.h>
+
+#define LARGE_PAGE_TAG "LargePageAllocator"
+#define LPA_LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LARGE_PAGE_TAG, __VA_ARGS__)
+#define LPA_LOGW(...) __android_log_print(ANDROID_LOG_WARN, LARGE_PAGE_TAG, __VA_ARGS__)
+
+/**
+ * 大缓冲区统计信息
+ */
+struct LargePageStats {
+    size_t mappedBytes = 0;      // 当前映射的总字节数
+    size_t mappingCount = 0;     // 当前映射数
+    size_t hugePageMappings = 0; // 累计成功设置MADV_HUGEPAGE的映射数
+    size_t discardedBytes = 0;   // 累计通过MADV_DONTNEED归还系统的字节数
+};
+
+/**
+ * 大缓冲区分配器
+ * 整帧RGBA缓冲区（4500万像素约180MB）按线性顺序访问，普通对齐分配使用4KB页，
+ * 每4KB一次缺页且TLB覆盖范围很小。达到阈值的缓冲区改为按2MB对齐直接mmap并设置MADV_HUGEPAGE，
+ * 透明大页可用时每2MB只缺页一次、只占一个TLB项；系统不支持时退化为普通匿名映射。
+ * 映射的页在首次访问时才由内核清零分配，因此不需要再memset。
+ * 不再使用但仍保留映射的缓冲区可以用discard()把脏页还给系统，而不是一直占用物理内存
+ */
+class LargePageAllocator {
+public:
+    static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+    // 至少两个大页才走映射路径，更小的缓冲区留给普通分配器
+    static constexpr size_t LARGE_BUFFER_THRESHOLD = 2 * HUGE_PAGE_SIZE;
+
+    /**
+     * 请求大小是否应走大缓冲区路径
+     */
+    static bool shouldUse(size_t size);
+
+    /**
+     * 映射一段按2MB对齐的匿名内存，内容全为0
+     * @param size 字节数，映射大小向上取整到2MB
+     * @return 内存地址，失败时返回nullptr
+     */
+    static void *allocate(size_t size);
+
+    /**
+     * 解除映射
+     * @param ptr allocate返回的地址
+     * @return ptr不是本分配器的映射时返回false，调用方应改用自己的释放方式
+     */
+    static bool deallocate(void *ptr);
+
+    /**
+     * 是否为本分配器的映射
+     */
+    static bool owns(void *ptr);
+
+    /**
+     * 提示内核该范围将被顺序读取（MADV_SEQUENTIAL），加大预读并尽早回收读过的页
+     * 范围按页向内取整，可以用于任意缓冲区
+     * @param sequential 为false时恢复为MADV_NORMAL
+     */
+    static void adviseSequential(const void *ptr, size_t size, bool sequential = true);
+
+    /**
+     * 丢弃范围内的页（MADV_DONTNEED），映射保留，再次访问时得到清零的新页
+     * 范围按2MB向内取整，不足一个大页的头尾保持不变
+     * @return 实际丢弃的字节数
+     */
+    static size_t discard(void *ptr, size_t size);
+
+    /**
+     * 启用或关闭大缓冲区路径（关闭后shouldUse始终返回false，已有映射不受影响）
+     */
+    static void setEnabled(bool enabled);
+
+    static bool isEnabled();
+
+    static LargePageStats getStats();
+
+private:
+    static std::mutex &registryMutex();
+
+    static std::unordered_map<void *, size_t> &registry(); // 地址 -> 映射大小
+
+    static LargePageStats &stats();
+};
+
+#endif // LARGE_PAGE_ALLOCATOR_H
@@ -0,0 +1,262 @@
+#include "memory_admission.h"
+#include "memory_pool.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+MemoryAdmissionController::Reservation::~Reservation() {
+    release();
+}
+
+MemoryAdmissionController::Reservation::Reservation(Reservation &&other) noexcept
+        : controller_(other.controller_), bytes_(other.bytes_) {
+    other.controller_ = nullptr;
+    other.bytes_ = 0;
+}
+
+MemoryAdmissionController::Reservation &
+MemoryAdmissionController::Reservation::operator=(Reservation &&other) noexcept {
+    if (this != &other) {
+        release();
+        controller_ = other.controller_;
+        bytes_ = other.bytes_;
+        other.controller_ = nullptr;
+        other.bytes_ = 0;
+    }
+    return *this;
+}
+
+void MemoryAdmissionController::Reservation::release() {
+    if (controller_) {
+        controller_->release(bytes_);
+        controller_ = nullptr;
+        bytes_ = 0;
+    }
+}
+
+MemoryAdmissionController &MemoryAdmissionController::getInstance() {
+    static MemoryAdmissionController instance;
+    return instance;
+}
+
+MemoryAdmissionController::MemoryAdmissionController() {
+    // 默认预算为物理内存的一半，读不到时按1GB
+    SystemMemoryStatus status;
+    readSystemMemoryStatus(meminfoPath_, "", status);
+    budget_ = status.hasMemInfo && status.totalBytes > 0 ? status.totalBytes / 2
+                                                         : static_cast<size_t>(1024) * 1024 * 1024;
+    ADM_LOGI("内存准入控制初始化，预算: %.2f MB", budget_ / (1024.0 * 1024.0));
+}
+
+bool MemoryAdmissionController::readSystemMemoryStatus(const std::string &meminfoPath,
+                                                       const std::string &pressurePath,
+                                                       SystemMemoryStatus &status) {
+    status = SystemMemoryStatus();
+
+    if (!meminfoPath.empty()) {
+        if (FILE *file = fopen(meminfoPath.c_str(), "r")) {
+            char line[256];
+            bool hasTotal = false;
+            bool hasAvailable = false;
+            while (fgets(line, sizeof(line), file)) {
+                unsigned long long kb = 0;
+                if (std::sscanf(line, "MemTotal: %llu kB", &kb) == 1) {
+                    status.totalBytes = static_cast<size_t>(kb) * 1024;
+                    hasTotal = true;
+                } else if (std::sscanf(line, "MemAvailable: %llu kB", &kb) == 1) {
+                    status.availableBytes = static_cast<size_t>(kb) * 1024;
+                    hasAvailable = true;
+                }
+            }
+            fclose(file);
+            status.hasMemInfo = hasTotal && hasAvailable;
+        }
+    }
+
+    if (!pressurePath.empty()) {
+        if (FILE *file = fopen(pressurePath.c_str(), "r")) {
+            char line[256];
+            while (fgets(line, sizeof(line), file)) {
+                double avg10 = 0.0;
+                if (std::sscanf(line, "some avg10=%lf", &avg10) == 1) {
+                    status.pressureAvg10 = avg10;
+                    status.hasPressure = true;
+                    break;
+                }
+            }
+            fclose(file);
+        }
+    }
+
+    return status.hasMemInfo || status.hasPressure;
+}
+
+const SystemMemoryStatus &MemoryAdmissionController::systemStatusLocked() {
+    const auto now = std::chrono::steady_clock::now();
+    if (now - statusTime_ >= STATUS_REFRESH_INTERVAL) {
+        readSystemMemoryStatus(meminfoPath_, pressurePath_, systemStatus_);
+        statusTime_ = now;
+    }
+    return systemStatus_;
+}
+
+bool MemoryAdmissionController::fitsLocked(size_t bytes) {
+    // 没有任务在运行时总是准入，否则超出预算的单个任务永远无法开始
+    if (activeJobs_ == 0) {
+        return true;
+    }
+
+    // 线程缓存中的块计入池的使用量，但随时可被复用，这里按空闲处理
+    const PoolStats poolStats = MemoryPool::getInstance().getStats();
+    const size_t poolCached = std::min(poolStats.threadCachedBytes, poolStats.totalInUse);
+    const size_t poolFree = poolStats.totalFree + poolCached;
+    const size_t poolInUse = poolStats.totalInUse - poolCached;
+
+    // 已准入任务的缓冲区大多来自内存池，两者取大者，避免重复计算
+    if (std::max(reservedBytes_, poolInUse) + bytes > budget_) {
+        return false;
+    }
+
+    // 池中空闲块已属于本进程，任务可以直接复用，池在分配失败时也会先释放它们
+    const SystemMemoryStatus &status = systemStatusLocked();
+    if (status.hasMemInfo && status.availableBytes + poolFree < bytes + systemReserve_) {
+        return false;
+    }
+    if (status.hasPressure && status.pressureAvg10 > pressureThreshold_) {
+        return false;
+    }
+    return true;
+}
+
+MemoryAdmissionController::Reservation MemoryAdmissionController::admitLocked(size_t bytes) {
+    reservedBytes_ += bytes;
+    activeJobs_++;
+    stats_.admittedJobs++;
+    stats_.peakReservedBytes = std::max(stats_.peakReservedBytes, reservedBytes_);
+    return Reservation(this, bytes);
+}
+
+MemoryAdmissionController::Reservation MemoryAdmissionController::tryReserve(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!waitQueue_.empty() || !fitsLocked(bytes)) {
+        return Reservation();
+    }
+    return admitLocked(bytes);
+}
+
+MemoryAdmissionController::Reservation MemoryAdmissionController::reserve(
+        size_t bytes,
+        std::chrono::milliseconds timeout,
+        const CancelCallback &cancelCallback
+) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (waitQueue_.empty() && fitsLocked(bytes)) {
+        return admitLocked(bytes);
+    }
+
+    const uint64_t ticket = nextTicket_++;
+    waitQueue_.push_back(ticket);
+    stats_.queuedJobs++;
+    ADM_LOGI("内存不足，任务排队: 需要 %.2f MB, 已预留 %.2f MB, 运行中 %zu 个任务, 排在第 %zu 位",
+             bytes / (1024.0 * 1024.0), reservedBytes_ / (1024.0 * 1024.0), activeJobs_,
+             waitQueue_.size());
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto deadline = start + timeout;
+    while (true) {
+        // 系统可用内存与压力的变化没有通知，因此按刷新间隔定期重新检查
+        released_.wait_for(lock, STATUS_REFRESH_INTERVAL);
+
+        const auto now = std::chrono::steady_clock::now();
+        const double waitedMs = std::chrono::duration<double, std::milli>(now - start).count();
+        // 只有队首的任务可以准入，准入后唤醒下一个任务立即检查
+        if (waitQueue_.front() == ticket && fitsLocked(bytes)) {
+            waitQueue_.pop_front();
+            released_.notify_all();
+            stats_.totalWaitMs += waitedMs;
+            ADM_LOGD("任务排队 %.1f ms 后准入", waitedMs);
+            return admitLocked(bytes);
+        }
+
+        bool cancelled = false;
+        if (cancelCallback) {
+            // 回调可能耗时或再次进入控制器，不在锁内调用
+            lock.unlock();
+            cancelled = cancelCallback();
+            lock.lock();
+        }
+        if (cancelled || now >= deadline) {
+            waitQueue_.erase(std::find(waitQueue_.begin(), waitQueue_.end(), ticket));
+            released_.notify_all();
+            stats_.timedOutJobs++;
+            stats_.totalWaitMs += waitedMs;
+            ADM_LOGW("任务%s，放弃准入: 需要 %.2f MB", cancelled ? "已取消" : "等待超时",
+                     bytes / (1024.0 * 1024.0));
+            return Reservation();
+        }
+    }
+}
+
+void MemoryAdmissionController::release(size_t bytes) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        reservedBytes_ -= std::min(bytes, reservedBytes_);
+        if (activeJobs_ > 0) {
+            activeJobs_--;
+        }
+    }
+    released_.notify_all();
+}
+
+void MemoryAdmissionController::setBudget(size_t bytes) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        budget_ = bytes;
+    }
+    released_.notify_all();
+    ADM_LOGI("设置内存准入预算: %.2f MB", bytes / (1024.0 * 1024.0));
+}
+
+size_t MemoryAdmissionController::getBudget() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return budget_;
+}
+
+void MemoryAdmissionController::setSystemReserve(size_t bytes) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        systemReserve_ = bytes;
+    }
+    released_.notify_all();
+}
+
+void MemoryAdmissionController::setPressureThreshold(double avg10Percent) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pressureThreshold_ = std::clamp(avg10Percent, 0.0, 100.0);
+    }
+    released_.notify_all();
+}
+
+void MemoryAdmissionController::setSystemSources(const std::string &meminfoPath,
+                                                 const std::string &pressurePath) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    meminfoPath_ = meminfoPath;
+    pressurePath_ = pressurePath;
+    statusTime_ = std::chrono::steady_clock::time_point();
+}
+
+AdmissionStats MemoryAdmissionController::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    AdmissionStats stats = stats_;
+    stats.activeJobs = activeJobs_;
+    stats.waitingJobs = waitQueue_.size();
+    stats.reservedBytes = reservedBytes_;
+    return stats;
+}
+
+void MemoryAdmissionController::resetStats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_ = AdmissionStats();
+    stats_.peakReservedBytes = reservedBytes_;
+}
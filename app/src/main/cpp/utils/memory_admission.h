@@ -0,0 +1,203 @@
+#ifndef MEMORY_ADMISSION_H
+#define MEMORY_ADMISSION_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <android/log.h>
+
+#define ADMISSION_TAG "MemoryAdmission"
+#define ADM_LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, ADMISSION_TAG, __VA_ARGS__)
+#define ADM_LOGI(...) __android_log_print(ANDROID_LOG_INFO, ADMISSION_TAG, __VA_ARGS__)
+#define ADM_LOGW(...) __android_log_print(ANDROID_LOG_WARN, ADMISSION_TAG, __VA_ARGS__)
+
+/**
+ * 系统内存状态
+ */
+struct SystemMemoryStatus {
+    size_t totalBytes = 0;      // MemTotal
+    size_t availableBytes = 0;  // MemAvailable
+    bool hasMemInfo = false;
+    double pressureAvg10 = 0.0; // PSI中some avg10，最近10秒内有任务因内存等待的时间百分比
+    bool hasPressure = false;
+};
+
+/**
+ * 准入统计信息
+ */
+struct AdmissionStats {
+    size_t admittedJobs = 0;
+    size_t queuedJobs = 0;    // 进入等待的任务数
+    size_t timedOutJobs = 0;  // 等待超时或被取消的任务数
+    size_t activeJobs = 0;
+    size_t waitingJobs = 0;   // 当前排队中的任务数
+    size_t reservedBytes = 0;
+    size_t peakReservedBytes = 0;
+    double totalWaitMs = 0.0;
+};
+
+/**
+ * 内存准入控制器
+ * 每个处理任务开始前先按预估的工作集预留内存，预留总量不超过预算，
+ * 同时参考系统可用内存（/proc/meminfo的MemAvailable）、内存压力（/proc/pressure/memory）
+ * 与MemoryPool的统计：池中空闲块（含线程缓存）可被新任务直接复用，计入系统可用内存；
+ * 池中使用量超过预留总量的部分来自未经准入的分配，同样占用预算。
+ * 放不下的任务按到达顺序排队等待其他任务结束，或由调用方降级为流式处理；
+ * 有任务排队时新任务不能越过它直接准入，大任务不会被源源不断的小任务饿死。
+ * 这样批量导出时内存不足表现为可预期的排队延迟，而不是事后清理或被系统低内存查杀。
+ * 没有任何任务在运行时总是准入，保证单个超大任务也能执行
+ */
+class MemoryAdmissionController {
+public:
+    /**
+     * 内存预留，析构时自动归还
+     */
+    class Reservation {
+    public:
+        Reservation() = default;
+
+        ~Reservation();
+
+        Reservation(Reservation &&other) noexcept;
+
+        Reservation &operator=(Reservation &&other) noexcept;
+
+        Reservation(const Reservation &) = delete;
+
+        Reservation &operator=(const Reservation &) = delete;
+
+        bool isValid() const { return controller_ != nullptr; }
+
+        size_t getBytes() const { return bytes_; }
+
+        /**
+         * 提前归还预留
+         */
+        void release();
+
+    private:
+        friend class MemoryAdmissionController;
+
+        Reservation(MemoryAdmissionController *controller, size_t bytes)
+                : controller_(controller), bytes_(bytes) {}
+
+        MemoryAdmissionController *controller_ = nullptr;
+        size_t bytes_ = 0;
+    };
+
+    using CancelCallback = std::function<bool()>; // 返回true表示放弃等待
+
+    static constexpr const char *PROC_MEMINFO = "/proc/meminfo";
+    static constexpr const char *PROC_PRESSURE_MEMORY = "/proc/pressure/memory";
+
+    static MemoryAdmissionController &getInstance();
+
+    /**
+     * 立即尝试预留，放不下或已有任务在排队时返回无效的预留
+     * @param bytes 任务预估的工作集
+     */
+    Reservation tryReserve(size_t bytes);
+
+    /**
+     * 预留内存，放不下时按到达顺序排队等待其他任务归还
+     * @param bytes 任务预估的工作集
+     * @param timeout 最长等待时间
+     * @param cancelCallback 等待期间定期检查的取消回调，可为空
+     * @return 超时或取消时返回无效的预留
+     */
+    Reservation reserve(size_t bytes,
+                        std::chrono::milliseconds timeout = std::chrono::minutes(5),
+                        const CancelCallback &cancelCallback = nullptr);
+
+    /**
+     * 设置预算（所有任务预留总量的上限）
+     */
+    void setBudget(size_t bytes);
+
+    size_t getBudget() const;
+
+    /**
+     * 设置准入后系统至少保留的可用内存
+     */
+    void setSystemReserve(size_t bytes);
+
+    /**
+     * 设置内存压力阈值，PSI some avg10超过该值时只允许一个任务运行
+     * @param avg10Percent 百分比（0-100）
+     */
+    void setPressureThreshold(double avg10Percent);
+
+    /**
+     * 设置系统状态文件路径，目录结构与/proc相同，可传入模拟文件进行测试；路径为空时不读取
+     */
+    void setSystemSources(const std::string &meminfoPath, const std::string &pressurePath);
+
+    AdmissionStats getStats() const;
+
+    void resetStats();
+
+    /**
+     * 读取系统内存状态
+     * @param meminfoPath meminfo文件路径
+     * @param pressurePath PSI内存文件路径，内核不支持PSI时不存在
+     * @param status 输出的状态
+     * @return 是否读到了meminfo或PSI中的任意一项
+     */
+    static bool readSystemMemoryStatus(const std::string &meminfoPath,
+                                       const std::string &pressurePath,
+                                       SystemMemoryStatus &status);
+
+private:
+    MemoryAdmissionController();
+
+    MemoryAdmissionController(const MemoryAdmissionController &) = delete;
+
+    MemoryAdmissionController &operator=(const MemoryAdmissionController &) = delete;
+
+    /**
+     * 在持有锁的情况下判断任务能否准入
+     */
+    bool fitsLocked(size_t bytes);
+
+    /**
+     * 在持有锁的情况下记录一次准入
+     */
+    Reservation admitLocked(size_t bytes);
+
+    void release(size_t bytes);
+
+    /**
+     * 获取系统内存状态，短时间内重复调用时复用上一次的读数
+     */
+    const SystemMemoryStatus &systemStatusLocked();
+
+    // 系统状态的最短刷新间隔，等待中的任务也按该间隔重新检查
+    static constexpr auto STATUS_REFRESH_INTERVAL = std::chrono::milliseconds(50);
+
+    mutable std::mutex mutex_;
+    std::condition_variable released_;
+
+    size_t budget_;
+    size_t systemReserve_ = 256 * 1024 * 1024; // 256MB
+    double pressureThreshold_ = 20.0;
+    size_t reservedBytes_ = 0;
+    size_t activeJobs_ = 0;
+
+    // 排队中任务的票号，按到达顺序排列，只有队首的任务可以准入
+    std::deque<uint64_t> waitQueue_;
+    uint64_t nextTicket_ = 0;
+
+    std::string meminfoPath_ = PROC_MEMINFO;
+    std::string pressurePath_ = PROC_PRESSURE_MEMORY;
+    SystemMemoryStatus systemStatus_;
+    std::chrono::steady_clock::time_point statusTime_;
+
+    AdmissionStats stats_;
+};
+
+#endif // MEMORY_ADMISSION_H
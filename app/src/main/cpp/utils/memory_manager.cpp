@@ -1,4 +1,5 @@
 #include "memory_manager.h"
+#include "large_page_allocator.h"
 #include <cstdlib>
 #include <cstring>
 #include <algorithm>
@@ -362,8 +363,8 @@ void MemoryManager::setMemoryPressureThreshold(float threshold) {
 void MemoryManager::handleMemoryPressure() {
     LOGW("处理内存压力，当前使用率: %.2f%%", getMemoryUsageRatio() * 100);
 
-    // 清理内存池
-    cleanup();
+    // 清理内存池中过期的空闲块（cleanup()会强制释放仍在使用的分配，只用于析构）
+    MemoryPool::getInstance().cleanup(false);
     triggerEvent(MemoryEvent::POOL_CLEANUP);
 
     // 强制垃圾回收
@@ -475,8 +476,8 @@ void MemoryManager::triggerEvent(MemoryEvent event, size_t size) {
 void MemoryManager::optimizeMemoryUsage() {
     LOGI("开始内存优化");
 
-    // 清理内存池
-    cleanup();
+    // 清理内存池中过期的空闲块，仍在使用的分配不受影响
+    MemoryPool::getInstance().cleanup(false);
 
     // 如果内存压力高，强制垃圾回收
     if (isMemoryPressureHigh()) {
@@ -508,7 +509,11 @@ void MemoryManager::startOptimizationThread() {
 }
 
 void MemoryManager::stopOptimizationThread() {
-    optimizationThreadRunning_.store(false);
+    {
+        std::lock_guard<std::mutex> lock(optimizationMutex_);
+        optimizationThreadRunning_.store(false);
+    }
+    optimizationCondition_.notify_all();
     if (optimizationThread_.joinable()) {
         optimizationThread_.join();
     }
@@ -518,7 +523,13 @@ void MemoryManager::optimizationWorker() {
     LOGI("自动优化线程启动，间隔: %lld 秒", optimizationInterval_.count());
 
     while (optimizationThreadRunning_.load()) {
-        std::this_thread::sleep_for(optimizationInterval_);
+        // 可被stopOptimizationThread()唤醒，停止时不必等完整个间隔
+        {
+            std::unique_lock<std::mutex> lock(optimizationMutex_);
+            optimizationCondition_.wait_for(lock, optimizationInterval_, [this]() {
+                return !optimizationThreadRunning_.load();
+            });
+        }
 
         if (optimizationThreadRunning_.load()) {
             optimizeMemoryUsage();
@@ -580,6 +591,13 @@ void *MemoryManager::allocateDirect(size_t size, size_t alignment) {
 }
 
 void *MemoryManager::allocateInternal(size_t size, size_t alignment) {
+    // 整帧大小的缓冲区按大页映射，映射的页由内核清零，不需要memset
+    if (LargePageAllocator::shouldUse(size) && alignment <= LargePageAllocator::HUGE_PAGE_SIZE) {
+        if (void *mapped = LargePageAllocator::allocate(size)) {
+            return mapped;
+        }
+    }
+
     void *ptr = nullptr;
 
 #ifdef _WIN32
@@ -599,7 +617,7 @@ void *MemoryManager::allocateInternal(size_t size, size_t alignment) {
 }
 
 void MemoryManager::deallocateInternal(void *ptr) {
-    if (ptr) {
+    if (ptr && !LargePageAllocator::deallocate(ptr)) {
 #ifdef _WIN32
         _aligned_free(ptr);
 #else
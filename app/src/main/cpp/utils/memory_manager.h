@@ -11,6 +11,7 @@
 #include <functional>
 #include <vector>
 #include <thread>
+#include <condition_variable>
 #include "memory_pool.h"
 
 // 分配信息结构
@@ -328,6 +329,8 @@ private:
     std::atomic<bool> optimizationThreadRunning_{false};
     std::chrono::seconds optimizationInterval_{30}; // 30秒
     std::thread optimizationThread_;
+    std::mutex optimizationMutex_;
+    std::condition_variable optimizationCondition_; // 停止时唤醒等待中的优化线程
 
     // JVM指针用于垃圾回收
     JavaVM *javaVM_ = nullptr;
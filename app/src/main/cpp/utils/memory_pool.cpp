@@ -1,4 +1,6 @@
 #include "memory_pool.h"
+#include "large_page_allocator.h"
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <chrono>
@@ -12,6 +14,48 @@
 
 #endif
 
+namespace {
+    // 紧贴在返回地址之前的块头，释放时不需要查表即可找到块（大页映射的块没有块头）
+    struct BlockHeader {
+        MemoryBlock *block;
+        uint64_t magic;
+    };
+
+    constexpr uint64_t BLOCK_MAGIC = 0x4C55545F504F4F4CULL; // "LUT_POOL"
+
+    void writeBlockHeader(MemoryBlock *block) {
+        auto *header = reinterpret_cast<BlockHeader *>(
+                static_cast<uint8_t *>(block->ptr) - sizeof(BlockHeader));
+        header->block = block;
+        header->magic = BLOCK_MAGIC;
+    }
+
+    // 大页映射的块空闲时整段丢弃，映射内不保存任何元数据，所有大页都能还给系统
+    void discardMappedBlock(MemoryBlock *block) {
+        const size_t mappedSize = (block->size + LargePageAllocator::HUGE_PAGE_SIZE - 1) /
+                                  LargePageAllocator::HUGE_PAGE_SIZE * LargePageAllocator::HUGE_PAGE_SIZE;
+        LargePageAllocator::discard(block->base, mappedSize);
+    }
+
+    // 内存池销毁后线程缓存不再归还块
+    std::atomic<bool> g_poolDestroyed{false};
+}
+
+/**
+ * 每线程缓存：按级别保存最近释放的块
+ */
+struct MemoryPool::ThreadCache {
+    std::vector<MemoryBlock *> magazines[THREAD_CACHE_CLASSES];
+    size_t cachedBytes = 0;
+    unsigned generation = 0;
+
+    ~ThreadCache() {
+        if (!g_poolDestroyed.load()) {
+            MemoryPool::getInstance().returnThreadCache(*this);
+        }
+    }
+};
+
 // 常用尺寸定义（基于常见图片分辨率和处理需求）
 const std::vector<size_t> MemoryPool::COMMON_SIZES = {
         // 小图片缓冲区
@@ -40,19 +84,40 @@ MemoryPool::MemoryPool() {
 }
 
 MemoryPool::~MemoryPool() {
+    g_poolDestroyed.store(true);
     cleanup(true);
     POOL_LOGI("内存池销毁，最终统计 - 命中率: %.2f%%, 复用次数: %zu",
               stats_.getHitRate() * 100, stats_.reuseCount);
 }
 
 void *MemoryPool::allocate(size_t size, size_t alignment) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    // 请求大小向上取整到尺寸级别，所有块至少按缓存行对齐
+    const int sizeClass = sizeClassOf(size);
+    const size_t blockAlignment = std::max(alignment, MIN_BLOCK_ALIGNMENT);
+    const bool cacheable = sizeClass < THREAD_CACHE_CLASSES &&
+                           blockAlignment == MIN_BLOCK_ALIGNMENT;
+
+    // 线程缓存命中时完全不加锁
+    ThreadCache *cache = nullptr;
+    if (cacheable) {
+        cache = &threadCache();
+        auto &magazine = cache->magazines[sizeClass];
+        if (!magazine.empty()) {
+            MemoryBlock *block = magazine.back();
+            magazine.pop_back();
+            block->threadCached = false;
+            cache->cachedBytes -= block->size;
+            threadCachedBytes_.fetch_sub(block->size, std::memory_order_relaxed);
+            threadCacheHits_.fetch_add(1, std::memory_order_relaxed);
+            return block->ptr;
+        }
+        threadCacheMisses_.fetch_add(1, std::memory_order_relaxed);
+    }
 
-    // 对齐大小到最近的2的幂次
-    size_t alignedSize = ((size + alignment - 1) / alignment) * alignment;
+    auto lock = lockPool();
 
-    // 首先尝试从现有块中找到合适的
-    MemoryBlock *block = findSuitableBlock(alignedSize, alignment);
+    // 尝试复用同级别（或稍大级别）的空闲块
+    MemoryBlock *block = findSuitableBlock(sizeClass, blockAlignment);
     if (block) {
         block->inUse = true;
         block->lastUsed = std::chrono::steady_clock::now();
@@ -61,15 +126,29 @@ void *MemoryPool::allocate(size_t size, size_t alignment) {
         stats_.totalInUse += block->size;
         stats_.totalFree -= block->size;
 
-        POOL_LOGD("复用内存块: %zu bytes (对齐: %zu), 命中率: %.2f%%",
-                  alignedSize, alignment, stats_.getHitRate() * 100);
+        // 顺便把同级别的其他空闲块成批装入线程缓存，后续分配不再加锁
+        if (cache && block->sizeClass == sizeClass) {
+            auto &freeList = freeLists_[sizeClass];
+            auto &magazine = cache->magazines[sizeClass];
+            while (!freeList.empty() && magazine.size() < THREAD_CACHE_BATCH) {
+                MemoryBlock *cached = freeList.back();
+                freeList.pop_back();
+                cached->inUse = true;
+                cached->threadCached = true;
+                stats_.totalInUse += cached->size;
+                stats_.totalFree -= cached->size;
+                cache->cachedBytes += cached->size;
+                threadCachedBytes_.fetch_add(cached->size, std::memory_order_relaxed);
+                magazine.push_back(cached);
+            }
+        }
         return block->ptr;
     }
 
     // 检查内存压力
     if (isMemoryPressureHigh()) {
         POOL_LOGW("内存压力过高，触发清理");
-        cleanupOldBlocks();
+        cleanupOldBlocks(false);
 
         // 如果设置了压力回调，通知上层
         if (pressureCallback_) {
@@ -78,16 +157,21 @@ void *MemoryPool::allocate(size_t size, size_t alignment) {
         }
     }
 
-    // 分配新块
-    void *ptr = allocateNewBlock(alignedSize, alignment);
+    // 分配新块，超过池上限时先释放全部空闲块再试一次，其他级别刚归还的块不应挡住新分配
+    void *ptr = allocateNewBlock(sizeClass, blockAlignment);
+    if (!ptr && stats_.totalFree > 0) {
+        cleanupBlocks(false, std::chrono::steady_clock::duration::zero());
+        ptr = allocateNewBlock(sizeClass, blockAlignment);
+    }
     if (!ptr) {
-        POOL_LOGE("内存分配失败: %zu bytes", alignedSize);
+        POOL_LOGE("内存分配失败: %zu bytes", size);
         return nullptr;
     }
 
     stats_.missCount++;
-    POOL_LOGD("分配新内存块: %zu bytes (对齐: %zu), 总分配: %.2f MB",
-              alignedSize, alignment, stats_.totalAllocated / (1024.0 * 1024.0));
+    POOL_LOGD("分配新内存块: %zu bytes (级别大小: %zu, 对齐: %zu), 总分配: %.2f MB",
+              size, sizeOfClass(sizeClass), blockAlignment,
+              stats_.totalAllocated / (1024.0 * 1024.0));
 
     return ptr;
 }
@@ -95,50 +179,163 @@ void *MemoryPool::allocate(size_t size, size_t alignment) {
 void MemoryPool::deallocate(void *ptr) {
     if (!ptr) return;
 
-    std::lock_guard<std::mutex> lock(mutex_);
+    // 通过块头（大页映射的块通过块表）找到内存块
+    MemoryBlock *block = blockFromPointer(ptr);
+    if (!block) {
+        POOL_LOGW("尝试释放未知的内存指针: %p", ptr);
+        return;
+    }
 
-    // 查找对应的内存块
-    auto it = std::find_if(blocks_.begin(), blocks_.end(),
-                           [ptr](const std::unique_ptr<MemoryBlock> &block) {
-                               return block->ptr == ptr;
-                           });
-
-    if (it != blocks_.end()) {
-        MemoryBlock *block = it->get();
-        if (block->inUse) {
-            block->inUse = false;
-            block->lastUsed = std::chrono::steady_clock::now();
-            stats_.totalInUse -= block->size;
-            stats_.totalFree += block->size;
-
-            POOL_LOGD("释放内存块: %zu bytes, 空闲内存: %.2f MB",
-                      block->size, stats_.totalFree / (1024.0 * 1024.0));
+    if (block->threadCached) {
+        POOL_LOGW("重复释放内存指针: %p", ptr);
+        return;
+    }
+
+    // 小块放入本线程缓存，缓存满时先把较早放入的一半成批归还全局池
+    if (block->sizeClass < THREAD_CACHE_CLASSES && block->alignment == MIN_BLOCK_ALIGNMENT) {
+        ThreadCache &cache = threadCache();
+        auto &magazine = cache.magazines[block->sizeClass];
+        if (magazine.size() >= THREAD_CACHE_CAPACITY) {
+            auto lock = lockPool();
+            for (size_t i = 0; i < THREAD_CACHE_BATCH; ++i) {
+                MemoryBlock *returned = magazine[i];
+                returned->threadCached = false;
+                cache.cachedBytes -= returned->size;
+                threadCachedBytes_.fetch_sub(returned->size, std::memory_order_relaxed);
+                releaseBlockLocked(returned);
+            }
+            magazine.erase(magazine.begin(), magazine.begin() + THREAD_CACHE_BATCH);
         }
-    } else {
-        POOL_LOGW("尝试释放未知的内存指针: %p", ptr);
+
+        block->threadCached = true;
+        block->lastUsed = std::chrono::steady_clock::now();
+        cache.cachedBytes += block->size;
+        threadCachedBytes_.fetch_add(block->size, std::memory_order_relaxed);
+        magazine.push_back(block);
+        return;
+    }
+
+    // 大页映射的块放回空闲链表前先把页还给系统，复用时重新缺页得到清零的页
+    if (block->mapped) {
+        discardMappedBlock(block);
     }
+
+    auto lock = lockPool();
+    releaseBlockLocked(block);
 }
 
-MemoryBlock *MemoryPool::findSuitableBlock(size_t size, size_t alignment) {
-    size_t key = calculateBlockKey(size, alignment);
+void MemoryPool::flushThreadCache() {
+    returnThreadCache(threadCache());
+}
 
-    // 首先查找精确匹配的块
-    auto it = sizeMap_.find(key);
-    if (it != sizeMap_.end()) {
-        for (MemoryBlock *block: it->second) {
-            if (!block->inUse && block->size >= size && block->alignment >= alignment) {
-                return block;
+void MemoryPool::returnThreadCache(ThreadCache &cache) {
+    if (cache.cachedBytes == 0) {
+        return;
+    }
+
+    auto lock = lockPool();
+    // 强制清理之后缓存中的块已经释放，只需丢弃
+    const bool valid = cache.generation == cacheGeneration_.load(std::memory_order_acquire);
+    for (auto &magazine: cache.magazines) {
+        if (valid) {
+            for (MemoryBlock *block: magazine) {
+                block->threadCached = false;
+                releaseBlockLocked(block);
             }
         }
+        magazine.clear();
     }
+    threadCachedBytes_.fetch_sub(cache.cachedBytes, std::memory_order_relaxed);
+    cache.cachedBytes = 0;
+}
 
-    // 查找稍大的可用块
-    for (auto &pair: sizeMap_) {
-        if (pair.first > key) {
-            for (MemoryBlock *block: pair.second) {
-                if (!block->inUse && block->size >= size && block->alignment >= alignment) {
-                    return block;
-                }
+MemoryPool::ThreadCache &MemoryPool::threadCache() {
+    static thread_local ThreadCache cache;
+
+    const unsigned generation = cacheGeneration_.load(std::memory_order_acquire);
+    if (cache.generation != generation) {
+        // 强制清理已经释放了这些块
+        for (auto &magazine: cache.magazines) {
+            magazine.clear();
+        }
+        threadCachedBytes_.fetch_sub(cache.cachedBytes, std::memory_order_relaxed);
+        cache.cachedBytes = 0;
+        cache.generation = generation;
+    }
+    return cache;
+}
+
+std::unique_lock<std::mutex> MemoryPool::lockPool() {
+    std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        lockContentions_.fetch_add(1, std::memory_order_relaxed);
+        lock.lock();
+    }
+    return lock;
+}
+
+void MemoryPool::releaseBlockLocked(MemoryBlock *block) {
+    if (!block->inUse) {
+        return;
+    }
+
+    block->inUse = false;
+    block->lastUsed = std::chrono::steady_clock::now();
+    stats_.totalInUse -= block->size;
+    stats_.totalFree += block->size;
+    freeLists_[block->sizeClass].push_back(block);
+}
+
+MemoryBlock *MemoryPool::blockFromPointer(void *ptr) {
+    // 大页映射的块直接返回2MB对齐的映射起点，前面可能没有可读的内存，只能查块表。
+    // 其他块的地址恰好2MB对齐时同样在块表中
+    if (reinterpret_cast<uintptr_t>(ptr) % LargePageAllocator::HUGE_PAGE_SIZE == 0) {
+        auto lock = lockPool();
+        auto it = blocks_.find(ptr);
+        return it != blocks_.end() ? it->second.get() : nullptr;
+    }
+
+    const auto *header = reinterpret_cast<const BlockHeader *>(
+            static_cast<uint8_t *>(ptr) - sizeof(BlockHeader));
+    if (header->magic != BLOCK_MAGIC || !header->block || header->block->ptr != ptr) {
+        return nullptr;
+    }
+    return header->block;
+}
+
+int MemoryPool::sizeClassOf(size_t size) {
+    if (size <= (static_cast<size_t>(1) << MIN_CLASS_SHIFT)) {
+        return 0;
+    }
+
+    // size位于(2^k, 2^(k+1)]，该区间的级别为2^k的5/4、6/4、7/4与8/4倍
+    const size_t n = size - 1;
+    int k = 0;
+    while ((n >> (k + 1)) != 0) {
+        ++k;
+    }
+    const int step = static_cast<int>((n >> (k - 2)) & 3) + 1;
+    return (k - MIN_CLASS_SHIFT) * CLASSES_PER_OCTAVE + step;
+}
+
+size_t MemoryPool::sizeOfClass(int sizeClass) {
+    const int octave = MIN_CLASS_SHIFT + sizeClass / CLASSES_PER_OCTAVE;
+    const size_t step = static_cast<size_t>(sizeClass % CLASSES_PER_OCTAVE);
+    return (static_cast<size_t>(1) << (octave - 2)) * (CLASSES_PER_OCTAVE + step);
+}
+
+MemoryBlock *MemoryPool::findSuitableBlock(int sizeClass, size_t alignment) {
+    // 先找同级别，再向上借用有限的几个级别，避免小请求占用大块
+    const int lastClass = std::min(sizeClass + MAX_CLASS_PROMOTION,
+                                   static_cast<int>(freeLists_.size()) - 1);
+    for (int c = sizeClass; c <= lastClass; ++c) {
+        auto &freeList = freeLists_[c];
+        for (size_t i = freeList.size(); i > 0; --i) {
+            MemoryBlock *block = freeList[i - 1];
+            if (block->alignment >= alignment) {
+                freeList[i - 1] = freeList.back();
+                freeList.pop_back();
+                return block;
             }
         }
     }
@@ -146,7 +343,18 @@ MemoryBlock *MemoryPool::findSuitableBlock(size_t size, size_t alignment) {
     return nullptr;
 }
 
-void *MemoryPool::allocateNewBlock(size_t size, size_t alignment) {
+void MemoryPool::removeFromFreeList(MemoryBlock *block) {
+    auto &freeList = freeLists_[block->sizeClass];
+    auto it = std::find(freeList.begin(), freeList.end(), block);
+    if (it != freeList.end()) {
+        *it = freeList.back();
+        freeList.pop_back();
+    }
+}
+
+void *MemoryPool::allocateNewBlock(int sizeClass, size_t alignment) {
+    const size_t size = sizeOfClass(sizeClass);
+
     // 检查是否超过最大池大小
     if (stats_.totalAllocated + size > maxPoolSize_) {
         POOL_LOGW("分配将超过最大池大小，当前: %.2f MB, 请求: %.2f MB, 限制: %.2f MB",
@@ -156,34 +364,48 @@ void *MemoryPool::allocateNewBlock(size_t size, size_t alignment) {
         return nullptr;
     }
 
-    void *ptr = nullptr;
+    // 大页映射的块直接返回2MB对齐的映射起点，块记录只保存在块表中，
+    // 2的幂次级别正好占满整数个大页；其他块多分配一个对齐单位放块头，返回地址仍按alignment对齐
+    void *base = nullptr;
+    const bool mapped = LargePageAllocator::shouldUse(size) &&
+                        alignment <= LargePageAllocator::HUGE_PAGE_SIZE;
 
+    if (mapped) {
+        base = LargePageAllocator::allocate(size);
+    } else {
 #ifdef _WIN32
-    ptr = _aligned_malloc(size, alignment);
+        base = _aligned_malloc(size + alignment, alignment);
 #else
-    if (posix_memalign(&ptr, alignment, size) != 0) {
-        ptr = nullptr;
-    }
+        if (posix_memalign(&base, alignment, size + alignment) != 0) {
+            base = nullptr;
+        }
 #endif
+    }
 
-    if (!ptr) {
+    if (!base) {
         return nullptr;
     }
 
+    void *ptr = mapped ? base : static_cast<uint8_t *>(base) + alignment;
+
     // 创建内存块记录
-    auto block = std::make_unique<MemoryBlock>(ptr, size, alignment);
+    auto block = std::make_unique<MemoryBlock>(ptr, base, size, alignment, sizeClass, mapped);
     block->inUse = true;
 
-    // 添加到大小映射
-    size_t key = calculateBlockKey(size, alignment);
-    sizeMap_[key].push_back(block.get());
+    if (!mapped) {
+        writeBlockHeader(block.get());
+    }
+
+    if (static_cast<int>(freeLists_.size()) <= sizeClass) {
+        freeLists_.resize(sizeClass + 1);
+    }
 
     // 更新统计
     stats_.totalAllocated += size;
     stats_.totalInUse += size;
     stats_.blockCount++;
 
-    blocks_.push_back(std::move(block));
+    blocks_.emplace(ptr, std::move(block));
 
     return ptr;
 }
@@ -194,17 +416,16 @@ void MemoryPool::preallocateCommonSizes() {
     for (size_t size: COMMON_SIZES) {
         // 为每个常用尺寸预分配1-2个块
         for (int i = 0; i < 2; ++i) {
-            void *ptr = allocateNewBlock(size, 32);
+            void *ptr = allocateNewBlock(sizeClassOf(size), MIN_BLOCK_ALIGNMENT);
             if (ptr) {
                 // 立即标记为未使用，以便后续复用
-                auto it = std::find_if(blocks_.rbegin(), blocks_.rend(),
-                                       [ptr](const std::unique_ptr<MemoryBlock> &block) {
-                                           return block->ptr == ptr;
-                                       });
-                if (it != blocks_.rend()) {
-                    (*it)->inUse = false;
-                    stats_.totalInUse -= (*it)->size;
-                    stats_.totalFree += (*it)->size;
+                MemoryBlock *block = blocks_[ptr].get();
+                block->inUse = false;
+                stats_.totalInUse -= block->size;
+                stats_.totalFree += block->size;
+                freeLists_[block->sizeClass].push_back(block);
+                if (block->mapped) {
+                    discardMappedBlock(block);
                 }
             }
         }
@@ -216,7 +437,14 @@ void MemoryPool::preallocateCommonSizes() {
 
 void MemoryPool::cleanup(bool force) {
     std::lock_guard<std::mutex> lock(mutex_);
+    cleanupOldBlocks(force);
+}
+
+void MemoryPool::cleanupOldBlocks(bool force) {
+    cleanupBlocks(force, maxBlockAge_);
+}
 
+void MemoryPool::cleanupBlocks(bool force, std::chrono::steady_clock::duration maxAge) {
     auto now = std::chrono::steady_clock::now();
     size_t cleanedCount = 0;
     size_t cleanedSize = 0;
@@ -224,26 +452,34 @@ void MemoryPool::cleanup(bool force) {
     // 清理旧的未使用块
     auto it = blocks_.begin();
     while (it != blocks_.end()) {
-        MemoryBlock *block = it->get();
+        MemoryBlock *block = it->second.get();
 
         bool shouldClean = force ||
-                           (!block->inUse && (now - block->lastUsed) > maxBlockAge_);
+                           (!block->inUse && (now - block->lastUsed) >= maxAge);
 
         if (shouldClean) {
-            // 从大小映射中移除
-            size_t key = calculateBlockKey(block->size, block->alignment);
-            auto &sizeVec = sizeMap_[key];
-            sizeVec.erase(std::remove(sizeVec.begin(), sizeVec.end(), block), sizeVec.end());
-            if (sizeVec.empty()) {
-                sizeMap_.erase(key);
+            // 从空闲链表中移除
+            if (!block->inUse) {
+                removeFromFreeList(block);
+            }
+
+            // 清除块头，之后对该指针的释放会被识别为未知指针（映射的块没有块头，
+            // 从块表移除后同样无法再找到）
+            if (!block->mapped) {
+                reinterpret_cast<BlockHeader *>(
+                        static_cast<uint8_t *>(block->ptr) - sizeof(BlockHeader))->magic = 0;
             }
 
             // 释放内存
+            if (block->mapped) {
+                LargePageAllocator::deallocate(block->base);
+            } else {
 #ifdef _WIN32
-            _aligned_free(block->ptr);
+                _aligned_free(block->base);
 #else
-            free(block->ptr);
+                free(block->base);
 #endif
+            }
 
             cleanedSize += block->size;
             cleanedCount++;
@@ -263,21 +499,17 @@ void MemoryPool::cleanup(bool force) {
         }
     }
 
+    // 强制清理会释放线程缓存中的块，让各线程丢弃自己的缓存
+    if (force) {
+        cacheGeneration_.fetch_add(1, std::memory_order_release);
+    }
+
     if (cleanedCount > 0) {
         POOL_LOGI("清理完成，释放 %zu 个块，总大小: %.2f MB",
                   cleanedCount, cleanedSize / (1024.0 * 1024.0));
     }
 }
 
-void MemoryPool::cleanupOldBlocks() {
-    cleanup(false);
-}
-
-size_t MemoryPool::calculateBlockKey(size_t size, size_t alignment) const {
-    // 使用大小和对齐方式计算唯一键
-    return (size << 8) | (alignment & 0xFF);
-}
-
 bool MemoryPool::isMemoryPressureHigh() const {
     double usage = static_cast<double>(stats_.totalAllocated) / maxPoolSize_;
     return usage > cleanupThreshold_;
@@ -289,6 +521,11 @@ void MemoryPool::setMaxPoolSize(size_t maxSize) {
     POOL_LOGI("设置最大池大小: %.2f MB", maxSize / (1024.0 * 1024.0));
 }
 
+size_t MemoryPool::getMaxPoolSize() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return maxPoolSize_;
+}
+
 void MemoryPool::setCleanupThreshold(double threshold) {
     std::lock_guard<std::mutex> lock(mutex_);
     cleanupThreshold_ = std::clamp(threshold, 0.1, 0.95);
@@ -302,7 +539,12 @@ void MemoryPool::setMemoryPressureCallback(std::function<void(double)> callback)
 
 PoolStats MemoryPool::getStats() const {
     std::lock_guard<std::mutex> lock(mutex_);
-    return stats_;
+    PoolStats stats = stats_;
+    stats.threadCacheHits = threadCacheHits_.load(std::memory_order_relaxed);
+    stats.threadCacheMisses = threadCacheMisses_.load(std::memory_order_relaxed);
+    stats.lockContentions = lockContentions_.load(std::memory_order_relaxed);
+    stats.threadCachedBytes = threadCachedBytes_.load(std::memory_order_relaxed);
+    return stats;
 }
 
 void MemoryPool::resetStats() {
@@ -310,6 +552,9 @@ void MemoryPool::resetStats() {
     stats_.hitCount = 0;
     stats_.missCount = 0;
     stats_.reuseCount = 0;
+    threadCacheHits_.store(0, std::memory_order_relaxed);
+    threadCacheMisses_.store(0, std::memory_order_relaxed);
+    lockContentions_.store(0, std::memory_order_relaxed);
     POOL_LOGI("统计信息已重置");
 }
 
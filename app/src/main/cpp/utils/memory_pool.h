@@ -22,15 +22,19 @@
  * 内存块结构
  */
 struct MemoryBlock {
-    void* ptr;
+    void* ptr;          // 返回给调用方的地址
+    void* base;         // 实际分配的地址，ptr之前是指回本结构的块头（大页映射的块没有块头，ptr即base）
     size_t size;
     size_t alignment;
-    bool inUse;
+    int sizeClass;
+    bool inUse;         // 对全局池而言是否被占用（线程缓存中的块也算占用）
+    bool threadCached;  // 是否正在某个线程的缓存中
+    bool mapped;        // 是否通过LargePageAllocator按大页映射
     std::chrono::steady_clock::time_point lastUsed;
     
-    MemoryBlock(void* p, size_t s, size_t a) 
-        : ptr(p), size(s), alignment(a), inUse(false), 
-          lastUsed(std::chrono::steady_clock::now()) {}
+    MemoryBlock(void* p, void* b, size_t s, size_t a, int c, bool m = false)
+        : ptr(p), base(b), size(s), alignment(a), sizeClass(c), inUse(false),
+          threadCached(false), mapped(m), lastUsed(std::chrono::steady_clock::now()) {}
 };
 
 /**
@@ -45,6 +49,14 @@ struct PoolStats {
     size_t missCount = 0;
     size_t reuseCount = 0;
     
+    // 线程缓存（不经过全局锁）的命中与未命中次数
+    size_t threadCacheHits = 0;
+    size_t threadCacheMisses = 0;
+    // 获取全局锁时发生等待的次数
+    size_t lockContentions = 0;
+    // 当前停留在各线程缓存中的字节数（计入totalInUse）
+    size_t threadCachedBytes = 0;
+    
     double getHitRate() const {
         size_t total = hitCount + missCount;
         return total > 0 ? static_cast<double>(hitCount) / total : 0.0;
@@ -53,7 +65,13 @@ struct PoolStats {
 
 /**
  * 高性能内存池管理器
- * 专为大图片处理优化，支持不同尺寸的内存块复用
+ * 专为大图片处理优化，请求大小向上取整到尺寸级别（每个2的幂次区间分4级，相邻级别相差不超过1.25倍），
+ * 同一级别的块互相复用，尺寸略有不同的分块也能命中；空闲块按级别放在链表中，
+ * 释放时通过块头O(1)找到块。
+ * 较小的级别在全局池前面还有每线程的缓存：释放的块先放入本线程缓存，分配时优先从中取，
+ * 缓存满或为空时才加锁与全局池成批交换，因此多个工作线程频繁分配释放时很少争用全局锁。
+ * 达到LargePageAllocator阈值的块按2MB对齐映射并启用透明大页，直接返回对齐的映射起点，
+ * 块记录只在块表中；释放回空闲链表时丢弃其中的页，空闲的大块不再占用物理内存
  */
 class MemoryPool {
 public:
@@ -69,8 +87,14 @@ public:
     // 内存池管理
     void cleanup(bool force = false);
     void setMaxPoolSize(size_t maxSize);
+    size_t getMaxPoolSize() const;
     void setCleanupThreshold(double threshold);
     
+    /**
+     * 将调用线程缓存中的块全部归还全局池（线程退出时会自动归还）
+     */
+    void flushThreadCache();
+    
     // 统计信息
     PoolStats getStats() const;
     void resetStats();
@@ -79,6 +103,18 @@ public:
     bool isMemoryPressureHigh() const;
     void setMemoryPressureCallback(std::function<void(double)> callback);
     
+    /**
+     * 计算请求大小所属的尺寸级别
+     * @param size 请求大小
+     * @return 级别索引，级别大小不小于请求大小
+     */
+    static int sizeClassOf(size_t size);
+    
+    /**
+     * 尺寸级别对应的块大小
+     */
+    static size_t sizeOfClass(int sizeClass);
+    
     ~MemoryPool();
     
 private:
@@ -86,16 +122,74 @@ private:
     MemoryPool(const MemoryPool&) = delete;
     MemoryPool& operator=(const MemoryPool&) = delete;
     
+    struct ThreadCache;
+    
+    /**
+     * 获取当前线程的缓存，强制清理后旧缓存中的块已被释放，直接丢弃
+     */
+    ThreadCache& threadCache();
+    
+    /**
+     * 把线程缓存中的块全部归还全局池
+     */
+    void returnThreadCache(ThreadCache& cache);
+    
+    /**
+     * 加全局锁，锁被占用时记一次争用
+     */
+    std::unique_lock<std::mutex> lockPool();
+    
+    /**
+     * 从线程缓存归还或直接释放时，在持有全局锁的情况下把块放回空闲链表
+     */
+    void releaseBlockLocked(MemoryBlock* block);
+    
+    /**
+     * 根据块头找到块，2MB对齐的指针（大页映射的块）加锁查块表，不是本池分配的指针返回nullptr
+     */
+    MemoryBlock* blockFromPointer(void* ptr);
+    
     // 内部方法
-    MemoryBlock* findSuitableBlock(size_t size, size_t alignment);
-    void* allocateNewBlock(size_t size, size_t alignment);
-    void cleanupOldBlocks();
-    size_t calculateBlockKey(size_t size, size_t alignment) const;
+    MemoryBlock* findSuitableBlock(int sizeClass, size_t alignment);
+    void* allocateNewBlock(int sizeClass, size_t alignment);
+    void removeFromFreeList(MemoryBlock* block);
+    
+    /**
+     * 释放过期（或强制释放全部）块，调用方必须已持有全局锁
+     * @param force 是否释放全部块，包括正在使用的块
+     */
+    void cleanupOldBlocks(bool force);
+
+    /**
+     * 释放空闲超过maxAge的块（force时释放全部块），调用方必须已持有全局锁
+     */
+    void cleanupBlocks(bool force, std::chrono::steady_clock::duration maxAge);
     
     // 成员变量
     mutable std::mutex mutex_;
-    std::vector<std::unique_ptr<MemoryBlock>> blocks_;
-    std::unordered_map<size_t, std::vector<MemoryBlock*>> sizeMap_;
+    std::unordered_map<void*, std::unique_ptr<MemoryBlock>> blocks_; // 指针 -> 块（持有块记录）
+    std::vector<std::vector<MemoryBlock*>> freeLists_;                // 按尺寸级别的空闲块（后进先出）
+    
+    // 最小级别为64字节，每个2的幂次区间分为4级
+    static constexpr int MIN_CLASS_SHIFT = 6;
+    static constexpr int CLASSES_PER_OCTAVE = 4;
+    // 找不到同级空闲块时最多向上借用的级别数（块大小最多为请求的约2倍）
+    static constexpr int MAX_CLASS_PROMOTION = 3;
+    // 所有块至少按缓存行对齐
+    static constexpr size_t MIN_BLOCK_ALIGNMENT = 64;
+    // 使用线程缓存的级别数（256KB及以下），更大的块直接走全局池，避免被单个线程囤积
+    static constexpr int THREAD_CACHE_CLASSES = (18 - MIN_CLASS_SHIFT) * CLASSES_PER_OCTAVE + 1;
+    // 每个级别的线程缓存容量，满时一次归还一半
+    static constexpr size_t THREAD_CACHE_CAPACITY = 16;
+    static constexpr size_t THREAD_CACHE_BATCH = THREAD_CACHE_CAPACITY / 2;
+    
+    // 线程缓存统计（无锁更新）
+    std::atomic<size_t> threadCacheHits_{0};
+    std::atomic<size_t> threadCacheMisses_{0};
+    std::atomic<size_t> lockContentions_{0};
+    std::atomic<size_t> threadCachedBytes_{0};
+    // 强制清理时递增，使各线程丢弃已失效的缓存
+    std::atomic<unsigned> cacheGeneration_{0};
     
     // 配置参数
     size_t maxPoolSize_ = 256 * 1024 * 1024; // 256MB默认最大池大小
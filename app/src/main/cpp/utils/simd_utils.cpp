@@ -3,39 +3,108 @@
 #include <cstring>
 #include <algorithm>
 
-// 静态成员初始化
-bool SIMDUtils::neonAvailable_ = false;
-bool SIMDUtils::featuresDetected_ = false;
+#if USE_NEON_SIMD && defined(__arm__)
+#include <sys/auxv.h>
+#ifndef HWCAP_NEON
+#define HWCAP_NEON (1 << 12)
+#endif
+#endif
 
 bool SIMDUtils::isNeonAvailable() {
-    if (!featuresDetected_) {
-        detectCpuFeatures();
+    return getSimdLevel() == SimdLevel::NEON;
+}
+
+SimdLevel SIMDUtils::getSimdLevel() {
+    static const SimdLevel level = detectCpuFeatures();
+    return level;
+}
+
+const char* SIMDUtils::getSimdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::NEON:
+            return "NEON";
+        case SimdLevel::SSE41:
+            return "SSE4.1";
+        case SimdLevel::AVX2:
+            return "AVX2";
+        default:
+            return "Scalar";
     }
-    return neonAvailable_;
 }
 
 int SIMDUtils::getOptimalBatchSize() {
-#ifdef USE_NEON_SIMD
-    if (isNeonAvailable()) {
-        return 4; // NEON可以并行处理4个像素
+    switch (getSimdLevel()) {
+        case SimdLevel::NEON:
+            return 16; // NEON每次解交织处理16个像素
+        case SimdLevel::AVX2:
+            return 8;
+        case SimdLevel::SSE41:
+            return 4;
+        default:
+            return 1; // 标量处理
     }
+}
+
+void SIMDUtils::processPixels(
+    const uint8_t* inputPixels,
+    uint8_t* outputPixels,
+    int pixelCount,
+    const LutData& primaryLut,
+    const LutData& secondaryLut,
+    const ProcessingParams& params,
+    const OrderedDitherRow& dither
+) {
+    switch (getSimdLevel()) {
+#if USE_NEON_SIMD
+        case SimdLevel::NEON:
+            processPixelsNeon(inputPixels, outputPixels, pixelCount,
+                              primaryLut, secondaryLut, params, dither);
+            return;
+#endif
+#if USE_X86_SIMD
+        case SimdLevel::AVX2:
+            processPixelsAvx2(inputPixels, outputPixels, pixelCount,
+                              primaryLut, secondaryLut, params, dither);
+            return;
+        case SimdLevel::SSE41:
+            processPixelsSse41(inputPixels, outputPixels, pixelCount,
+                               primaryLut, secondaryLut, params, dither);
+            return;
 #endif
-    return 1; // 标量处理
+        default:
+            processPixelsScalar(inputPixels, outputPixels, pixelCount,
+                                primaryLut, secondaryLut, params, dither);
+            return;
+    }
 }
 
-void SIMDUtils::detectCpuFeatures() {
-#ifdef USE_NEON_SIMD
-    // 在ARM设备上，如果编译时启用了NEON，运行时通常也支持
-    neonAvailable_ = true;
-    LOGD("检测到NEON支持");
+SimdLevel SIMDUtils::detectCpuFeatures() {
+    SimdLevel level = SimdLevel::SCALAR;
+    
+#if USE_NEON_SIMD
+#if defined(__aarch64__)
+    // AArch64架构必定包含Advanced SIMD
+    level = SimdLevel::NEON;
 #else
-    neonAvailable_ = false;
-    LOGD("未检测到NEON支持");
+    // ARMv7需要在运行时确认NEON单元存在
+    if (getauxval(AT_HWCAP) & HWCAP_NEON) {
+        level = SimdLevel::NEON;
+    }
+#endif
+#elif USE_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        level = SimdLevel::AVX2;
+    } else if (__builtin_cpu_supports("sse4.1")) {
+        level = SimdLevel::SSE41;
+    }
 #endif
-    featuresDetected_ = true;
+    
+    LOGD("检测到SIMD级别: %s", getSimdLevelName(level));
+    return level;
 }
 
-#ifdef USE_NEON_SIMD
+#if USE_NEON_SIMD
 
 void SIMDUtils::processPixelsNeon(
     const uint8_t* inputPixels,
@@ -43,129 +112,140 @@ void SIMDUtils::processPixelsNeon(
     int pixelCount,
     const LutData& primaryLut,
     const LutData& secondaryLut,
-    const ProcessingParams& params
+    const ProcessingParams& params,
+    const OrderedDitherRow& dither
 ) {
-    const int batchSize = 4;
+    const int batchSize = 16;
     const int fullBatches = pixelCount / batchSize;
     const int remainingPixels = pixelCount % batchSize;
     
     const uint8_t* input = inputPixels;
     uint8_t* output = outputPixels;
     
-    // 处理完整的4像素批次
+    const bool useSecondaryLut = secondaryLut.isLoaded && params.lut2Strength > 0.0f;
+    const bool useStrength = params.strength < 1.0f;
+    const float32x4_t lut2Strength = vdupq_n_f32(params.lut2Strength);
+    const float32x4_t lut2InvStrength = vdupq_n_f32(1.0f - params.lut2Strength);
+    const float32x4_t strength = vdupq_n_f32(params.strength);
+    const float32x4_t invStrength = vdupq_n_f32(1.0f - params.strength);
+    
+    // 处理完整的16像素批次
     for (int batch = 0; batch < fullBatches; ++batch) {
-        // 转换为浮点RGB
-        float32x4_t r, g, b;
-        convertRgbToFloat4x(input, r, g, b);
+        // ARGB_8888解交织：val[0]=B, val[1]=G, val[2]=R, val[3]=A
+        uint8x16x4_t pixels = vld4q_u8(input);
         
-        // 应用主LUT
-        float32x4_t lutR, lutG, lutB;
-        applyLutNeon4x(r, g, b, lutR, lutG, lutB, primaryLut);
+        float32x4_t r[4], g[4], b[4];
+        widenToFloat16x(pixels.val[2], r);
+        widenToFloat16x(pixels.val[1], g);
+        widenToFloat16x(pixels.val[0], b);
         
-        // 应用次LUT（如果存在）
-        if (secondaryLut.isLoaded && params.lut2Strength > 0.0f) {
-            float32x4_t lut2R, lut2G, lut2B;
-            applyLutNeon4x(lutR, lutG, lutB, lut2R, lut2G, lut2B, secondaryLut);
+        for (int quad = 0; quad < 4; ++quad) {
+            // 应用主LUT
+            float32x4_t lutR, lutG, lutB;
+            applyLutNeon4x(r[quad], g[quad], b[quad], lutR, lutG, lutB, primaryLut,
+                           params.interpolationMode);
             
-            // 混合两个LUT的结果
-            float32x4_t strength = vdupq_n_f32(params.lut2Strength);
-            float32x4_t invStrength = vsubq_f32(vdupq_n_f32(1.0f), strength);
+            // 应用次LUT（如果存在）并混合两个LUT的结果
+            if (useSecondaryLut) {
+                float32x4_t lut2R, lut2G, lut2B;
+                applyLutNeon4x(lutR, lutG, lutB, lut2R, lut2G, lut2B, secondaryLut,
+                               params.interpolationMode);
+                
+                lutR = vmlaq_f32(vmulq_f32(lutR, lut2InvStrength), lut2R, lut2Strength);
+                lutG = vmlaq_f32(vmulq_f32(lutG, lut2InvStrength), lut2G, lut2Strength);
+                lutB = vmlaq_f32(vmulq_f32(lutB, lut2InvStrength), lut2B, lut2Strength);
+            }
             
-            lutR = vmlaq_f32(vmulq_f32(lutR, invStrength), lut2R, strength);
-            lutG = vmlaq_f32(vmulq_f32(lutG, invStrength), lut2G, strength);
-            lutB = vmlaq_f32(vmulq_f32(lutB, invStrength), lut2B, strength);
-        }
-        
-        // 应用强度混合
-        if (params.strength < 1.0f) {
-            float32x4_t strength = vdupq_n_f32(params.strength);
-            float32x4_t invStrength = vsubq_f32(vdupq_n_f32(1.0f), strength);
+            // 应用强度混合
+            if (useStrength) {
+                lutR = vmlaq_f32(vmulq_f32(r[quad], invStrength), lutR, strength);
+                lutG = vmlaq_f32(vmulq_f32(g[quad], invStrength), lutG, strength);
+                lutB = vmlaq_f32(vmulq_f32(b[quad], invStrength), lutB, strength);
+            }
             
-            lutR = vmlaq_f32(vmulq_f32(r, invStrength), lutR, strength);
-            lutG = vmlaq_f32(vmulq_f32(g, invStrength), lutG, strength);
-            lutB = vmlaq_f32(vmulq_f32(b, invStrength), lutB, strength);
+            // 限制范围
+            r[quad] = clampNeon(lutR);
+            g[quad] = clampNeon(lutG);
+            b[quad] = clampNeon(lutB);
         }
         
-        // 限制范围
-        lutR = clampNeon(lutR);
-        lutG = clampNeon(lutG);
-        lutB = clampNeon(lutB);
+        // 收窄回8位并交织存储，Alpha通道原样写回；有序抖动的阈值在此处代替0.5
+        float32x4_t offsets[4];
+        loadQuantizeOffsets16x(dither, batch * batchSize, offsets);
+        pixels.val[2] = narrowToU8x16(r, offsets);
+        pixels.val[1] = narrowToU8x16(g, offsets);
+        pixels.val[0] = narrowToU8x16(b, offsets);
+        vst4q_u8(output, pixels);
         
-        // 转换回RGB并存储
-        convertFloatToRgb4x(lutR, lutG, lutB, output);
-        
-        input += 16; // 4像素 * 4字节
-        output += 16;
+        input += 64; // 16像素 * 4字节
+        output += 64;
     }
     
     // 处理剩余像素（标量方式）
     if (remainingPixels > 0) {
         processPixelsScalar(
             input, output, remainingPixels,
-            primaryLut, secondaryLut, params
+            primaryLut, secondaryLut, params,
+            dither.advanced(fullBatches * batchSize)
         );
     }
 }
 
-void SIMDUtils::convertRgbToFloat4x(
-    const uint8_t* rgbPixels,
-    float32x4_t& r,
-    float32x4_t& g,
-    float32x4_t& b
+void SIMDUtils::widenToFloat16x(
+    const uint8x16_t& channel,
+    float32x4_t out[4]
 ) {
-    // 简化NEON实现，直接使用标量方式提取RGB值
-    // uint8x4_t在某些NDK版本中不可用，改用直接内存访问
-    // 简化实现：直接访问内存
-    uint8_t r_vals[4] = {rgbPixels[2], rgbPixels[6], rgbPixels[10], rgbPixels[14]};
-    uint8_t g_vals[4] = {rgbPixels[1], rgbPixels[5], rgbPixels[9], rgbPixels[13]};
-    uint8_t b_vals[4] = {rgbPixels[0], rgbPixels[4], rgbPixels[8], rgbPixels[12]};
-    
-    // 转换为浮点并归一化
-    uint16x4_t r_u16 = vget_low_u16(vmovl_u8(vld1_u8(r_vals)));
-    uint16x4_t g_u16 = vget_low_u16(vmovl_u8(vld1_u8(g_vals)));
-    uint16x4_t b_u16 = vget_low_u16(vmovl_u8(vld1_u8(b_vals)));
-    
-    uint32x4_t r_u32 = vmovl_u16(r_u16);
-    uint32x4_t g_u32 = vmovl_u16(g_u16);
-    uint32x4_t b_u32 = vmovl_u16(b_u16);
-    
-    r = vmulq_f32(vcvtq_f32_u32(r_u32), vdupq_n_f32(1.0f / 255.0f));
-    g = vmulq_f32(vcvtq_f32_u32(g_u32), vdupq_n_f32(1.0f / 255.0f));
-    b = vmulq_f32(vcvtq_f32_u32(b_u32), vdupq_n_f32(1.0f / 255.0f));
+    const float32x4_t scale = vdupq_n_f32(1.0f / 255.0f);
+    
+    const uint16x8_t low = vmovl_u8(vget_low_u8(channel));
+    const uint16x8_t high = vmovl_u8(vget_high_u8(channel));
+    
+    out[0] = vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(low))), scale);
+    out[1] = vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(low))), scale);
+    out[2] = vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(high))), scale);
+    out[3] = vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(high))), scale);
 }
 
-void SIMDUtils::convertFloatToRgb4x(
-    const float32x4_t& r,
-    const float32x4_t& g,
-    const float32x4_t& b,
-    uint8_t* rgbPixels
+uint8x16_t SIMDUtils::narrowToU8x16(
+    const float32x4_t in[4],
+    const float32x4_t offset[4]
 ) {
-    // 转换为8位整数
-    uint32x4_t r_u32 = vcvtq_u32_f32(vmulq_f32(r, vdupq_n_f32(255.0f)));
-    uint32x4_t g_u32 = vcvtq_u32_f32(vmulq_f32(g, vdupq_n_f32(255.0f)));
-    uint32x4_t b_u32 = vcvtq_u32_f32(vmulq_f32(b, vdupq_n_f32(255.0f)));
-    
-    uint16x4_t r_u16 = vmovn_u32(r_u32);
-    uint16x4_t g_u16 = vmovn_u32(g_u32);
-    uint16x4_t b_u16 = vmovn_u32(b_u32);
-    
-    uint8x8_t r_u8 = vmovn_u16(vcombine_u16(r_u16, r_u16));
-    uint8x8_t g_u8 = vmovn_u16(vcombine_u16(g_u16, g_u16));
-    uint8x8_t b_u8 = vmovn_u16(vcombine_u16(b_u16, b_u16));
-    
-    // 简化实现：直接写入内存
-    uint8_t r_vals[4], g_vals[4], b_vals[4];
-    vst1_u8(r_vals, r_u8);
-    vst1_u8(g_vals, g_u8);
-    vst1_u8(b_vals, b_u8);
-    
-    // 组装ARGB像素
-    for (int i = 0; i < 4; ++i) {
-        rgbPixels[i * 4 + 0] = b_vals[i]; // B
-        rgbPixels[i * 4 + 1] = g_vals[i]; // G
-        rgbPixels[i * 4 + 2] = r_vals[i]; // R
-        rgbPixels[i * 4 + 3] = rgbPixels[i * 4 + 3]; // 保持Alpha
+    const float32x4_t scale = vdupq_n_f32(255.0f);
+    
+    // 与标量路径一致：value * 255 + offset 后截断
+    const uint32x4_t v0 = vcvtq_u32_f32(vmlaq_f32(offset[0], in[0], scale));
+    const uint32x4_t v1 = vcvtq_u32_f32(vmlaq_f32(offset[1], in[1], scale));
+    const uint32x4_t v2 = vcvtq_u32_f32(vmlaq_f32(offset[2], in[2], scale));
+    const uint32x4_t v3 = vcvtq_u32_f32(vmlaq_f32(offset[3], in[3], scale));
+    
+    const uint16x8_t low = vcombine_u16(vqmovn_u32(v0), vqmovn_u32(v1));
+    const uint16x8_t high = vcombine_u16(vqmovn_u32(v2), vqmovn_u32(v3));
+    
+    return vcombine_u8(vqmovn_u16(low), vqmovn_u16(high));
+}
+
+void SIMDUtils::loadQuantizeOffsets16x(
+    const OrderedDitherRow& dither,
+    int pixel,
+    float32x4_t out[4]
+) {
+    if (!dither.enabled()) {
+        const float32x4_t half = vdupq_n_f32(0.5f);
+        out[0] = out[1] = out[2] = out[3] = half;
+        return;
     }
+    
+    // (threshold + 0.5) / 256
+    const float32x4_t scale = vdupq_n_f32(1.0f / 256.0f);
+    const float32x4_t bias = vdupq_n_f32(0.5f / 256.0f);
+    const uint8x16_t thresholds = vld1q_u8(dither.at(pixel));
+    const uint16x8_t low = vmovl_u8(vget_low_u8(thresholds));
+    const uint16x8_t high = vmovl_u8(vget_high_u8(thresholds));
+    
+    out[0] = vmlaq_f32(bias, vcvtq_f32_u32(vmovl_u16(vget_low_u16(low))), scale);
+    out[1] = vmlaq_f32(bias, vcvtq_f32_u32(vmovl_u16(vget_high_u16(low))), scale);
+    out[2] = vmlaq_f32(bias, vcvtq_f32_u32(vmovl_u16(vget_low_u16(high))), scale);
+    out[3] = vmlaq_f32(bias, vcvtq_f32_u32(vmovl_u16(vget_high_u16(high))), scale);
 }
 
 void SIMDUtils::applyLutNeon4x(
@@ -175,7 +255,8 @@ void SIMDUtils::applyLutNeon4x(
     float32x4_t& outR,
     float32x4_t& outG,
     float32x4_t& outB,
-    const LutData& lutData
+    const LutData& lutData,
+    int interpolationMode
 ) {
     if (!lutData.isLoaded || lutData.data.empty()) {
         outR = r;
@@ -184,6 +265,12 @@ void SIMDUtils::applyLutNeon4x(
         return;
     }
     
+    if (interpolationMode == 1 && lutData.size >= 2) {
+        // 使用四面体插值
+        tetrahedralInterpolationNeon4x(r, g, b, lutData, outR, outG, outB);
+        return;
+    }
+    
     // 使用三线性插值
     trilinearInterpolationNeon4x(r, g, b, lutData, outR, outG, outB);
 }
@@ -240,6 +327,68 @@ void SIMDUtils::memsetNeon(void* dst, uint8_t value, size_t bytes) {
     }
 }
 
+void SIMDUtils::getLutValuesNeon4x(
+    const uint32x4_t& indices,
+    const LutData& lutData,
+    float32x4_t& outR,
+    float32x4_t& outG,
+    float32x4_t& outB
+) {
+    const float* lut = lutData.data.data();
+    const float* p0 = lut + vgetq_lane_u32(indices, 0);
+    const float* p1 = lut + vgetq_lane_u32(indices, 1);
+    const float* p2 = lut + vgetq_lane_u32(indices, 2);
+    const float* p3 = lut + vgetq_lane_u32(indices, 3);
+    
+    // 逐通道读取顶点并直接装入对应通道
+    outR = vld1q_dup_f32(p0 + 0);
+    outG = vld1q_dup_f32(p0 + 1);
+    outB = vld1q_dup_f32(p0 + 2);
+    
+    outR = vld1q_lane_f32(p1 + 0, outR, 1);
+    outG = vld1q_lane_f32(p1 + 1, outG, 1);
+    outB = vld1q_lane_f32(p1 + 2, outB, 1);
+    
+    outR = vld1q_lane_f32(p2 + 0, outR, 2);
+    outG = vld1q_lane_f32(p2 + 1, outG, 2);
+    outB = vld1q_lane_f32(p2 + 2, outB, 2);
+    
+    outR = vld1q_lane_f32(p3 + 0, outR, 3);
+    outG = vld1q_lane_f32(p3 + 1, outG, 3);
+    outB = vld1q_lane_f32(p3 + 2, outB, 3);
+}
+
+uint32x4_t SIMDUtils::calculateLutIndicesNeon(
+    const float32x4_t& r,
+    const float32x4_t& g,
+    const float32x4_t& b,
+    int lutSize,
+    float32x4_t& dx,
+    float32x4_t& dy,
+    float32x4_t& dz
+) {
+    const float32x4_t maxIndex = vdupq_n_f32(static_cast<float>(lutSize - 1));
+    const uint32x4_t maxBase = vdupq_n_u32(static_cast<uint32_t>(lutSize - 2));
+    
+    // 限制到[0,1]后映射到索引空间
+    const float32x4_t fx = vmulq_f32(clampNeon(r), maxIndex);
+    const float32x4_t fy = vmulq_f32(clampNeon(g), maxIndex);
+    const float32x4_t fz = vmulq_f32(clampNeon(b), maxIndex);
+    
+    const uint32x4_t x0 = vminq_u32(vcvtq_u32_f32(fx), maxBase);
+    const uint32x4_t y0 = vminq_u32(vcvtq_u32_f32(fy), maxBase);
+    const uint32x4_t z0 = vminq_u32(vcvtq_u32_f32(fz), maxBase);
+    
+    dx = vsubq_f32(fx, vcvtq_f32_u32(x0));
+    dy = vsubq_f32(fy, vcvtq_f32_u32(y0));
+    dz = vsubq_f32(fz, vcvtq_f32_u32(z0));
+    
+    // 索引 = (x0*size*size + y0*size + z0) * 3
+    const uint32x4_t sizeVec = vdupq_n_u32(static_cast<uint32_t>(lutSize));
+    const uint32x4_t index = vmlaq_u32(z0, vmlaq_u32(y0, x0, sizeVec), sizeVec);
+    return vmulq_n_u32(index, 3);
+}
+
 void SIMDUtils::trilinearInterpolationNeon4x(
     const float32x4_t& x,
     const float32x4_t& y,
@@ -249,26 +398,108 @@ void SIMDUtils::trilinearInterpolationNeon4x(
     float32x4_t& outG,
     float32x4_t& outB
 ) {
-    // 简化实现：回退到标量版本
-    // 完整的NEON三线性插值实现较为复杂，这里提供基础框架
-    float x_vals[4], y_vals[4], z_vals[4];
-    float r_vals[4], g_vals[4], b_vals[4];
-    
-    vst1q_f32(x_vals, x);
-    vst1q_f32(y_vals, y);
-    vst1q_f32(z_vals, z);
-    
-    for (int i = 0; i < 4; ++i) {
-        LutProcessor::applyLut(
-            x_vals[i], y_vals[i], z_vals[i],
-            r_vals[i], g_vals[i], b_vals[i],
-            lutData
-        );
+    const int size = lutData.size;
+    if (size < 2) {
+        // 单节点LUT没有插值区间，直接输出该节点
+        outR = vdupq_n_f32(lutData.data[0]);
+        outG = vdupq_n_f32(lutData.data[1]);
+        outB = vdupq_n_f32(lutData.data[2]);
+        return;
+    }
+    
+    float32x4_t dx, dy, dz;
+    const uint32x4_t base = calculateLutIndicesNeon(x, y, z, size, dx, dy, dz);
+    
+    const uint32_t strideR = static_cast<uint32_t>(size * size * 3);
+    const uint32_t strideG = static_cast<uint32_t>(size * 3);
+    const uint32_t strideB = 3;
+    
+    // 读取8个顶点，corner的bit2/bit1/bit0分别对应x/y/z方向+1
+    float32x4_t c[8][3];
+    for (int corner = 0; corner < 8; ++corner) {
+        const uint32_t offset = ((corner & 4) ? strideR : 0) +
+                                ((corner & 2) ? strideG : 0) +
+                                ((corner & 1) ? strideB : 0);
+        getLutValuesNeon4x(vaddq_u32(base, vdupq_n_u32(offset)), lutData,
+                           c[corner][0], c[corner][1], c[corner][2]);
     }
     
-    outR = vld1q_f32(r_vals);
-    outG = vld1q_f32(g_vals);
-    outB = vld1q_f32(b_vals);
+    // 三线性插值：先沿x，再沿y，最后沿z
+    float32x4_t result[3];
+    for (int channel = 0; channel < 3; ++channel) {
+        const float32x4_t c00 = lerpNeon(c[0][channel], c[4][channel], dx);
+        const float32x4_t c01 = lerpNeon(c[1][channel], c[5][channel], dx);
+        const float32x4_t c10 = lerpNeon(c[2][channel], c[6][channel], dx);
+        const float32x4_t c11 = lerpNeon(c[3][channel], c[7][channel], dx);
+        
+        const float32x4_t c0 = lerpNeon(c00, c10, dy);
+        const float32x4_t c1 = lerpNeon(c01, c11, dy);
+        
+        result[channel] = lerpNeon(c0, c1, dz);
+    }
+    
+    outR = result[0];
+    outG = result[1];
+    outB = result[2];
+}
+
+void SIMDUtils::tetrahedralInterpolationNeon4x(
+    const float32x4_t& x,
+    const float32x4_t& y,
+    const float32x4_t& z,
+    const LutData& lutData,
+    float32x4_t& outR,
+    float32x4_t& outG,
+    float32x4_t& outB
+) {
+    const int size = lutData.size;
+    
+    float32x4_t dx, dy, dz;
+    const uint32x4_t base = calculateLutIndicesNeon(x, y, z, size, dx, dy, dz);
+    
+    const uint32x4_t strideR = vdupq_n_u32(static_cast<uint32_t>(size * size * 3));
+    const uint32x4_t strideG = vdupq_n_u32(static_cast<uint32_t>(size * 3));
+    const uint32x4_t strideB = vdupq_n_u32(3);
+    const uint32x4_t strideAll = vaddq_u32(vaddq_u32(strideR, strideG), strideB);
+    
+    // 按小数部分排序得到权重 w1 >= w2 >= w3
+    const float32x4_t w1 = vmaxq_f32(vmaxq_f32(dx, dy), dz);
+    const float32x4_t w3 = vminq_f32(vminq_f32(dx, dy), dz);
+    const float32x4_t w2 = vmaxq_f32(vminq_f32(dx, dy), vminq_f32(vmaxq_f32(dx, dy), dz));
+    
+    // 路径 c000 -> c000+最大轴 -> c111-最小轴 -> c111，
+    // 最大轴优先x、最小轴优先取非x，保证两者在相等时也不会选到同一轴
+    const uint32x4_t xIsMax = vandq_u32(vcgeq_f32(dx, dy), vcgeq_f32(dx, dz));
+    const uint32x4_t yIsMax = vcgeq_f32(dy, dz);
+    const uint32x4_t xIsMin = vandq_u32(vcltq_f32(dx, dy), vcltq_f32(dx, dz));
+    const uint32x4_t yIsMin = vcltq_f32(dy, dz);
+    
+    const uint32x4_t offsetMax = vbslq_u32(xIsMax, strideR, vbslq_u32(yIsMax, strideG, strideB));
+    const uint32x4_t offsetMin = vbslq_u32(xIsMin, strideR, vbslq_u32(yIsMin, strideG, strideB));
+    
+    float32x4_t c0[3], c1[3], c2[3], c3[3];
+    getLutValuesNeon4x(base, lutData, c0[0], c0[1], c0[2]);
+    getLutValuesNeon4x(vaddq_u32(base, offsetMax), lutData, c1[0], c1[1], c1[2]);
+    getLutValuesNeon4x(vsubq_u32(vaddq_u32(base, strideAll), offsetMin), lutData,
+                       c2[0], c2[1], c2[2]);
+    getLutValuesNeon4x(vaddq_u32(base, strideAll), lutData, c3[0], c3[1], c3[2]);
+    
+    // 重心坐标权重
+    const float32x4_t k0 = vsubq_f32(vdupq_n_f32(1.0f), w1);
+    const float32x4_t k1 = vsubq_f32(w1, w2);
+    const float32x4_t k2 = vsubq_f32(w2, w3);
+    
+    float32x4_t result[3];
+    for (int channel = 0; channel < 3; ++channel) {
+        float32x4_t sum = vmulq_f32(c0[channel], k0);
+        sum = vmlaq_f32(sum, c1[channel], k1);
+        sum = vmlaq_f32(sum, c2[channel], k2);
+        result[channel] = vmlaq_f32(sum, c3[channel], w3);
+    }
+    
+    outR = result[0];
+    outG = result[1];
+    outB = result[2];
 }
 
 #endif // USE_NEON_SIMD
@@ -279,7 +510,8 @@ void SIMDUtils::processPixelsScalar(
     int pixelCount,
     const LutData& primaryLut,
     const LutData& secondaryLut,
-    const ProcessingParams& params
+    const ProcessingParams& params,
+    const OrderedDitherRow& dither
 ) {
     const int bytesPerPixel = 4;
     
@@ -299,12 +531,14 @@ void SIMDUtils::processPixelsScalar(
         
         // 应用主LUT
         float lutR, lutG, lutB;
-        LutProcessor::applyLut(r, g, b, lutR, lutG, lutB, primaryLut);
+        LutProcessor::applyLut(r, g, b, lutR, lutG, lutB, primaryLut,
+                               params.interpolationMode);
         
         // 应用第二LUT（如果存在）
         if (secondaryLut.isLoaded && params.lut2Strength > 0.0f) {
             float lut2R, lut2G, lut2B;
-            LutProcessor::applyLut(lutR, lutG, lutB, lut2R, lut2G, lut2B, secondaryLut);
+            LutProcessor::applyLut(lutR, lutG, lutB, lut2R, lut2G, lut2B, secondaryLut,
+                                   params.interpolationMode);
             
             // 混合两个LUT的结果
             lutR = lutR * (1.0f - params.lut2Strength) + lut2R * params.lut2Strength;
@@ -324,9 +558,12 @@ void SIMDUtils::processPixelsScalar(
         lutG = std::clamp(lutG, 0.0f, 1.0f);
         lutB = std::clamp(lutB, 0.0f, 1.0f);
         
+        // 不抖动时为0.5（四舍五入），有序抖动时为该像素的阈值
+        const float quantizeOffset = dither.offset(i);
+        
         outputPixels[offset + 3] = alpha; // 保持Alpha通道
-        outputPixels[offset + 2] = static_cast<uint8_t>(lutR * 255.0f + 0.5f);
-        outputPixels[offset + 1] = static_cast<uint8_t>(lutG * 255.0f + 0.5f);
-        outputPixels[offset + 0] = static_cast<uint8_t>(lutB * 255.0f + 0.5f);
+        outputPixels[offset + 2] = static_cast<uint8_t>(lutR * 255.0f + quantizeOffset);
+        outputPixels[offset + 1] = static_cast<uint8_t>(lutG * 255.0f + quantizeOffset);
+        outputPixels[offset + 0] = static_cast<uint8_t>(lutB * 255.0f + quantizeOffset);
     }
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define SIMD_UTILS_H
 
 #include "../include/native_lut_processor.h"
+#include "dither_matrix.h"
 #include <cstdint>
 
 // 检测NEON支持
@@ -12,9 +13,27 @@
 #define USE_NEON_SIMD 0
 #endif
 
+// 检测x86架构（AVX2/SSE4.1内核按函数目标属性编译，运行时再根据CPU特性分派）
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define USE_X86_SIMD 1
+#else
+#define USE_X86_SIMD 0
+#endif
+
+/**
+ * 运行时选择的SIMD级别
+ */
+enum class SimdLevel {
+    SCALAR = 0,
+    NEON = 1,
+    SSE41 = 2,
+    AVX2 = 3
+};
+
 /**
  * SIMD优化工具类
- * 提供ARM NEON指令集优化的图片处理功能
+ * 提供ARM NEON与x86 SSE4.1/AVX2指令集优化的图片处理功能
  */
 class SIMDUtils {
 public:
@@ -24,13 +43,110 @@ public:
      */
     static bool isNeonAvailable();
     
+    /**
+     * 获取运行时检测到的SIMD级别（首次调用时检测，线程安全）
+     * @return SIMD级别
+     */
+    static SimdLevel getSimdLevel();
+    
+    /**
+     * 获取SIMD级别名称
+     * @param level SIMD级别
+     * @return 名称字符串
+     */
+    static const char* getSimdLevelName(SimdLevel level);
+    
     /**
      * 获取SIMD处理的最优批次大小
      * @return 像素数量
      */
     static int getOptimalBatchSize();
     
-#ifdef USE_NEON_SIMD
+    /**
+     * 像素批处理，按运行时SIMD级别分派到对应内核
+     * @param inputPixels 输入像素数据
+     * @param outputPixels 输出像素数据
+     * @param pixelCount 像素数量
+     * @param primaryLut 主LUT数据
+     * @param secondaryLut 次LUT数据
+     * @param params 处理参数
+     * @param dither 有序抖动阈值行（不抖动时为空）
+     */
+    static void processPixels(
+        const uint8_t* inputPixels,
+        uint8_t* outputPixels,
+        int pixelCount,
+        const LutData& primaryLut,
+        const LutData& secondaryLut,
+        const ProcessingParams& params,
+        const OrderedDitherRow& dither = OrderedDitherRow()
+    );
+    
+    /**
+     * 标量版本的像素处理（回退实现，也是各SIMD内核的对照基准）
+     * @param inputPixels 输入像素数据
+     * @param outputPixels 输出像素数据
+     * @param pixelCount 像素数量
+     * @param primaryLut 主LUT数据
+     * @param secondaryLut 次LUT数据
+     * @param params 处理参数
+     * @param dither 有序抖动阈值行（不抖动时为空）
+     */
+    static void processPixelsScalar(
+        const uint8_t* inputPixels,
+        uint8_t* outputPixels,
+        int pixelCount,
+        const LutData& primaryLut,
+        const LutData& secondaryLut,
+        const ProcessingParams& params,
+        const OrderedDitherRow& dither = OrderedDitherRow()
+    );
+    
+#if USE_X86_SIMD
+    /**
+     * 使用AVX2优化的像素批处理（每次8个像素，顶点通过gather读取）
+     * 调用前需确认CPU支持AVX2
+     * @param inputPixels 输入像素数据
+     * @param outputPixels 输出像素数据
+     * @param pixelCount 像素数量
+     * @param primaryLut 主LUT数据
+     * @param secondaryLut 次LUT数据
+     * @param params 处理参数
+     * @param dither 有序抖动阈值行（不抖动时为空）
+     */
+    static void processPixelsAvx2(
+        const uint8_t* inputPixels,
+        uint8_t* outputPixels,
+        int pixelCount,
+        const LutData& primaryLut,
+        const LutData& secondaryLut,
+        const ProcessingParams& params,
+        const OrderedDitherRow& dither = OrderedDitherRow()
+    );
+    
+    /**
+     * 使用SSE4.1优化的像素批处理（每次4个像素）
+     * 调用前需确认CPU支持SSE4.1
+     * @param inputPixels 输入像素数据
+     * @param outputPixels 输出像素数据
+     * @param pixelCount 像素数量
+     * @param primaryLut 主LUT数据
+     * @param secondaryLut 次LUT数据
+     * @param params 处理参数
+     * @param dither 有序抖动阈值行（不抖动时为空）
+     */
+    static void processPixelsSse41(
+        const uint8_t* inputPixels,
+        uint8_t* outputPixels,
+        int pixelCount,
+        const LutData& primaryLut,
+        const LutData& secondaryLut,
+        const ProcessingParams& params,
+        const OrderedDitherRow& dither = OrderedDitherRow()
+    );
+#endif // USE_X86_SIMD
+    
+#if USE_NEON_SIMD
     /**
      * 使用NEON优化的像素批处理
      * @param inputPixels 输入像素数据
@@ -39,6 +155,7 @@ public:
      * @param primaryLut 主LUT数据
      * @param secondaryLut 次LUT数据
      * @param params 处理参数
+     * @param dither 有序抖动阈值行（不抖动时为空）
      */
     static void processPixelsNeon(
         const uint8_t* inputPixels,
@@ -46,31 +163,43 @@ public:
         int pixelCount,
         const LutData& primaryLut,
         const LutData& secondaryLut,
-        const ProcessingParams& params
+        const ProcessingParams& params,
+        const OrderedDitherRow& dither = OrderedDitherRow()
     );
     
     /**
-     * NEON优化的RGB到浮点转换
-     * @param rgbPixels 输入RGB像素（4个像素，16字节）
-     * @param r, g, b 输出浮点数组（4个元素）
+     * NEON优化的8位通道到浮点转换（16个像素）
+     * 在寄存器内逐级扩宽 u8 -> u16 -> u32 -> f32，并归一化到[0,1]
+     * @param channel 16个像素的单通道值（vld4q_u8解交织后的一个通道）
+     * @param out 输出4组浮点向量，按像素顺序每组4个
      */
-    static void convertRgbToFloat4x(
-        const uint8_t* rgbPixels,
-        float32x4_t& r,
-        float32x4_t& g,
-        float32x4_t& b
+    static void widenToFloat16x(
+        const uint8x16_t& channel,
+        float32x4_t out[4]
     );
     
     /**
-     * NEON优化的浮点到RGB转换
-     * @param r, g, b 输入浮点数组（4个元素）
-     * @param rgbPixels 输出RGB像素（4个像素，16字节）
+     * NEON优化的浮点到8位通道转换（16个像素）
+     * 加上量化偏移后截断并饱和收窄 f32 -> u32 -> u16 -> u8
+     * @param in 输入4组浮点向量（已限制到[0,1]）
+     * @param offset 每个像素的量化偏移（四舍五入时为0.5，有序抖动时为阈值）
+     * @return 16个像素的单通道值
      */
-    static void convertFloatToRgb4x(
-        const float32x4_t& r,
-        const float32x4_t& g,
-        const float32x4_t& b,
-        uint8_t* rgbPixels
+    static uint8x16_t narrowToU8x16(
+        const float32x4_t in[4],
+        const float32x4_t offset[4]
+    );
+    
+    /**
+     * 读取16个像素的量化偏移：不抖动时为0.5，有序抖动时为 (阈值 + 0.5) / 256
+     * @param dither 有序抖动阈值行
+     * @param pixel 第一个像素的索引
+     * @param out 输出4组偏移向量
+     */
+    static void loadQuantizeOffsets16x(
+        const OrderedDitherRow& dither,
+        int pixel,
+        float32x4_t out[4]
     );
     
     /**
@@ -78,6 +207,7 @@ public:
      * @param r, g, b 输入RGB浮点值
      * @param outR, outG, outB 输出RGB浮点值
      * @param lutData LUT数据
+     * @param interpolationMode 插值模式（0=三线性，1=四面体）
      */
     static void applyLutNeon4x(
         const float32x4_t& r,
@@ -86,7 +216,8 @@ public:
         float32x4_t& outR,
         float32x4_t& outG,
         float32x4_t& outB,
-        const LutData& lutData
+        const LutData& lutData,
+        int interpolationMode = 0
     );
     
     /**
@@ -153,7 +284,8 @@ public:
 private:
     /**
      * 获取LUT中指定位置的值（NEON优化）
-     * @param indices 索引数组（4个元素）
+     * 各通道的顶点地址互不相关，这是插值中唯一保留逐通道读取的步骤
+     * @param indices 4个通道在数据数组中的偏移（已乘以3）
      * @param lutData LUT数据
      * @param outR, outG, outB 输出RGB值
      */
@@ -166,16 +298,21 @@ private:
     );
     
     /**
-     * 计算LUT索引（NEON优化）
+     * 计算LUT基准顶点偏移与小数部分（NEON优化）
+     * 基准顶点限制在[0, size-2]，保证+1的邻居总是有效，边界处小数部分为1
      * @param r, g, b 输入RGB值
-     * @param lutSize LUT尺寸
-     * @return 线性索引
+     * @param lutSize LUT尺寸（至少为2）
+     * @param dx, dy, dz 输出各轴小数部分
+     * @return 基准顶点在数据数组中的偏移（已乘以3）
      */
     static uint32x4_t calculateLutIndicesNeon(
         const float32x4_t& r,
         const float32x4_t& g,
         const float32x4_t& b,
-        int lutSize
+        int lutSize,
+        float32x4_t& dx,
+        float32x4_t& dy,
+        float32x4_t& dz
     );
     
     /**
@@ -194,33 +331,30 @@ private:
         float32x4_t& outB
     );
     
-#endif // USE_NEON_SIMD
-    
     /**
-     * 标量版本的像素处理（回退实现）
-     * @param inputPixels 输入像素数据
-     * @param outputPixels 输出像素数据
-     * @param pixelCount 像素数量
-     * @param primaryLut 主LUT数据
-     * @param secondaryLut 次LUT数据
-     * @param params 处理参数
+     * NEON优化的四面体插值
+     * 四面体选择通过比较掩码无分支完成，每个像素只读取4个顶点
+     * @param x, y, z 插值坐标
+     * @param lutData LUT数据
+     * @param outR, outG, outB 输出RGB值
      */
-    static void processPixelsScalar(
-        const uint8_t* inputPixels,
-        uint8_t* outputPixels,
-        int pixelCount,
-        const LutData& primaryLut,
-        const LutData& secondaryLut,
-        const ProcessingParams& params
+    static void tetrahedralInterpolationNeon4x(
+        const float32x4_t& x,
+        const float32x4_t& y,
+        const float32x4_t& z,
+        const LutData& lutData,
+        float32x4_t& outR,
+        float32x4_t& outG,
+        float32x4_t& outB
     );
     
+#endif // USE_NEON_SIMD
+    
     /**
      * 检测CPU特性
+     * @return 可用的最高SIMD级别
      */
-    static void detectCpuFeatures();
-    
-    static bool neonAvailable_;
-    static bool featuresDetected_;
+    static SimdLevel detectCpuFeatures();
 };
 
 /**
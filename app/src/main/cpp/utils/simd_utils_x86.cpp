@@ -0,0 +1,518 @@
+#include "simd_utils.h"
+#include <cstring>
+
+#if USE_X86_SIMD
+
+// x86内核按函数目标属性单独启用AVX2/SSE4.1，整个工程无需-mavx2编译，
+// 由SIMDUtils::processPixels在运行时确认CPU特性后才会调用
+#define X86_TARGET_AVX2 __attribute__((target("avx2")))
+#define X86_TARGET_SSE41 __attribute__((target("sse4.1")))
+
+namespace {
+
+// ==================== AVX2（8像素） ====================
+
+X86_TARGET_AVX2
+inline __m256 clampAvx2(__m256 values) {
+    return _mm256_min_ps(_mm256_max_ps(values, _mm256_setzero_ps()), _mm256_set1_ps(1.0f));
+}
+
+X86_TARGET_AVX2
+inline __m256 lerpAvx2(__m256 a, __m256 b, __m256 t) {
+    return _mm256_add_ps(a, _mm256_mul_ps(_mm256_sub_ps(b, a), t));
+}
+
+/**
+ * 8个像素的量化偏移：不抖动时为0.5，有序抖动时为 (阈值 + 0.5) / 256
+ */
+X86_TARGET_AVX2
+inline __m256 quantizeOffsetsAvx2(const OrderedDitherRow &dither, int pixel) {
+    if (!dither.enabled()) {
+        return _mm256_set1_ps(0.5f);
+    }
+    const __m128i thresholds = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(dither.at(pixel)));
+    return _mm256_add_ps(
+            _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(thresholds)),
+                          _mm256_set1_ps(1.0f / 256.0f)),
+            _mm256_set1_ps(0.5f / 256.0f));
+}
+
+/**
+ * 计算基准顶点偏移（已乘以3）与各轴小数部分
+ * 基准顶点限制在[0, size-2]，边界处小数部分为1
+ */
+X86_TARGET_AVX2
+inline __m256i lutIndicesAvx2(
+        __m256 r, __m256 g, __m256 b, int size,
+        __m256 &dx, __m256 &dy, __m256 &dz
+) {
+    const __m256 maxIndex = _mm256_set1_ps(static_cast<float>(size - 1));
+    const __m256i maxBase = _mm256_set1_epi32(size - 2);
+
+    const __m256 fx = _mm256_mul_ps(clampAvx2(r), maxIndex);
+    const __m256 fy = _mm256_mul_ps(clampAvx2(g), maxIndex);
+    const __m256 fz = _mm256_mul_ps(clampAvx2(b), maxIndex);
+
+    const __m256i x0 = _mm256_min_epi32(_mm256_cvttps_epi32(fx), maxBase);
+    const __m256i y0 = _mm256_min_epi32(_mm256_cvttps_epi32(fy), maxBase);
+    const __m256i z0 = _mm256_min_epi32(_mm256_cvttps_epi32(fz), maxBase);
+
+    dx = _mm256_sub_ps(fx, _mm256_cvtepi32_ps(x0));
+    dy = _mm256_sub_ps(fy, _mm256_cvtepi32_ps(y0));
+    dz = _mm256_sub_ps(fz, _mm256_cvtepi32_ps(z0));
+
+    // 索引 = (x0*size*size + y0*size + z0) * 3
+    const __m256i sizeVec = _mm256_set1_epi32(size);
+    const __m256i index = _mm256_add_epi32(
+            _mm256_mullo_epi32(_mm256_add_epi32(_mm256_mullo_epi32(x0, sizeVec), y0), sizeVec),
+            z0);
+    return _mm256_mullo_epi32(index, _mm256_set1_epi32(3));
+}
+
+/**
+ * 通过gather读取8个顶点的RGB分量
+ */
+X86_TARGET_AVX2
+inline void gatherAvx2(const float *lut, __m256i index, __m256 &outR, __m256 &outG, __m256 &outB) {
+    outR = _mm256_i32gather_ps(lut + 0, index, 4);
+    outG = _mm256_i32gather_ps(lut + 1, index, 4);
+    outB = _mm256_i32gather_ps(lut + 2, index, 4);
+}
+
+X86_TARGET_AVX2
+void applyLutAvx2(
+        __m256 r, __m256 g, __m256 b,
+        __m256 &outR, __m256 &outG, __m256 &outB,
+        const LutData &lutData,
+        int interpolationMode
+) {
+    if (!lutData.isLoaded || lutData.data.empty()) {
+        outR = r;
+        outG = g;
+        outB = b;
+        return;
+    }
+
+    const int size = lutData.size;
+    const float *lut = lutData.data.data();
+    if (size < 2) {
+        // 单节点LUT没有插值区间，直接输出该节点
+        outR = _mm256_set1_ps(lut[0]);
+        outG = _mm256_set1_ps(lut[1]);
+        outB = _mm256_set1_ps(lut[2]);
+        return;
+    }
+
+    __m256 dx, dy, dz;
+    const __m256i base = lutIndicesAvx2(r, g, b, size, dx, dy, dz);
+
+    const __m256i strideR = _mm256_set1_epi32(size * size * 3);
+    const __m256i strideG = _mm256_set1_epi32(size * 3);
+    const __m256i strideB = _mm256_set1_epi32(3);
+
+    if (interpolationMode == 1) {
+        // 四面体插值：权重 w1 >= w2 >= w3，路径 c000 -> +最大轴 -> c111-最小轴 -> c111
+        const __m256 w1 = _mm256_max_ps(_mm256_max_ps(dx, dy), dz);
+        const __m256 w3 = _mm256_min_ps(_mm256_min_ps(dx, dy), dz);
+        const __m256 w2 = _mm256_max_ps(_mm256_min_ps(dx, dy),
+                                        _mm256_min_ps(_mm256_max_ps(dx, dy), dz));
+
+        const __m256i xIsMax = _mm256_castps_si256(_mm256_and_ps(
+                _mm256_cmp_ps(dx, dy, _CMP_GE_OQ), _mm256_cmp_ps(dx, dz, _CMP_GE_OQ)));
+        const __m256i yIsMax = _mm256_castps_si256(_mm256_cmp_ps(dy, dz, _CMP_GE_OQ));
+        const __m256i xIsMin = _mm256_castps_si256(_mm256_and_ps(
+                _mm256_cmp_ps(dx, dy, _CMP_LT_OQ), _mm256_cmp_ps(dx, dz, _CMP_LT_OQ)));
+        const __m256i yIsMin = _mm256_castps_si256(_mm256_cmp_ps(dy, dz, _CMP_LT_OQ));
+
+        const __m256i offsetMax = _mm256_blendv_epi8(
+                _mm256_blendv_epi8(strideB, strideG, yIsMax), strideR, xIsMax);
+        const __m256i offsetMin = _mm256_blendv_epi8(
+                _mm256_blendv_epi8(strideB, strideG, yIsMin), strideR, xIsMin);
+        const __m256i strideAll = _mm256_add_epi32(_mm256_add_epi32(strideR, strideG), strideB);
+        const __m256i index3 = _mm256_add_epi32(base, strideAll);
+
+        __m256 c0[3], c1[3], c2[3], c3[3];
+        gatherAvx2(lut, base, c0[0], c0[1], c0[2]);
+        gatherAvx2(lut, _mm256_add_epi32(base, offsetMax), c1[0], c1[1], c1[2]);
+        gatherAvx2(lut, _mm256_sub_epi32(index3, offsetMin), c2[0], c2[1], c2[2]);
+        gatherAvx2(lut, index3, c3[0], c3[1], c3[2]);
+
+        const __m256 k0 = _mm256_sub_ps(_mm256_set1_ps(1.0f), w1);
+        const __m256 k1 = _mm256_sub_ps(w1, w2);
+        const __m256 k2 = _mm256_sub_ps(w2, w3);
+
+        __m256 result[3];
+        for (int channel = 0; channel < 3; ++channel) {
+            __m256 sum = _mm256_mul_ps(c0[channel], k0);
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(c1[channel], k1));
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(c2[channel], k2));
+            result[channel] = _mm256_add_ps(sum, _mm256_mul_ps(c3[channel], w3));
+        }
+
+        outR = result[0];
+        outG = result[1];
+        outB = result[2];
+        return;
+    }
+
+    // 三线性插值：corner的bit2/bit1/bit0分别对应x/y/z方向+1
+    __m256 c[8][3];
+    for (int corner = 0; corner < 8; ++corner) {
+        __m256i index = base;
+        if (corner & 4) index = _mm256_add_epi32(index, strideR);
+        if (corner & 2) index = _mm256_add_epi32(index, strideG);
+        if (corner & 1) index = _mm256_add_epi32(index, strideB);
+        gatherAvx2(lut, index, c[corner][0], c[corner][1], c[corner][2]);
+    }
+
+    __m256 result[3];
+    for (int channel = 0; channel < 3; ++channel) {
+        const __m256 c00 = lerpAvx2(c[0][channel], c[4][channel], dx);
+        const __m256 c01 = lerpAvx2(c[1][channel], c[5][channel], dx);
+        const __m256 c10 = lerpAvx2(c[2][channel], c[6][channel], dx);
+        const __m256 c11 = lerpAvx2(c[3][channel], c[7][channel], dx);
+
+        result[channel] = lerpAvx2(lerpAvx2(c00, c10, dy), lerpAvx2(c01, c11, dy), dz);
+    }
+
+    outR = result[0];
+    outG = result[1];
+    outB = result[2];
+}
+
+// ==================== SSE4.1（4像素） ====================
+
+X86_TARGET_SSE41
+inline __m128 clampSse41(__m128 values) {
+    return _mm_min_ps(_mm_max_ps(values, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+}
+
+X86_TARGET_SSE41
+inline __m128 lerpSse41(__m128 a, __m128 b, __m128 t) {
+    return _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), t));
+}
+
+X86_TARGET_SSE41
+inline __m128 quantizeOffsetsSse41(const OrderedDitherRow &dither, int pixel) {
+    if (!dither.enabled()) {
+        return _mm_set1_ps(0.5f);
+    }
+    int32_t packed;
+    std::memcpy(&packed, dither.at(pixel), sizeof(packed));
+    return _mm_add_ps(
+            _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(packed))),
+                       _mm_set1_ps(1.0f / 256.0f)),
+            _mm_set1_ps(0.5f / 256.0f));
+}
+
+X86_TARGET_SSE41
+inline __m128i lutIndicesSse41(
+        __m128 r, __m128 g, __m128 b, int size,
+        __m128 &dx, __m128 &dy, __m128 &dz
+) {
+    const __m128 maxIndex = _mm_set1_ps(static_cast<float>(size - 1));
+    const __m128i maxBase = _mm_set1_epi32(size - 2);
+
+    const __m128 fx = _mm_mul_ps(clampSse41(r), maxIndex);
+    const __m128 fy = _mm_mul_ps(clampSse41(g), maxIndex);
+    const __m128 fz = _mm_mul_ps(clampSse41(b), maxIndex);
+
+    const __m128i x0 = _mm_min_epi32(_mm_cvttps_epi32(fx), maxBase);
+    const __m128i y0 = _mm_min_epi32(_mm_cvttps_epi32(fy), maxBase);
+    const __m128i z0 = _mm_min_epi32(_mm_cvttps_epi32(fz), maxBase);
+
+    dx = _mm_sub_ps(fx, _mm_cvtepi32_ps(x0));
+    dy = _mm_sub_ps(fy, _mm_cvtepi32_ps(y0));
+    dz = _mm_sub_ps(fz, _mm_cvtepi32_ps(z0));
+
+    const __m128i sizeVec = _mm_set1_epi32(size);
+    const __m128i index = _mm_add_epi32(
+            _mm_mullo_epi32(_mm_add_epi32(_mm_mullo_epi32(x0, sizeVec), y0), sizeVec), z0);
+    return _mm_mullo_epi32(index, _mm_set1_epi32(3));
+}
+
+/**
+ * SSE没有gather指令，逐通道读取顶点后组装为向量
+ */
+X86_TARGET_SSE41
+inline void gatherSse41(const float *lut, __m128i index, __m128 &outR, __m128 &outG, __m128 &outB) {
+    const float *p0 = lut + _mm_extract_epi32(index, 0);
+    const float *p1 = lut + _mm_extract_epi32(index, 1);
+    const float *p2 = lut + _mm_extract_epi32(index, 2);
+    const float *p3 = lut + _mm_extract_epi32(index, 3);
+
+    outR = _mm_setr_ps(p0[0], p1[0], p2[0], p3[0]);
+    outG = _mm_setr_ps(p0[1], p1[1], p2[1], p3[1]);
+    outB = _mm_setr_ps(p0[2], p1[2], p2[2], p3[2]);
+}
+
+X86_TARGET_SSE41
+void applyLutSse41(
+        __m128 r, __m128 g, __m128 b,
+        __m128 &outR, __m128 &outG, __m128 &outB,
+        const LutData &lutData,
+        int interpolationMode
+) {
+    if (!lutData.isLoaded || lutData.data.empty()) {
+        outR = r;
+        outG = g;
+        outB = b;
+        return;
+    }
+
+    const int size = lutData.size;
+    const float *lut = lutData.data.data();
+    if (size < 2) {
+        outR = _mm_set1_ps(lut[0]);
+        outG = _mm_set1_ps(lut[1]);
+        outB = _mm_set1_ps(lut[2]);
+        return;
+    }
+
+    __m128 dx, dy, dz;
+    const __m128i base = lutIndicesSse41(r, g, b, size, dx, dy, dz);
+
+    const __m128i strideR = _mm_set1_epi32(size * size * 3);
+    const __m128i strideG = _mm_set1_epi32(size * 3);
+    const __m128i strideB = _mm_set1_epi32(3);
+
+    if (interpolationMode == 1) {
+        const __m128 w1 = _mm_max_ps(_mm_max_ps(dx, dy), dz);
+        const __m128 w3 = _mm_min_ps(_mm_min_ps(dx, dy), dz);
+        const __m128 w2 = _mm_max_ps(_mm_min_ps(dx, dy), _mm_min_ps(_mm_max_ps(dx, dy), dz));
+
+        const __m128i xIsMax = _mm_castps_si128(
+                _mm_and_ps(_mm_cmpge_ps(dx, dy), _mm_cmpge_ps(dx, dz)));
+        const __m128i yIsMax = _mm_castps_si128(_mm_cmpge_ps(dy, dz));
+        const __m128i xIsMin = _mm_castps_si128(
+                _mm_and_ps(_mm_cmplt_ps(dx, dy), _mm_cmplt_ps(dx, dz)));
+        const __m128i yIsMin = _mm_castps_si128(_mm_cmplt_ps(dy, dz));
+
+        const __m128i offsetMax = _mm_blendv_epi8(
+                _mm_blendv_epi8(strideB, strideG, yIsMax), strideR, xIsMax);
+        const __m128i offsetMin = _mm_blendv_epi8(
+                _mm_blendv_epi8(strideB, strideG, yIsMin), strideR, xIsMin);
+        const __m128i strideAll = _mm_add_epi32(_mm_add_epi32(strideR, strideG), strideB);
+        const __m128i index3 = _mm_add_epi32(base, strideAll);
+
+        __m128 c0[3], c1[3], c2[3], c3[3];
+        gatherSse41(lut, base, c0[0], c0[1], c0[2]);
+        gatherSse41(lut, _mm_add_epi32(base, offsetMax), c1[0], c1[1], c1[2]);
+        gatherSse41(lut, _mm_sub_epi32(index3, offsetMin), c2[0], c2[1], c2[2]);
+        gatherSse41(lut, index3, c3[0], c3[1], c3[2]);
+
+        const __m128 k0 = _mm_sub_ps(_mm_set1_ps(1.0f), w1);
+        const __m128 k1 = _mm_sub_ps(w1, w2);
+        const __m128 k2 = _mm_sub_ps(w2, w3);
+
+        __m128 result[3];
+        for (int channel = 0; channel < 3; ++channel) {
+            __m128 sum = _mm_mul_ps(c0[channel], k0);
+            sum = _mm_add_ps(sum, _mm_mul_ps(c1[channel], k1));
+            sum = _mm_add_ps(sum, _mm_mul_ps(c2[channel], k2));
+            result[channel] = _mm_add_ps(sum, _mm_mul_ps(c3[channel], w3));
+        }
+
+        outR = result[0];
+        outG = result[1];
+        outB = result[2];
+        return;
+    }
+
+    __m128 c[8][3];
+    for (int corner = 0; corner < 8; ++corner) {
+        __m128i index = base;
+        if (corner & 4) index = _mm_add_epi32(index, strideR);
+        if (corner & 2) index = _mm_add_epi32(index, strideG);
+        if (corner & 1) index = _mm_add_epi32(index, strideB);
+        gatherSse41(lut, index, c[corner][0], c[corner][1], c[corner][2]);
+    }
+
+    __m128 result[3];
+    for (int channel = 0; channel < 3; ++channel) {
+        const __m128 c00 = lerpSse41(c[0][channel], c[4][channel], dx);
+        const __m128 c01 = lerpSse41(c[1][channel], c[5][channel], dx);
+        const __m128 c10 = lerpSse41(c[2][channel], c[6][channel], dx);
+        const __m128 c11 = lerpSse41(c[3][channel], c[7][channel], dx);
+
+        result[channel] = lerpSse41(lerpSse41(c00, c10, dy), lerpSse41(c01, c11, dy), dz);
+    }
+
+    outR = result[0];
+    outG = result[1];
+    outB = result[2];
+}
+
+} // namespace
+
+X86_TARGET_AVX2
+void SIMDUtils::processPixelsAvx2(
+    const uint8_t* inputPixels,
+    uint8_t* outputPixels,
+    int pixelCount,
+    const LutData& primaryLut,
+    const LutData& secondaryLut,
+    const ProcessingParams& params,
+    const OrderedDitherRow& dither
+) {
+    const int batchSize = 8;
+    const int fullBatches = pixelCount / batchSize;
+    const int remainingPixels = pixelCount % batchSize;
+
+    const bool useSecondaryLut = secondaryLut.isLoaded && params.lut2Strength > 0.0f;
+    const bool useStrength = params.strength < 1.0f;
+    const __m256 lut2Strength = _mm256_set1_ps(params.lut2Strength);
+    const __m256 lut2InvStrength = _mm256_set1_ps(1.0f - params.lut2Strength);
+    const __m256 strength = _mm256_set1_ps(params.strength);
+    const __m256 invStrength = _mm256_set1_ps(1.0f - params.strength);
+
+    const __m256i byteMask = _mm256_set1_epi32(0xFF);
+    const __m256i alphaMask = _mm256_set1_epi32(static_cast<int>(0xFF000000u));
+    const __m256 inv255 = _mm256_set1_ps(1.0f / 255.0f);
+    const __m256 scale = _mm256_set1_ps(255.0f);
+
+    const uint8_t* input = inputPixels;
+    uint8_t* output = outputPixels;
+
+    for (int batch = 0; batch < fullBatches; ++batch) {
+        // ARGB_8888在内存中依次为B,G,R,A，按小端32位读取时B位于最低字节
+        const __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input));
+
+        const __m256 b = _mm256_mul_ps(
+                _mm256_cvtepi32_ps(_mm256_and_si256(pixels, byteMask)), inv255);
+        const __m256 g = _mm256_mul_ps(
+                _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(pixels, 8), byteMask)), inv255);
+        const __m256 r = _mm256_mul_ps(
+                _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(pixels, 16), byteMask)), inv255);
+
+        // 应用主LUT
+        __m256 lutR, lutG, lutB;
+        applyLutAvx2(r, g, b, lutR, lutG, lutB, primaryLut, params.interpolationMode);
+
+        // 应用次LUT（如果存在）并混合两个LUT的结果
+        if (useSecondaryLut) {
+            __m256 lut2R, lut2G, lut2B;
+            applyLutAvx2(lutR, lutG, lutB, lut2R, lut2G, lut2B, secondaryLut,
+                         params.interpolationMode);
+
+            lutR = _mm256_add_ps(_mm256_mul_ps(lutR, lut2InvStrength), _mm256_mul_ps(lut2R, lut2Strength));
+            lutG = _mm256_add_ps(_mm256_mul_ps(lutG, lut2InvStrength), _mm256_mul_ps(lut2G, lut2Strength));
+            lutB = _mm256_add_ps(_mm256_mul_ps(lutB, lut2InvStrength), _mm256_mul_ps(lut2B, lut2Strength));
+        }
+
+        // 应用强度混合
+        if (useStrength) {
+            lutR = _mm256_add_ps(_mm256_mul_ps(r, invStrength), _mm256_mul_ps(lutR, strength));
+            lutG = _mm256_add_ps(_mm256_mul_ps(g, invStrength), _mm256_mul_ps(lutG, strength));
+            lutB = _mm256_add_ps(_mm256_mul_ps(b, invStrength), _mm256_mul_ps(lutB, strength));
+        }
+
+        // 限制范围后与标量路径一致按 value * 255 + offset 截断（offset为0.5或有序抖动阈值）
+        const __m256 offsets = quantizeOffsetsAvx2(dither, batch * batchSize);
+        const __m256i outR = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(clampAvx2(lutR), scale), offsets));
+        const __m256i outG = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(clampAvx2(lutG), scale), offsets));
+        const __m256i outB = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(clampAvx2(lutB), scale), offsets));
+
+        // 重新组装像素，Alpha通道原样写回
+        __m256i result = _mm256_and_si256(pixels, alphaMask);
+        result = _mm256_or_si256(result, outB);
+        result = _mm256_or_si256(result, _mm256_slli_epi32(outG, 8));
+        result = _mm256_or_si256(result, _mm256_slli_epi32(outR, 16));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output), result);
+
+        input += 32; // 8像素 * 4字节
+        output += 32;
+    }
+
+    // 处理剩余像素（标量方式）
+    if (remainingPixels > 0) {
+        processPixelsScalar(
+            input, output, remainingPixels,
+            primaryLut, secondaryLut, params,
+            dither.advanced(fullBatches * batchSize)
+        );
+    }
+}
+
+X86_TARGET_SSE41
+void SIMDUtils::processPixelsSse41(
+    const uint8_t* inputPixels,
+    uint8_t* outputPixels,
+    int pixelCount,
+    const LutData& primaryLut,
+    const LutData& secondaryLut,
+    const ProcessingParams& params,
+    const OrderedDitherRow& dither
+) {
+    const int batchSize = 4;
+    const int fullBatches = pixelCount / batchSize;
+    const int remainingPixels = pixelCount % batchSize;
+
+    const bool useSecondaryLut = secondaryLut.isLoaded && params.lut2Strength > 0.0f;
+    const bool useStrength = params.strength < 1.0f;
+    const __m128 lut2Strength = _mm_set1_ps(params.lut2Strength);
+    const __m128 lut2InvStrength = _mm_set1_ps(1.0f - params.lut2Strength);
+    const __m128 strength = _mm_set1_ps(params.strength);
+    const __m128 invStrength = _mm_set1_ps(1.0f - params.strength);
+
+    const __m128i byteMask = _mm_set1_epi32(0xFF);
+    const __m128i alphaMask = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+    const __m128 inv255 = _mm_set1_ps(1.0f / 255.0f);
+    const __m128 scale = _mm_set1_ps(255.0f);
+
+    const uint8_t* input = inputPixels;
+    uint8_t* output = outputPixels;
+
+    for (int batch = 0; batch < fullBatches; ++batch) {
+        const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input));
+
+        const __m128 b = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(pixels, byteMask)), inv255);
+        const __m128 g = _mm_mul_ps(
+                _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(pixels, 8), byteMask)), inv255);
+        const __m128 r = _mm_mul_ps(
+                _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(pixels, 16), byteMask)), inv255);
+
+        __m128 lutR, lutG, lutB;
+        applyLutSse41(r, g, b, lutR, lutG, lutB, primaryLut, params.interpolationMode);
+
+        if (useSecondaryLut) {
+            __m128 lut2R, lut2G, lut2B;
+            applyLutSse41(lutR, lutG, lutB, lut2R, lut2G, lut2B, secondaryLut,
+                          params.interpolationMode);
+
+            lutR = _mm_add_ps(_mm_mul_ps(lutR, lut2InvStrength), _mm_mul_ps(lut2R, lut2Strength));
+            lutG = _mm_add_ps(_mm_mul_ps(lutG, lut2InvStrength), _mm_mul_ps(lut2G, lut2Strength));
+            lutB = _mm_add_ps(_mm_mul_ps(lutB, lut2InvStrength), _mm_mul_ps(lut2B, lut2Strength));
+        }
+
+        if (useStrength) {
+            lutR = _mm_add_ps(_mm_mul_ps(r, invStrength), _mm_mul_ps(lutR, strength));
+            lutG = _mm_add_ps(_mm_mul_ps(g, invStrength), _mm_mul_ps(lutG, strength));
+            lutB = _mm_add_ps(_mm_mul_ps(b, invStrength), _mm_mul_ps(lutB, strength));
+        }
+
+        const __m128 offsets = quantizeOffsetsSse41(dither, batch * batchSize);
+        const __m128i outR = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(clampSse41(lutR), scale), offsets));
+        const __m128i outG = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(clampSse41(lutG), scale), offsets));
+        const __m128i outB = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(clampSse41(lutB), scale), offsets));
+
+        __m128i result = _mm_and_si128(pixels, alphaMask);
+        result = _mm_or_si128(result, outB);
+        result = _mm_or_si128(result, _mm_slli_epi32(outG, 8));
+        result = _mm_or_si128(result, _mm_slli_epi32(outR, 16));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output), result);
+
+        input += 16; // 4像素 * 4字节
+        output += 16;
+    }
+
+    if (remainingPixels > 0) {
+        processPixelsScalar(
+            input, output, remainingPixels,
+            primaryLut, secondaryLut, params,
+            dither.advanced(fullBatches * batchSize)
+        );
+    }
+}
+
+#endif // USE_X86_SIMD
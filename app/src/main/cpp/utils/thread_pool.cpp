@@ -0,0 +1,430 @@
+#include "thread_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <pthread.h>
+
+namespace {
+    // 当前线程在线程池中的队列索引，非池内线程为-1
+    thread_local int tlsWorkerIndex = -1;
+    thread_local const ThreadPool *tlsWorkerPool = nullptr;
+
+    /**
+     * 作用域内计入正在进行的工作，供isIdle()判断
+     */
+    class ActiveWorkScope {
+    public:
+        explicit ActiveWorkScope(std::atomic<int> &counter) : counter_(counter) {
+            counter_.fetch_add(1);
+        }
+
+        ~ActiveWorkScope() {
+            counter_.fetch_sub(1);
+        }
+
+    private:
+        std::atomic<int> &counter_;
+    };
+}
+
+ThreadPool &ThreadPool::getInstance() {
+    static ThreadPool instance;
+    return instance;
+}
+
+ThreadPool::ThreadPool() {
+    // 调用线程在parallelFor中也参与执行，工作线程数为核心数-1
+    const unsigned hardwareThreads = std::max(2u, std::thread::hardware_concurrency());
+    const int workerCount = static_cast<int>(hardwareThreads) - 1;
+
+    queues_.reserve(workerCount);
+    for (int i = 0; i < workerCount; ++i) {
+        queues_.push_back(std::make_unique<WorkerQueue>());
+    }
+
+    // 按大核优先展开所有核心，第0个核心留给参与执行的调用线程，
+    // 工作线程i分到第i+1个核心所在的整个簇（绑簇而非单核，保留簇内调度余地）
+    const CpuTopologyInfo &topology = CpuTopology::getSystemTopology();
+    for (const auto &cluster: topology.clusters) {
+        allCpus_.insert(allCpus_.end(), cluster.cpus.begin(), cluster.cpus.end());
+    }
+    workerCpus_.resize(workerCount);
+    if (!allCpus_.empty()) {
+        for (int i = 0; i < workerCount; ++i) {
+            const int cpu = allCpus_[(i + 1) % allCpus_.size()];
+            workerCpus_[i] = topology.clusters[topology.clusterOf(cpu)].cpus;
+        }
+    }
+
+    workers_.reserve(workerCount);
+    for (int i = 0; i < workerCount; ++i) {
+        workers_.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+
+    TP_LOGI("线程池初始化，工作线程数: %d, CPU簇数: %zu", workerCount, topology.clusters.size());
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        stopping_ = true;
+    }
+    sleepCondition_.notify_all();
+
+    for (auto &worker: workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+int ThreadPool::getWorkerCount() const {
+    return static_cast<int>(workers_.size());
+}
+
+bool ThreadPool::isIdle() const {
+    return activeWork_.load() == 0 && pendingTasks_.load() == 0;
+}
+
+void ThreadPool::parallelFor(
+        int begin,
+        int end,
+        int grain,
+        const std::function<void(int, int)> &body,
+        const ProgressCallback &progressCallback
+) {
+    if (end <= begin) {
+        return;
+    }
+
+    ActiveWorkScope activeScope(activeWork_);
+    grain = std::max(1, grain);
+    const int totalChunks = (end - begin + grain - 1) / grain;
+
+    // 只有一个分块时直接在调用线程执行
+    if (totalChunks == 1) {
+        body(begin, end);
+        if (progressCallback) {
+            progressCallback(1, 1);
+        }
+        return;
+    }
+
+    auto state = std::make_shared<CompletionState>();
+
+    std::vector<Task> tasks;
+    tasks.reserve(totalChunks);
+    for (int chunkBegin = begin; chunkBegin < end; chunkBegin += grain) {
+        const int chunkEnd = std::min(chunkBegin + grain, end);
+        tasks.emplace_back([state, &body, chunkBegin, chunkEnd]() {
+            std::exception_ptr exception;
+            try {
+                body(chunkBegin, chunkEnd);
+            } catch (...) {
+                exception = std::current_exception();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (exception && !state->exception) {
+                    state->exception = exception;
+                }
+                ++state->completed;
+            }
+            state->condition.notify_all();
+        });
+    }
+    enqueueBatch(tasks);
+
+    helpUntilComplete(state, totalChunks, progressCallback);
+}
+
+void ThreadPool::parallelForAdaptive(
+        int begin,
+        int end,
+        int minGrain,
+        const std::function<void(int, int)> &body,
+        const ProgressCallback &progressCallback
+) {
+    if (end <= begin) {
+        return;
+    }
+
+    ActiveWorkScope activeScope(activeWork_);
+    minGrain = std::max(1, minGrain);
+    const int total = end - begin;
+    const int participants = static_cast<int>(queues_.size()) + 1;
+
+    if (total <= minGrain) {
+        body(begin, end);
+        if (progressCallback) {
+            progressCallback(total, total);
+        }
+        return;
+    }
+
+    struct AdaptiveState : CompletionState {
+        std::atomic<int> next{0};
+    };
+    auto state = std::make_shared<AdaptiveState>();
+    state->next.store(begin);
+
+    // 每个参与线程运行一个领取循环；领取失败（游标已越过end）后不会再访问body，
+    // 因此迟到的领取任务在parallelForAdaptive返回后执行也是安全的
+    auto runner = [state, &body, end, minGrain, participants]() {
+        double nsPerItem = 0.0;
+        while (true) {
+            const int remaining = end - state->next.load(std::memory_order_relaxed);
+            if (remaining <= 0) {
+                break;
+            }
+
+            // 首个分块用minGrain测速，之后按目标耗时换算；尾部按剩余量缩小分块
+            int chunk = minGrain;
+            if (nsPerItem > 0.0) {
+                chunk = static_cast<int>(std::min<double>(
+                        ADAPTIVE_CHUNK_TARGET_NS / nsPerItem, remaining));
+            }
+            chunk = std::clamp(chunk, minGrain, std::max(minGrain, remaining / (2 * participants)));
+
+            const int chunkBegin = state->next.fetch_add(chunk);
+            if (chunkBegin >= end) {
+                break;
+            }
+            const int chunkEnd = std::min(chunkBegin + chunk, end);
+
+            const auto startTime = std::chrono::steady_clock::now();
+            std::exception_ptr exception;
+            try {
+                body(chunkBegin, chunkEnd);
+            } catch (...) {
+                exception = std::current_exception();
+            }
+            const auto elapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - startTime).count();
+
+            const double sample = static_cast<double>(elapsedNs) / (chunkEnd - chunkBegin);
+            nsPerItem = nsPerItem > 0.0 ? 0.5 * nsPerItem + 0.5 * sample : sample;
+
+            int finished = chunkEnd - chunkBegin;
+            if (exception) {
+                // 出错后放弃尚未领取的元素，并计入完成量以便调用线程结束等待
+                const int abandonedFrom = state->next.exchange(end);
+                if (abandonedFrom < end) {
+                    finished += end - abandonedFrom;
+                }
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (exception && !state->exception) {
+                    state->exception = exception;
+                }
+                state->completed += finished;
+            }
+            state->condition.notify_all();
+        }
+    };
+
+    std::vector<Task> tasks(queues_.size(), runner);
+    enqueueBatch(tasks);
+
+    // 调用线程同样作为一个参与者领取分块
+    runner();
+
+    helpUntilComplete(state, total, progressCallback);
+}
+
+void ThreadPool::run(
+        SchedulingMode mode,
+        int begin,
+        int end,
+        int grain,
+        const std::function<void(int, int)> &body,
+        const ProgressCallback &progressCallback
+) {
+    if (mode == SchedulingMode::ADAPTIVE) {
+        parallelForAdaptive(begin, end, grain, body, progressCallback);
+    } else {
+        parallelFor(begin, end, grain, body, progressCallback);
+    }
+}
+
+void ThreadPool::setCorePinning(bool enabled) {
+    if (corePinning_.exchange(enabled) == enabled) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        affinityGeneration_.fetch_add(1);
+    }
+    sleepCondition_.notify_all();
+
+    TP_LOGD("工作线程绑核: %s", enabled ? "启用" : "关闭");
+}
+
+bool ThreadPool::isCorePinningEnabled() const {
+    return corePinning_.load();
+}
+
+void ThreadPool::helpUntilComplete(
+        const std::shared_ptr<CompletionState> &state,
+        int total,
+        const ProgressCallback &progressCallback
+) {
+    // 调用线程一边执行任务一边等待，完成事件驱动进度回调
+    const int selfIndex = tlsWorkerPool == this ? tlsWorkerIndex : -1;
+    int reported = 0;
+    while (true) {
+        int completed;
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            completed = state->completed;
+        }
+
+        if (progressCallback && completed != reported) {
+            reported = completed;
+            progressCallback(completed, total);
+        }
+        if (completed == total) {
+            break;
+        }
+
+        Task task;
+        if (tryAcquire(selfIndex, task)) {
+            task();
+            continue;
+        }
+
+        // 没有可执行的任务，等待剩余部分在其他线程上完成
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->condition.wait(lock, [&]() {
+            return state->completed != completed;
+        });
+    }
+
+    if (state->exception) {
+        std::rethrow_exception(state->exception);
+    }
+}
+
+void ThreadPool::enqueue(Task task) {
+    const int queueCount = static_cast<int>(queues_.size());
+    const int index = tlsWorkerPool == this
+                      ? tlsWorkerIndex
+                      : static_cast<int>(nextQueue_.fetch_add(1) % queueCount);
+
+    {
+        std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+        queues_[index]->tasks.push_back(std::move(task));
+    }
+    notifyTasks(1);
+}
+
+void ThreadPool::enqueueBatch(std::vector<Task> &tasks) {
+    const int taskCount = static_cast<int>(tasks.size());
+    const int queueCount = static_cast<int>(queues_.size());
+
+    // 第i个队列分到连续的第[i*n/q, (i+1)*n/q)个任务；队列所有者从队尾取，
+    // 窃取者从队首取，因此按逆序放入，让所有者按原顺序处理相邻分块
+    for (int queue = 0; queue < queueCount; ++queue) {
+        const int first = static_cast<int>(static_cast<long long>(taskCount) * queue / queueCount);
+        const int last = static_cast<int>(static_cast<long long>(taskCount) * (queue + 1) /
+                                          queueCount);
+        if (first == last) {
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(queues_[queue]->mutex);
+        for (int i = last - 1; i >= first; --i) {
+            queues_[queue]->tasks.push_back(std::move(tasks[i]));
+        }
+    }
+    notifyTasks(taskCount);
+}
+
+bool ThreadPool::tryAcquire(int selfIndex, Task &task) {
+    const int queueCount = static_cast<int>(queues_.size());
+
+    if (selfIndex >= 0) {
+        WorkerQueue &own = *queues_[selfIndex];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            pendingTasks_.fetch_sub(1);
+            return true;
+        }
+    }
+
+    const int start = selfIndex >= 0 ? selfIndex + 1 : 0;
+    for (int offset = 0; offset < queueCount; ++offset) {
+        const int index = (start + offset) % queueCount;
+        if (index == selfIndex) {
+            continue;
+        }
+
+        WorkerQueue &victim = *queues_[index];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            pendingTasks_.fetch_sub(1);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ThreadPool::notifyTasks(int count) {
+    {
+        // 在睡眠锁内更新计数，避免工作线程检查条件与进入等待之间丢失唤醒
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        pendingTasks_.fetch_add(count);
+    }
+
+    if (count == 1) {
+        sleepCondition_.notify_one();
+    } else {
+        sleepCondition_.notify_all();
+    }
+}
+
+void ThreadPool::applyAffinity(int index, bool pinned) {
+    CpuTopology::pinCurrentThread(pinned ? workerCpus_[index] : allCpus_);
+}
+
+void ThreadPool::workerLoop(int index) {
+    tlsWorkerIndex = index;
+    tlsWorkerPool = this;
+
+    const std::string name = "lut-worker-" + std::to_string(index);
+    pthread_setname_np(pthread_self(), name.c_str());
+
+    unsigned appliedGeneration = 0;
+    while (true) {
+        const unsigned generation = affinityGeneration_.load();
+        if (generation != appliedGeneration) {
+            appliedGeneration = generation;
+            applyAffinity(index, corePinning_.load());
+        }
+
+        Task task;
+        if (tryAcquire(index, task)) {
+            ActiveWorkScope activeScope(activeWork_);
+            task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        sleepCondition_.wait(lock, [this, appliedGeneration]() {
+            return stopping_ || pendingTasks_.load() > 0 ||
+                   affinityGeneration_.load() != appliedGeneration;
+        });
+        if (stopping_) {
+            break;
+        }
+    }
+}
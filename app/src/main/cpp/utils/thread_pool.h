@@ -0,0 +1,226 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <android/log.h>
+#include "cpu_topology.h"
+
+#define THREAD_POOL_TAG "ThreadPool"
+#define TP_LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, THREAD_POOL_TAG, __VA_ARGS__)
+#define TP_LOGI(...) __android_log_print(ANDROID_LOG_INFO, THREAD_POOL_TAG, __VA_ARGS__)
+#define TP_LOGW(...) __android_log_print(ANDROID_LOG_WARN, THREAD_POOL_TAG, __VA_ARGS__)
+#define TP_LOGE(...) __android_log_print(ANDROID_LOG_ERROR, THREAD_POOL_TAG, __VA_ARGS__)
+
+/**
+ * 进程级持久工作窃取线程池
+ * 每个工作线程持有自己的任务双端队列：本线程从队尾取任务，
+ * 空闲线程从其他线程队列的队首窃取，大小核之间的负载不均由窃取自动抹平
+ */
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    /**
+     * 分块完成进度回调（在调用parallelFor的线程上执行）
+     * @param completedChunks 已完成分块数
+     * @param totalChunks 总分块数
+     */
+    using ProgressCallback = std::function<void(int completedChunks, int totalChunks)>;
+
+    /**
+     * 调度模式
+     */
+    enum class SchedulingMode {
+        WORK_STEALING, // 固定大小分块 + 工作窃取
+        ADAPTIVE       // 按每个线程实测吞吐量动态领取分块
+    };
+
+    static ThreadPool& getInstance();
+
+    /**
+     * 获取工作线程数（不含参与执行的调用线程）
+     * @return 工作线程数
+     */
+    int getWorkerCount() const;
+
+    /**
+     * 线程池是否空闲：没有排队的任务，也没有正在执行的任务或parallelFor调用
+     * 只是瞬时状态，用于让后台的低优先级工作（如分块调优）避开正在进行的处理
+     * @return 是否空闲
+     */
+    bool isIdle() const;
+
+    /**
+     * 将[begin, end)按grain切分为分块并行执行，阻塞直到全部完成
+     * 调用线程在等待期间同样执行任务，因此可以在池内线程中嵌套调用；
+     * 分块中抛出的第一个异常会在全部分块结束后重新抛出
+     * @param begin 起始位置
+     * @param end 结束位置（不含）
+     * @param grain 每个分块的大小
+     * @param body 分块处理函数，参数为分块的[begin, end)
+     * @param progressCallback 进度回调，分块完成时在调用线程上触发，可为空
+     */
+    void parallelFor(
+            int begin,
+            int end,
+            int grain,
+            const std::function<void(int, int)>& body,
+            const ProgressCallback& progressCallback = nullptr
+    );
+
+    /**
+     * 自适应分块并行执行，阻塞直到全部完成
+     * 各参与线程从共享游标领取分块：先领取minGrain个元素测出本线程每元素耗时，
+     * 之后按目标时长换算分块大小，剩余量较少时分块逐渐缩小，
+     * 使小核自动领到更小的分块，不会在最后拖慢整体
+     * @param begin 起始位置
+     * @param end 结束位置（不含）
+     * @param minGrain 最小分块大小
+     * @param body 分块处理函数，参数为分块的[begin, end)
+     * @param progressCallback 进度回调，参数为已完成元素数与总元素数，在调用线程上触发，可为空
+     */
+    void parallelForAdaptive(
+            int begin,
+            int end,
+            int minGrain,
+            const std::function<void(int, int)>& body,
+            const ProgressCallback& progressCallback = nullptr
+    );
+
+    /**
+     * 按模式选择parallelFor或parallelForAdaptive
+     * @param grain WORK_STEALING模式下为分块大小，ADAPTIVE模式下为最小分块大小
+     */
+    void run(
+            SchedulingMode mode,
+            int begin,
+            int end,
+            int grain,
+            const std::function<void(int, int)>& body,
+            const ProgressCallback& progressCallback = nullptr
+    );
+
+    /**
+     * 启用或关闭工作线程绑核，启用时每个工作线程绑定到分配给它的CPU簇，
+     * 工作线程在下一次被唤醒时应用新设置。
+     * 这是整个进程的设置，由应用在启动时设置一次，不随单个任务切换
+     * @param enabled 是否绑核
+     */
+    void setCorePinning(bool enabled);
+
+    bool isCorePinningEnabled() const;
+
+    /**
+     * 提交单个任务
+     * 返回的future不应在池内线程中阻塞等待，否则可能占满所有工作线程
+     * @param function 任务函数
+     * @return 任务结果
+     */
+    template<typename Function>
+    auto submit(Function&& function) -> std::future<decltype(function())> {
+        using Result = decltype(function());
+        auto task = std::make_shared<std::packaged_task<Result()>>(
+                std::forward<Function>(function));
+        std::future<Result> future = task->get_future();
+        enqueue([task]() { (*task)(); });
+        return future;
+    }
+
+private:
+    ThreadPool();
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * parallelFor与parallelForAdaptive共享的完成状态
+     */
+    struct CompletionState {
+        std::mutex mutex;
+        std::condition_variable condition;
+        int completed = 0;
+        std::exception_ptr exception;
+    };
+
+    /**
+     * 工作线程的任务队列
+     */
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    /**
+     * 将任务放入队列：池内线程放入自己的队列，外部线程轮流分发
+     */
+    void enqueue(Task task);
+
+    /**
+     * 批量放入任务，按连续区间分给各个队列，保持同一线程处理相邻分块
+     */
+    void enqueueBatch(std::vector<Task>& tasks);
+
+    /**
+     * 取出一个任务：先取本线程队列队尾，再从其他队列队首窃取
+     * @param selfIndex 当前线程的队列索引，外部线程为-1
+     * @param task 输出的任务
+     * @return 是否取到任务
+     */
+    bool tryAcquire(int selfIndex, Task& task);
+
+    /**
+     * 通知有新任务到达
+     * @param count 新任务数量
+     */
+    void notifyTasks(int count);
+
+    /**
+     * 调用线程一边执行任务一边等待完成，期间触发进度回调，结束后重新抛出首个异常
+     * @param state 完成状态
+     * @param total 需要完成的总量
+     * @param progressCallback 进度回调，可为空
+     */
+    void helpUntilComplete(
+            const std::shared_ptr<CompletionState>& state,
+            int total,
+            const ProgressCallback& progressCallback
+    );
+
+    /**
+     * 按当前绑核设置更新工作线程的亲和性
+     */
+    void applyAffinity(int index, bool pinned);
+
+    void workerLoop(int index);
+
+    // 自适应模式下每个分块的目标耗时
+    static constexpr long long ADAPTIVE_CHUNK_TARGET_NS = 2000000;
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread> workers_;
+
+    std::mutex sleepMutex_;
+    std::condition_variable sleepCondition_;
+    std::atomic<int> pendingTasks_{0};
+    std::atomic<int> activeWork_{0}; // 正在执行的任务与进行中的parallelFor调用
+    std::atomic<unsigned> nextQueue_{0};
+    bool stopping_ = false;
+
+    // 每个工作线程分配到的CPU簇核心，按大核优先的顺序分配
+    std::vector<std::vector<int>> workerCpus_;
+    std::vector<int> allCpus_;
+    std::atomic<bool> corePinning_{false};
+    std::atomic<unsigned> affinityGeneration_{0};
+};
+
+#endif // THREAD_POOL_H
@@ -9,7 +9,8 @@ echo.
 :: 设置路径
 set SHADER_DIR=%~dp0
 set PROJECT_DIR=%~dp0..\..\..\..
-set OUTPUT_DIR=%PROJECT_DIR%\assets\shaders
+:: 应用构建时由Gradle的compileShaders任务编译并打包着色器，这里的输出只用于手动检查
+set OUTPUT_DIR=%PROJECT_DIR%\..\..\build\shaders
 
 :: 查找glslc
 set GLSLC=
@@ -79,6 +80,27 @@ for %%f in ("%SHADER_DIR%*.comp") do (
     echo.
 )
 
+:: 存储缓冲区变体：同一源文件定义STORAGE_BUFFER
+if exist "%SHADER_DIR%lut_processor.comp" (
+    echo Compiling: lut_processor.comp ^(STORAGE_BUFFER^)
+    
+    "%GLSLC%" ^
+        --target-env=vulkan1.0 ^
+        -O ^
+        -DSTORAGE_BUFFER ^
+        "%SHADER_DIR%lut_processor.comp" ^
+        -o "%OUTPUT_DIR%\lut_processor_buffer.spv"
+    
+    if !errorlevel! equ 0 (
+        echo   SUCCESS: lut_processor_buffer.spv
+        set /a COMPILE_COUNT+=1
+    ) else (
+        echo   FAILED: lut_processor.comp ^(STORAGE_BUFFER^)
+        set /a ERROR_COUNT+=1
+    )
+    echo.
+)
+
 :: 也编译.vert和.frag文件
 for %%f in ("%SHADER_DIR%*.vert") do (
     set "INPUT_FILE=%%f"
@@ -8,7 +8,9 @@ echo ""
 # 设置路径
 SCRIPT_DIR="$(cd "$(dirname "$0")" && pwd)"
 PROJECT_DIR="${SCRIPT_DIR}/../../../.."
-OUTPUT_DIR="${PROJECT_DIR}/assets/shaders"
+# 应用构建时由Gradle的compileShaders任务编译并打包着色器，本脚本只用于手动检查编译结果，
+# 输出到构建目录，避免与生成的assets重复
+OUTPUT_DIR="${PROJECT_DIR}/../../build/shaders"
 
 # 查找glslc
 GLSLC=""
@@ -66,11 +68,12 @@ ERROR_COUNT=0
 compile_shader() {
     local input_file="$1"
     local output_file="$2"
+    local extra_args=("${@:3}")
     local shader_name=$(basename "$input_file")
     
     echo "Compiling: ${shader_name}"
     
-    if "${GLSLC}" --target-env=vulkan1.0 -O "$input_file" -o "$output_file"; then
+    if "${GLSLC}" --target-env=vulkan1.0 -O "${extra_args[@]}" "$input_file" -o "$output_file"; then
         echo "  SUCCESS: $(basename "$output_file")"
         ((COMPILE_COUNT++))
     else
@@ -88,6 +91,11 @@ for f in "${SCRIPT_DIR}"/*.comp; do
     fi
 done
 
+# 存储缓冲区变体：同一源文件定义STORAGE_BUFFER
+if [ -f "${SCRIPT_DIR}/lut_processor.comp" ]; then
+    compile_shader "${SCRIPT_DIR}/lut_processor.comp" "${OUTPUT_DIR}/lut_processor_buffer.spv" -DSTORAGE_BUFFER
+fi
+
 # 编译顶点着色器 (.vert)
 for f in "${SCRIPT_DIR}"/*.vert; do
     if [ -f "$f" ]; then
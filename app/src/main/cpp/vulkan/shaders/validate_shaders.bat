@@ -9,7 +9,7 @@ echo.
 :: 设置路径
 set SHADER_DIR=%~dp0
 set PROJECT_DIR=%~dp0..\..\..\..
-set OUTPUT_DIR=%PROJECT_DIR%\assets\shaders
+set OUTPUT_DIR=%PROJECT_DIR%\..\..\build\shaders
 
 :: 查找spirv-val
 set SPIRV_VAL=
@@ -1,10 +1,15 @@
 #include "vk_compute_pipeline.h"
 #include "vk_context.h"
 #include "vk_memory_pool.h"
+#include "../utils/dither_matrix.h"
 #include <android/log.h>
+#ifdef __ANDROID__
 #include <android/asset_manager.h>
+#endif
+#include <algorithm>
 #include <cstring>
 #include <fstream>
+#include <limits>
 #include <sstream>
 
 #define LOG_TAG "VkComputePipeline"
@@ -16,7 +21,12 @@
 namespace vulkan {
 
 VkComputePipeline::VkComputePipeline(VkContext* context, VkMemoryPool* memoryPool)
-    : context_(context), memoryPool_(memoryPool), assetManager_(nullptr) {
+    : context_(context), memoryPool_(memoryPool), assetManager_(nullptr),
+      pipelineCache_(std::make_unique<VkPipelineCacheFile>(context)),
+      uploadRing_(std::make_unique<VkStagingRing>(
+          context, VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, false)),
+      readbackRing_(std::make_unique<VkStagingRing>(
+          context, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, true)) {
     LOGI("VkComputePipeline created");
 }
 
@@ -30,7 +40,12 @@ void VkComputePipeline::setAssetManager(AAssetManager* assetManager) {
     LOGI("Asset manager set: %p", assetManager);
 }
 
+void VkComputePipeline::setShaderPath(const std::string& path) {
+    shaderPath_ = path;
+}
+
 std::vector<char> VkComputePipeline::loadSPIRVFromAssets(const std::string& assetPath) {
+#ifdef __ANDROID__
     if (!assetManager_) {
         LOGE("Asset manager not set");
         return {};
@@ -61,6 +76,68 @@ std::vector<char> VkComputePipeline::loadSPIRVFromAssets(const std::string& asse
     
     LOGI("Loaded SPIR-V from assets: %s (%zu bytes)", assetPath.c_str(), size);
     return buffer;
+#else
+    LOGW("Asset manager is only available on Android: %s", assetPath.c_str());
+    return {};
+#endif
+}
+
+std::vector<char> VkComputePipeline::loadSPIRVFromFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        LOGE("Failed to open shader file: %s", path.c_str());
+        return {};
+    }
+
+    const std::streamsize size = file.tellg();
+    if (size < 4 || size % 4 != 0) {
+        LOGE("Invalid SPIR-V size in %s: %lld", path.c_str(), static_cast<long long>(size));
+        return {};
+    }
+
+    std::vector<char> buffer(static_cast<size_t>(size));
+    file.seekg(0);
+    if (!file.read(buffer.data(), size)) {
+        LOGE("Failed to read shader file: %s", path.c_str());
+        return {};
+    }
+
+    uint32_t magic = 0;
+    memcpy(&magic, buffer.data(), sizeof(magic));
+    if (magic != 0x07230203) {
+        LOGE("Invalid SPIR-V in file: %s", path.c_str());
+        return {};
+    }
+
+    LOGI("Loaded SPIR-V from file: %s (%zu bytes)", path.c_str(), buffer.size());
+    return buffer;
+}
+
+bool VkComputePipeline::declaresTileConstants(const std::vector<char>& spirvCode) {
+    constexpr uint32_t OP_VARIABLE = 59;
+    constexpr uint32_t STORAGE_CLASS_PUSH_CONSTANT = 9;
+    constexpr size_t HEADER_WORDS = 5;
+
+    const size_t wordCount = spirvCode.size() / sizeof(uint32_t);
+    std::vector<uint32_t> words(wordCount);
+    memcpy(words.data(), spirvCode.data(), wordCount * sizeof(uint32_t));
+
+    // 逐条遍历指令：首字高16位为指令字数，低16位为操作码
+    size_t index = HEADER_WORDS;
+    while (index < wordCount) {
+        const uint32_t length = words[index] >> 16;
+        const uint32_t opcode = words[index] & 0xFFFF;
+        if (length == 0 || index + length > wordCount) {
+            break;
+        }
+        // OpVariable: 结果类型、结果ID、存储类
+        if (opcode == OP_VARIABLE && length >= 4 &&
+            words[index + 3] == STORAGE_CLASS_PUSH_CONSTANT) {
+            return true;
+        }
+        index += length;
+    }
+    return false;
 }
 
 bool VkComputePipeline::initialize() {
@@ -78,14 +155,20 @@ bool VkComputePipeline::initialize() {
     }
 
     // 创建描述符集布局
-    if (!createDescriptorSetLayout()) {
+    if (!createDescriptorSetLayout(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, descriptorSetLayout_)) {
         LOGE("Failed to create descriptor set layout");
         cleanup();
         return false;
     }
 
+    // 载入磁盘上的管线缓存，失败时不使用缓存直接编译
+    if (!pipelineCache_->create(pipelineCachePath_)) {
+        LOGW("Pipeline cache unavailable, compiling without cache");
+    }
+
     // 创建计算管线
-    if (!createComputePipeline()) {
+    if (!createComputePipeline(computeShaderModule_, descriptorSetLayout_,
+                               pipelineLayout_, pipeline_)) {
         LOGE("Failed to create compute pipeline");
         cleanup();
         return false;
@@ -105,6 +188,13 @@ bool VkComputePipeline::initialize() {
         return false;
     }
 
+    // 创建有序抖动阈值缓冲区
+    if (!createDitherBuffer()) {
+        LOGE("Failed to create dither buffer");
+        cleanup();
+        return false;
+    }
+
     // 创建LUT纹理
     if (!createLutTexture(lutImage_, lutImageMemory_, lutImageView_, 32)) {
         LOGE("Failed to create LUT texture");
@@ -140,13 +230,6 @@ bool VkComputePipeline::initialize() {
         return false;
     }
 
-    // 创建默认的1x1输入输出图像（避免在loadLut时描述符无效）
-    if (!createInOutImages(1, 1)) {
-        LOGE("Failed to create default input/output images");
-        cleanup();
-        return false;
-    }
-
     // 创建命令缓冲区
     VkCommandBufferAllocateInfo allocInfo = {};
     allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
@@ -161,32 +244,22 @@ bool VkComputePipeline::initialize() {
         return false;
     }
 
-    // 创建栅栏
-    VkFenceCreateInfo fenceInfo = {};
-    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-    fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-
-    result = vkCreateFence(context_->getDevice(), &fenceInfo, nullptr, &fence_);
-    if (result != VK_SUCCESS) {
-        LOGE("Failed to create fence: %d", result);
+    // 创建各帧的命令缓冲区、同步对象与描述符集
+    if (!createFrameSlots()) {
+        LOGE("Failed to create frame slots");
         cleanup();
         return false;
     }
 
-    // 创建描述符集
-    VkDescriptorSetAllocateInfo descriptorSetAllocInfo = {};
-    descriptorSetAllocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-    descriptorSetAllocInfo.descriptorPool = descriptorPool_;
-    descriptorSetAllocInfo.descriptorSetCount = 1;
-    descriptorSetAllocInfo.pSetLayouts = &descriptorSetLayout_;
-
-    result = vkAllocateDescriptorSets(context_->getDevice(), &descriptorSetAllocInfo, &descriptorSet_);
-    if (result != VK_SUCCESS) {
-        LOGE("Failed to allocate descriptor set: %d", result);
-        cleanup();
-        return false;
+    // 初始化前已选择存储缓冲区变体
+    if (computePath_ == ComputePath::STORAGE_BUFFER && !createBufferVariant()) {
+        LOGW("Storage buffer variant unavailable, using storage images");
+        computePath_ = ComputePath::STORAGE_IMAGE;
     }
 
+    // 新编译的管线写回磁盘，下次启动直接复用
+    pipelineCache_->save();
+
     initialized_ = true;
     LOGI("VkComputePipeline initialized successfully");
     return true;
@@ -207,8 +280,16 @@ void VkComputePipeline::cleanup() {
         vkDeviceWaitIdle(device);
     }
 
-    // 释放输入输出图像
-    freeInOutImages();
+    // 释放存储缓冲区变体与各帧资源
+    destroyBufferVariant();
+    destroyFrameSlots();
+
+    // 释放暂存环
+    uploadRing_->destroy();
+    readbackRing_->destroy();
+
+    // 管线缓存已在创建管线后写回
+    pipelineCache_->destroy();
 
     // 释放LUT纹理
     if (lutSampler_ != VK_NULL_HANDLE) {
@@ -257,6 +338,17 @@ void VkComputePipeline::cleanup() {
         uniformBufferMemory_ = VK_NULL_HANDLE;
     }
 
+    // 释放抖动阈值缓冲区
+    if (ditherBuffer_ != VK_NULL_HANDLE) {
+        vkDestroyBuffer(device, ditherBuffer_, nullptr);
+        ditherBuffer_ = VK_NULL_HANDLE;
+    }
+
+    if (ditherBufferMemory_ != VK_NULL_HANDLE) {
+        vkFreeMemory(device, ditherBufferMemory_, nullptr);
+        ditherBufferMemory_ = VK_NULL_HANDLE;
+    }
+
     // 释放描述符池
     if (descriptorPool_ != VK_NULL_HANDLE) {
         vkDestroyDescriptorPool(device, descriptorPool_, nullptr);
@@ -291,12 +383,6 @@ void VkComputePipeline::cleanup() {
         commandBuffer_ = VK_NULL_HANDLE;
     }
 
-    // 释放栅栏
-    if (fence_ != VK_NULL_HANDLE) {
-        vkDestroyFence(device, fence_, nullptr);
-        fence_ = VK_NULL_HANDLE;
-    }
-
     initialized_ = false;
     LOGI("VkComputePipeline cleaned up");
 }
@@ -306,11 +392,21 @@ bool VkComputePipeline::createShaderModule() {
     
     // 尝试从assets加载SPIR-V
     std::vector<char> spirvCode = loadSPIRVFromAssets("shaders/lut_processor.spv");
+
+    // 没有Asset管理器时从文件加载
+    if (spirvCode.empty() && !shaderPath_.empty()) {
+        spirvCode = loadSPIRVFromFile(shaderPath_);
+    }
     
     if (spirvCode.empty()) {
         LOGW("Failed to load SPIR-V from assets, trying embedded shader...");
         return createShaderModuleFromEmbedded();
     }
+
+    if (!declaresTileConstants(spirvCode)) {
+        LOGE("Shader binary has no tile push constants, rebuild it with compile_shaders");
+        return false;
+    }
     
     VkShaderModuleCreateInfo createInfo = {};
     createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
@@ -379,18 +475,21 @@ bool VkComputePipeline::createShaderModuleFromEmbedded() {
     return true;
 }
 
-bool VkComputePipeline::createDescriptorSetLayout() {
+bool VkComputePipeline::createDescriptorSetLayout(
+    VkDescriptorType pixelType,
+    VkDescriptorSetLayout& layout
+) {
     // 输入图像
     VkDescriptorSetLayoutBinding inputImageBinding = {};
     inputImageBinding.binding = 0;
-    inputImageBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    inputImageBinding.descriptorType = pixelType;
     inputImageBinding.descriptorCount = 1;
     inputImageBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
 
     // 输出图像
     VkDescriptorSetLayoutBinding outputImageBinding = {};
     outputImageBinding.binding = 1;
-    outputImageBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    outputImageBinding.descriptorType = pixelType;
     outputImageBinding.descriptorCount = 1;
     outputImageBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
 
@@ -415,12 +514,20 @@ bool VkComputePipeline::createDescriptorSetLayout() {
     uniformBinding.descriptorCount = 1;
     uniformBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
 
+    // 有序抖动阈值表
+    VkDescriptorSetLayoutBinding ditherBinding = {};
+    ditherBinding.binding = 5;
+    ditherBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    ditherBinding.descriptorCount = 1;
+    ditherBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
     std::vector<VkDescriptorSetLayoutBinding> bindings = {
         inputImageBinding,
         outputImageBinding,
         lutTextureBinding,
         lut2TextureBinding,
-        uniformBinding
+        uniformBinding,
+        ditherBinding
     };
 
     VkDescriptorSetLayoutCreateInfo layoutInfo = {};
@@ -429,7 +536,7 @@ bool VkComputePipeline::createDescriptorSetLayout() {
     layoutInfo.pBindings = bindings.data();
 
     VkResult result = vkCreateDescriptorSetLayout(
-        context_->getDevice(), &layoutInfo, nullptr, &descriptorSetLayout_
+        context_->getDevice(), &layoutInfo, nullptr, &layout
     );
 
     if (result != VK_SUCCESS) {
@@ -441,20 +548,33 @@ bool VkComputePipeline::createDescriptorSetLayout() {
     return true;
 }
 
-bool VkComputePipeline::createComputePipeline() {
+bool VkComputePipeline::createComputePipeline(
+    VkShaderModule shaderModule,
+    VkDescriptorSetLayout setLayout,
+    VkPipelineLayout& layout,
+    VkPipeline& pipeline
+) {
     VkPipelineShaderStageCreateInfo shaderStageInfo = {};
     shaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
     shaderStageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
-    shaderStageInfo.module = computeShaderModule_;
+    shaderStageInfo.module = shaderModule;
     shaderStageInfo.pName = "main";
 
+    // 分块位置通过推送常量传入
+    VkPushConstantRange pushConstantRange = {};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(TileConstants);
+
     VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
     pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
     pipelineLayoutInfo.setLayoutCount = 1;
-    pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout_;
+    pipelineLayoutInfo.pSetLayouts = &setLayout;
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
 
     VkResult result = vkCreatePipelineLayout(
-        context_->getDevice(), &pipelineLayoutInfo, nullptr, &pipelineLayout_
+        context_->getDevice(), &pipelineLayoutInfo, nullptr, &layout
     );
 
     if (result != VK_SUCCESS) {
@@ -465,10 +585,10 @@ bool VkComputePipeline::createComputePipeline() {
     VkComputePipelineCreateInfo pipelineInfo = {};
     pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
     pipelineInfo.stage = shaderStageInfo;
-    pipelineInfo.layout = pipelineLayout_;
+    pipelineInfo.layout = layout;
 
     result = vkCreateComputePipelines(
-        context_->getDevice(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline_
+        context_->getDevice(), pipelineCache_->getHandle(), 1, &pipelineInfo, nullptr, &pipeline
     );
 
     if (result != VK_SUCCESS) {
@@ -480,18 +600,154 @@ bool VkComputePipeline::createComputePipeline() {
     return true;
 }
 
+bool VkComputePipeline::createBufferVariant() {
+    if (bufferPipeline_ != VK_NULL_HANDLE) {
+        return true;
+    }
+
+    LOGI("Creating storage buffer variant...");
+
+    std::vector<char> spirvCode = loadSPIRVFromAssets("shaders/lut_processor_buffer.spv");
+
+    // 没有Asset管理器时从图像变体同目录加载：lut_processor.spv -> lut_processor_buffer.spv
+    if (spirvCode.empty() && !shaderPath_.empty()) {
+        std::string path = shaderPath_;
+        const std::string extension = ".spv";
+        if (path.size() > extension.size() &&
+            path.compare(path.size() - extension.size(), extension.size(), extension) == 0) {
+            path.erase(path.size() - extension.size());
+        }
+        spirvCode = loadSPIRVFromFile(path + "_buffer.spv");
+    }
+
+    if (spirvCode.empty()) {
+        LOGW("Storage buffer shader not found");
+        return false;
+    }
+
+    if (!declaresTileConstants(spirvCode)) {
+        LOGE("Storage buffer shader has no tile push constants, rebuild it with compile_shaders");
+        return false;
+    }
+
+    VkShaderModuleCreateInfo createInfo = {};
+    createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    createInfo.codeSize = spirvCode.size();
+    createInfo.pCode = reinterpret_cast<const uint32_t*>(spirvCode.data());
+
+    VkResult result = vkCreateShaderModule(
+        context_->getDevice(), &createInfo, nullptr, &bufferShaderModule_
+    );
+    if (result != VK_SUCCESS) {
+        LOGE("Failed to create storage buffer shader module: %d", result);
+        return false;
+    }
+
+    if (!createDescriptorSetLayout(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, bufferDescriptorSetLayout_) ||
+        !createComputePipeline(bufferShaderModule_, bufferDescriptorSetLayout_,
+                               bufferPipelineLayout_, bufferPipeline_)) {
+        destroyBufferVariant();
+        return false;
+    }
+
+    for (FrameSlot& frame : frames_) {
+        VkDescriptorSetAllocateInfo allocInfo = {};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = descriptorPool_;
+        allocInfo.descriptorSetCount = 1;
+        allocInfo.pSetLayouts = &bufferDescriptorSetLayout_;
+
+        result = vkAllocateDescriptorSets(context_->getDevice(), &allocInfo, &frame.bufferDescriptorSet);
+        if (result != VK_SUCCESS) {
+            LOGE("Failed to allocate storage buffer descriptor set: %d", result);
+            destroyBufferVariant();
+            return false;
+        }
+    }
+
+    LOGI("Storage buffer variant created (%zu bytes SPIR-V)", spirvCode.size());
+    if (initialized_) {
+        pipelineCache_->save();
+    }
+    return true;
+}
+
+void VkComputePipeline::destroyBufferVariant() {
+    VkDevice device = context_->getDevice();
+
+    for (FrameSlot& frame : frames_) {
+        if (frame.bufferDescriptorSet != VK_NULL_HANDLE && descriptorPool_ != VK_NULL_HANDLE) {
+            vkFreeDescriptorSets(device, descriptorPool_, 1, &frame.bufferDescriptorSet);
+        }
+        frame.bufferDescriptorSet = VK_NULL_HANDLE;
+    }
+
+    if (bufferPipeline_ != VK_NULL_HANDLE) {
+        vkDestroyPipeline(device, bufferPipeline_, nullptr);
+        bufferPipeline_ = VK_NULL_HANDLE;
+    }
+
+    if (bufferPipelineLayout_ != VK_NULL_HANDLE) {
+        vkDestroyPipelineLayout(device, bufferPipelineLayout_, nullptr);
+        bufferPipelineLayout_ = VK_NULL_HANDLE;
+    }
+
+    if (bufferDescriptorSetLayout_ != VK_NULL_HANDLE) {
+        vkDestroyDescriptorSetLayout(device, bufferDescriptorSetLayout_, nullptr);
+        bufferDescriptorSetLayout_ = VK_NULL_HANDLE;
+    }
+
+    if (bufferShaderModule_ != VK_NULL_HANDLE) {
+        vkDestroyShaderModule(device, bufferShaderModule_, nullptr);
+        bufferShaderModule_ = VK_NULL_HANDLE;
+    }
+}
+
+bool VkComputePipeline::setComputePath(ComputePath path) {
+    if (path == computePath_) {
+        return true;
+    }
+
+    // 未初始化时只记录选择，由initialize创建
+    if (initialized_ && path == ComputePath::STORAGE_BUFFER && !createBufferVariant()) {
+        LOGW("Storage buffer variant unavailable, keeping storage images");
+        return false;
+    }
+    computePath_ = path;
+
+    // 存储缓冲区变体不使用帧图像，释放以节省显存（processBatch返回时没有在途帧）
+    if (initialized_ && path == ComputePath::STORAGE_BUFFER) {
+        for (FrameSlot& frame : frames_) {
+            destroyStorageImage(frame.inputImage, frame.inputImageMemory, frame.inputImageView);
+            destroyStorageImage(frame.outputImage, frame.outputImageMemory, frame.outputImageView);
+            frame.width = 0;
+            frame.height = 0;
+        }
+    }
+
+    LOGI("Compute path: %s",
+         path == ComputePath::STORAGE_BUFFER ? "storage buffer" : "storage image");
+    return true;
+}
+
+bool VkComputePipeline::usesTransferQueue() const {
+    return computePath_ == ComputePath::STORAGE_IMAGE && context_->hasDedicatedTransferQueue();
+}
+
 bool VkComputePipeline::createDescriptorPool() {
+    // 每帧两个描述符集：存储图像变体与存储缓冲区变体各一个
     VkDescriptorPoolSize poolSizes[] = {
-        {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 2},
-        {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 2},
-        {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1}
+        {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 2 * MAX_FRAMES_IN_FLIGHT},
+        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2 * MAX_FRAMES_IN_FLIGHT},
+        {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4 * MAX_FRAMES_IN_FLIGHT},
+        {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 4 * MAX_FRAMES_IN_FLIGHT}
     };
 
     VkDescriptorPoolCreateInfo poolInfo = {};
     poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
     poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
-    poolInfo.maxSets = 1;
-    poolInfo.poolSizeCount = 3;
+    poolInfo.maxSets = 2 * MAX_FRAMES_IN_FLIGHT;
+    poolInfo.poolSizeCount = 4;
     poolInfo.pPoolSizes = poolSizes;
 
     VkResult result = vkCreateDescriptorPool(
@@ -558,6 +814,73 @@ bool VkComputePipeline::createUniformBuffer() {
     return true;
 }
 
+bool VkComputePipeline::createDitherBuffer() {
+    // 着色器中为两个uvec4[256]数组，每个uint按小端打包4个阈值，与CPU阈值表字节序一致
+    const VkDeviceSize matrixSize = DitherMatrix::SIZE * DitherMatrix::SIZE;
+    const VkDeviceSize bufferSize = matrixSize * 2;
+
+    VkBufferCreateInfo bufferInfo = {};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = bufferSize;
+    bufferInfo.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VkResult result = vkCreateBuffer(
+        context_->getDevice(), &bufferInfo, nullptr, &ditherBuffer_
+    );
+
+    if (result != VK_SUCCESS) {
+        LOGE("Failed to create dither buffer: %d", result);
+        return false;
+    }
+
+    VkMemoryRequirements memRequirements;
+    vkGetBufferMemoryRequirements(context_->getDevice(), ditherBuffer_, &memRequirements);
+
+    VkMemoryAllocateInfo allocInfo = {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = memRequirements.size;
+    allocInfo.memoryTypeIndex = context_->findMemoryType(
+        memRequirements.memoryTypeBits,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+    );
+
+    result = vkAllocateMemory(
+        context_->getDevice(), &allocInfo, nullptr, &ditherBufferMemory_
+    );
+
+    if (result != VK_SUCCESS) {
+        LOGE("Failed to allocate dither buffer memory: %d", result);
+        return false;
+    }
+
+    result = vkBindBufferMemory(
+        context_->getDevice(), ditherBuffer_, ditherBufferMemory_, 0
+    );
+
+    if (result != VK_SUCCESS) {
+        LOGE("Failed to bind dither buffer memory: %d", result);
+        return false;
+    }
+
+    // 阈值表只写入一次
+    void* mappedData;
+    result = vkMapMemory(context_->getDevice(), ditherBufferMemory_, 0, bufferSize, 0, &mappedData);
+    if (result != VK_SUCCESS) {
+        LOGE("Failed to map dither buffer memory: %d", result);
+        return false;
+    }
+
+    uint8_t* dst = static_cast<uint8_t*>(mappedData);
+    std::memcpy(dst, DitherMatrix::getMatrix(DitherMatrix::DITHER_BAYER), matrixSize);
+    std::memcpy(dst + matrixSize, DitherMatrix::getMatrix(DitherMatrix::DITHER_BLUE_NOISE), matrixSize);
+
+    vkUnmapMemory(context_->getDevice(), ditherBufferMemory_);
+
+    LOGI("Dither buffer created");
+    return true;
+}
+
 bool VkComputePipeline::createLutTexture(VkImage& image, VkDeviceMemory& memory, 
                                           VkImageView& imageView, int lutSize) {
     // 创建3D图像用于LUT
@@ -627,11 +950,14 @@ bool VkComputePipeline::createLutTexture(VkImage& image, VkDeviceMemory& memory,
     return true;
 }
 
-bool VkComputePipeline::createInOutImages(int width, int height) {
-    // 释放旧的图像资源
-    freeInOutImages();
-
-    // 创建输入图像
+bool VkComputePipeline::createStorageImage(
+    int width,
+    int height,
+    VkImageUsageFlags usage,
+    VkImage& image,
+    VkDeviceMemory& memory,
+    VkImageView& imageView
+) {
     VkImageCreateInfo imageInfo = {};
     imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
     imageInfo.imageType = VK_IMAGE_TYPE_2D;
@@ -643,19 +969,28 @@ bool VkComputePipeline::createInOutImages(int width, int height) {
     imageInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
     imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
     imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    imageInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    imageInfo.usage = usage;
     imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
     imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
-    // 创建输入图像
-    VkResult result = vkCreateImage(context_->getDevice(), &imageInfo, nullptr, &inputImage_);
+    // 上传与回读在传输队列上执行时，图像由两个队列族并发共享，无需所有权转移
+    const uint32_t queueFamilies[] = {
+        context_->getComputeQueueFamily(), context_->getTransferQueueFamily()
+    };
+    if (context_->hasDedicatedTransferQueue()) {
+        imageInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        imageInfo.queueFamilyIndexCount = 2;
+        imageInfo.pQueueFamilyIndices = queueFamilies;
+    }
+
+    VkResult result = vkCreateImage(context_->getDevice(), &imageInfo, nullptr, &image);
     if (result != VK_SUCCESS) {
-        LOGE("Failed to create input image: %d", result);
+        LOGE("Failed to create storage image: %d", result);
         return false;
     }
 
     VkMemoryRequirements memRequirements;
-    vkGetImageMemoryRequirements(context_->getDevice(), inputImage_, &memRequirements);
+    vkGetImageMemoryRequirements(context_->getDevice(), image, &memRequirements);
 
     VkMemoryAllocateInfo allocInfo = {};
     allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
@@ -665,22 +1000,23 @@ bool VkComputePipeline::createInOutImages(int width, int height) {
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
     );
 
-    result = vkAllocateMemory(context_->getDevice(), &allocInfo, nullptr, &inputImageMemory_);
+    result = vkAllocateMemory(context_->getDevice(), &allocInfo, nullptr, &memory);
     if (result != VK_SUCCESS) {
-        LOGE("Failed to allocate input image memory: %d", result);
+        LOGE("Failed to allocate storage image memory: %d", result);
+        destroyStorageImage(image, memory, imageView);
         return false;
     }
 
-    result = vkBindImageMemory(context_->getDevice(), inputImage_, inputImageMemory_, 0);
+    result = vkBindImageMemory(context_->getDevice(), image, memory, 0);
     if (result != VK_SUCCESS) {
-        LOGE("Failed to bind input image memory: %d", result);
+        LOGE("Failed to bind storage image memory: %d", result);
+        destroyStorageImage(image, memory, imageView);
         return false;
     }
 
-    // 创建输入图像视图
     VkImageViewCreateInfo viewInfo = {};
     viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-    viewInfo.image = inputImage_;
+    viewInfo.image = image;
     viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
     viewInfo.format = VK_FORMAT_R8G8B8A8_UNORM;
     viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
@@ -689,63 +1025,179 @@ bool VkComputePipeline::createInOutImages(int width, int height) {
     viewInfo.subresourceRange.baseArrayLayer = 0;
     viewInfo.subresourceRange.layerCount = 1;
 
-    result = vkCreateImageView(context_->getDevice(), &viewInfo, nullptr, &inputImageView_);
+    result = vkCreateImageView(context_->getDevice(), &viewInfo, nullptr, &imageView);
     if (result != VK_SUCCESS) {
-        LOGE("Failed to create input image view: %d", result);
+        LOGE("Failed to create storage image view: %d", result);
+        destroyStorageImage(image, memory, imageView);
         return false;
     }
 
-    // 创建输出图像
-    imageInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
-    result = vkCreateImage(context_->getDevice(), &imageInfo, nullptr, &outputImage_);
-    if (result != VK_SUCCESS) {
-        LOGE("Failed to create output image: %d", result);
-        return false;
+    return true;
+}
+
+void VkComputePipeline::destroyStorageImage(
+    VkImage& image,
+    VkDeviceMemory& memory,
+    VkImageView& imageView
+) {
+    VkDevice device = context_->getDevice();
+
+    if (imageView != VK_NULL_HANDLE) {
+        vkDestroyImageView(device, imageView, nullptr);
+        imageView = VK_NULL_HANDLE;
+    }
+    if (image != VK_NULL_HANDLE) {
+        vkDestroyImage(device, image, nullptr);
+        image = VK_NULL_HANDLE;
     }
+    if (memory != VK_NULL_HANDLE) {
+        vkFreeMemory(device, memory, nullptr);
+        memory = VK_NULL_HANDLE;
+    }
+}
 
-    vkGetImageMemoryRequirements(context_->getDevice(), outputImage_, &memRequirements);
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = context_->findMemoryType(
-        memRequirements.memoryTypeBits,
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
-    );
+bool VkComputePipeline::createFrameSlots() {
+    VkDevice device = context_->getDevice();
+    const bool dedicatedTransfer = context_->hasDedicatedTransferQueue();
+
+    frames_.resize(MAX_FRAMES_IN_FLIGHT);
+    for (FrameSlot& frame : frames_) {
+        VkCommandBufferAllocateInfo allocInfo = {};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = context_->getCommandPool();
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = 1;
+
+        VkResult result = vkAllocateCommandBuffers(device, &allocInfo, &frame.computeCommands);
+        if (result != VK_SUCCESS) {
+            LOGE("Failed to allocate frame command buffer: %d", result);
+            return false;
+        }
 
-    result = vkAllocateMemory(context_->getDevice(), &allocInfo, nullptr, &outputImageMemory_);
-    if (result != VK_SUCCESS) {
-        LOGE("Failed to allocate output image memory: %d", result);
-        return false;
+        if (dedicatedTransfer) {
+            allocInfo.commandPool = context_->getTransferCommandPool();
+            VkCommandBuffer transferCommands[2];
+            allocInfo.commandBufferCount = 2;
+            result = vkAllocateCommandBuffers(device, &allocInfo, transferCommands);
+            if (result != VK_SUCCESS) {
+                LOGE("Failed to allocate transfer command buffers: %d", result);
+                return false;
+            }
+            frame.uploadCommands = transferCommands[0];
+            frame.readbackCommands = transferCommands[1];
+
+            VkSemaphoreCreateInfo semaphoreInfo = {};
+            semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+            if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &frame.uploadDone) != VK_SUCCESS ||
+                vkCreateSemaphore(device, &semaphoreInfo, nullptr, &frame.computeDone) != VK_SUCCESS) {
+                LOGE("Failed to create frame semaphores");
+                return false;
+            }
+        }
+
+        VkFenceCreateInfo fenceInfo = {};
+        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+
+        result = vkCreateFence(device, &fenceInfo, nullptr, &frame.fence);
+        if (result != VK_SUCCESS) {
+            LOGE("Failed to create frame fence: %d", result);
+            return false;
+        }
+
+        VkDescriptorSetAllocateInfo descriptorSetAllocInfo = {};
+        descriptorSetAllocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        descriptorSetAllocInfo.descriptorPool = descriptorPool_;
+        descriptorSetAllocInfo.descriptorSetCount = 1;
+        descriptorSetAllocInfo.pSetLayouts = &descriptorSetLayout_;
+
+        result = vkAllocateDescriptorSets(device, &descriptorSetAllocInfo, &frame.descriptorSet);
+        if (result != VK_SUCCESS) {
+            LOGE("Failed to allocate frame descriptor set: %d", result);
+            return false;
+        }
     }
 
-    result = vkBindImageMemory(context_->getDevice(), outputImage_, outputImageMemory_, 0);
-    if (result != VK_SUCCESS) {
-        LOGE("Failed to bind output image memory: %d", result);
-        return false;
+    LOGI("Frame slots created: %u, dedicated transfer queue: %d",
+         MAX_FRAMES_IN_FLIGHT, dedicatedTransfer ? 1 : 0);
+    return true;
+}
+
+void VkComputePipeline::destroyFrameSlots() {
+    VkDevice device = context_->getDevice();
+
+    for (FrameSlot& frame : frames_) {
+        destroyStorageImage(frame.inputImage, frame.inputImageMemory, frame.inputImageView);
+        destroyStorageImage(frame.outputImage, frame.outputImageMemory, frame.outputImageView);
+
+        if (frame.computeCommands != VK_NULL_HANDLE) {
+            vkFreeCommandBuffers(device, context_->getCommandPool(), 1, &frame.computeCommands);
+        }
+        if (frame.uploadCommands != VK_NULL_HANDLE) {
+            vkFreeCommandBuffers(device, context_->getTransferCommandPool(), 1, &frame.uploadCommands);
+        }
+        if (frame.readbackCommands != VK_NULL_HANDLE) {
+            vkFreeCommandBuffers(device, context_->getTransferCommandPool(), 1, &frame.readbackCommands);
+        }
+        if (frame.uploadDone != VK_NULL_HANDLE) {
+            vkDestroySemaphore(device, frame.uploadDone, nullptr);
+        }
+        if (frame.computeDone != VK_NULL_HANDLE) {
+            vkDestroySemaphore(device, frame.computeDone, nullptr);
+        }
+        if (frame.fence != VK_NULL_HANDLE) {
+            vkDestroyFence(device, frame.fence, nullptr);
+        }
     }
 
-    // 创建输出图像视图
-    viewInfo.image = outputImage_;
-    result = vkCreateImageView(context_->getDevice(), &viewInfo, nullptr, &outputImageView_);
-    if (result != VK_SUCCESS) {
-        LOGE("Failed to create output image view: %d", result);
-        return false;
+    // 描述符集随描述符池一起释放
+    frames_.clear();
+}
+
+bool VkComputePipeline::prepareFrameImages(FrameSlot& frame, int width, int height) {
+    if (frame.width >= width && frame.height >= height && frame.inputImage != VK_NULL_HANDLE) {
+        return true;
+    }
+
+    // 只增不减：按两个方向各自的最大值重建，尺寸交替变化的批次不会反复创建图像
+    if (frame.inputImage != VK_NULL_HANDLE) {
+        width = std::max(width, frame.width);
+        height = std::max(height, frame.height);
     }
 
-    currentWidth_ = width;
-    currentHeight_ = height;
+    destroyStorageImage(frame.inputImage, frame.inputImageMemory, frame.inputImageView);
+    destroyStorageImage(frame.outputImage, frame.outputImageMemory, frame.outputImageView);
+    frame.width = 0;
+    frame.height = 0;
 
-    LOGI("Input/Output images created: %dx%d", width, height);
+    if (!createStorageImage(width, height,
+                            VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+                            frame.inputImage, frame.inputImageMemory, frame.inputImageView) ||
+        !createStorageImage(width, height,
+                            VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                            frame.outputImage, frame.outputImageMemory, frame.outputImageView)) {
+        destroyStorageImage(frame.inputImage, frame.inputImageMemory, frame.inputImageView);
+        return false;
+    }
+
+    frame.width = width;
+    frame.height = height;
+    LOGI("Frame images grown to %dx%d", width, height);
     return true;
 }
 
-void VkComputePipeline::updateDescriptorSet() {
+void VkComputePipeline::writeDescriptorSet(const FrameSlot& frame, const BandStaging& band) {
+    const bool bufferPath = computePath_ == ComputePath::STORAGE_BUFFER;
+    const VkDescriptorSet descriptorSet = bufferPath ? frame.bufferDescriptorSet : frame.descriptorSet;
+
     // 更新输入图像描述符
     VkDescriptorImageInfo inputImageInfo = {};
-    inputImageInfo.imageView = inputImageView_;
+    inputImageInfo.imageView = frame.inputImageView;
     inputImageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
 
     VkWriteDescriptorSet inputWrite = {};
     inputWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    inputWrite.dstSet = descriptorSet_;
+    inputWrite.dstSet = descriptorSet;
     inputWrite.dstBinding = 0;
     inputWrite.dstArrayElement = 0;
     inputWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
@@ -754,18 +1206,37 @@ void VkComputePipeline::updateDescriptorSet() {
 
     // 更新输出图像描述符
     VkDescriptorImageInfo outputImageInfo = {};
-    outputImageInfo.imageView = outputImageView_;
+    outputImageInfo.imageView = frame.outputImageView;
     outputImageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
 
     VkWriteDescriptorSet outputWrite = {};
     outputWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    outputWrite.dstSet = descriptorSet_;
+    outputWrite.dstSet = descriptorSet;
     outputWrite.dstBinding = 1;
     outputWrite.dstArrayElement = 0;
     outputWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
     outputWrite.descriptorCount = 1;
     outputWrite.pImageInfo = &outputImageInfo;
 
+    // 存储缓冲区变体直接绑定行带的上传与回读区段
+    VkDescriptorBufferInfo inputBufferInfo = {};
+    VkDescriptorBufferInfo outputBufferInfo = {};
+    if (bufferPath) {
+        inputBufferInfo.buffer = band.upload.buffer;
+        inputBufferInfo.offset = band.upload.offset;
+        inputBufferInfo.range = band.upload.size;
+        inputWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        inputWrite.pImageInfo = nullptr;
+        inputWrite.pBufferInfo = &inputBufferInfo;
+
+        outputBufferInfo.buffer = band.readback.buffer;
+        outputBufferInfo.offset = band.readback.offset;
+        outputBufferInfo.range = band.readback.size;
+        outputWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        outputWrite.pImageInfo = nullptr;
+        outputWrite.pBufferInfo = &outputBufferInfo;
+    }
+
     // 更新LUT纹理描述符
     VkDescriptorImageInfo lutImageInfo = {};
     lutImageInfo.imageView = lutImageView_;
@@ -774,7 +1245,7 @@ void VkComputePipeline::updateDescriptorSet() {
 
     VkWriteDescriptorSet lutWrite = {};
     lutWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    lutWrite.dstSet = descriptorSet_;
+    lutWrite.dstSet = descriptorSet;
     lutWrite.dstBinding = 2;
     lutWrite.dstArrayElement = 0;
     lutWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
@@ -789,15 +1260,30 @@ void VkComputePipeline::updateDescriptorSet() {
 
     VkWriteDescriptorSet uniformWrite = {};
     uniformWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    uniformWrite.dstSet = descriptorSet_;
+    uniformWrite.dstSet = descriptorSet;
     uniformWrite.dstBinding = 4;
     uniformWrite.dstArrayElement = 0;
     uniformWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
     uniformWrite.descriptorCount = 1;
     uniformWrite.pBufferInfo = &bufferInfo;
 
+    // 更新抖动阈值表描述符
+    VkDescriptorBufferInfo ditherBufferInfo = {};
+    ditherBufferInfo.buffer = ditherBuffer_;
+    ditherBufferInfo.offset = 0;
+    ditherBufferInfo.range = VK_WHOLE_SIZE;
+
+    VkWriteDescriptorSet ditherWrite = {};
+    ditherWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    ditherWrite.dstSet = descriptorSet;
+    ditherWrite.dstBinding = 5;
+    ditherWrite.dstArrayElement = 0;
+    ditherWrite.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    ditherWrite.descriptorCount = 1;
+    ditherWrite.pBufferInfo = &ditherBufferInfo;
+
     std::vector<VkWriteDescriptorSet> writes = {
-            inputWrite, outputWrite, lutWrite, uniformWrite
+            inputWrite, outputWrite, lutWrite, uniformWrite, ditherWrite
     };
 
     // 只有当LUT2有效时才更新LUT2描述符
@@ -809,7 +1295,7 @@ void VkComputePipeline::updateDescriptorSet() {
         lut2ImageInfo.sampler = lutSampler_;
 
         lut2Write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        lut2Write.dstSet = descriptorSet_;
+        lut2Write.dstSet = descriptorSet;
         lut2Write.dstBinding = 3;
         lut2Write.dstArrayElement = 0;
         lut2Write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
@@ -824,7 +1310,7 @@ void VkComputePipeline::updateDescriptorSet() {
         lut2ImageInfo.sampler = lutSampler_;
 
         lut2Write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        lut2Write.dstSet = descriptorSet_;
+        lut2Write.dstSet = descriptorSet;
         lut2Write.dstBinding = 3;
         lut2Write.dstArrayElement = 0;
         lut2Write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
@@ -1049,9 +1535,6 @@ bool VkComputePipeline::loadLut(const float* lutData, int lutSize, bool isSecond
         lutSize_ = lutSize;
     }
 
-    // 更新描述符集
-    updateDescriptorSet();
-
     LOGI("LUT data loaded successfully, size=%d, isSecond=%d", lutSize, isSecondLut);
     return true;
 }
@@ -1063,28 +1546,62 @@ bool VkComputePipeline::processImage(
     uint8_t* outputPixels,
     const ProcessingParams& params
 ) {
-    if (!initialized_) {
-        LOGE("Pipeline not initialized");
+    std::vector<BatchItem> items(1);
+    items[0].width = inputWidth;
+    items[0].height = inputHeight;
+    items[0].inputPixels = inputPixels;
+    items[0].outputPixels = outputPixels;
+
+    if (!processBatch(items, params)) {
         return false;
     }
 
-    // 检查是否需要重新创建图像
-    if (inputWidth != currentWidth_ || inputHeight != currentHeight_) {
-        if (!createInOutImages(inputWidth, inputHeight)) {
-            LOGE("Failed to create input/output images");
-            return false;
+    // 调试：检查前几个像素
+    if (inputWidth > 0 && inputHeight > 0) {
+        const uint8_t* firstPixel = outputPixels;
+        LOGD("Output pixel[0]: R=%d G=%d B=%d A=%d", 
+             firstPixel[0], firstPixel[1], firstPixel[2], firstPixel[3]);
+        
+        // 检查是否全黑
+        const int checkedBytes = static_cast<int>(std::min<int64_t>(
+            100, static_cast<int64_t>(inputWidth) * inputHeight * 4));
+        bool allBlack = true;
+        for (int i = 0; i < checkedBytes; i += 4) {
+            if (outputPixels[i] != 0 || outputPixels[i+1] != 0 || 
+                outputPixels[i+2] != 0) {
+                allBlack = false;
+                break;
+            }
+        }
+        if (allBlack) {
+            LOGW("WARNING: Output appears to be all black!");
+            
+            // 检查输入像素
+            const uint8_t* inputFirst = inputPixels;
+            LOGD("Input pixel[0]: R=%d G=%d B=%d A=%d", 
+                 inputFirst[0], inputFirst[1], inputFirst[2], inputFirst[3]);
         }
     }
 
-    // 每次处理都更新描述符集，确保绑定正确
-    updateDescriptorSet();
+    LOGD("Image processed successfully: %dx%d", inputWidth, inputHeight);
+    return true;
+}
+
+bool VkComputePipeline::processBatch(std::vector<BatchItem>& items, const ProcessingParams& params) {
+    if (!initialized_) {
+        LOGE("Pipeline not initialized");
+        return false;
+    }
+    if (items.empty()) {
+        return true;
+    }
 
     // 更新LUT尺寸到参数中
     ProcessingParams updatedParams = params;
     updatedParams.lutSize = static_cast<float>(lutSize_ > 0 ? lutSize_ : 32);
     updatedParams.lut2Size = static_cast<float>(lut2Size_ > 0 ? lut2Size_ : 32);
 
-    // 更新Uniform缓冲区
+    // 更新Uniform缓冲区（整批共用，上一批的帧已全部完成）
     void* mappedData;
     VkResult result = vkMapMemory(
         context_->getDevice(), uniformBufferMemory_, 0, sizeof(ProcessingParams), 0, &mappedData
@@ -1098,89 +1615,231 @@ bool VkComputePipeline::processImage(
     memcpy(mappedData, &updatedParams, sizeof(ProcessingParams));
     vkUnmapMemory(context_->getDevice(), uniformBufferMemory_);
 
-    // 创建暂存缓冲区用于数据传输
-    VkDeviceSize imageSize = inputWidth * inputHeight * 4;
-    
-    VkBuffer stagingBuffer;
-    VkDeviceMemory stagingBufferMemory;
+    // 切块：未超过设备限制的图片只有一块
+    std::vector<TileJob> jobs;
+    planTiles(items, jobs);
 
-    VkBufferCreateInfo bufferInfo = {};
-    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-    bufferInfo.size = imageSize;
-    bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
-    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    // 暂存环按最大的行带预留所有在途帧的空间，之后的分配不再扩容
+    const uint32_t frameCount = static_cast<uint32_t>(
+        std::min<size_t>(MAX_FRAMES_IN_FLIGHT, jobs.size()));
+    VkDeviceSize largestBandBytes = 0;
+    for (const TileJob& job : jobs) {
+        largestBandBytes = std::max(largestBandBytes,
+                                    static_cast<VkDeviceSize>(job.imageWidth) * job.height * 4);
+    }
+    uploadRing_->reserve(largestBandBytes, frameCount);
+    readbackRing_->reserve(largestBandBytes, frameCount);
 
-    result = vkCreateBuffer(context_->getDevice(), &bufferInfo, nullptr, &stagingBuffer);
-    if (result != VK_SUCCESS) {
-        LOGE("Failed to create staging buffer: %d", result);
-        return false;
+    BandStaging band;
+    for (size_t index = 0; index < jobs.size(); ++index) {
+        FrameSlot& frame = frames_[index % frameCount];
+
+        // 轮到的帧仍在途时先等它完成，保持最多frameCount帧在途
+        if (frame.busy) {
+            finishFrame(frame, items);
+        }
+        beginFrame(frame, items, jobs[index], band);
     }
 
-    VkMemoryRequirements memRequirements;
-    vkGetBufferMemoryRequirements(context_->getDevice(), stagingBuffer, &memRequirements);
+    while (finishOldestFrame(items)) {
+    }
+    // 失败的块可能留下未回收的行带区段
+    uploadRing_->release(submitSerial_);
+    readbackRing_->release(submitSerial_);
 
-    VkMemoryAllocateInfo allocInfo = {};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = context_->findMemoryType(
-        memRequirements.memoryTypeBits,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
-    );
+    size_t succeeded = 0;
+    for (const BatchItem& item : items) {
+        succeeded += item.success ? 1 : 0;
+    }
+    LOGD("Batch processed: %zu/%zu images, %zu tiles, %u frames in flight",
+         succeeded, items.size(), jobs.size(), frameCount);
+    return succeeded == items.size();
+}
 
-    result = vkAllocateMemory(context_->getDevice(), &allocInfo, nullptr, &stagingBufferMemory);
-    if (result != VK_SUCCESS) {
-        LOGE("Failed to allocate staging buffer memory: %d", result);
-        vkDestroyBuffer(context_->getDevice(), stagingBuffer, nullptr);
+int VkComputePipeline::tileDimension() const {
+    // 存储缓冲区变体没有图像尺寸限制，只受绑定范围约束（见planTiles）
+    int limit = std::numeric_limits<int>::max();
+    if (computePath_ == ComputePath::STORAGE_IMAGE) {
+        limit = static_cast<int>(context_->getMaxImageDimension2D());
+        if (limit <= 0) {
+            limit = 4096;
+        }
+    }
+    if (tileDimensionLimit_ > 0) {
+        limit = std::min(limit, static_cast<int>(tileDimensionLimit_));
+    }
+    return limit;
+}
+
+void VkComputePipeline::planTiles(std::vector<BatchItem>& items, std::vector<TileJob>& jobs) const {
+    const int tileLimit = tileDimension();
+
+    // 存储缓冲区变体把整条行带绑定为一个描述符，行带不能超过maxStorageBufferRange
+    const bool bufferPath = computePath_ == ComputePath::STORAGE_BUFFER;
+    const VkDeviceSize maxBindingBytes = context_->getDeviceProperties().limits.maxStorageBufferRange;
+    const VkDeviceSize maxBandBytes = bufferPath
+            ? std::min<VkDeviceSize>(MAX_TILED_BAND_BYTES, maxBindingBytes)
+            : MAX_TILED_BAND_BYTES;
+
+    for (size_t index = 0; index < items.size(); ++index) {
+        BatchItem& item = items[index];
+        if (item.width <= 0 || item.height <= 0 || !item.inputPixels || !item.outputPixels) {
+            LOGE("Invalid batch item %zu: %dx%d", index, item.width, item.height);
+            item.success = false;
+            continue;
+        }
+        item.success = true;
+
+        TileJob job;
+        job.itemIndex = index;
+        job.imageWidth = item.width;
+        job.imageHeight = item.height;
+
+        const VkDeviceSize imageBytes = static_cast<VkDeviceSize>(item.width) * item.height * 4;
+        if (item.width <= tileLimit && item.height <= tileLimit &&
+            (!bufferPath || imageBytes <= maxBindingBytes)) {
+            job.width = item.width;
+            job.height = item.height;
+            job.frameWidth = item.width;
+            job.frameHeight = item.height;
+            jobs.push_back(job);
+            continue;
+        }
+
+        // 行带覆盖整行，高度同时受设备限制与暂存上限约束
+        const VkDeviceSize rowBytes = static_cast<VkDeviceSize>(item.width) * 4;
+        const int tileWidth = std::min(item.width, tileLimit);
+        const int bandHeight = std::min({item.height, tileLimit,
+                                         static_cast<int>(std::max<VkDeviceSize>(
+                                                 1, maxBandBytes / rowBytes))});
+        const int columns = (item.width + tileWidth - 1) / tileWidth;
+
+        job.frameWidth = tileWidth;
+        job.frameHeight = bandHeight;
+        job.bandTiles = columns;
+        for (int y = 0; y < item.height; y += bandHeight) {
+            for (int column = 0; column < columns; ++column) {
+                job.x = column * tileWidth;
+                job.y = y;
+                job.width = std::min(tileWidth, item.width - job.x);
+                job.height = std::min(bandHeight, item.height - y);
+                job.firstInBand = column == 0;
+                job.lastInBand = column == columns - 1;
+                jobs.push_back(job);
+            }
+        }
+
+        LOGI("Tiling %dx%d image: %d columns x %d bands of %dx%d (limit %d)",
+             item.width, item.height, columns, (item.height + bandHeight - 1) / bandHeight,
+             tileWidth, bandHeight, tileLimit);
+    }
+}
+
+bool VkComputePipeline::beginFrame(
+    FrameSlot& frame,
+    std::vector<BatchItem>& items,
+    const TileJob& job,
+    BandStaging& band
+) {
+    // 每块都占一个序号，行带区段的回收序号据此预先确定
+    const uint64_t serial = ++submitSerial_;
+    BatchItem& item = items[job.itemIndex];
+
+    if (job.firstInBand) {
+        band = BandStaging();
+        band.serial = serial + job.bandTiles - 1;
+
+        // 从暂存环取上传与回读区段，空间被在途帧占满时先完成最早的一帧
+        const VkDeviceSize bandBytes = static_cast<VkDeviceSize>(job.imageWidth) * job.height * 4;
+        band.upload = uploadRing_->allocate(bandBytes, band.serial);
+        while (!band.upload.isValid() && finishOldestFrame(items)) {
+            band.upload = uploadRing_->allocate(bandBytes, band.serial);
+        }
+        band.readback = readbackRing_->allocate(bandBytes, band.serial);
+        while (band.upload.isValid() && !band.readback.isValid() && finishOldestFrame(items)) {
+            band.readback = readbackRing_->allocate(bandBytes, band.serial);
+        }
+
+        if (!band.upload.isValid() || !band.readback.isValid()) {
+            LOGE("Failed to allocate staging ring space: %llu bytes",
+                 static_cast<unsigned long long>(bandBytes));
+            // 本行带的区段是最新的，释放前须先完成所有更早的帧
+            while (finishOldestFrame(items)) {
+            }
+            uploadRing_->release(band.serial);
+            readbackRing_->release(band.serial);
+            band = BandStaging();
+        } else {
+            // 行带在整图中连续，一次拷入
+            const size_t rowBytes = static_cast<size_t>(job.imageWidth) * 4;
+            memcpy(band.upload.mappedData, item.inputPixels + rowBytes * job.y, bandBytes);
+            uploadRing_->flush(band.upload);
+        }
+    }
+
+    // 行带暂存失败时其余各块直接失败
+    if (!band.upload.isValid() || !band.readback.isValid()) {
+        item.success = false;
         return false;
     }
 
-    result = vkBindBufferMemory(context_->getDevice(), stagingBuffer, stagingBufferMemory, 0);
-    if (result != VK_SUCCESS) {
-        LOGE("Failed to bind staging buffer memory: %d", result);
-        vkFreeMemory(context_->getDevice(), stagingBufferMemory, nullptr);
-        vkDestroyBuffer(context_->getDevice(), stagingBuffer, nullptr);
+    if (computePath_ == ComputePath::STORAGE_IMAGE &&
+        !prepareFrameImages(frame, job.frameWidth, job.frameHeight)) {
+        LOGE("Failed to create frame images: %dx%d", job.frameWidth, job.frameHeight);
+        item.success = false;
         return false;
     }
+    writeDescriptorSet(frame, band);
 
-    // 上传输入图像数据
-    void* data;
-    result = vkMapMemory(context_->getDevice(), stagingBufferMemory, 0, imageSize, 0, &data);
-    if (result != VK_SUCCESS) {
-        LOGE("Failed to map staging buffer: %d", result);
-        vkFreeMemory(context_->getDevice(), stagingBufferMemory, nullptr);
-        vkDestroyBuffer(context_->getDevice(), stagingBuffer, nullptr);
+    if (!recordFrame(frame, job, band) || !submitFrame(frame)) {
+        while (finishOldestFrame(items)) {
+        }
+        item.success = false;
         return false;
     }
 
-    memcpy(data, inputPixels, imageSize);
-    vkUnmapMemory(context_->getDevice(), stagingBufferMemory);
+    frame.busy = true;
+    frame.serial = serial;
+    frame.job = job;
+    frame.band = band;
+    return true;
+}
+
+bool VkComputePipeline::recordFrame(FrameSlot& frame, const TileJob& job, const BandStaging& band) {
+    if (computePath_ == ComputePath::STORAGE_BUFFER) {
+        return recordBufferFrame(frame, job, band);
+    }
+    const bool dedicatedTransfer = usesTransferQueue();
 
-    // 录制命令缓冲区
     VkCommandBufferBeginInfo beginInfo = {};
     beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
     beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
 
-    vkResetCommandBuffer(commandBuffer_, 0);
-    vkBeginCommandBuffer(commandBuffer_, &beginInfo);
+    // 块从行带中按整图行长直接拷贝
+    const VkDeviceSize tileOffset = static_cast<VkDeviceSize>(job.x) * 4;
+    VkBufferImageCopy region = {};
+    region.bufferOffset = band.upload.offset + tileOffset;
+    region.bufferRowLength = static_cast<uint32_t>(job.imageWidth);
+    region.bufferImageHeight = 0;
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.mipLevel = 0;
+    region.imageSubresource.baseArrayLayer = 0;
+    region.imageSubresource.layerCount = 1;
+    region.imageOffset = {0, 0, 0};
+    region.imageExtent = {static_cast<uint32_t>(job.width),
+                          static_cast<uint32_t>(job.height), 1};
 
-    // 转换输入图像布局
-    VkImageMemoryBarrier barrier = {};
-    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.image = inputImage_;
-    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    barrier.subresourceRange.baseMipLevel = 0;
-    barrier.subresourceRange.levelCount = 1;
-    barrier.subresourceRange.baseArrayLayer = 0;
-    barrier.subresourceRange.layerCount = 1;
-    barrier.srcAccessMask = 0;
-    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    // 上传：独立传输队列时单独录制，否则与计算录制在同一个命令缓冲区
+    VkCommandBuffer uploadCommands = dedicatedTransfer ? frame.uploadCommands : frame.computeCommands;
+    vkResetCommandBuffer(uploadCommands, 0);
+    vkBeginCommandBuffer(uploadCommands, &beginInfo);
 
+    VkImageMemoryBarrier barrier = createImageMemoryBarrier(
+        frame.inputImage, 0, VK_ACCESS_TRANSFER_WRITE_BIT,
+        VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
+    );
     vkCmdPipelineBarrier(
-        commandBuffer_,
+        uploadCommands,
         VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
         VK_PIPELINE_STAGE_TRANSFER_BIT,
         0,
@@ -1189,37 +1848,31 @@ bool VkComputePipeline::processImage(
         1, &barrier
     );
 
-    // 复制缓冲区到输入图像
-    VkBufferImageCopy region = {};
-    region.bufferOffset = 0;
-    region.bufferRowLength = 0;
-    region.bufferImageHeight = 0;
-    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    region.imageSubresource.mipLevel = 0;
-    region.imageSubresource.baseArrayLayer = 0;
-    region.imageSubresource.layerCount = 1;
-    region.imageOffset = {0, 0, 0};
-    region.imageExtent = {static_cast<uint32_t>(inputWidth), 
-                          static_cast<uint32_t>(inputHeight), 1};
-
     vkCmdCopyBufferToImage(
-        commandBuffer_,
-        stagingBuffer,
-        inputImage_,
+        uploadCommands,
+        band.upload.buffer,
+        frame.inputImage,
         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
         1,
         &region
     );
 
-    // 转换输入图像为General布局
-    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-    barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
-    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    if (dedicatedTransfer) {
+        vkEndCommandBuffer(uploadCommands);
+        vkResetCommandBuffer(frame.computeCommands, 0);
+        vkBeginCommandBuffer(frame.computeCommands, &beginInfo);
+    }
 
+    // 转换输入图像为General布局；跨队列时上传的可见性由信号量保证，源阶段取等待阶段
+    barrier = createImageMemoryBarrier(
+        frame.inputImage,
+        dedicatedTransfer ? 0 : VK_ACCESS_TRANSFER_WRITE_BIT,
+        VK_ACCESS_SHADER_READ_BIT,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_GENERAL
+    );
     vkCmdPipelineBarrier(
-        commandBuffer_,
-        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        frame.computeCommands,
+        dedicatedTransfer ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT : VK_PIPELINE_STAGE_TRANSFER_BIT,
         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
         0,
         0, nullptr,
@@ -1228,14 +1881,12 @@ bool VkComputePipeline::processImage(
     );
 
     // 转换输出图像为General布局
-    barrier.image = outputImage_;
-    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
-    barrier.srcAccessMask = 0;
-    barrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
-
+    barrier = createImageMemoryBarrier(
+        frame.outputImage, 0, VK_ACCESS_SHADER_WRITE_BIT,
+        VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL
+    );
     vkCmdPipelineBarrier(
-        commandBuffer_,
+        frame.computeCommands,
         VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
         0,
@@ -1245,153 +1896,285 @@ bool VkComputePipeline::processImage(
     );
 
     // 绑定计算管线
-    vkCmdBindPipeline(commandBuffer_, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_);
+    vkCmdBindPipeline(frame.computeCommands, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_);
     vkCmdBindDescriptorSets(
-        commandBuffer_,
+        frame.computeCommands,
         VK_PIPELINE_BIND_POINT_COMPUTE,
         pipelineLayout_,
         0,
         1,
-        &descriptorSet_,
+        &frame.descriptorSet,
         0,
         nullptr
     );
 
-    // 调度计算
-    uint32_t groupX = (inputWidth + 15) / 16;
-    uint32_t groupY = (inputHeight + 15) / 16;
-    vkCmdDispatch(commandBuffer_, groupX, groupY, 1);
-
-    // 转换输出图像为传输源
-    barrier.image = outputImage_;
-    barrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
-    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
-    barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    TileConstants constants = {};
+    constants.offsetX = job.x;
+    constants.offsetY = job.y;
+    constants.extentX = job.width;
+    constants.extentY = job.height;
+    constants.imageWidth = job.imageWidth;
+    constants.imageHeight = job.imageHeight;
+    vkCmdPushConstants(
+        frame.computeCommands,
+        pipelineLayout_,
+        VK_SHADER_STAGE_COMPUTE_BIT,
+        0,
+        sizeof(TileConstants),
+        &constants
+    );
 
+    // 调度计算
+    uint32_t groupX = (job.width + 15) / 16;
+    uint32_t groupY = (job.height + 15) / 16;
+    vkCmdDispatch(frame.computeCommands, groupX, groupY, 1);
+
+    // 转换输出图像为传输源；跨队列时由信号量衔接回读
+    barrier = createImageMemoryBarrier(
+        frame.outputImage,
+        VK_ACCESS_SHADER_WRITE_BIT,
+        dedicatedTransfer ? 0 : VK_ACCESS_TRANSFER_READ_BIT,
+        VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
+    );
     vkCmdPipelineBarrier(
-        commandBuffer_,
+        frame.computeCommands,
         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        dedicatedTransfer ? VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT : VK_PIPELINE_STAGE_TRANSFER_BIT,
         0,
         0, nullptr,
         0, nullptr,
         1, &barrier
     );
 
-    // 复制输出图像到暂存缓冲区
+    VkCommandBuffer readbackCommands = frame.computeCommands;
+    if (dedicatedTransfer) {
+        vkEndCommandBuffer(frame.computeCommands);
+        readbackCommands = frame.readbackCommands;
+        vkResetCommandBuffer(readbackCommands, 0);
+        vkBeginCommandBuffer(readbackCommands, &beginInfo);
+    }
+
+    // 复制输出图像到回读行带中的对应位置
+    region.bufferOffset = band.readback.offset + tileOffset;
     vkCmdCopyImageToBuffer(
-        commandBuffer_,
-        outputImage_,
+        readbackCommands,
+        frame.outputImage,
         VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-        stagingBuffer,
+        band.readback.buffer,
         1,
         &region
     );
 
-    vkEndCommandBuffer(commandBuffer_);
+    // 回读内存可能是HOST_CACHED，拷贝结果需对主机读取可见
+    VkBufferMemoryBarrier readbackBarrier = {};
+    readbackBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    readbackBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    readbackBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    readbackBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    readbackBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    readbackBarrier.buffer = band.readback.buffer;
+    readbackBarrier.offset = band.readback.offset;
+    readbackBarrier.size = band.readback.size;
 
-    // 提交命令
-    VkSubmitInfo submitInfo = {};
-    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &commandBuffer_;
+    vkCmdPipelineBarrier(
+        readbackCommands,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_HOST_BIT,
+        0,
+        0, nullptr,
+        1, &readbackBarrier,
+        0, nullptr
+    );
 
-    vkResetFences(context_->getDevice(), 1, &fence_);
-    result = vkQueueSubmit(context_->getComputeQueue(), 1, &submitInfo, fence_);
+    VkResult result = vkEndCommandBuffer(readbackCommands);
     if (result != VK_SUCCESS) {
-        LOGE("Failed to submit command buffer: %d", result);
-        vkFreeMemory(context_->getDevice(), stagingBufferMemory, nullptr);
-        vkDestroyBuffer(context_->getDevice(), stagingBuffer, nullptr);
+        LOGE("Failed to record frame commands: %d", result);
         return false;
     }
+    return true;
+}
 
-    // 等待完成
-    result = vkWaitForFences(context_->getDevice(), 1, &fence_, VK_TRUE, UINT64_MAX);
-    if (result != VK_SUCCESS) {
-        LOGE("Failed to wait for fence: %d", result);
-        vkFreeMemory(context_->getDevice(), stagingBufferMemory, nullptr);
-        vkDestroyBuffer(context_->getDevice(), stagingBuffer, nullptr);
-        return false;
-    }
+bool VkComputePipeline::recordBufferFrame(FrameSlot& frame, const TileJob& job, const BandStaging& band) {
+    VkCommandBufferBeginInfo beginInfo = {};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+    // 主机写入在提交时自动可见，无需上传屏障
+    vkResetCommandBuffer(frame.computeCommands, 0);
+    vkBeginCommandBuffer(frame.computeCommands, &beginInfo);
 
-    // 读取结果
-    result = vkMapMemory(context_->getDevice(), stagingBufferMemory, 0, imageSize, 0, &data);
+    vkCmdBindPipeline(frame.computeCommands, VK_PIPELINE_BIND_POINT_COMPUTE, bufferPipeline_);
+    vkCmdBindDescriptorSets(
+        frame.computeCommands,
+        VK_PIPELINE_BIND_POINT_COMPUTE,
+        bufferPipelineLayout_,
+        0,
+        1,
+        &frame.bufferDescriptorSet,
+        0,
+        nullptr
+    );
+
+    TileConstants constants = {};
+    constants.offsetX = job.x;
+    constants.offsetY = job.y;
+    constants.extentX = job.width;
+    constants.extentY = job.height;
+    constants.imageWidth = job.imageWidth;
+    constants.imageHeight = job.imageHeight;
+    vkCmdPushConstants(
+        frame.computeCommands,
+        bufferPipelineLayout_,
+        VK_SHADER_STAGE_COMPUTE_BIT,
+        0,
+        sizeof(TileConstants),
+        &constants
+    );
+
+    uint32_t groupX = (job.width + 15) / 16;
+    uint32_t groupY = (job.height + 15) / 16;
+    vkCmdDispatch(frame.computeCommands, groupX, groupY, 1);
+
+    // 着色器写入的回读区段需对主机读取可见
+    VkBufferMemoryBarrier readbackBarrier = {};
+    readbackBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    readbackBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    readbackBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    readbackBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    readbackBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    readbackBarrier.buffer = band.readback.buffer;
+    readbackBarrier.offset = band.readback.offset;
+    readbackBarrier.size = band.readback.size;
+
+    vkCmdPipelineBarrier(
+        frame.computeCommands,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_HOST_BIT,
+        0,
+        0, nullptr,
+        1, &readbackBarrier,
+        0, nullptr
+    );
+
+    VkResult result = vkEndCommandBuffer(frame.computeCommands);
     if (result != VK_SUCCESS) {
-        LOGE("Failed to map staging buffer for reading: %d", result);
-        vkFreeMemory(context_->getDevice(), stagingBufferMemory, nullptr);
-        vkDestroyBuffer(context_->getDevice(), stagingBuffer, nullptr);
+        LOGE("Failed to record buffer frame commands: %d", result);
         return false;
     }
+    return true;
+}
 
-    memcpy(outputPixels, data, imageSize);
-    
-    // 调试：检查前几个像素
-    if (inputWidth > 0 && inputHeight > 0) {
-        const uint8_t* firstPixel = outputPixels;
-        LOGD("Output pixel[0]: R=%d G=%d B=%d A=%d", 
-             firstPixel[0], firstPixel[1], firstPixel[2], firstPixel[3]);
-        
-        // 检查是否全黑
-        bool allBlack = true;
-        for (int i = 0; i < std::min(100, (int)imageSize); i += 4) {
-            if (outputPixels[i] != 0 || outputPixels[i+1] != 0 || 
-                outputPixels[i+2] != 0) {
-                allBlack = false;
-                break;
-            }
+bool VkComputePipeline::submitFrame(FrameSlot& frame) {
+    vkResetFences(context_->getDevice(), 1, &frame.fence);
+
+    VkSubmitInfo submitInfo = {};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+
+    VkResult result;
+    if (!usesTransferQueue()) {
+        submitInfo.pCommandBuffers = &frame.computeCommands;
+        result = vkQueueSubmit(context_->getComputeQueue(), 1, &submitInfo, frame.fence);
+    } else {
+        // 上传 -> 计算 -> 回读，用信号量串联；相邻帧的上传与回读在传输队列上与计算重叠
+        submitInfo.pCommandBuffers = &frame.uploadCommands;
+        submitInfo.signalSemaphoreCount = 1;
+        submitInfo.pSignalSemaphores = &frame.uploadDone;
+        result = vkQueueSubmit(context_->getTransferQueue(), 1, &submitInfo, VK_NULL_HANDLE);
+
+        if (result == VK_SUCCESS) {
+            const VkPipelineStageFlags computeWait = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+            submitInfo.waitSemaphoreCount = 1;
+            submitInfo.pWaitSemaphores = &frame.uploadDone;
+            submitInfo.pWaitDstStageMask = &computeWait;
+            submitInfo.pCommandBuffers = &frame.computeCommands;
+            submitInfo.pSignalSemaphores = &frame.computeDone;
+            result = vkQueueSubmit(context_->getComputeQueue(), 1, &submitInfo, VK_NULL_HANDLE);
         }
-        if (allBlack) {
-            LOGW("WARNING: Output appears to be all black!");
-            
-            // 检查输入像素
-            const uint8_t* inputFirst = inputPixels;
-            LOGD("Input pixel[0]: R=%d G=%d B=%d A=%d", 
-                 inputFirst[0], inputFirst[1], inputFirst[2], inputFirst[3]);
+
+        if (result == VK_SUCCESS) {
+            const VkPipelineStageFlags transferWait = VK_PIPELINE_STAGE_TRANSFER_BIT;
+            submitInfo.waitSemaphoreCount = 1;
+            submitInfo.pWaitSemaphores = &frame.computeDone;
+            submitInfo.pWaitDstStageMask = &transferWait;
+            submitInfo.pCommandBuffers = &frame.readbackCommands;
+            submitInfo.signalSemaphoreCount = 0;
+            submitInfo.pSignalSemaphores = nullptr;
+            result = vkQueueSubmit(context_->getTransferQueue(), 1, &submitInfo, frame.fence);
         }
     }
-    
-    vkUnmapMemory(context_->getDevice(), stagingBufferMemory);
-
-    // 清理
-    vkFreeMemory(context_->getDevice(), stagingBufferMemory, nullptr);
-    vkDestroyBuffer(context_->getDevice(), stagingBuffer, nullptr);
 
-    LOGD("Image processed successfully: %dx%d", inputWidth, inputHeight);
+    if (result != VK_SUCCESS) {
+        LOGE("Failed to submit frame: %d", result);
+        // 部分提交后无法单独撤回，等待队列空闲再复用本帧资源
+        vkDeviceWaitIdle(context_->getDevice());
+        return false;
+    }
     return true;
 }
 
-void VkComputePipeline::freeInOutImages() {
-    VkDevice device = context_->getDevice();
-
-    if (inputImageView_ != VK_NULL_HANDLE) {
-        vkDestroyImageView(device, inputImageView_, nullptr);
-        inputImageView_ = VK_NULL_HANDLE;
-    }
-    if (inputImage_ != VK_NULL_HANDLE) {
-        vkDestroyImage(device, inputImage_, nullptr);
-        inputImage_ = VK_NULL_HANDLE;
-    }
-    if (inputImageMemory_ != VK_NULL_HANDLE) {
-        vkFreeMemory(device, inputImageMemory_, nullptr);
-        inputImageMemory_ = VK_NULL_HANDLE;
+void VkComputePipeline::finishFrame(FrameSlot& frame, std::vector<BatchItem>& items) {
+    if (!frame.busy) {
+        return;
     }
+    frame.busy = false;
 
-    if (outputImageView_ != VK_NULL_HANDLE) {
-        vkDestroyImageView(device, outputImageView_, nullptr);
-        outputImageView_ = VK_NULL_HANDLE;
-    }
-    if (outputImage_ != VK_NULL_HANDLE) {
-        vkDestroyImage(device, outputImage_, nullptr);
-        outputImage_ = VK_NULL_HANDLE;
+    const TileJob& job = frame.job;
+    BatchItem& item = items[job.itemIndex];
+    VkResult result = vkWaitForFences(context_->getDevice(), 1, &frame.fence, VK_TRUE, UINT64_MAX);
+    if (result != VK_SUCCESS) {
+        LOGE("Failed to wait for frame fence: %d", result);
+        item.success = false;
+    } else if (job.lastInBand && item.success) {
+        // 帧按提交顺序完成，行带的各块此时都已写回，整条行带一次拷出
+        const size_t rowBytes = static_cast<size_t>(job.imageWidth) * 4;
+        readbackRing_->invalidate(frame.band.readback);
+        memcpy(item.outputPixels + rowBytes * job.y, frame.band.readback.mappedData,
+               frame.band.readback.size);
+    }
+
+    // 回收序号不大于本帧的暂存区段；行带区段要到最后一块完成才回收
+    uploadRing_->release(frame.serial);
+    readbackRing_->release(frame.serial);
+    frame.band = BandStaging();
+}
+
+bool VkComputePipeline::finishOldestFrame(std::vector<BatchItem>& items) {
+    FrameSlot* oldest = nullptr;
+    for (FrameSlot& frame : frames_) {
+        if (frame.busy && (!oldest || frame.serial < oldest->serial)) {
+            oldest = &frame;
+        }
     }
-    if (outputImageMemory_ != VK_NULL_HANDLE) {
-        vkFreeMemory(device, outputImageMemory_, nullptr);
-        outputImageMemory_ = VK_NULL_HANDLE;
+    if (!oldest) {
+        return false;
     }
+    finishFrame(*oldest, items);
+    return true;
+}
 
-    currentWidth_ = 0;
-    currentHeight_ = 0;
+VkImageMemoryBarrier VkComputePipeline::createImageMemoryBarrier(
+    VkImage image,
+    VkAccessFlags srcAccessMask,
+    VkAccessFlags dstAccessMask,
+    VkImageLayout oldLayout,
+    VkImageLayout newLayout
+) {
+    VkImageMemoryBarrier barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.oldLayout = oldLayout;
+    barrier.newLayout = newLayout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.baseMipLevel = 0;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount = 1;
+    barrier.srcAccessMask = srcAccessMask;
+    barrier.dstAccessMask = dstAccessMask;
+    return barrier;
 }
 
 } // namespace vulkan
@@ -1,6 +1,8 @@
 #ifndef VK_COMPUTE_PIPELINE_H
 #define VK_COMPUTE_PIPELINE_H
 
+#include "vk_staging_ring.h"
+#include "vk_pipeline_cache_file.h"
 #include <vulkan/vulkan.h>
 #include <vector>
 #include <string>
@@ -47,6 +49,31 @@ public:
         float colorPreservation = 0.8f;
     };
 
+    /**
+     * 批处理中的一张图片
+     */
+    struct BatchItem {
+        int width = 0;
+        int height = 0;
+        const uint8_t* inputPixels = nullptr;
+        uint8_t* outputPixels = nullptr;
+        bool success = false;   // 处理结果，由processBatch填写
+    };
+
+    /**
+     * 像素读写方式
+     */
+    enum class ComputePath {
+        STORAGE_IMAGE,  // 暂存区拷贝到rgba8存储图像，处理后再拷回
+        STORAGE_BUFFER  // 着色器直接读写暂存区中打包的RGBA8，省去两次整图拷贝与图像布局转换
+    };
+
+    // 批处理时同时在途的帧数
+    static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 3;
+
+    // 分块处理时一条行带的暂存上限，超大图片的暂存环不随整图增长
+    static constexpr VkDeviceSize MAX_TILED_BAND_BYTES = 64 * 1024 * 1024;
+
     /**
      * 构造函数
      * @param context Vulkan上下文
@@ -65,6 +92,34 @@ public:
      */
     void setAssetManager(AAssetManager* assetManager);
 
+    /**
+     * 设置SPIR-V着色器文件路径（无Asset管理器时使用，如在Linux上用lavapipe验证）
+     * 存储缓冲区变体从同目录的同名*_buffer.spv加载
+     * @param path 文件路径
+     */
+    void setShaderPath(const std::string& path);
+
+    /**
+     * 设置磁盘管线缓存文件路径，需在initialize之前调用
+     * @param path 文件路径，空字符串表示不保存到磁盘
+     */
+    void setPipelineCachePath(const std::string& path) { pipelineCachePath_ = path; }
+
+    /**
+     * 限制单块的最大边长
+     * @param limit 最大边长，0表示使用设备的maxImageDimension2D；不会超过设备限制
+     */
+    void setTileDimensionLimit(uint32_t limit) { tileDimensionLimit_ = limit; }
+
+    /**
+     * 选择像素读写方式，可在两次处理之间切换
+     * 存储缓冲区变体在首次选择时创建，着色器缺失或创建失败时保持原方式
+     * @return 是否切换成功
+     */
+    bool setComputePath(ComputePath path);
+
+    ComputePath getComputePath() const { return computePath_; }
+
     /**
      * 初始化计算管线
      * @return 是否初始化成功
@@ -102,11 +157,35 @@ public:
         const ProcessingParams& params
     );
 
+    /**
+     * 批量处理图像
+     * 最多MAX_FRAMES_IN_FLIGHT张图片同时在途，每帧有独立的命令缓冲区、栅栏、描述符集与暂存区段：
+     * CPU拷入下一张图片时GPU仍在处理上一张；有独立传输队列时上传与回读在传输队列上执行，
+     * 用信号量与计算队列衔接，三者在相邻图片之间重叠。
+     * 超过maxImageDimension2D的图片按行带切块，每块占一帧：行带整体拷入暂存环一次，
+     * 各块以bufferRowLength与偏移直接从中拷贝，CPU不再重新排列像素
+     * @param items 图片列表，各图片尺寸可以不同，处理结果写入每项的success
+     * @param params 处理参数（整批共用）
+     * @return 是否全部处理成功
+     */
+    bool processBatch(std::vector<BatchItem>& items, const ProcessingParams& params);
+
     /**
      * 检查是否已初始化
      */
     bool isInitialized() const { return initialized_; }
 
+    /**
+     * 获取上传与回读暂存环的统计
+     */
+    VkStagingRing::Stats getUploadRingStats() const { return uploadRing_->getStats(); }
+    VkStagingRing::Stats getReadbackRingStats() const { return readbackRing_->getStats(); }
+
+    /**
+     * 本次初始化是否复用了磁盘上的管线缓存
+     */
+    bool isPipelineCacheLoaded() const { return pipelineCache_->isLoadedFromFile(); }
+
 private:
     VkContext* context_;
     VkMemoryPool* memoryPool_;
@@ -117,15 +196,25 @@ private:
     VkPipeline pipeline_ = VK_NULL_HANDLE;
     VkDescriptorSetLayout descriptorSetLayout_ = VK_NULL_HANDLE;
     VkDescriptorPool descriptorPool_ = VK_NULL_HANDLE;
-    VkDescriptorSet descriptorSet_ = VK_NULL_HANDLE;
 
     // 着色器模块
     VkShaderModule computeShaderModule_ = VK_NULL_HANDLE;
 
+    // 存储缓冲区变体，首次选择时创建
+    VkShaderModule bufferShaderModule_ = VK_NULL_HANDLE;
+    VkDescriptorSetLayout bufferDescriptorSetLayout_ = VK_NULL_HANDLE;
+    VkPipelineLayout bufferPipelineLayout_ = VK_NULL_HANDLE;
+    VkPipeline bufferPipeline_ = VK_NULL_HANDLE;
+    ComputePath computePath_ = ComputePath::STORAGE_IMAGE;
+
     // 资源
     VkBuffer uniformBuffer_ = VK_NULL_HANDLE;
     VkDeviceMemory uniformBufferMemory_ = VK_NULL_HANDLE;
 
+    // 有序抖动阈值表
+    VkBuffer ditherBuffer_ = VK_NULL_HANDLE;
+    VkDeviceMemory ditherBufferMemory_ = VK_NULL_HANDLE;
+
     // LUT纹理
     VkImage lutImage_ = VK_NULL_HANDLE;
     VkDeviceMemory lutImageMemory_ = VK_NULL_HANDLE;
@@ -136,25 +225,93 @@ private:
     VkDeviceMemory lut2ImageMemory_ = VK_NULL_HANDLE;
     VkImageView lut2ImageView_ = VK_NULL_HANDLE;
 
-    // 输入输出图像
-    VkImage inputImage_ = VK_NULL_HANDLE;
-    VkDeviceMemory inputImageMemory_ = VK_NULL_HANDLE;
-    VkImageView inputImageView_ = VK_NULL_HANDLE;
+    /**
+     * 推送常量：块在整图中的位置，着色器用全局像素坐标计算颗粒与抖动，块之间没有接缝
+     */
+    struct TileConstants {
+        int32_t offsetX;
+        int32_t offsetY;
+        int32_t extentX;        // 块的有效尺寸，帧图像可能更大
+        int32_t extentY;
+        int32_t imageWidth;     // 整图尺寸
+        int32_t imageHeight;
+    };
+
+    /**
+     * 一块的处理任务，未分块的图片只有一块
+     */
+    struct TileJob {
+        size_t itemIndex = 0;
+        int x = 0;              // 块在整图中的位置，y即所在行带的起点
+        int y = 0;
+        int width = 0;
+        int height = 0;
+        int imageWidth = 0;     // 整图尺寸，宽度即暂存区的行长
+        int imageHeight = 0;
+        int frameWidth = 0;     // 帧图像尺寸，同一图片的各块相同，边缘块只用其中一部分
+        int frameHeight = 0;
+        int bandTiles = 1;      // 所在行带的块数
+        bool firstInBand = true;
+        bool lastInBand = true;
+    };
+
+    /**
+     * 一条行带在暂存环中的上传与回读区段，由行带最后一块的提交序号回收
+     */
+    struct BandStaging {
+        VkStagingRing::Allocation upload;
+        VkStagingRing::Allocation readback;
+        uint64_t serial = 0;
+    };
 
-    VkImage outputImage_ = VK_NULL_HANDLE;
-    VkDeviceMemory outputImageMemory_ = VK_NULL_HANDLE;
-    VkImageView outputImageView_ = VK_NULL_HANDLE;
+    /**
+     * 一帧的独立资源与在途状态
+     */
+    struct FrameSlot {
+        VkImage inputImage = VK_NULL_HANDLE;
+        VkDeviceMemory inputImageMemory = VK_NULL_HANDLE;
+        VkImageView inputImageView = VK_NULL_HANDLE;
+        VkImage outputImage = VK_NULL_HANDLE;
+        VkDeviceMemory outputImageMemory = VK_NULL_HANDLE;
+        VkImageView outputImageView = VK_NULL_HANDLE;
+        int width = 0;      // 帧图像的已分配尺寸（高水位）
+        int height = 0;
+
+        VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+        VkDescriptorSet bufferDescriptorSet = VK_NULL_HANDLE;   // 存储缓冲区变体
+        VkCommandBuffer computeCommands = VK_NULL_HANDLE;
+        VkCommandBuffer uploadCommands = VK_NULL_HANDLE;    // 仅独立传输队列
+        VkCommandBuffer readbackCommands = VK_NULL_HANDLE;  // 仅独立传输队列
+        VkSemaphore uploadDone = VK_NULL_HANDLE;
+        VkSemaphore computeDone = VK_NULL_HANDLE;
+        VkFence fence = VK_NULL_HANDLE;                     // 回读完成
+
+        bool busy = false;
+        uint64_t serial = 0;
+        TileJob job;
+        BandStaging band;
+    };
 
-    // 命令缓冲区
-    VkCommandBuffer commandBuffer_ = VK_NULL_HANDLE;
+    std::vector<FrameSlot> frames_;
+    std::string shaderPath_;
+
+    // 管线缓存，跨启动复用驱动的编译结果
+    std::unique_ptr<VkPipelineCacheFile> pipelineCache_;
+    std::string pipelineCachePath_;
+
+    // 持久映射的上传与回读暂存环，按提交序号回收
+    std::unique_ptr<VkStagingRing> uploadRing_;
+    std::unique_ptr<VkStagingRing> readbackRing_;
+    uint64_t submitSerial_ = 0;
+
+    // 单块最大边长，0表示使用设备限制
+    uint32_t tileDimensionLimit_ = 0;
 
-    // 同步
-    VkFence fence_ = VK_NULL_HANDLE;
+    // LUT上传使用的命令缓冲区
+    VkCommandBuffer commandBuffer_ = VK_NULL_HANDLE;
 
     // 状态
     bool initialized_ = false;
-    int currentWidth_ = 0;
-    int currentHeight_ = 0;
     int lutSize_ = 0;
     int lut2Size_ = 0;
 
@@ -170,6 +327,19 @@ private:
      */
     std::vector<char> loadSPIRVFromAssets(const std::string& assetPath);
 
+    /**
+     * 从文件加载SPIR-V着色器
+     */
+    std::vector<char> loadSPIRVFromFile(const std::string& path);
+
+    /**
+     * 检查SPIR-V是否声明了推送常量（分块偏移与尺寸）
+     * 早于分块的旧二进制不读取推送常量，分块时每块都会按原点取样，须拒绝加载
+     * @param spirvCode SPIR-V数据
+     * @return 是否声明了推送常量
+     */
+    static bool declaresTileConstants(const std::vector<char>& spirvCode);
+
     /**
      * 从嵌入数据创建着色器模块
      */
@@ -177,13 +347,30 @@ private:
 
     /**
      * 创建描述符集布局
+     * @param pixelType 输入输出像素的描述符类型（存储图像或存储缓冲区）
      */
-    bool createDescriptorSetLayout();
+    bool createDescriptorSetLayout(VkDescriptorType pixelType, VkDescriptorSetLayout& layout);
 
     /**
      * 创建计算管线
      */
-    bool createComputePipeline();
+    bool createComputePipeline(VkShaderModule shaderModule, VkDescriptorSetLayout setLayout,
+                               VkPipelineLayout& layout, VkPipeline& pipeline);
+
+    /**
+     * 创建存储缓冲区变体的着色器、管线与各帧描述符集
+     */
+    bool createBufferVariant();
+
+    /**
+     * 释放存储缓冲区变体
+     */
+    void destroyBufferVariant();
+
+    /**
+     * 上传与回读是否在独立传输队列上执行（存储缓冲区变体没有拷贝）
+     */
+    bool usesTransferQueue() const;
 
     /**
      * 创建描述符池和描述符集
@@ -195,6 +382,11 @@ private:
      */
     bool createUniformBuffer();
 
+    /**
+     * 创建有序抖动阈值缓冲区（Bayer与蓝噪声，与CPU共用DitherMatrix数据）
+     */
+    bool createDitherBuffer();
+
     /**
      * 创建LUT纹理
      */
@@ -202,24 +394,79 @@ private:
                           VkImageView& imageView, int lutSize);
 
     /**
-     * 创建输入输出图像
+     * 创建存储图像及其视图（有独立传输队列时两个队列族并发共享）
+     */
+    bool createStorageImage(int width, int height, VkImageUsageFlags usage,
+                            VkImage& image, VkDeviceMemory& memory, VkImageView& imageView);
+
+    /**
+     * 释放存储图像
+     */
+    void destroyStorageImage(VkImage& image, VkDeviceMemory& memory, VkImageView& imageView);
+
+    /**
+     * 创建各帧的命令缓冲区、同步对象与描述符集
+     */
+    bool createFrameSlots();
+
+    /**
+     * 释放各帧资源
+     */
+    void destroyFrameSlots();
+
+    /**
+     * 准备至少能容纳指定尺寸的帧输入输出图像。
+     * 图像保持在高水位尺寸，只在需要更大时重建，块的拷贝与调度按块尺寸进行
+     */
+    bool prepareFrameImages(FrameSlot& frame, int width, int height);
+
+    /**
+     * 更新帧的描述符集（LUT可能已重新加载，每帧开始时写入）
+     * 存储缓冲区变体把行带的暂存区段绑定为输入输出
+     */
+    void writeDescriptorSet(const FrameSlot& frame, const BandStaging& band);
+
+    /**
+     * 单块的最大边长
+     */
+    int tileDimension() const;
+
+    /**
+     * 把各图片切成块，尺寸无效的图片直接标记为失败
+     */
+    void planTiles(std::vector<BatchItem>& items, std::vector<TileJob>& jobs) const;
+
+    /**
+     * 提交一块；行带的第一块负责把整条行带拷入暂存环
+     */
+    bool beginFrame(FrameSlot& frame, std::vector<BatchItem>& items, const TileJob& job,
+                    BandStaging& band);
+
+    /**
+     * 录制一帧的命令缓冲区
      */
-    bool createInOutImages(int width, int height);
+    bool recordFrame(FrameSlot& frame, const TileJob& job, const BandStaging& band);
 
     /**
-     * 更新描述符集
+     * 录制存储缓冲区变体的一帧：只有调度与回读可见性屏障
      */
-    void updateDescriptorSet();
+    bool recordBufferFrame(FrameSlot& frame, const TileJob& job, const BandStaging& band);
 
     /**
-     * 录制命令缓冲区
+     * 提交一帧
      */
-    bool recordCommandBuffer(const ProcessingParams& params);
+    bool submitFrame(FrameSlot& frame);
 
     /**
-     * 执行计算
+     * 等待一帧完成，行带的最后一块完成后读回整条行带
      */
-    bool submitAndWait();
+    void finishFrame(FrameSlot& frame, std::vector<BatchItem>& items);
+
+    /**
+     * 完成最早提交的在途帧
+     * @return 没有在途帧时返回false
+     */
+    bool finishOldestFrame(std::vector<BatchItem>& items);
 
     /**
      * 创建图像内存屏障
@@ -231,11 +478,6 @@ private:
         VkImageLayout oldLayout,
         VkImageLayout newLayout
     );
-
-    /**
-     * 释放输入输出图像资源
-     */
-    void freeInOutImages();
 };
 
 } // namespace vulkan
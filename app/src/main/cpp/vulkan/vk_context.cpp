@@ -1,5 +1,7 @@
 #include "vk_context.h"
 #include <android/log.h>
+#include <cstring>
+#include <mutex>
 #include <set>
 #include <stdexcept>
 
@@ -113,6 +115,11 @@ void VkContext::cleanup() {
 
     LOGI("Cleaning up Vulkan context...");
 
+    if (transferCommandPool_ != VK_NULL_HANDLE && transferCommandPool_ != commandPool_) {
+        vkDestroyCommandPool(device_, transferCommandPool_, nullptr);
+    }
+    transferCommandPool_ = VK_NULL_HANDLE;
+
     if (commandPool_ != VK_NULL_HANDLE) {
         vkDestroyCommandPool(device_, commandPool_, nullptr);
         commandPool_ = VK_NULL_HANDLE;
@@ -241,6 +248,18 @@ bool VkContext::selectPhysicalDevice() {
         vkGetPhysicalDeviceProperties(device, &deviceProperties_);
         vkGetPhysicalDeviceMemoryProperties(device, &memoryProperties_);
 
+        // 设备UUID用于校验磁盘上的管线缓存，需要Vulkan 1.1
+        std::memset(deviceUUID_, 0, sizeof(deviceUUID_));
+        if (deviceProperties_.apiVersion >= VK_API_VERSION_1_1) {
+            VkPhysicalDeviceIDProperties idProperties = {};
+            idProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES;
+            VkPhysicalDeviceProperties2 properties2 = {};
+            properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+            properties2.pNext = &idProperties;
+            vkGetPhysicalDeviceProperties2(device, &properties2);
+            std::memcpy(deviceUUID_, idProperties.deviceUUID, sizeof(deviceUUID_));
+        }
+
         physicalDevice_ = device;
         LOGI("Selected physical device: %s", deviceProperties_.deviceName);
         return true;
@@ -311,6 +330,18 @@ bool VkContext::createCommandPool() {
         return false;
     }
 
+    // 独立的传输队列族需要自己的命令池
+    if (transferQueueFamily_ != computeQueueFamily_) {
+        poolInfo.queueFamilyIndex = transferQueueFamily_;
+        result = vkCreateCommandPool(device_, &poolInfo, nullptr, &transferCommandPool_);
+        if (result != VK_SUCCESS) {
+            LOGE("Failed to create transfer command pool: %d", result);
+            return false;
+        }
+    } else {
+        transferCommandPool_ = commandPool_;
+    }
+
     LOGI("Command pool created successfully");
     return true;
 }
@@ -418,28 +449,34 @@ uint32_t VkContext::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags pr
 }
 
 bool VkContext::isVulkanSupported() {
-    // 尝试创建临时实例来检查Vulkan支持
-    VkApplicationInfo appInfo = {};
-    appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
-    appInfo.pApplicationName = "VulkanCheck";
-    appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
-    appInfo.pEngineName = "No Engine";
-    appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-    appInfo.apiVersion = VK_API_VERSION_1_1;
-
-    VkInstanceCreateInfo createInfo = {};
-    createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
-    createInfo.pApplicationInfo = &appInfo;
+    return probe().available;
+}
 
-    VkInstance testInstance;
-    VkResult result = vkCreateInstance(&createInfo, nullptr, &testInstance);
+VkContext::DeviceProbe VkContext::probe() {
+    static std::mutex mutex;
+    static DeviceProbe result;
+    static bool probed = false;
 
-    if (result == VK_SUCCESS) {
-        vkDestroyInstance(testInstance, nullptr);
-        return true;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (probed) {
+        return result;
+    }
+    probed = true;
+
+    // 临时上下文只走到物理设备选择，选中的设备与initialize一致
+    VkContext context;
+    if (context.createInstance() && context.selectPhysicalDevice()) {
+        result.available = true;
+        result.properties = context.deviceProperties_;
+        result.dedicatedTransferQueue = context.hasDedicatedTransferQueue();
+    }
+    if (context.instance_ != VK_NULL_HANDLE) {
+        vkDestroyInstance(context.instance_, nullptr);
+        context.instance_ = VK_NULL_HANDLE;
     }
 
-    return false;
+    LOGI("Vulkan probe: %s", result.available ? result.properties.deviceName : "no suitable device");
+    return result;
 }
 
 uint32_t VkContext::getMaxImageDimension2D() const {
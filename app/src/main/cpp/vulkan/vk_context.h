@@ -2,6 +2,7 @@
 #define VK_CONTEXT_H
 
 #include <vulkan/vulkan.h>
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <memory>
@@ -14,6 +15,15 @@ namespace vulkan {
  */
 class VkContext {
 public:
+    /**
+     * 轻量级能力探测结果
+     */
+    struct DeviceProbe {
+        bool available = false;                 // 有满足要求的物理设备
+        VkPhysicalDeviceProperties properties{};
+        bool dedicatedTransferQueue = false;
+    };
+
     VkContext();
     ~VkContext();
 
@@ -44,15 +54,26 @@ public:
     VkQueue getComputeQueue() const { return computeQueue_; }
     VkQueue getTransferQueue() const { return transferQueue_; }
     VkCommandPool getCommandPool() const { return commandPool_; }
+    VkCommandPool getTransferCommandPool() const { return transferCommandPool_; }
     uint32_t getComputeQueueFamily() const { return computeQueueFamily_; }
     uint32_t getTransferQueueFamily() const { return transferQueueFamily_; }
 
+    /**
+     * 是否有独立于计算队列族的传输队列
+     */
+    bool hasDedicatedTransferQueue() const { return transferQueueFamily_ != computeQueueFamily_; }
+
     /**
      * 获取设备属性
      */
     const VkPhysicalDeviceProperties& getDeviceProperties() const { return deviceProperties_; }
     const VkPhysicalDeviceMemoryProperties& getMemoryProperties() const { return memoryProperties_; }
 
+    /**
+     * 设备UUID，设备不支持Vulkan 1.1时全为0
+     */
+    const uint8_t* getDeviceUUID() const { return deviceUUID_; }
+
     /**
      * 查找合适的内存类型
      * @param typeFilter 内存类型过滤器
@@ -62,10 +83,16 @@ public:
     uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
 
     /**
-     * 检查设备是否支持Vulkan
+     * 检查设备是否支持Vulkan（即probe().available）
      */
     static bool isVulkanSupported();
 
+    /**
+     * 只创建实例并按initialize相同的规则选择物理设备，不创建逻辑设备、队列与命令池
+     * 结果在进程内缓存，可用性与纹理尺寸查询不必再初始化完整的上下文
+     */
+    static DeviceProbe probe();
+
     /**
      * 获取最大纹理尺寸
      */
@@ -78,12 +105,14 @@ private:
     VkQueue computeQueue_ = VK_NULL_HANDLE;
     VkQueue transferQueue_ = VK_NULL_HANDLE;
     VkCommandPool commandPool_ = VK_NULL_HANDLE;
+    VkCommandPool transferCommandPool_ = VK_NULL_HANDLE; // 与计算队列同族时即commandPool_
 
     uint32_t computeQueueFamily_ = 0;
     uint32_t transferQueueFamily_ = 0;
 
     VkPhysicalDeviceProperties deviceProperties_;
     VkPhysicalDeviceMemoryProperties memoryProperties_;
+    uint8_t deviceUUID_[VK_UUID_SIZE] = {};
 
     bool initialized_ = false;
 
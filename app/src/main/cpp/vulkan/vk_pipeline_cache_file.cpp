@@ -0,0 +1,193 @@
+#include "vk_pipeline_cache_file.h"
+#include "vk_context.h"
+#include "../utils/file_utils.h"
+#include <android/log.h>
+#include <cstdio>
+#include <cstring>
+
+#define LOG_TAG "VkPipelineCacheFile"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+
+namespace vulkan {
+
+namespace {
+
+/**
+ * 文件头，其后紧跟vkGetPipelineCacheData的数据
+ */
+struct PipelineCacheFileHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t vendorID;
+    uint32_t deviceID;
+    uint32_t driverVersion;
+    uint32_t dataSize;
+    uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+    uint8_t deviceUUID[VK_UUID_SIZE];
+    uint64_t checksum;
+};
+
+static_assert(sizeof(PipelineCacheFileHeader) == 64, "PipelineCacheFileHeader布局必须固定");
+
+void fillHeader(const VkContext* context, PipelineCacheFileHeader& header) {
+    const VkPhysicalDeviceProperties& properties = context->getDeviceProperties();
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, VkPipelineCacheFile::FILE_MAGIC, sizeof(header.magic));
+    header.version = VkPipelineCacheFile::FILE_VERSION;
+    header.vendorID = properties.vendorID;
+    header.deviceID = properties.deviceID;
+    header.driverVersion = properties.driverVersion;
+    std::memcpy(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE);
+    std::memcpy(header.deviceUUID, context->getDeviceUUID(), VK_UUID_SIZE);
+}
+
+} // namespace
+
+VkPipelineCacheFile::VkPipelineCacheFile(VkContext* context) : context_(context) {
+}
+
+VkPipelineCacheFile::~VkPipelineCacheFile() {
+    destroy();
+}
+
+bool VkPipelineCacheFile::create(const std::string& path) {
+    destroy();
+    path_ = path;
+
+    std::vector<uint8_t> data;
+    if (!path_.empty()) {
+        data = loadData();
+    }
+
+    VkPipelineCacheCreateInfo createInfo = {};
+    createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    createInfo.initialDataSize = data.size();
+    createInfo.pInitialData = data.empty() ? nullptr : data.data();
+
+    VkResult result = vkCreatePipelineCache(context_->getDevice(), &createInfo, nullptr, &cache_);
+    if (result != VK_SUCCESS && !data.empty()) {
+        // 驱动拒绝旧数据时从空缓存开始
+        LOGW("Pipeline cache data rejected: %d", result);
+        data.clear();
+        createInfo.initialDataSize = 0;
+        createInfo.pInitialData = nullptr;
+        result = vkCreatePipelineCache(context_->getDevice(), &createInfo, nullptr, &cache_);
+    }
+    if (result != VK_SUCCESS) {
+        LOGE("Failed to create pipeline cache: %d", result);
+        cache_ = VK_NULL_HANDLE;
+        return false;
+    }
+
+    loadedFromFile_ = !data.empty();
+    savedBytes_ = data.size();
+    if (loadedFromFile_) {
+        LOGI("Pipeline cache loaded: %zu bytes from %s", data.size(), path_.c_str());
+    }
+    return true;
+}
+
+std::vector<uint8_t> VkPipelineCacheFile::loadData() const {
+    FILE* file = fopen(path_.c_str(), "rb");
+    if (!file) {
+        return {};
+    }
+
+    PipelineCacheFileHeader header;
+    std::vector<uint8_t> data;
+    bool read = fread(&header, sizeof(header), 1, file) == 1 &&
+                std::memcmp(header.magic, FILE_MAGIC, sizeof(header.magic)) == 0 &&
+                header.version == FILE_VERSION &&
+                header.dataSize > 0 && header.dataSize <= MAX_DATA_BYTES;
+    if (read) {
+        data.resize(header.dataSize);
+        read = fread(data.data(), data.size(), 1, file) == 1 &&
+               FileUtils::fnv1a64(data.data(), data.size()) == header.checksum;
+    }
+    fclose(file);
+
+    if (!read) {
+        LOGW("Pipeline cache file invalid, ignoring: %s", path_.c_str());
+        return {};
+    }
+
+    PipelineCacheFileHeader expected;
+    fillHeader(context_, expected);
+    if (header.vendorID != expected.vendorID || header.deviceID != expected.deviceID ||
+        header.driverVersion != expected.driverVersion ||
+        std::memcmp(header.pipelineCacheUUID, expected.pipelineCacheUUID, VK_UUID_SIZE) != 0 ||
+        std::memcmp(header.deviceUUID, expected.deviceUUID, VK_UUID_SIZE) != 0) {
+        LOGI("Pipeline cache belongs to another device or driver, rebuilding");
+        return {};
+    }
+
+    // 驱动自己的缓存头也必须匹配，部分驱动对不匹配的数据处理不当
+    VkPipelineCacheHeaderVersionOne driverHeader;
+    if (data.size() < sizeof(driverHeader)) {
+        return {};
+    }
+    std::memcpy(&driverHeader, data.data(), sizeof(driverHeader));
+    if (driverHeader.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE ||
+        driverHeader.vendorID != expected.vendorID || driverHeader.deviceID != expected.deviceID ||
+        std::memcmp(driverHeader.pipelineCacheUUID, expected.pipelineCacheUUID,
+                    VK_UUID_SIZE) != 0) {
+        LOGW("Pipeline cache driver header mismatch, ignoring");
+        return {};
+    }
+
+    return data;
+}
+
+bool VkPipelineCacheFile::save() {
+    if (cache_ == VK_NULL_HANDLE || path_.empty()) {
+        return false;
+    }
+
+    VkDevice device = context_->getDevice();
+    size_t size = 0;
+    VkResult result = vkGetPipelineCacheData(device, cache_, &size, nullptr);
+    if (result != VK_SUCCESS || size == 0 || size > MAX_DATA_BYTES) {
+        return false;
+    }
+    if (size == savedBytes_) {
+        return true;
+    }
+
+    std::vector<uint8_t> data(size);
+    result = vkGetPipelineCacheData(device, cache_, &size, data.data());
+    if (result != VK_SUCCESS) {
+        LOGW("Failed to read pipeline cache data: %d", result);
+        return false;
+    }
+    data.resize(size);
+
+    PipelineCacheFileHeader header;
+    fillHeader(context_, header);
+    header.dataSize = static_cast<uint32_t>(data.size());
+    header.checksum = FileUtils::fnv1a64(data.data(), data.size());
+
+    if (!FileUtils::writeAtomically(path_, {{&header, sizeof(header)},
+                                            {data.data(), data.size()}})) {
+        LOGW("Failed to write pipeline cache file: %s", path_.c_str());
+        return false;
+    }
+
+    savedBytes_ = data.size();
+    LOGI("Pipeline cache saved: %zu bytes", data.size());
+    return true;
+}
+
+void VkPipelineCacheFile::destroy() {
+    if (cache_ != VK_NULL_HANDLE) {
+        vkDestroyPipelineCache(context_->getDevice(), cache_, nullptr);
+        cache_ = VK_NULL_HANDLE;
+    }
+    savedBytes_ = 0;
+    loadedFromFile_ = false;
+}
+
+} // namespace vulkan
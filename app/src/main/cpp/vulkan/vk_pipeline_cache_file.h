@@ -0,0 +1,76 @@
+#ifndef VK_PIPELINE_CACHE_FILE_H
+#define VK_PIPELINE_CACHE_FILE_H
+
+#include <vulkan/vulkan.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace vulkan {
+
+class VkContext;
+
+/**
+ * 保存在磁盘上的管线缓存
+ * 每次启动都从SPIR-V重新编译计算管线，首张照片的延迟主要花在这里。
+ * 管线创建后把VkPipelineCache序列化到应用缓存目录，下次启动时载入，驱动直接复用编译结果。
+ * 文件头记录厂商、设备、驱动版本、管线缓存UUID与设备UUID，任一项不一致（驱动升级、换机恢复数据）
+ * 或数据校验和不符时丢弃旧文件，从空缓存开始
+ */
+class VkPipelineCacheFile {
+public:
+    static constexpr char FILE_MAGIC[4] = {'L', '2', 'P', 'V'};
+    static constexpr uint16_t FILE_VERSION = 1;
+    // 超过该大小的文件视为损坏
+    static constexpr size_t MAX_DATA_BYTES = 16 * 1024 * 1024;
+
+    explicit VkPipelineCacheFile(VkContext* context);
+    ~VkPipelineCacheFile();
+
+    // 禁止拷贝
+    VkPipelineCacheFile(const VkPipelineCacheFile&) = delete;
+    VkPipelineCacheFile& operator=(const VkPipelineCacheFile&) = delete;
+
+    /**
+     * 创建管线缓存，文件与当前设备匹配时用其中的数据初始化
+     * @param path 缓存文件路径，空字符串表示只在内存中缓存
+     * @return 是否创建成功
+     */
+    bool create(const std::string& path);
+
+    /**
+     * 缓存内容有变化时写回文件（写入临时文件后原子重命名）
+     * @return 是否已与文件一致，未设置路径时返回false
+     */
+    bool save();
+
+    /**
+     * 销毁管线缓存，不写回文件
+     */
+    void destroy();
+
+    VkPipelineCache getHandle() const { return cache_; }
+
+    /**
+     * 本次是否从文件载入了有效数据
+     */
+    bool isLoadedFromFile() const { return loadedFromFile_; }
+
+private:
+    VkContext* context_;
+    VkPipelineCache cache_ = VK_NULL_HANDLE;
+    std::string path_;
+    size_t savedBytes_ = 0;     // 文件中数据的大小，缓存增长后才需要写回
+    bool loadedFromFile_ = false;
+
+    /**
+     * 读取并校验缓存文件
+     * @return 数据部分，文件不存在或与当前设备不匹配时为空
+     */
+    std::vector<uint8_t> loadData() const;
+};
+
+} // namespace vulkan
+
+#endif // VK_PIPELINE_CACHE_FILE_H
@@ -0,0 +1,285 @@
+#include "vk_staging_ring.h"
+#include "vk_context.h"
+#include <android/log.h>
+#include <algorithm>
+
+#define LOG_TAG "VkStagingRing"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+
+namespace vulkan {
+
+namespace {
+
+// 容量按1MB取整，避免相近尺寸的图片反复扩容
+constexpr VkDeviceSize CAPACITY_GRANULARITY = 1024 * 1024;
+
+VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+VkStagingRing::VkStagingRing(VkContext* context, VkBufferUsageFlags usage, bool readback)
+    : context_(context), usage_(usage), readback_(readback) {
+}
+
+VkStagingRing::~VkStagingRing() {
+    destroy();
+}
+
+VkStagingRing::Allocation VkStagingRing::allocate(VkDeviceSize size, uint64_t serial) {
+    if (size == 0) {
+        return {};
+    }
+
+    VkDeviceSize offset = 0;
+    if (!findOffset(size, offset)) {
+        if (!inFlight_.empty()) {
+            // 正在使用的缓冲区不能重建，由调用方等待最早的提交完成后重试
+            stats_.stallCount++;
+            return {};
+        }
+        if (!grow(size)) {
+            return {};
+        }
+        offset = 0;
+    }
+
+    head_ = offset + size;
+    inFlight_.push_back({offset, head_, serial});
+    stats_.allocations++;
+
+    Allocation allocation;
+    allocation.buffer = buffer_;
+    allocation.offset = offset;
+    allocation.size = size;
+    allocation.mappedData = static_cast<uint8_t*>(mappedData_) + offset;
+    return allocation;
+}
+
+bool VkStagingRing::reserve(VkDeviceSize size, uint32_t count) {
+    if (count == 0 || size == 0) {
+        return true;
+    }
+    // 每段起点按对齐取整，最后一段不需要尾部填充
+    const VkDeviceSize required = alignUp(size, rangeAlignment()) * (count - 1) + size;
+    if (required <= capacity_) {
+        return true;
+    }
+    if (!inFlight_.empty()) {
+        return false;
+    }
+    return grow(required);
+}
+
+void VkStagingRing::release(uint64_t completedSerial) {
+    while (!inFlight_.empty() && inFlight_.front().serial <= completedSerial) {
+        inFlight_.pop_front();
+    }
+    if (inFlight_.empty()) {
+        head_ = 0;
+    }
+}
+
+bool VkStagingRing::findOffset(VkDeviceSize size, VkDeviceSize& offset) const {
+    if (buffer_ == VK_NULL_HANDLE) {
+        return false;
+    }
+    if (inFlight_.empty()) {
+        offset = 0;
+        return size <= capacity_;
+    }
+
+    const VkDeviceSize tail = inFlight_.front().begin;
+    const VkDeviceSize start = alignUp(head_, alignment_);
+    if (tail < head_) {
+        // 在途区段为[tail, head)：先用尾部剩余空间，不够时绕回开头
+        if (start + size <= capacity_) {
+            offset = start;
+            return true;
+        }
+        if (size <= tail) {
+            offset = 0;
+            return true;
+        }
+        return false;
+    }
+
+    // 已绕回，在途区段为[tail, capacity)与[0, head)
+    if (start + size <= tail) {
+        offset = start;
+        return true;
+    }
+    return false;
+}
+
+bool VkStagingRing::grow(VkDeviceSize minCapacity) {
+    const VkDeviceSize capacity =
+            alignUp(std::max(minCapacity, capacity_ * 2), CAPACITY_GRANULARITY);
+    destroy();
+
+    VkDevice device = context_->getDevice();
+
+    VkBufferCreateInfo bufferInfo = {};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = capacity;
+    bufferInfo.usage = usage_;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    // 有独立传输队列时暂存区可能被两个队列族使用
+    const uint32_t queueFamilies[] = {
+        context_->getComputeQueueFamily(), context_->getTransferQueueFamily()
+    };
+    if (context_->hasDedicatedTransferQueue()) {
+        bufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        bufferInfo.queueFamilyIndexCount = 2;
+        bufferInfo.pQueueFamilyIndices = queueFamilies;
+    }
+
+    VkResult result = vkCreateBuffer(device, &bufferInfo, nullptr, &buffer_);
+    if (result != VK_SUCCESS) {
+        LOGE("Failed to create staging ring buffer: %d", result);
+        buffer_ = VK_NULL_HANDLE;
+        return false;
+    }
+
+    VkMemoryRequirements memRequirements;
+    vkGetBufferMemoryRequirements(device, buffer_, &memRequirements);
+
+    // 回读优先HOST_CACHED，上传优先HOST_COHERENT
+    const VkMemoryPropertyFlags visible = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+    const VkMemoryPropertyFlags coherent = VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    const VkMemoryPropertyFlags cached = VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+    const VkMemoryPropertyFlags readbackPreference[] = {
+        visible | cached | coherent, visible | cached, visible | coherent, visible
+    };
+    const VkMemoryPropertyFlags uploadPreference[] = {visible | coherent, visible};
+
+    uint32_t memoryTypeIndex = UINT32_MAX;
+    if (readback_) {
+        for (VkMemoryPropertyFlags flags : readbackPreference) {
+            memoryTypeIndex = context_->findMemoryType(memRequirements.memoryTypeBits, flags);
+            if (memoryTypeIndex != UINT32_MAX) break;
+        }
+    } else {
+        for (VkMemoryPropertyFlags flags : uploadPreference) {
+            memoryTypeIndex = context_->findMemoryType(memRequirements.memoryTypeBits, flags);
+            if (memoryTypeIndex != UINT32_MAX) break;
+        }
+    }
+
+    if (memoryTypeIndex == UINT32_MAX) {
+        LOGE("No host visible memory type for staging ring");
+        vkDestroyBuffer(device, buffer_, nullptr);
+        buffer_ = VK_NULL_HANDLE;
+        return false;
+    }
+
+    VkMemoryAllocateInfo allocInfo = {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = memRequirements.size;
+    allocInfo.memoryTypeIndex = memoryTypeIndex;
+
+    result = vkAllocateMemory(device, &allocInfo, nullptr, &memory_);
+    if (result != VK_SUCCESS) {
+        LOGE("Failed to allocate staging ring memory: %d", result);
+        vkDestroyBuffer(device, buffer_, nullptr);
+        buffer_ = VK_NULL_HANDLE;
+        memory_ = VK_NULL_HANDLE;
+        return false;
+    }
+
+    result = vkBindBufferMemory(device, buffer_, memory_, 0);
+    if (result == VK_SUCCESS) {
+        result = vkMapMemory(device, memory_, 0, VK_WHOLE_SIZE, 0, &mappedData_);
+    }
+    if (result != VK_SUCCESS) {
+        LOGE("Failed to bind or map staging ring memory: %d", result);
+        vkFreeMemory(device, memory_, nullptr);
+        vkDestroyBuffer(device, buffer_, nullptr);
+        buffer_ = VK_NULL_HANDLE;
+        memory_ = VK_NULL_HANDLE;
+        mappedData_ = nullptr;
+        return false;
+    }
+
+    const VkPhysicalDeviceMemoryProperties& memoryProperties = context_->getMemoryProperties();
+    coherent_ = (memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & coherent) != 0;
+
+    alignment_ = rangeAlignment();
+
+    capacity_ = capacity;
+    head_ = 0;
+    stats_.capacity = capacity;
+    stats_.growCount++;
+
+    LOGI("Staging ring %s grown to %.2f MB (coherent=%d)", readback_ ? "readback" : "upload",
+         capacity / (1024.0 * 1024.0), coherent_ ? 1 : 0);
+    return true;
+}
+
+VkDeviceSize VkStagingRing::rangeAlignment() const {
+    const VkPhysicalDeviceLimits& limits = context_->getDeviceProperties().limits;
+    return std::max<VkDeviceSize>({256, limits.nonCoherentAtomSize,
+                                   limits.optimalBufferCopyOffsetAlignment,
+                                   limits.minStorageBufferOffsetAlignment});
+}
+
+VkMappedMemoryRange VkStagingRing::mappedRange(const Allocation& allocation) const {
+    const VkDeviceSize atom = context_->getDeviceProperties().limits.nonCoherentAtomSize;
+    const VkDeviceSize begin = allocation.offset / atom * atom;
+    const VkDeviceSize end = alignUp(allocation.offset + allocation.size, atom);
+
+    VkMappedMemoryRange range = {};
+    range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+    range.memory = memory_;
+    range.offset = begin;
+    range.size = end >= capacity_ ? VK_WHOLE_SIZE : end - begin;
+    return range;
+}
+
+void VkStagingRing::flush(const Allocation& allocation) const {
+    if (coherent_ || !allocation.isValid()) {
+        return;
+    }
+    const VkMappedMemoryRange range = mappedRange(allocation);
+    vkFlushMappedMemoryRanges(context_->getDevice(), 1, &range);
+}
+
+void VkStagingRing::invalidate(const Allocation& allocation) const {
+    if (coherent_ || !allocation.isValid()) {
+        return;
+    }
+    const VkMappedMemoryRange range = mappedRange(allocation);
+    vkInvalidateMappedMemoryRanges(context_->getDevice(), 1, &range);
+}
+
+void VkStagingRing::destroy() {
+    if (buffer_ == VK_NULL_HANDLE && memory_ == VK_NULL_HANDLE) {
+        return;
+    }
+
+    VkDevice device = context_->getDevice();
+    if (memory_ != VK_NULL_HANDLE) {
+        if (mappedData_ != nullptr) {
+            vkUnmapMemory(device, memory_);
+        }
+        vkFreeMemory(device, memory_, nullptr);
+    }
+    if (buffer_ != VK_NULL_HANDLE) {
+        vkDestroyBuffer(device, buffer_, nullptr);
+    }
+
+    buffer_ = VK_NULL_HANDLE;
+    memory_ = VK_NULL_HANDLE;
+    mappedData_ = nullptr;
+    capacity_ = 0;
+    head_ = 0;
+    inFlight_.clear();
+    stats_.capacity = 0;
+}
+
+} // namespace vulkan
@@ -0,0 +1,138 @@
+#ifndef VK_STAGING_RING_H
+#define VK_STAGING_RING_H
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <deque>
+
+namespace vulkan {
+
+class VkContext;
+
+/**
+ * 持久映射的暂存环形缓冲区
+ * 每张图片都创建、分配、映射再释放一个整图大小的暂存缓冲区时，驱动分配调用是每帧最慢的操作之一。
+ * 环形缓冲区只创建一次并保持映射，按提交序号回收已完成的区段；容量不足且没有在途区段时按几何倍数扩容，
+ * 批处理中同尺寸的图片不再产生任何驱动分配
+ */
+class VkStagingRing {
+public:
+    /**
+     * 环中的一段
+     */
+    struct Allocation {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkDeviceSize offset = 0;
+        VkDeviceSize size = 0;
+        void* mappedData = nullptr;
+
+        bool isValid() const { return buffer != VK_NULL_HANDLE; }
+    };
+
+    /**
+     * 使用统计
+     */
+    struct Stats {
+        VkDeviceSize capacity = 0;
+        uint64_t allocations = 0;   // 成功分配的区段数
+        uint64_t growCount = 0;     // 重新创建缓冲区的次数（含首次创建）
+        uint64_t stallCount = 0;    // 空间被在途区段占满而分配失败的次数
+    };
+
+    /**
+     * 构造函数
+     * @param context Vulkan上下文
+     * @param usage 缓冲区用途（上传为TRANSFER_SRC，回读为TRANSFER_DST）
+     * @param readback 是否用于回读，回读优先选择HOST_CACHED内存，CPU读取比写合并内存快得多
+     */
+    VkStagingRing(VkContext* context, VkBufferUsageFlags usage, bool readback);
+    ~VkStagingRing();
+
+    // 禁止拷贝
+    VkStagingRing(const VkStagingRing&) = delete;
+    VkStagingRing& operator=(const VkStagingRing&) = delete;
+
+    /**
+     * 分配一段暂存区
+     * @param size 字节数
+     * @param serial 使用该区段的提交序号，序号完成后由release回收
+     * @return 分配结果，空间被在途区段占满或创建失败时无效
+     */
+    Allocation allocate(VkDeviceSize size, uint64_t serial);
+
+    /**
+     * 空闲时预先扩容，保证能同时容纳count段size字节（多帧在途时使用）
+     * @return 容量是否足够
+     */
+    bool reserve(VkDeviceSize size, uint32_t count);
+
+    /**
+     * 回收序号不大于completedSerial的区段
+     */
+    void release(uint64_t completedSerial);
+
+    /**
+     * 主机写入后刷新（非一致性内存需要）
+     */
+    void flush(const Allocation& allocation) const;
+
+    /**
+     * 主机读取前失效（非一致性内存需要）
+     */
+    void invalidate(const Allocation& allocation) const;
+
+    /**
+     * 释放缓冲区，调用前必须确保没有在途区段
+     */
+    void destroy();
+
+    Stats getStats() const { return stats_; }
+
+private:
+    // 在途区段
+    struct Range {
+        VkDeviceSize begin;
+        VkDeviceSize end;
+        uint64_t serial;
+    };
+
+    VkContext* context_;
+    VkBufferUsageFlags usage_;
+    bool readback_;
+
+    VkBuffer buffer_ = VK_NULL_HANDLE;
+    VkDeviceMemory memory_ = VK_NULL_HANDLE;
+    void* mappedData_ = nullptr;
+    bool coherent_ = true;
+    VkDeviceSize capacity_ = 0;
+    VkDeviceSize alignment_ = 256;
+
+    VkDeviceSize head_ = 0;
+    std::deque<Range> inFlight_;
+    Stats stats_;
+
+    /**
+     * 区段起点需满足的对齐：拷贝偏移、存储缓冲区绑定偏移与非一致性内存刷新粒度
+     */
+    VkDeviceSize rangeAlignment() const;
+
+    /**
+     * 以不小于minCapacity的几何增长容量重新创建缓冲区
+     */
+    bool grow(VkDeviceSize minCapacity);
+
+    /**
+     * 为size字节找空闲的起始偏移
+     * @return 找不到时返回false
+     */
+    bool findOffset(VkDeviceSize size, VkDeviceSize& offset) const;
+
+    /**
+     * 非一致性内存的刷新范围需按nonCoherentAtomSize对齐
+     */
+    VkMappedMemoryRange mappedRange(const Allocation& allocation) const;
+};
+
+} // namespace vulkan
+
+#endif // VK_STAGING_RING_H
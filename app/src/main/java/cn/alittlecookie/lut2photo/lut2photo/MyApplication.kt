@@ -131,7 +131,14 @@ class MyApplication : Application() {
             val nativeMemoryLimitMB = targetMemoryMB
 
             // 调用Native全局初始化
-            val result = NativeLutProcessor().nativeInitializeGlobalComponents(nativeMemoryLimitMB)
+            val nativeProcessor = NativeLutProcessor()
+            val result = nativeProcessor.nativeInitializeGlobalComponents(nativeMemoryLimitMB)
+
+            // 处理画像（策略代价模型、分块调优结果）以及Native层按路径加载LUT时的二进制缓存写入应用缓存目录
+            nativeProcessor.nativeSetLutCacheDirectory(cacheDir.absolutePath)
+
+            // 工作线程绑核是线程池的进程级设置，只在这里设置一次，默认关闭
+            nativeProcessor.nativeSetCorePinning(false)
 
             if (result == 0) {
                 Log.i(TAG, "Native全局组件初始化成功，内存限制: ${nativeMemoryLimitMB}MB")
@@ -186,6 +186,8 @@ class ProcessingHistoryAdapter(
                 val ditherText = when (record.ditherType.lowercase()) {
                     "floyd" -> "Floyd"
                     "random" -> "Random"
+                    "bayer" -> "Bayer"
+                    "blue_noise" -> "Blue Noise"
                     "none", "" -> "None"
                     else -> record.ditherType
                 }
@@ -23,6 +23,10 @@ class CpuLutProcessor : ILutProcessor {
         // 更宽松的正则表达式，支持更多数字格式
         private val DATA_LINE_REGEX =
             Regex("^\\s*([+-]?[0-9]*\\.?[0-9]+(?:[eE][+-]?[0-9]+)?)\\s+([+-]?[0-9]*\\.?[0-9]+(?:[eE][+-]?[0-9]+)?)\\s+([+-]?[0-9]*\\.?[0-9]+(?:[eE][+-]?[0-9]+)?)\\s*$")
+
+        // 有序抖动阈值表边长（与native层DitherMatrix::SIZE一致）
+        private const val DITHER_MATRIX_SIZE = 64
+        private const val DITHER_MATRIX_MASK = DITHER_MATRIX_SIZE - 1
     }
 
     internal var lut: Array<Array<Array<FloatArray>>>? = null
@@ -35,6 +39,9 @@ class CpuLutProcessor : ILutProcessor {
     // 用于控制警告日志只打印一次
     private var hasLoggedLut2Warning = false
 
+    // 有序抖动阈值表，按抖动类型缓存
+    private val ditherMatrices = mutableMapOf<ILutProcessor.DitherType, ByteArray?>()
+
     /**
      * 获取加载的LUT数据
      * @return LUT数据数组，如果未加载则返回null
@@ -386,6 +393,7 @@ class CpuLutProcessor : ILutProcessor {
         bitmap.getPixels(pixels, 0, width, 0, 0, width, height)
 
         var processedPixels = 0
+        val thresholds = getOrderedDitherMatrix(params.ditherType)
 
         // 应用双LUT处理链：LUT1 → LUT2
         for (i in pixels.indices) {
@@ -418,11 +426,12 @@ class CpuLutProcessor : ILutProcessor {
                 hasLoggedLut2Warning = true
             }
 
+            val bias = orderedDitherBias(thresholds, i % width, i / width)
             pixels[i] = Color.argb(
                 a,
-                (r * 255).toInt(),
-                (g * 255).toInt(),
-                (b * 255).toInt()
+                (r * 255 + bias).toInt(),
+                (g * 255 + bias).toInt(),
+                (b * 255 + bias).toInt()
             )
             processedPixels++
 
@@ -441,6 +450,8 @@ class CpuLutProcessor : ILutProcessor {
             )
 
             ILutProcessor.DitherType.RANDOM -> applyRandomDithering(pixels)
+            // 有序抖动已在量化时完成
+            ILutProcessor.DitherType.BAYER, ILutProcessor.DitherType.BLUE_NOISE,
             ILutProcessor.DitherType.NONE -> {}
         }
 
@@ -465,6 +476,7 @@ class CpuLutProcessor : ILutProcessor {
 
         // 创建结果bitmap
         val resultBitmap = createBitmap(width, height)
+        val thresholds = getOrderedDitherMatrix(params.ditherType)
 
         var currentY = 0
         while (currentY < height) {
@@ -505,11 +517,12 @@ class CpuLutProcessor : ILutProcessor {
                     hasLoggedLut2Warning = true
                 }
 
+                val bias = orderedDitherBias(thresholds, i % width, currentY + i / width)
                 blockPixels[i] = Color.argb(
                     a,
-                    (r * 255).toInt(),
-                    (g * 255).toInt(),
-                    (b * 255).toInt()
+                    (r * 255 + bias).toInt(),
+                    (g * 255 + bias).toInt(),
+                    (b * 255 + bias).toInt()
                 )
             }
 
@@ -524,6 +537,7 @@ class CpuLutProcessor : ILutProcessor {
                 }
 
                 ILutProcessor.DitherType.RANDOM -> applyRandomDithering(blockPixels)
+                ILutProcessor.DitherType.BAYER, ILutProcessor.DitherType.BLUE_NOISE,
                 ILutProcessor.DitherType.NONE -> {}
             }
 
@@ -646,6 +660,39 @@ class CpuLutProcessor : ILutProcessor {
         }
     }
 
+    /**
+     * 获取有序抖动阈值表（64x64，行优先），与native及GPU路径使用同一份数据
+     * @return 非有序抖动或native库不可用时返回null
+     */
+    private fun getOrderedDitherMatrix(ditherType: ILutProcessor.DitherType): ByteArray? {
+        if (ditherType != ILutProcessor.DitherType.BAYER &&
+            ditherType != ILutProcessor.DitherType.BLUE_NOISE
+        ) {
+            return null
+        }
+        return synchronized(ditherMatrices) {
+            ditherMatrices.getOrPut(ditherType) {
+                try {
+                    NativeLutProcessor.nativeGetDitherMatrix(ditherType.ordinal)
+                } catch (e: Throwable) {
+                    Log.w("CpuLutProcessor", "无法获取有序抖动阈值表，按不抖动处理", e)
+                    null
+                }
+            }
+        }
+    }
+
+    /**
+     * 量化偏置：不抖动时为0（保持截断），有序抖动时为 (阈值 + 0.5) / 256
+     */
+    private fun orderedDitherBias(thresholds: ByteArray?, x: Int, y: Int): Float {
+        if (thresholds == null) {
+            return 0f
+        }
+        val index = (y and DITHER_MATRIX_MASK) * DITHER_MATRIX_SIZE + (x and DITHER_MATRIX_MASK)
+        return ((thresholds[index].toInt() and 0xFF) + 0.5f) / 256f
+    }
+
     private fun applyRandomDithering(pixels: IntArray) {
         for (i in pixels.indices) {
             val pixel = pixels[i]
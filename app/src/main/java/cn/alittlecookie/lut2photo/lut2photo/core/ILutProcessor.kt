@@ -16,16 +16,39 @@ interface ILutProcessor {
         val strength: Float = 1.0f,
         val lut2Strength: Float = 1.0f,  // 第二个LUT的强度
         val quality: Int = 90,
-        val ditherType: DitherType = DitherType.NONE
+        val ditherType: DitherType = DitherType.NONE,
+        // 四面体插值目前只有Native CPU处理器支持，Vulkan处理器始终使用三线性插值
+        val interpolationMode: InterpolationMode = InterpolationMode.TRILINEAR,
+        val schedulerMode: SchedulerMode = SchedulerMode.AUTO
     )
 
     /**
-     * 抖动类型
+     * LUT插值方式（序号即native层的interpolationMode，顺序不可调整）
+     */
+    enum class InterpolationMode {
+        TRILINEAR,
+        TETRAHEDRAL
+    }
+
+    /**
+     * 多线程调度方式（序号即native层的schedulerMode，顺序不可调整）
+     * AUTO在异构CPU上使用自适应分块，其余情况使用工作窃取
+     */
+    enum class SchedulerMode {
+        AUTO,
+        WORK_STEALING,
+        ADAPTIVE
+    }
+
+    /**
+     * 抖动类型（序号即native层的ditherType，顺序不可调整）
      */
     enum class DitherType {
         NONE,
         FLOYD_STEINBERG,
-        RANDOM
+        RANDOM,
+        BAYER,
+        BLUE_NOISE
     }
 
     /**
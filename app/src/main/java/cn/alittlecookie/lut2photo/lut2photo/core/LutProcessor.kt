@@ -5,7 +5,9 @@ class LutProcessor {
     enum class DitherType {
         NONE,
         FLOYD_STEINBERG,
-        RANDOM
+        RANDOM,
+        BAYER,
+        BLUE_NOISE
     }
 
 }
\ No newline at end of file
@@ -3,6 +3,8 @@ package cn.alittlecookie.lut2photo.lut2photo.core
 import android.graphics.Bitmap
 import android.util.Log
 import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.Job
+import kotlinx.coroutines.isActive
 import kotlinx.coroutines.withContext
 import java.io.InputStream
 
@@ -33,6 +35,14 @@ class NativeLutProcessor : ILutProcessor {
             }
         }
 
+        /**
+         * 获取有序抖动阈值表（64x64，行优先，每项0-255）
+         * @param ditherType 抖动类型序号（3=BAYER，4=BLUE_NOISE）
+         * @return 非有序抖动时返回null
+         */
+        @JvmStatic
+        external fun nativeGetDitherMatrix(ditherType: Int): ByteArray?
+
         // 错误码常量
         private const val SUCCESS = 0
         private const val ERROR_INVALID_BITMAP = -1
@@ -84,44 +94,45 @@ class NativeLutProcessor : ILutProcessor {
                     return@withContext false
                 }
 
-                // 读取LUT数据
-                val lutData = parseCubeLut(inputStream)
-                if (lutData.isEmpty()) {
-                    Log.e(TAG, "LUT数据解析失败")
+                // 文本交给Native解析器处理（.cube/.3dl），不再在Kotlin中逐行解析
+                val lutBytes = inputStream.readBytes()
+                if (lutBytes.isEmpty()) {
+                    Log.e(TAG, "LUT数据为空")
                     return@withContext false
                 }
 
-                // 计算LUT尺寸
-                val lutSize = Math.round(Math.cbrt(lutData.size / 3.0)).toInt()
-                Log.d(
-                    TAG,
-                    "加载LUT，尺寸: ${lutSize}x${lutSize}x${lutSize}, 数据点: ${lutData.size}"
-                )
+                checkLoadResult(nativeLoadLutBytes(nativeHandle, lutBytes))
+            } catch (e: Exception) {
+                Log.e(TAG, "加载LUT时发生异常", e)
+                false
+            }
+        }
+    }
 
-                // 调用Native方法加载LUT
-                when (val result = nativeLoadLut(nativeHandle, lutData.toFloatArray(), lutSize)) {
-                    SUCCESS -> {
-                        Log.i(TAG, "LUT加载成功")
-                        true
-                    }
+    private fun checkLoadResult(result: Int): Boolean {
+        return when (result) {
+            SUCCESS -> {
+                Log.i(TAG, "LUT加载成功")
+                true
+            }
 
-                    ERROR_INVALID_PARAMETERS -> {
-                        Log.e(TAG, "LUT参数无效")
-                        false
-                    }
+            ERROR_INVALID_PARAMETERS -> {
+                Log.e(TAG, "LUT参数无效")
+                false
+            }
 
-                    ERROR_MEMORY_ALLOCATION -> {
-                        Log.e(TAG, "Native内存分配失败")
-                        false
-                    }
+            ERROR_MEMORY_ALLOCATION -> {
+                Log.e(TAG, "Native内存分配失败")
+                false
+            }
 
-                    else -> {
-                        Log.e(TAG, "LUT加载失败，错误码: $result")
-                        false
-                    }
-                }
-            } catch (e: Exception) {
-                Log.e(TAG, "加载LUT时发生异常", e)
+            ERROR_LUT_NOT_LOADED -> {
+                Log.e(TAG, "LUT数据解析失败")
+                false
+            }
+
+            else -> {
+                Log.e(TAG, "LUT加载失败，错误码: $result")
                 false
             }
         }
@@ -152,7 +163,7 @@ class NativeLutProcessor : ILutProcessor {
                     Bitmap.Config.ARGB_8888
                 )
 
-                // 调用Native处理方法
+                // 调用Native处理方法，传入当前Job，协程取消时Native端放弃内存准入排队与剩余分块
                 val result = nativeProcessBitmap(
                     nativeHandle,
                     bitmap,
@@ -161,9 +172,18 @@ class NativeLutProcessor : ILutProcessor {
                     params.lut2Strength,
                     params.quality,
                     params.ditherType.ordinal,
-                    true // 使用多线程
+                    true, // 使用多线程
+                    params.interpolationMode.ordinal,
+                    params.schedulerMode.ordinal,
+                    coroutineContext[Job]
                 )
 
+                if (!isActive) {
+                    Log.d(TAG, "Native处理已取消")
+                    outputBitmap.recycle()
+                    return@withContext null
+                }
+
                 when (result) {
                     SUCCESS -> {
                         Log.d(TAG, "Native处理成功")
@@ -298,57 +318,17 @@ class NativeLutProcessor : ILutProcessor {
         }
     }
 
-    /**
-     * 解析Cube LUT文件
-     */
-    private fun parseCubeLut(inputStream: InputStream): List<Float> {
-        val lutData = mutableListOf<Float>()
-
-        try {
-            inputStream.bufferedReader().use { reader ->
-                var lutSize = 0
-
-                reader.forEachLine { line ->
-                    val trimmedLine = line.trim()
-
-                    // 跳过注释和空行
-                    if (trimmedLine.isEmpty() || trimmedLine.startsWith("#")) {
-                        return@forEachLine
-                    }
-
-                    // 解析LUT_3D_SIZE
-                    if (trimmedLine.startsWith("LUT_3D_SIZE")) {
-                        lutSize = trimmedLine.split("\\s+".toRegex())[1].toInt()
-                        Log.d(TAG, "检测到LUT尺寸: $lutSize")
-                        return@forEachLine
-                    }
-
-                    // 解析RGB数据
-                    if (trimmedLine.matches("^[0-9.\\s-]+$".toRegex())) {
-                        val values = trimmedLine.split("\\s+".toRegex())
-                            .filter { it.isNotEmpty() }
-                            .map { it.toFloat() }
-
-                        if (values.size == 3) {
-                            lutData.addAll(values)
-                        }
-                    }
-                }
-            }
-
-            Log.d(TAG, "LUT解析完成，数据点数: ${lutData.size}")
-        } catch (e: Exception) {
-            Log.e(TAG, "解析LUT文件失败", e)
-            return emptyList()
-        }
-
-        return lutData
-    }
-
     // Native方法声明
     private external fun nativeCreate(): Long
     private external fun nativeDestroy(handle: Long)
     private external fun nativeLoadLut(handle: Long, lutData: FloatArray, lutSize: Int): Int
+    private external fun nativeLoadLutBytes(handle: Long, lutBytes: ByteArray): Int
+    external fun nativeSetLutCacheDirectory(cacheDir: String?)
+
+    /**
+     * 工作线程是否绑定到各自的CPU簇，进程级设置，由应用启动时设置一次
+     */
+    external fun nativeSetCorePinning(enabled: Boolean)
     private external fun nativeProcessBitmap(
         handle: Long,
         inputBitmap: Bitmap,
@@ -357,7 +337,10 @@ class NativeLutProcessor : ILutProcessor {
         lut2Strength: Float,
         quality: Int,
         ditherType: Int,
-        useMultiThreading: Boolean
+        useMultiThreading: Boolean,
+        interpolationMode: Int,
+        schedulerMode: Int,
+        job: Job?
     ): Int
 
     external fun nativeGetMemoryUsage(handle: Long): Long
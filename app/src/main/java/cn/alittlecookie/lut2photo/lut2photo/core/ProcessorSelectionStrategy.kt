@@ -100,16 +100,10 @@ class ProcessorSelectionStrategy(private val context: Context) {
             )
         }
         
-        // 2. 检查GPU纹理尺寸限制
+        // 2. 超过GPU纹理尺寸限制的图片由Vulkan分块处理，不再回退CPU
         val maxTextureSize = getMaxTextureSize()
         if (maxDimension > maxTextureSize) {
-            Log.w(TAG, "图片尺寸超过GPU纹理限制: $maxDimension > $maxTextureSize")
-            return@withContext SelectionResult(
-                processorType = ILutProcessor.ProcessorType.CPU,
-                reason = "图片尺寸超过GPU纹理限制($maxDimension > $maxTextureSize)",
-                fallbackReason = FallbackReason.TEXTURE_SIZE_LIMIT,
-                shouldShowToast = userPreference == ILutProcessor.ProcessorType.VULKAN
-            )
+            Log.i(TAG, "图片尺寸超过GPU纹理限制($maxDimension > $maxTextureSize)，Vulkan将分块处理")
         }
         
         // 3. 检查内存可用性
@@ -197,16 +191,10 @@ class ProcessorSelectionStrategy(private val context: Context) {
             )
         }
         
-        // 2. 检查GPU纹理尺寸限制
+        // 2. 超过GPU纹理尺寸限制的图片由Vulkan分块处理，不再回退CPU
         val maxTextureSize = getMaxTextureSize()
         if (maxDimension > maxTextureSize) {
-            Log.w(TAG, "图片尺寸超过GPU纹理限制: $maxDimension > $maxTextureSize")
-            return@withContext SelectionResult(
-                processorType = ILutProcessor.ProcessorType.CPU,
-                reason = "图片尺寸超过GPU纹理限制($maxDimension > $maxTextureSize)",
-                fallbackReason = FallbackReason.TEXTURE_SIZE_LIMIT,
-                shouldShowToast = userPreferenceString.uppercase() == "VULKAN"
-            )
+            Log.i(TAG, "图片尺寸超过GPU纹理限制($maxDimension > $maxTextureSize)，Vulkan将分块处理")
         }
         
         // 3. 检查内存可用性
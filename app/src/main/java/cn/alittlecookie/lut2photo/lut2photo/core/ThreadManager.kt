@@ -64,8 +64,8 @@ class ThreadManager(context: Context) {
     // CPU processing semaphore (max 5 concurrent)
     private val cpuSemaphore = Semaphore(MAX_CPU_CONCURRENT)
 
-    // GPU processing channel (serial processing)
-    private val gpuChannel = Channel<ProcessingTask>(Channel.UNLIMITED)
+    // GPU processing channel (serial processing, one batch per element)
+    private val gpuChannel = Channel<List<ProcessingTask>>(Channel.UNLIMITED)
 
     // Active tasks tracking
     private val activeTasks = ConcurrentHashMap<String, Job>()
@@ -225,19 +225,8 @@ class ThreadManager(context: Context) {
     private fun startGpuProcessingLoop() {
         gpuProcessingJob = gpuScope.launch {
             try {
-                for (task in gpuChannel) {
-                    try {
-                        vulkanProcessor.setFilmGrainConfig(task.grainConfigSnapshot)
-                        task.onProgress?.invoke("Processing on Vulkan...")
-                        val result = vulkanProcessor.processImage(task.bitmap, task.params)
-                        task.onComplete(Result.success(result))
-                    } catch (e: Throwable) {
-                        Log.e(TAG, "Vulkan processing failed for task ${task.id}", e)
-                        // Fallback to CPU processing
-                        processCpuFallback(task)
-                    } finally {
-                        activeTasks.remove(task.id)
-                    }
+                for (batch in gpuChannel) {
+                    processGpuBatch(batch)
                 }
             } catch (e: Exception) {
                 Log.e(TAG, "Vulkan processing loop error", e)
@@ -245,6 +234,32 @@ class ThreadManager(context: Context) {
         }
     }
 
+    /**
+     * 处理一批同参数的GPU任务，多张时一次提交给Vulkan使各帧相互重叠
+     */
+    private suspend fun processGpuBatch(batch: List<ProcessingTask>) {
+        val first = batch.first()
+        try {
+            vulkanProcessor.setFilmGrainConfig(first.grainConfigSnapshot)
+            batch.forEach { it.onProgress?.invoke("Processing on Vulkan...") }
+            if (batch.size == 1) {
+                val result = vulkanProcessor.processImage(first.bitmap, first.params)
+                first.onComplete(Result.success(result))
+            } else {
+                val results = vulkanProcessor.processImages(batch.map { it.bitmap }, first.params)
+                batch.forEachIndexed { index, task ->
+                    task.onComplete(Result.success(results[index]))
+                }
+            }
+        } catch (e: Throwable) {
+            Log.e(TAG, "Vulkan processing failed for batch ${batch.map { it.id }}", e)
+            // Fallback to CPU processing
+            batch.forEach { processCpuFallback(it) }
+        } finally {
+            batch.forEach { activeTasks.remove(it.id) }
+        }
+    }
+
     private suspend fun processCpuFallback(task: ProcessingTask) {
         try {
             task.onProgress?.invoke("Fallback to CPU processing...")
@@ -404,7 +419,7 @@ class ThreadManager(context: Context) {
                     ILutProcessor.ProcessorType.VULKAN -> {
                         Log.d(TAG, "任务 $taskId 提交给Vulkan处理")
                         managerScope.launch {
-                            gpuChannel.send(task)
+                            gpuChannel.send(listOf(task))
                         }
                     }
 
@@ -424,7 +439,7 @@ class ThreadManager(context: Context) {
                         if (isVulkanAvailable) {
                             Log.d(TAG, "任务 $taskId 提交给Vulkan处理")
                             managerScope.launch {
-                                gpuChannel.send(task)
+                                gpuChannel.send(listOf(task))
                             }
                         } else {
                             Log.w(TAG, "Vulkan请求但不可用，任务 $taskId 回退到CPU")
@@ -443,6 +458,69 @@ class ThreadManager(context: Context) {
         return taskId
     }
 
+    /**
+     * Submit a batch of images that share the same parameters
+     * Vulkan processes the whole batch in one submission (see VulkanLutProcessor.MAX_BATCH_SIZE);
+     * on CPU each image becomes an ordinary task
+     * @param bitmaps Input bitmaps to process
+     * @param params Processing parameters
+     * @param onComplete Completion callback with the index of the bitmap in the batch
+     * @return Task IDs for tracking, in input order
+     */
+    fun submitBatch(
+        bitmaps: List<Bitmap>,
+        params: ILutProcessor.ProcessingParams,
+        onComplete: (Int, Result<Bitmap?>) -> Unit
+    ): List<String> {
+        val grainConfigSnapshot = currentGrainConfig
+        val tasks = bitmaps.mapIndexed { index, bitmap ->
+            val taskId = "task_${taskCounter.incrementAndGet()}_${System.currentTimeMillis()}"
+            ProcessingTask(taskId, bitmap, params, grainConfigSnapshot, null) { result ->
+                onComplete(index, result)
+            }
+        }
+        if (tasks.isEmpty()) {
+            return emptyList()
+        }
+
+        managerScope.launch {
+            // 按批中最大的图片选择处理器，整批使用同一处理器
+            val largest = bitmaps.maxBy { it.width.toLong() * it.height }
+            val processorType = try {
+                processorSelectionStrategy.selectOptimalProcessor(
+                    bitmap = largest,
+                    userPreferenceString = preferencesManager.processorType,
+                    isVulkanAvailable = isVulkanAvailable
+                ).processorType
+            } catch (e: Exception) {
+                Log.e(TAG, "智能处理器选择失败，回退到原逻辑", e)
+                if (preferredProcessor == ILutProcessor.ProcessorType.VULKAN && isVulkanAvailable) {
+                    ILutProcessor.ProcessorType.VULKAN
+                } else {
+                    ILutProcessor.ProcessorType.CPU
+                }
+            }
+
+            Log.d(TAG, "批量提交${tasks.size}个任务给$processorType 处理")
+            when (processorType) {
+                ILutProcessor.ProcessorType.VULKAN -> {
+                    tasks.chunked(VulkanLutProcessor.MAX_BATCH_SIZE).forEach { chunk ->
+                        val job = managerScope.launch {
+                            gpuChannel.send(chunk)
+                        }
+                        chunk.forEach { activeTasks[it.id] = job }
+                    }
+                }
+
+                ILutProcessor.ProcessorType.CPU -> {
+                    tasks.forEach { activeTasks[it.id] = submitCpuTask(it) }
+                }
+            }
+        }
+
+        return tasks.map { it.id }
+    }
+
     private fun submitCpuTask(task: ProcessingTask): Job {
         return cpuScope.launch {
             cpuSemaphore.acquire()
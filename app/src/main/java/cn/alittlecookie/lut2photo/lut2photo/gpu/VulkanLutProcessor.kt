@@ -21,6 +21,9 @@ class VulkanLutProcessor(private val context: Context) : ILutProcessor {
     companion object {
         private const val TAG = "VulkanLutProcessor"
 
+        // 一批的图片数，与native层的在途帧数（MAX_FRAMES_IN_FLIGHT）一致
+        const val MAX_BATCH_SIZE = 3
+
         init {
             try {
                 Log.i(TAG, "Loading native Vulkan library...")
@@ -34,7 +37,10 @@ class VulkanLutProcessor(private val context: Context) : ILutProcessor {
 
     // Native方法声明
     private external fun nativeIsVulkanAvailable(): Boolean
-    private external fun nativeCreate(assetManager: android.content.res.AssetManager): Long
+    private external fun nativeCreate(
+        assetManager: android.content.res.AssetManager,
+        cacheDir: String?
+    ): Long
     private external fun nativeDestroy(handle: Long)
     private external fun nativeGetDeviceInfo(handle: Long): String
     private external fun nativeGetMaxTextureSize(handle: Long): Int
@@ -56,7 +62,20 @@ class VulkanLutProcessor(private val context: Context) : ILutProcessor {
         grainSize: Float,
         grainSeed: Float
     ): Boolean
+    private external fun nativeProcessBatch(
+        handle: Long,
+        inputBitmaps: Array<Bitmap>,
+        outputBitmaps: Array<Bitmap>,
+        lutStrength: Float,
+        lut2Strength: Float,
+        ditherType: Int,
+        grainEnabled: Boolean,
+        grainStrength: Float,
+        grainSize: Float,
+        grainSeed: Float
+    ): BooleanArray?
     private external fun nativeRelease(handle: Long)
+    private external fun nativeSetStorageBufferPath(handle: Long, enabled: Boolean): Boolean
 
     // 处理器状态
     private var nativeHandle: Long = 0
@@ -75,6 +94,9 @@ class VulkanLutProcessor(private val context: Context) : ILutProcessor {
     // 胶片颗粒配置
     private var currentGrainConfig: FilmGrainConfig? = null
 
+    // 是否让着色器直接读写暂存缓冲区（省去图像拷贝，统一内存的GPU上更快）
+    private var useStorageBufferPath = false
+
     override fun getProcessorType(): ILutProcessor.ProcessorType {
         return ILutProcessor.ProcessorType.VULKAN
     }
@@ -200,6 +222,17 @@ class VulkanLutProcessor(private val context: Context) : ILutProcessor {
         Log.d(TAG, "Film grain config set: ${config?.isEnabled}")
     }
 
+    /**
+     * 选择存储缓冲区或存储图像计算路径，在下一次处理时生效
+     */
+    fun setStorageBufferPath(enabled: Boolean) {
+        useStorageBufferPath = enabled
+        if (isInitialized && nativeHandle != 0L) {
+            val applied = nativeSetStorageBufferPath(nativeHandle, enabled)
+            Log.d(TAG, "Storage buffer path: $enabled (applied=$applied)")
+        }
+    }
+
     override suspend fun processImage(
         bitmap: Bitmap,
         params: ILutProcessor.ProcessingParams
@@ -273,6 +306,83 @@ class VulkanLutProcessor(private val context: Context) : ILutProcessor {
         return processWithCpu(bitmap, params)
     }
 
+    /**
+     * 用同一组参数批量处理多张图片
+     * 一次提交整批，上一张回读时下一张已在上传或计算；失败的图片单独回退到CPU
+     * @return 与输入一一对应的结果，失败为null
+     */
+    suspend fun processImages(
+        bitmaps: List<Bitmap>,
+        params: ILutProcessor.ProcessingParams
+    ): List<Bitmap?> {
+        if (bitmaps.size <= 1) {
+            return bitmaps.map { processImage(it, params) }
+        }
+        Log.d(TAG, "Processing batch of ${bitmaps.size} images")
+
+        val hasLut = currentLut != null || currentLut2 != null
+        val hasGrain = currentGrainConfig?.isEnabled == true &&
+                (currentGrainConfig?.globalStrength ?: 0f) > 0f
+        if (!hasLut && !hasGrain) {
+            return bitmaps.map { processImage(it, params) }
+        }
+
+        if (!isInitialized) {
+            initializeVulkan()
+        }
+
+        val results = arrayOfNulls<Bitmap>(bitmaps.size)
+        if (isInitialized && nativeHandle != 0L) {
+            try {
+                val outputBitmaps = Array(bitmaps.size) { index ->
+                    Bitmap.createBitmap(
+                        bitmaps[index].width, bitmaps[index].height,
+                        Bitmap.Config.ARGB_8888
+                    )
+                }
+
+                val grainConfig = currentGrainConfig
+                val grainSeed = (System.currentTimeMillis() % 1000).toFloat() / 1000f
+                val lut1Strength = if (currentLut != null) params.strength else 0f
+                val lut2Strength = if (currentLut2 != null) params.lut2Strength else 0f
+
+                val succeeded = withContext(Dispatchers.IO) {
+                    nativeProcessBatch(
+                        nativeHandle,
+                        bitmaps.toTypedArray(),
+                        outputBitmaps,
+                        lut1Strength,
+                        lut2Strength,
+                        params.ditherType.ordinal,
+                        grainConfig?.isEnabled == true,
+                        grainConfig?.globalStrength ?: 0f,
+                        grainConfig?.grainSize ?: 1f,
+                        grainSeed
+                    )
+                }
+
+                for (index in bitmaps.indices) {
+                    if (succeeded != null && succeeded[index]) {
+                        results[index] = outputBitmaps[index]
+                    } else {
+                        outputBitmaps[index].recycle()
+                    }
+                }
+                Log.d(TAG, "Vulkan batch processed: ${results.count { it != null }}/${bitmaps.size}")
+            } catch (e: Exception) {
+                Log.e(TAG, "Vulkan batch processing failed, falling back to CPU", e)
+            }
+        }
+
+        // 失败的图片逐张回退到CPU处理
+        for (index in bitmaps.indices) {
+            if (results[index] == null) {
+                results[index] = processWithCpu(bitmaps[index], params)
+            }
+        }
+        return results.toList()
+    }
+
     /**
      * 初始化Vulkan
      */
@@ -290,14 +400,18 @@ class VulkanLutProcessor(private val context: Context) : ILutProcessor {
                 // 获取AssetManager
                 val assetManager = context.assets
 
-                // 创建Vulkan处理器
-                nativeHandle = nativeCreate(assetManager)
+                // 创建Vulkan处理器，管线缓存保存在应用缓存目录
+                nativeHandle = nativeCreate(assetManager, context.cacheDir?.absolutePath)
                 if (nativeHandle == 0L) {
                     Log.e(TAG, "Failed to create Vulkan processor")
                     return@withContext
                 }
 
                 isInitialized = true
+
+                if (useStorageBufferPath) {
+                    nativeSetStorageBufferPath(nativeHandle, true)
+                }
                 
                 val deviceInfo = nativeGetDeviceInfo(nativeHandle)
                 Log.i(TAG, "Vulkan initialized successfully")
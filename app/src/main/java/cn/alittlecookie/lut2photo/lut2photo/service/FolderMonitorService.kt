@@ -34,6 +34,7 @@ import cn.alittlecookie.lut2photo.lut2photo.core.WatermarkProcessor
 import cn.alittlecookie.lut2photo.lut2photo.filetracker.FileRecord
 import cn.alittlecookie.lut2photo.lut2photo.filetracker.FileTrackerConfig
 import cn.alittlecookie.lut2photo.lut2photo.filetracker.FileTrackerManager
+import cn.alittlecookie.lut2photo.lut2photo.gpu.VulkanLutProcessor
 import cn.alittlecookie.lut2photo.lut2photo.utils.PreferencesManager
 import kotlinx.coroutines.CoroutineScope
 import kotlinx.coroutines.Dispatchers
@@ -44,6 +45,7 @@ import kotlinx.coroutines.delay
 import kotlinx.coroutines.isActive
 import kotlinx.coroutines.launch
 import java.io.File
+import java.util.concurrent.atomic.AtomicInteger
 import kotlin.coroutines.resume
 import kotlin.coroutines.suspendCoroutine
 
@@ -74,6 +76,40 @@ class FolderMonitorService : Service() {
         
         // 状态查询广播
         const val ACTION_QUERY_STATUS = "cn.alittlecookie.lut2photo.QUERY_MONITORING_STATUS"
+
+        // 存量文件批量提交给Vulkan时一批的总像素上限（输入与输出位图同时驻留）
+        internal const val MAX_BATCH_PIXELS = 36_000_000L
+
+        /**
+         * 按像素数顺序分组，每组总像素不超过maxPixels（单张超限时独立成组）
+         * 只有一项时不读取像素数
+         */
+        internal fun <T> groupByPixelBudget(
+            items: List<T>,
+            maxPixels: Long = MAX_BATCH_PIXELS,
+            pixelsOf: (T) -> Long
+        ): List<List<T>> {
+            if (items.size <= 1) {
+                return if (items.isEmpty()) emptyList() else listOf(items)
+            }
+            val groups = mutableListOf<List<T>>()
+            var current = mutableListOf<T>()
+            var currentPixels = 0L
+            for (item in items) {
+                val pixels = pixelsOf(item)
+                if (current.isNotEmpty() && currentPixels + pixels > maxPixels) {
+                    groups.add(current)
+                    current = mutableListOf()
+                    currentPixels = 0L
+                }
+                current.add(item)
+                currentPixels += pixels
+            }
+            if (current.isNotEmpty()) {
+                groups.add(current)
+            }
+            return groups
+        }
     }
 
 
@@ -498,6 +534,8 @@ class FolderMonitorService : Service() {
             ditherType = when (dither.uppercase()) {
                 "FLOYD_STEINBERG" -> ILutProcessor.DitherType.FLOYD_STEINBERG
                 "RANDOM" -> ILutProcessor.DitherType.RANDOM
+                "BAYER" -> ILutProcessor.DitherType.BAYER
+                "BLUE_NOISE" -> ILutProcessor.DitherType.BLUE_NOISE
                 "NONE" -> ILutProcessor.DitherType.NONE
                 else -> ILutProcessor.DitherType.NONE
             }
@@ -610,13 +648,17 @@ class FolderMonitorService : Service() {
                 startForeground(NOTIFICATION_ID, statusNotification)
                 broadcastMonitoringStatus(initialStatus)
                 
-                for ((index, fileRecord) in existingFiles.withIndex()) {
+                // Vulkan处理时按批提交，各图片的上传、计算与回读相互重叠
+                var handledCount = 0
+                for (window in existingFiles.chunked(existingFilesBatchSize())) {
                     if (!isMonitoring) break
-                    processFileRecord(fileRecord)
-                    
+                    processFileRecords(window)
+                    val previousCount = handledCount
+                    handledCount += window.size
+
                     // 每处理10个文件更新一次通知
-                    if (index % 10 == 0) {
-                        val progressStatus = "正在处理存量文件: ${index + 1}/${existingFiles.size}"
+                    if (previousCount == 0 || previousCount / 10 != handledCount / 10) {
+                        val progressStatus = "正在处理存量文件: $handledCount/${existingFiles.size}"
                         val progressNotification = createNotification(
                             "文件夹监控服务",
                             progressStatus
@@ -698,60 +740,123 @@ class FolderMonitorService : Service() {
      * 处理FileRecord
      */
     private suspend fun processFileRecord(fileRecord: FileRecord) {
-        try {
-            Log.d(TAG, "开始处理文件: ${fileRecord.fileName}")
-            
-            // 检查文件是否已处理（统一使用处理历史系统）
-            if (isFileAlreadyProcessed(fileRecord.fileName)) {
-                Log.d(TAG, "文件已处理，跳过: ${fileRecord.fileName}")
-                fileTrackerManager?.markFileAsProcessed(fileRecord.fileName)
-                return
-            }
-            
-            val documentFile = DocumentFile.fromSingleUri(this, fileRecord.uri)
-            if (documentFile == null || !documentFile.exists()) {
-                Log.w(TAG, "文件不存在或无法访问: ${fileRecord.fileName}")
-                return
+        processFileRecords(listOf(fileRecord))
+    }
+
+    /**
+     * 处理一组FileRecord：逐个校验后按像素上限分批处理
+     */
+    private suspend fun processFileRecords(fileRecords: List<FileRecord>) {
+        val readyFiles = fileRecords.mapNotNull { fileRecord ->
+            try {
+                prepareFileRecord(fileRecord)?.let { fileRecord to it }
+            } catch (e: Exception) {
+                Log.e(TAG, "处理文件失败: ${fileRecord.fileName}", e)
+                null
             }
-            
-            // 检查文件完整性（防止处理未完全传输的文件）
-            if (!isImageFileComplete(documentFile)) {
-                // 记录重试次数
-                val retryCount = fileRetryCount.getOrDefault(fileRecord.fileName, 0) + 1
-                fileRetryCount[fileRecord.fileName] = retryCount
-                incompleteFiles.add(fileRecord.fileName)
-                
-                if (retryCount >= maxRetryCount) {
-                    Log.w(TAG, "文件 ${fileRecord.fileName} 重试次数已达上限($maxRetryCount)，跳过处理")
-                    // 标记为已处理，避免无限重试
+        }
+
+        for (group in groupByPixelBudget(readyFiles) { readImagePixels(it.second) }) {
+            group.forEach { (fileRecord, _) -> startProcessingFile(fileRecord.fileName) }
+
+            val failures = processingParams?.let { params ->
+                Log.d(TAG, "处理文件 ${group.map { it.first.fileName }} 使用的参数: strength=${params.strength}, lut2Strength=${params.lut2Strength}, quality=${params.quality}, dither=${params.ditherType}")
+                try {
+                    processDocumentFiles(group.map { it.second }, getOutputDir()!!, params)
+                } catch (e: Exception) {
+                    List(group.size) { e }
+                }
+            } ?: List(group.size) { null }
+
+            group.forEachIndexed { index, (fileRecord, _) ->
+                completeProcessingFile(fileRecord.fileName)
+                val failure = failures[index]
+                if (failure == null) {
                     fileTrackerManager?.markFileAsProcessed(fileRecord.fileName)
-                    fileRetryCount.remove(fileRecord.fileName)
-                    incompleteFiles.remove(fileRecord.fileName)
                 } else {
-                    Log.d(TAG, "文件 ${fileRecord.fileName} 未完整传输，等待下次检测 (重试次数: $retryCount/$maxRetryCount)")
-                    // 不标记为已处理，等待下次增量检测时重新尝试
+                    Log.e(TAG, "处理文件失败: ${fileRecord.fileName}", failure)
                 }
-                return
-            }
-            
-            // 文件完整性校验通过，清理重试记录
-            Log.d(TAG, "文件完整性校验通过: ${fileRecord.fileName}")
-            fileRetryCount.remove(fileRecord.fileName)
-            incompleteFiles.remove(fileRecord.fileName)
-            
-            startProcessingFile(fileRecord.fileName)
-            
-            processingParams?.let { params ->
-                Log.d(TAG, "处理文件 ${fileRecord.fileName} 使用的参数: strength=${params.strength}, lut2Strength=${params.lut2Strength}, quality=${params.quality}, dither=${params.ditherType}")
-                processDocumentFile(documentFile, getOutputDir()!!, params)
             }
-            
-            completeProcessingFile(fileRecord.fileName)
+        }
+    }
+
+    /**
+     * 校验FileRecord是否需要处理
+     * @return 可以处理的文件，已处理、不存在或未传输完成时返回null
+     */
+    private suspend fun prepareFileRecord(fileRecord: FileRecord): DocumentFile? {
+        Log.d(TAG, "开始处理文件: ${fileRecord.fileName}")
+        
+        // 检查文件是否已处理（统一使用处理历史系统）
+        if (isFileAlreadyProcessed(fileRecord.fileName)) {
+            Log.d(TAG, "文件已处理，跳过: ${fileRecord.fileName}")
             fileTrackerManager?.markFileAsProcessed(fileRecord.fileName)
+            return null
+        }
+        
+        val documentFile = DocumentFile.fromSingleUri(this, fileRecord.uri)
+        if (documentFile == null || !documentFile.exists()) {
+            Log.w(TAG, "文件不存在或无法访问: ${fileRecord.fileName}")
+            return null
+        }
+        
+        // 检查文件完整性（防止处理未完全传输的文件）
+        if (!isImageFileComplete(documentFile)) {
+            // 记录重试次数
+            val retryCount = fileRetryCount.getOrDefault(fileRecord.fileName, 0) + 1
+            fileRetryCount[fileRecord.fileName] = retryCount
+            incompleteFiles.add(fileRecord.fileName)
             
+            if (retryCount >= maxRetryCount) {
+                Log.w(TAG, "文件 ${fileRecord.fileName} 重试次数已达上限($maxRetryCount)，跳过处理")
+                // 标记为已处理，避免无限重试
+                fileTrackerManager?.markFileAsProcessed(fileRecord.fileName)
+                fileRetryCount.remove(fileRecord.fileName)
+                incompleteFiles.remove(fileRecord.fileName)
+            } else {
+                Log.d(TAG, "文件 ${fileRecord.fileName} 未完整传输，等待下次检测 (重试次数: $retryCount/$maxRetryCount)")
+                // 不标记为已处理，等待下次增量检测时重新尝试
+            }
+            return null
+        }
+        
+        // 文件完整性校验通过，清理重试记录
+        Log.d(TAG, "文件完整性校验通过: ${fileRecord.fileName}")
+        fileRetryCount.remove(fileRecord.fileName)
+        incompleteFiles.remove(fileRecord.fileName)
+        return documentFile
+    }
+
+    /**
+     * 存量文件一批的数量：使用Vulkan时与其在途帧数一致，CPU处理时逐个进行
+     */
+    private fun existingFilesBatchSize(): Int {
+        val processorInfo = threadManager.getProcessorInfo()
+        return if (processorInfo.isVulkanAvailable &&
+            processorInfo.preferredProcessor == ILutProcessor.ProcessorType.VULKAN
+        ) {
+            VulkanLutProcessor.MAX_BATCH_SIZE
+        } else {
+            1
+        }
+    }
+
+    /**
+     * 只解码图片头部读取像素数，读取失败时按上限计算（独立成组）
+     */
+    private fun readImagePixels(file: DocumentFile): Long {
+        return try {
+            val options = BitmapFactory.Options().apply { inJustDecodeBounds = true }
+            contentResolver.openInputStream(file.uri)?.use { stream ->
+                BitmapFactory.decodeStream(stream, null, options)
+            }
+            if (options.outWidth > 0 && options.outHeight > 0) {
+                options.outWidth.toLong() * options.outHeight
+            } else {
+                MAX_BATCH_PIXELS
+            }
         } catch (e: Exception) {
-            Log.e(TAG, "处理文件失败: ${fileRecord.fileName}", e)
-            completeProcessingFile(fileRecord.fileName)
+            MAX_BATCH_PIXELS
         }
     }
 
@@ -1082,6 +1187,8 @@ class FolderMonitorService : Service() {
                 ditherType = when (ditherType.uppercase()) {
                     "FLOYD_STEINBERG" -> ILutProcessor.DitherType.FLOYD_STEINBERG
                     "RANDOM" -> ILutProcessor.DitherType.RANDOM
+                    "BAYER" -> ILutProcessor.DitherType.BAYER
+                    "BLUE_NOISE" -> ILutProcessor.DitherType.BLUE_NOISE
                     "NONE" -> ILutProcessor.DitherType.NONE
                     else -> ILutProcessor.DitherType.NONE
                 }
@@ -1361,101 +1468,155 @@ class FolderMonitorService : Service() {
         outputDir: DocumentFile,
         params: ILutProcessor.ProcessingParams
     ) {
-        try {
-            Log.d(TAG, "开始处理文件: ${inputFile.name}")
+        processDocumentFiles(listOf(inputFile), outputDir, params).first()?.let { throw it }
+    }
+
+    /**
+     * 解码一组文件后整批提交处理，再逐个添加水印并保存
+     * @return 与输入一一对应的异常，成功为null
+     */
+    private suspend fun processDocumentFiles(
+        inputFiles: List<DocumentFile>,
+        outputDir: DocumentFile,
+        params: ILutProcessor.ProcessingParams
+    ): List<Exception?> {
+        val failures = arrayOfNulls<Exception>(inputFiles.size)
+        val correctedBitmaps = arrayOfNulls<Bitmap>(inputFiles.size)
+        val lutProcessedBitmaps = arrayOfNulls<Bitmap>(inputFiles.size)
 
-            var decodedBitmap: Bitmap? = null
-            var correctedBitmap: Bitmap? = null
-            var lutProcessedBitmap: Bitmap? = null
-            var finalBitmap: Bitmap? = null
+        try {
+            inputFiles.forEachIndexed { index, inputFile ->
+                try {
+                    Log.d(TAG, "开始处理文件: ${inputFile.name}")
+                    correctedBitmaps[index] = decodeDocumentFile(inputFile)
+                } catch (e: Exception) {
+                    Log.e(TAG, "处理文档文件失败: ${inputFile.name}", e)
+                    failures[index] = e
+                }
+            }
 
-            try {
-                val orientation = contentResolver.openInputStream(inputFile.uri)?.use { stream ->
-                    ExifInterface(stream).getAttributeInt(
-                        ExifInterface.TAG_ORIENTATION,
-                        ExifInterface.ORIENTATION_NORMAL
+            // 使用submitBatch处理图片（LUT处理），Vulkan上整批一次提交
+            val decodedIndices = inputFiles.indices.filter { correctedBitmaps[it] != null }
+            if (decodedIndices.isNotEmpty()) {
+                val results = suspendCoroutine { continuation ->
+                    val batchResults = arrayOfNulls<Bitmap>(decodedIndices.size)
+                    val remaining = AtomicInteger(decodedIndices.size)
+                    threadManager.submitBatch(
+                        bitmaps = decodedIndices.map { correctedBitmaps[it]!! },
+                        params = params,
+                        onComplete = { index, result ->
+                            batchResults[index] = result.getOrNull()
+                            if (remaining.decrementAndGet() == 0) {
+                                continuation.resume(batchResults.toList())
+                            }
+                        }
                     )
-                } ?: ExifInterface.ORIENTATION_NORMAL
+                }
+                decodedIndices.forEachIndexed { batchIndex, index ->
+                    lutProcessedBitmaps[index] = results[batchIndex]
+                }
+            }
 
-                decodedBitmap = contentResolver.openInputStream(inputFile.uri)?.use { stream ->
-                    BitmapFactory.decodeStream(stream)
+            inputFiles.forEachIndexed { index, inputFile ->
+                val lutProcessedBitmap = lutProcessedBitmaps[index] ?: return@forEachIndexed
+                try {
+                    saveProcessedBitmap(inputFile, outputDir, lutProcessedBitmap, params)
+                } catch (e: Exception) {
+                    Log.e(TAG, "处理文档文件失败: ${inputFile.name}", e)
+                    failures[index] = e
                 }
+            }
+        } finally {
+            recycleBitmaps(*lutProcessedBitmaps, *correctedBitmaps)
+        }
+        return failures.toList()
+    }
 
-                if (decodedBitmap != null) {
-                    // 应用EXIF方向变换
-                    correctedBitmap = applyExifOrientation(decodedBitmap!!, orientation)
-
-                    // 使用submitTask处理图片（LUT处理）
-                    lutProcessedBitmap = suspendCoroutine { continuation ->
-                        threadManager.submitTask(
-                            bitmap = correctedBitmap!!,
-                            params = params,
-                            onComplete = { result ->
-                                continuation.resume(result.getOrNull())
-                            }
-                        )
-                    }
+    /**
+     * 解码图片并按EXIF方向校正
+     */
+    private fun decodeDocumentFile(inputFile: DocumentFile): Bitmap? {
+        val orientation = contentResolver.openInputStream(inputFile.uri)?.use { stream ->
+            ExifInterface(stream).getAttributeInt(
+                ExifInterface.TAG_ORIENTATION,
+                ExifInterface.ORIENTATION_NORMAL
+            )
+        } ?: ExifInterface.ORIENTATION_NORMAL
 
-                    if (lutProcessedBitmap != null) {
-                        // 检查是否需要添加水印
-                        val watermarkConfig =
-                            preferencesManager.getWatermarkConfig(forFolderMonitor = true)  // 明确指定是文件夹监控
-                        finalBitmap =
-                            if (watermarkConfig.isEnabled) {  // 这里会使用folderMonitorWatermarkEnabled
-                                Log.d(TAG, "开始添加水印: ${inputFile.name}")
-                                try {
-                                    val watermarkedBitmap = watermarkProcessor.addWatermark(
-                                        lutProcessedBitmap!!,
-                                        watermarkConfig,
-                                        inputFile.uri,
-                                        currentLutName,
-                                        if (currentLut2Name.isNotEmpty()) currentLut2Name else null,
-                                        params.strength,
-                                        params.lut2Strength
-                                    )
-                                    Log.d(TAG, "水印添加完成: ${inputFile.name}")
-                                    watermarkedBitmap
-                                } catch (e: Exception) {
-                                    Log.e(TAG, "添加水印失败: ${inputFile.name}", e)
-                                    lutProcessedBitmap
-                                }
-                            } else {
-                                lutProcessedBitmap
-                            }
+        val decodedBitmap = contentResolver.openInputStream(inputFile.uri)?.use { stream ->
+            BitmapFactory.decodeStream(stream)
+        } ?: return null
 
-                        // 修复：使用正确的文件命名格式
-                        val originalName = inputFile.name?.substringBeforeLast(".") ?: "unknown"
-                        val outputFileName = "${originalName}-${currentLutName}.jpg"
-                        val outputFile = outputDir.createFile("image/jpeg", outputFileName)
-
-                        // 在processDocumentFile方法中，替换原来的保存逻辑
-                        outputFile?.let { file ->
-                            // 直接保存带EXIF信息的图片，而不是分两步
-                            saveBitmapWithExif(
-                                finalBitmap!!,
-                                inputFile.uri,
-                                file.uri,
-                                params.quality,
-                                outputFileName
-                            )
-
-                            // 保存处理记录到历史
-                            saveProcessingRecord(
-                                fileName = inputFile.name ?: "unknown",
-                                inputPath = inputFile.uri.toString(),
-                                outputPath = file.uri.toString(),
-                                lutFileName = currentLutName,
-                                params = params
-                            )
-                        }
+        // 应用EXIF方向变换
+        return applyExifOrientation(decodedBitmap, orientation)
+    }
+
+    /**
+     * 添加水印（如启用）并保存处理结果与历史记录
+     */
+    private suspend fun saveProcessedBitmap(
+        inputFile: DocumentFile,
+        outputDir: DocumentFile,
+        lutProcessedBitmap: Bitmap,
+        params: ILutProcessor.ProcessingParams
+    ) {
+        var finalBitmap: Bitmap? = null
+        try {
+            // 检查是否需要添加水印
+            val watermarkConfig =
+                preferencesManager.getWatermarkConfig(forFolderMonitor = true)  // 明确指定是文件夹监控
+            finalBitmap =
+                if (watermarkConfig.isEnabled) {  // 这里会使用folderMonitorWatermarkEnabled
+                    Log.d(TAG, "开始添加水印: ${inputFile.name}")
+                    try {
+                        val watermarkedBitmap = watermarkProcessor.addWatermark(
+                            lutProcessedBitmap,
+                            watermarkConfig,
+                            inputFile.uri,
+                            currentLutName,
+                            if (currentLut2Name.isNotEmpty()) currentLut2Name else null,
+                            params.strength,
+                            params.lut2Strength
+                        )
+                        Log.d(TAG, "水印添加完成: ${inputFile.name}")
+                        watermarkedBitmap
+                    } catch (e: Exception) {
+                        Log.e(TAG, "添加水印失败: ${inputFile.name}", e)
+                        lutProcessedBitmap
                     }
+                } else {
+                    lutProcessedBitmap
                 }
-            } finally {
-                recycleBitmaps(finalBitmap, lutProcessedBitmap, correctedBitmap, decodedBitmap)
+
+            // 修复：使用正确的文件命名格式
+            val originalName = inputFile.name?.substringBeforeLast(".") ?: "unknown"
+            val outputFileName = "${originalName}-${currentLutName}.jpg"
+            val outputFile = outputDir.createFile("image/jpeg", outputFileName)
+
+            // 直接保存带EXIF信息的图片，而不是分两步
+            outputFile?.let { file ->
+                saveBitmapWithExif(
+                    finalBitmap!!,
+                    inputFile.uri,
+                    file.uri,
+                    params.quality,
+                    outputFileName
+                )
+
+                // 保存处理记录到历史
+                saveProcessingRecord(
+                    fileName = inputFile.name ?: "unknown",
+                    inputPath = inputFile.uri.toString(),
+                    outputPath = file.uri.toString(),
+                    lutFileName = currentLutName,
+                    params = params
+                )
+            }
+        } finally {
+            // 处理结果由调用方回收，这里只回收水印生成的新位图
+            if (finalBitmap !== lutProcessedBitmap) {
+                recycleBitmaps(finalBitmap)
             }
-        } catch (e: Exception) {
-            Log.e(TAG, "处理文档文件失败: ${inputFile.name}", e)
-            throw e
         }
     }
 
@@ -276,6 +276,8 @@ class DashboardFragment : Fragment() {
                     R.id.button_dither_none -> LutProcessor.DitherType.NONE
                     R.id.button_dither_floyd -> LutProcessor.DitherType.FLOYD_STEINBERG
                     R.id.button_dither_random -> LutProcessor.DitherType.RANDOM
+                    R.id.button_dither_bayer -> LutProcessor.DitherType.BAYER
+                    R.id.button_dither_blue_noise -> LutProcessor.DitherType.BLUE_NOISE
                     else -> LutProcessor.DitherType.NONE
                 }
                 preferencesManager.dashboardDitherType = ditherType.name
@@ -476,6 +478,8 @@ class DashboardFragment : Fragment() {
         val buttonId = when (ditherType) {
             ILutProcessor.DitherType.FLOYD_STEINBERG -> R.id.button_dither_floyd
             ILutProcessor.DitherType.RANDOM -> R.id.button_dither_random
+            ILutProcessor.DitherType.BAYER -> R.id.button_dither_bayer
+            ILutProcessor.DitherType.BLUE_NOISE -> R.id.button_dither_blue_noise
             ILutProcessor.DitherType.NONE -> R.id.button_dither_none
         }
         binding.toggleGroupDither.check(buttonId)
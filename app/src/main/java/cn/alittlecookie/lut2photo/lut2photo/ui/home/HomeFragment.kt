@@ -446,6 +446,8 @@ class HomeFragment : Fragment() {
                     R.id.button_dither_none -> LutProcessor.DitherType.NONE
                     R.id.button_dither_floyd -> LutProcessor.DitherType.FLOYD_STEINBERG
                     R.id.button_dither_random -> LutProcessor.DitherType.RANDOM
+                    R.id.button_dither_bayer -> LutProcessor.DitherType.BAYER
+                    R.id.button_dither_blue_noise -> LutProcessor.DitherType.BLUE_NOISE
                     else -> LutProcessor.DitherType.NONE
                 }
                 preferencesManager.homeDitherType = ditherType.name
@@ -593,6 +595,8 @@ class HomeFragment : Fragment() {
         val buttonId = when (ditherType) {
             LutProcessor.DitherType.FLOYD_STEINBERG -> R.id.button_dither_floyd
             LutProcessor.DitherType.RANDOM -> R.id.button_dither_random
+            LutProcessor.DitherType.BAYER -> R.id.button_dither_bayer
+            LutProcessor.DitherType.BLUE_NOISE -> R.id.button_dither_blue_noise
             LutProcessor.DitherType.NONE -> R.id.button_dither_none
         }
         binding.toggleGroupDither.check(buttonId)
@@ -790,6 +794,8 @@ class HomeFragment : Fragment() {
         return when (preferencesManager.homeDitherType.lowercase()) {
             "floyd_steinberg" -> LutProcessor.DitherType.FLOYD_STEINBERG
             "random" -> LutProcessor.DitherType.RANDOM
+            "bayer" -> LutProcessor.DitherType.BAYER
+            "blue_noise" -> LutProcessor.DitherType.BLUE_NOISE
             else -> LutProcessor.DitherType.NONE
         }
     }
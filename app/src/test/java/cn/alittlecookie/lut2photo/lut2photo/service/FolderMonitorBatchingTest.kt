@@ -0,0 +1,62 @@
+package cn.alittlecookie.lut2photo.lut2photo.service
+
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertTrue
+import org.junit.Test
+
+/**
+ * 存量文件按像素上限分批的单元测试
+ */
+class FolderMonitorBatchingTest {
+
+    private val maxPixels = FolderMonitorService.MAX_BATCH_PIXELS
+
+    @Test
+    fun testGroupByPixelBudget_emptyAndSingle() {
+        val empty = FolderMonitorService.groupByPixelBudget(emptyList<String>()) { 0L }
+        assertTrue(empty.isEmpty())
+
+        // 只有一张时不读取像素数
+        var reads = 0
+        val single = FolderMonitorService.groupByPixelBudget(listOf("a")) {
+            reads++
+            maxPixels * 2
+        }
+        assertEquals(listOf(listOf("a")), single)
+        assertEquals(0, reads)
+    }
+
+    @Test
+    fun testGroupByPixelBudget_fillsUpToLimit() {
+        // 三张12MP恰好等于上限，第四张另起一组
+        val pixels = mapOf("a" to 12_000_000L, "b" to 12_000_000L, "c" to 12_000_000L, "d" to 1L)
+        val groups = FolderMonitorService.groupByPixelBudget(pixels.keys.toList()) { pixels.getValue(it) }
+        assertEquals(listOf(listOf("a", "b", "c"), listOf("d")), groups)
+    }
+
+    @Test
+    fun testGroupByPixelBudget_oversizedImageIsAlone() {
+        // 48MP超过36MP上限，独立成组，前后的小图不与它合并
+        val pixels = linkedMapOf(
+            "a" to 12_000_000L,
+            "b" to 12_000_000L,
+            "large" to 48_000_000L,
+            "c" to 12_000_000L,
+            "d" to 12_000_000L
+        )
+        val groups = FolderMonitorService.groupByPixelBudget(pixels.keys.toList()) { pixels.getValue(it) }
+
+        assertEquals(listOf(listOf("a", "b"), listOf("large"), listOf("c", "d")), groups)
+        assertEquals(pixels.keys.toList(), groups.flatten())
+        for (group in groups) {
+            val total = group.sumOf { pixels.getValue(it) }
+            assertTrue(group.size == 1 || total <= maxPixels)
+        }
+    }
+
+    @Test
+    fun testGroupByPixelBudget_consecutiveOversizedImages() {
+        val groups = FolderMonitorService.groupByPixelBudget(listOf("x", "y")) { maxPixels + 1 }
+        assertEquals(listOf(listOf("x"), listOf("y")), groups)
+    }
+}